@@ -0,0 +1,81 @@
+// Copyright 2023 The titan-search Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "benchmark/benchmark.h"
+#include "rigel/taskflow/taskflow.h"
+#include "rigel/taskflow/algorithm/for_each.h"
+
+// Repeated for_each over a regular workload (equal cost per iteration) and
+// an irregular one (a few iterations are 1000x more expensive). Each
+// benchmark iteration runs the taskflow 20 times, so the adaptive partitioner
+// tunes its chunk size and mode on the first runs and reuses them afterwards.
+
+static constexpr size_t N = 1 << 16;
+
+static size_t work(size_t i, size_t n) {
+  size_t s = i;
+  for(size_t k=0; k<n; k++) {
+    s = s * 2654435761u + k;
+  }
+  return s;
+}
+
+template <typename P>
+static void BM_Regular(benchmark::State& state) {
+
+  rigel::Executor executor;
+  rigel::Taskflow taskflow;
+
+  std::vector<size_t> data(N);
+
+  taskflow.for_each_index(size_t{0}, N, size_t{1}, [&](size_t i){
+    data[i] = work(i, 8);
+  }, P());
+
+  for(auto _ : state) {
+    executor.run_n(taskflow, 20).wait();
+  }
+
+  state.SetItemsProcessed(state.iterations() * 20 * N);
+}
+
+template <typename P>
+static void BM_Irregular(benchmark::State& state) {
+
+  rigel::Executor executor;
+  rigel::Taskflow taskflow;
+
+  std::vector<size_t> data(N);
+
+  taskflow.for_each_index(size_t{0}, N, size_t{1}, [&](size_t i){
+    data[i] = work(i, (i % 1024 == 0) ? 8000 : 8);
+  }, P());
+
+  for(auto _ : state) {
+    executor.run_n(taskflow, 20).wait();
+  }
+
+  state.SetItemsProcessed(state.iterations() * 20 * N);
+}
+
+BENCHMARK_TEMPLATE(BM_Regular, rigel::StaticPartitioner)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Regular, rigel::GuidedPartitioner)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Regular, rigel::DynamicPartitioner)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Regular, rigel::AdaptivePartitioner)->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_Irregular, rigel::StaticPartitioner)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Irregular, rigel::GuidedPartitioner)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Irregular, rigel::DynamicPartitioner)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Irregular, rigel::AdaptivePartitioner)->UseRealTime();
@@ -0,0 +1,50 @@
+// Copyright 2023 The titan-search Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "benchmark/benchmark.h"
+#include "rigel/taskflow/taskflow.h"
+#include "rigel/taskflow/algorithm/for_each.h"
+
+// Repeated for_each over an array that fits in the aggregate L2 cache of
+// the workers (256 KB per worker). Each benchmark iteration runs the
+// taskflow 100 times, so a partitioner that keeps the same chunks on the
+// same workers reuses the data left in their caches by the previous run.
+
+static constexpr size_t L2_FLOATS_PER_WORKER = 64 * 1024;
+
+template <typename P>
+static void BM_RepeatedForEach(benchmark::State& state) {
+
+  rigel::Executor executor;
+
+  std::vector<float> data(L2_FLOATS_PER_WORKER * executor.num_workers(), 1.0f);
+
+  rigel::Taskflow taskflow;
+
+  taskflow.for_each(data.begin(), data.end(), [](float& f){
+    f = f * 0.999f + 0.001f;
+  }, P());
+
+  for(auto _ : state) {
+    executor.run_n(taskflow, 100).wait();
+  }
+
+  state.SetItemsProcessed(state.iterations() * 100 * data.size());
+}
+
+BENCHMARK_TEMPLATE(BM_RepeatedForEach, rigel::StaticPartitioner)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_RepeatedForEach, rigel::GuidedPartitioner)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_RepeatedForEach, rigel::DynamicPartitioner)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_RepeatedForEach, rigel::AffinityPartitioner)->UseRealTime();
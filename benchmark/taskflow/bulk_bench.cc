@@ -0,0 +1,113 @@
+// Copyright 2023 The titan-search Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "benchmark/benchmark.h"
+#include "rigel/taskflow/taskflow.h"
+
+// Cost of submitting many independent tasks. Each iteration submits
+// state.range(1) empty tasks to an executor of state.range(0) workers and
+// waits for them: BM_SilentAsyncLoop calls Executor::silent_async in a
+// loop, which takes the topology and queue locks and notifies once per
+// task, while BM_SilentAsyncBulk makes one Executor::silent_async_bulk
+// call. The Worker variants submit from inside a task, where the tasks go
+// to the queue of the submitting worker.
+
+static void BM_SilentAsyncLoop(benchmark::State& state) {
+
+  rigel::Executor executor(static_cast<size_t>(state.range(0)));
+
+  std::atomic<size_t> counter {0};
+
+  for(auto _ : state) {
+    for(int64_t i=0; i<state.range(1); i++) {
+      executor.silent_async([&](){ counter.fetch_add(1, std::memory_order_relaxed); });
+    }
+    executor.wait_for_all();
+  }
+
+  benchmark::DoNotOptimize(counter.load());
+  state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+
+static void BM_SilentAsyncBulk(benchmark::State& state) {
+
+  rigel::Executor executor(static_cast<size_t>(state.range(0)));
+
+  std::atomic<size_t> counter {0};
+
+  for(auto _ : state) {
+    executor.silent_async_bulk(int64_t{0}, state.range(1), [&](int64_t){
+      counter.fetch_add(1, std::memory_order_relaxed);
+    });
+    executor.wait_for_all();
+  }
+
+  benchmark::DoNotOptimize(counter.load());
+  state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+
+static void BM_SilentAsyncLoopWorker(benchmark::State& state) {
+
+  rigel::Executor executor(static_cast<size_t>(state.range(0)));
+
+  std::atomic<size_t> counter {0};
+
+  for(auto _ : state) {
+    executor.silent_async([&](){
+      for(int64_t i=0; i<state.range(1); i++) {
+        executor.silent_async([&](){ counter.fetch_add(1, std::memory_order_relaxed); });
+      }
+    });
+    executor.wait_for_all();
+  }
+
+  benchmark::DoNotOptimize(counter.load());
+  state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+
+static void BM_SilentAsyncBulkWorker(benchmark::State& state) {
+
+  rigel::Executor executor(static_cast<size_t>(state.range(0)));
+
+  std::atomic<size_t> counter {0};
+
+  for(auto _ : state) {
+    executor.silent_async([&](){
+      executor.silent_async_bulk(int64_t{0}, state.range(1), [&](int64_t){
+        counter.fetch_add(1, std::memory_order_relaxed);
+      });
+    });
+    executor.wait_for_all();
+  }
+
+  benchmark::DoNotOptimize(counter.load());
+  state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+
+BENCHMARK(BM_SilentAsyncLoop)
+  ->ArgsProduct({{1, 4}, {1000, 100000}})
+  ->UseRealTime();
+
+BENCHMARK(BM_SilentAsyncBulk)
+  ->ArgsProduct({{1, 4}, {1000, 100000}})
+  ->UseRealTime();
+
+BENCHMARK(BM_SilentAsyncLoopWorker)
+  ->ArgsProduct({{1, 4}, {1000, 100000}})
+  ->UseRealTime();
+
+BENCHMARK(BM_SilentAsyncBulkWorker)
+  ->ArgsProduct({{1, 4}, {1000, 100000}})
+  ->UseRealTime();
@@ -0,0 +1,108 @@
+// Copyright 2023 The titan-search Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "benchmark/benchmark.h"
+#include "rigel/taskflow/taskflow.h"
+#include "rigel/taskflow/algorithm/compact.h"
+
+// The first argument is the selectivity in percent, i.e., the fraction of
+// elements that satisfy the predicate. Real time is reported since the
+// calling thread only waits for the executor.
+
+static constexpr size_t N = 1 << 20;
+
+static std::vector<int> make_input() {
+  std::vector<int> input(N);
+  for(auto& i : input) {
+    i = ::rand() % 100;
+  }
+  return input;
+}
+
+static void BM_StdCopyIf(benchmark::State& state) {
+  int s = static_cast<int>(state.range(0));
+  auto input = make_input();
+  std::vector<int> output(N);
+  for(auto _ : state) {
+    auto itr = std::copy_if(input.begin(), input.end(), output.begin(), [s](int i){ return i < s; });
+    benchmark::DoNotOptimize(itr);
+  }
+  state.SetItemsProcessed(state.iterations() * N);
+}
+
+template <typename P>
+static void BM_CopyIf(benchmark::State& state) {
+  int s = static_cast<int>(state.range(0));
+  auto input = make_input();
+  std::vector<int> output(N);
+  std::vector<int>::iterator itr;
+  rigel::Executor executor;
+  rigel::Taskflow taskflow;
+  taskflow.copy_if(input.begin(), input.end(), output.begin(), itr, [s](int i){ return i < s; }, P());
+  for(auto _ : state) {
+    executor.run(taskflow).wait();
+    benchmark::DoNotOptimize(itr);
+  }
+  state.SetItemsProcessed(state.iterations() * N);
+}
+
+template <typename P>
+static void BM_RemoveIf(benchmark::State& state) {
+  int s = static_cast<int>(state.range(0));
+  auto golden = make_input();
+  std::vector<int> input;
+  std::vector<int>::iterator itr;
+  rigel::Executor executor;
+  rigel::Taskflow taskflow;
+  for(auto _ : state) {
+    state.PauseTiming();
+    input = golden;
+    taskflow.clear();
+    taskflow.remove_if(input.begin(), input.end(), itr, [s](int i){ return i >= s; }, P());
+    state.ResumeTiming();
+    executor.run(taskflow).wait();
+    benchmark::DoNotOptimize(itr);
+  }
+  state.SetItemsProcessed(state.iterations() * N);
+}
+
+template <typename P>
+static void BM_StablePartition(benchmark::State& state) {
+  int s = static_cast<int>(state.range(0));
+  auto golden = make_input();
+  std::vector<int> input;
+  std::vector<int>::iterator itr;
+  rigel::Executor executor;
+  rigel::Taskflow taskflow;
+  for(auto _ : state) {
+    state.PauseTiming();
+    input = golden;
+    taskflow.clear();
+    taskflow.stable_partition(input.begin(), input.end(), itr, [s](int i){ return i < s; }, P());
+    state.ResumeTiming();
+    executor.run(taskflow).wait();
+    benchmark::DoNotOptimize(itr);
+  }
+  state.SetItemsProcessed(state.iterations() * N);
+}
+
+#define SELECTIVITIES Arg(1)->Arg(10)->Arg(50)->Arg(90)->UseRealTime()
+
+BENCHMARK(BM_StdCopyIf)->SELECTIVITIES;
+BENCHMARK_TEMPLATE(BM_CopyIf, rigel::StaticPartitioner)->SELECTIVITIES;
+BENCHMARK_TEMPLATE(BM_CopyIf, rigel::GuidedPartitioner)->SELECTIVITIES;
+BENCHMARK_TEMPLATE(BM_CopyIf, rigel::DynamicPartitioner)->SELECTIVITIES;
+BENCHMARK_TEMPLATE(BM_RemoveIf, rigel::GuidedPartitioner)->SELECTIVITIES;
+BENCHMARK_TEMPLATE(BM_StablePartition, rigel::GuidedPartitioner)->SELECTIVITIES;
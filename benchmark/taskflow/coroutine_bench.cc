@@ -0,0 +1,100 @@
+// Copyright 2023 The titan-search Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "benchmark/benchmark.h"
+#include "rigel/taskflow/taskflow.h"
+
+// Waiting on asynchronous work from inside a task. Each of state.range(1)
+// tasks waits state.range(2) times in a row for an async task that runs on a
+// second executor with two workers (as for an I/O pool). BM_CorunWait
+// waits with Runtime::corun_until, which keeps the waiting task on the stack
+// of its worker while the worker runs other tasks (including other waiting
+// tasks), so waits nest; the max_nesting counter reports the deepest nesting
+// of waiting tasks on one worker. BM_CoroWait uses coroutine tasks that
+// suspend at each co_await and never nest.
+
+static void spin(size_t n) {
+  for(size_t i=0; i<n; i++) {
+    benchmark::DoNotOptimize(i);
+  }
+}
+
+static thread_local size_t nesting = 0;
+
+static void BM_CorunWait(benchmark::State& state) {
+
+  rigel::Executor executor(static_cast<size_t>(state.range(0)));
+  rigel::Executor io(2);
+  rigel::Taskflow taskflow;
+
+  const auto D = state.range(2);
+
+  std::atomic<size_t> max_nesting {0};
+
+  for(int64_t i=0; i<state.range(1); i++) {
+    taskflow.emplace([&, D](rigel::Runtime& rt){
+      auto depth = ++nesting;
+      for(auto prev = max_nesting.load(); prev < depth &&
+          !max_nesting.compare_exchange_weak(prev, depth););
+      for(int64_t d=0; d<D; d++) {
+        auto fu = io.async([](){ spin(4096); return 1; });
+        rt.corun_until([&](){
+          return fu.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        });
+        benchmark::DoNotOptimize(fu.get());
+      }
+      --nesting;
+    });
+  }
+
+  for(auto _ : state) {
+    executor.run(taskflow).wait();
+  }
+
+  state.counters["max_nesting"] = static_cast<double>(max_nesting.load());
+  state.SetItemsProcessed(state.iterations() * state.range(1) * D);
+}
+
+static void BM_CoroWait(benchmark::State& state) {
+
+  rigel::Executor executor(static_cast<size_t>(state.range(0)));
+  rigel::Executor io(2);
+  rigel::Taskflow taskflow;
+
+  const auto D = state.range(2);
+
+  for(int64_t i=0; i<state.range(1); i++) {
+    taskflow.emplace([&, D]() -> rigel::Coro {
+      for(int64_t d=0; d<D; d++) {
+        benchmark::DoNotOptimize(co_await io.async([](){ spin(4096); return 1; }));
+      }
+    });
+  }
+
+  for(auto _ : state) {
+    executor.run(taskflow).wait();
+  }
+
+  state.counters["max_nesting"] = 1;
+  state.SetItemsProcessed(state.iterations() * state.range(1) * D);
+}
+
+BENCHMARK(BM_CorunWait)
+  ->ArgsProduct({{1, 4}, {16, 256}, {1, 16}})
+  ->UseRealTime();
+
+BENCHMARK(BM_CoroWait)
+  ->ArgsProduct({{1, 4}, {16, 256}, {1, 16}})
+  ->UseRealTime();
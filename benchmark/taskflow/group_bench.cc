@@ -0,0 +1,69 @@
+// Copyright 2023 The titan-search Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "benchmark/benchmark.h"
+#include "rigel/taskflow/taskflow.h"
+
+// Latency of a latency-critical task under batch load. A batch taskflow of
+// 256 tasks that spin for 100 us each runs over and over on an executor of
+// state.range(1) workers while each iteration submits one small task and
+// waits for its result. With state.range(0) == 0 all workers form a single
+// group, so the small task queues up behind the batch tasks; with
+// state.range(0) == 1 one worker forms an "rt" group of its own that the
+// batch tasks cannot take, and state.range(0) == 2 additionally lends that
+// worker to the batch group while it is idle.
+
+static void spin(std::chrono::microseconds d) {
+  auto end = std::chrono::steady_clock::now() + d;
+  while(std::chrono::steady_clock::now() < end);
+}
+
+static void BM_RtLatency(benchmark::State& state) {
+
+  const auto mode = state.range(0);
+  const auto W = static_cast<size_t>(state.range(1));
+
+  auto executor = mode == 0 ?
+    std::make_unique<rigel::Executor>(W) :
+    std::make_unique<rigel::Executor>(std::vector<rigel::WorkerGroup>{
+      {"rt", 1, {}, mode == 2}, {"batch", W - 1}
+    });
+
+  std::atomic<bool> stop {false};
+
+  rigel::Taskflow batch;
+  if(mode != 0) {
+    batch.group(executor->group_id("batch"));
+  }
+  for(int i=0; i<256; i++) {
+    batch.emplace([](){ spin(std::chrono::microseconds(100)); });
+  }
+
+  auto load = executor->run_until(batch, [&](){ return stop.load(); });
+
+  // the first runs of the batch fill the queues
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+  for(auto _ : state) {
+    benchmark::DoNotOptimize(executor->async([](){ return 1; }).get());
+  }
+
+  stop = true;
+  load.wait();
+}
+
+BENCHMARK(BM_RtLatency)
+  ->ArgsProduct({{0, 1, 2}, {2, 4}})
+  ->UseRealTime();
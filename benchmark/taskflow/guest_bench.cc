@@ -0,0 +1,62 @@
+// Copyright 2023 The titan-search Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "benchmark/benchmark.h"
+#include "rigel/taskflow/taskflow.h"
+
+// Latency of small taskflows submitted from many client threads. Each
+// benchmark thread is a client that runs its own diamond of ten tasks of
+// 5 us each on a shared executor of state.range(1) workers and waits for the
+// result. With state.range(0) == 0 the clients block on the future; with
+// state.range(0) == 1 guest waits are enabled and the clients run tasks
+// while they wait.
+
+static void spin(std::chrono::microseconds d) {
+  auto end = std::chrono::steady_clock::now() + d;
+  while(std::chrono::steady_clock::now() < end);
+}
+
+static std::unique_ptr<rigel::Executor> executor;
+
+static void BM_ClientLatency(benchmark::State& state) {
+
+  if(state.thread_index() == 0) {
+    executor = std::make_unique<rigel::Executor>(state.range(1));
+    executor->enable_guest_waits(state.range(0) == 1);
+  }
+
+  rigel::Taskflow taskflow;
+  auto S = taskflow.emplace([](){ spin(std::chrono::microseconds(5)); });
+  auto T = taskflow.emplace([](){ spin(std::chrono::microseconds(5)); });
+  for(int i=0; i<8; i++) {
+    auto t = taskflow.emplace([](){ spin(std::chrono::microseconds(5)); });
+    S.precede(t);
+    T.succeed(t);
+  }
+
+  for(auto _ : state) {
+    executor->run(taskflow).wait();
+  }
+
+  if(state.thread_index() == 0) {
+    executor.reset();
+  }
+}
+
+BENCHMARK(BM_ClientLatency)
+  ->ArgsProduct({{0, 1}, {2, 4}})
+  ->Threads(4)
+  ->Threads(16)
+  ->UseRealTime();
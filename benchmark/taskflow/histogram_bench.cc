@@ -0,0 +1,113 @@
+// Copyright 2023 The titan-search Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <random>
+#include "benchmark/benchmark.h"
+#include "rigel/taskflow/taskflow.h"
+#include "rigel/taskflow/algorithm/for_each.h"
+#include "rigel/taskflow/algorithm/histogram.h"
+
+// Histogram of 4M random keys with a bucket count that fits in L1
+// (256 buckets) and one that only fits in DRAM (4M buckets), compared with
+// the hand-rolled version that increments a shared array of atomics.
+
+static constexpr size_t N = 1 << 22;
+
+static std::vector<uint32_t> make_keys(size_t num_bins) {
+  std::vector<uint32_t> keys(N);
+  std::mt19937 rng(0);
+  std::uniform_int_distribution<uint32_t> dist(0, static_cast<uint32_t>(num_bins - 1));
+  for(auto& k : keys) {
+    k = dist(rng);
+  }
+  return keys;
+}
+
+static void BM_Histogram(benchmark::State& state) {
+
+  size_t num_bins = state.range(0);
+
+  rigel::Executor executor;
+  rigel::Taskflow taskflow;
+
+  auto keys = make_keys(num_bins);
+  std::vector<size_t> bins(num_bins);
+
+  taskflow.histogram(keys.begin(), keys.end(), bins.begin(), num_bins,
+    [](uint32_t k){ return static_cast<size_t>(k); }
+  );
+
+  for(auto _ : state) {
+    std::fill(bins.begin(), bins.end(), 0);
+    executor.run(taskflow).wait();
+    benchmark::DoNotOptimize(bins.data());
+  }
+
+  state.SetItemsProcessed(state.iterations() * N);
+}
+
+static void BM_AtomicHistogram(benchmark::State& state) {
+
+  size_t num_bins = state.range(0);
+
+  rigel::Executor executor;
+  rigel::Taskflow taskflow;
+
+  auto keys = make_keys(num_bins);
+  std::vector<std::atomic<size_t>> bins(num_bins);
+
+  taskflow.for_each(keys.begin(), keys.end(), [&](uint32_t k){
+    bins[k].fetch_add(1, std::memory_order_relaxed);
+  });
+
+  for(auto _ : state) {
+    for(auto& b : bins) {
+      b.store(0, std::memory_order_relaxed);
+    }
+    executor.run(taskflow).wait();
+    benchmark::DoNotOptimize(bins.data());
+  }
+
+  state.SetItemsProcessed(state.iterations() * N);
+}
+
+static void BM_HistogramReduce(benchmark::State& state) {
+
+  size_t num_bins = state.range(0);
+
+  rigel::Executor executor;
+  rigel::Taskflow taskflow;
+
+  auto keys = make_keys(num_bins);
+  std::vector<double> sums(num_bins);
+
+  taskflow.histogram_reduce(keys.begin(), keys.end(), sums.begin(), num_bins,
+    [](uint32_t k){ return static_cast<size_t>(k); },
+    [](uint32_t k){ return static_cast<double>(k) * 0.5; },
+    std::plus<double>{}
+  );
+
+  for(auto _ : state) {
+    std::fill(sums.begin(), sums.end(), 0.0);
+    executor.run(taskflow).wait();
+    benchmark::DoNotOptimize(sums.data());
+  }
+
+  state.SetItemsProcessed(state.iterations() * N);
+}
+
+BENCHMARK(BM_Histogram)->Arg(256)->Arg(1 << 22)->UseRealTime();
+BENCHMARK(BM_AtomicHistogram)->Arg(256)->Arg(1 << 22)->UseRealTime();
+BENCHMARK(BM_HistogramReduce)->Arg(256)->Arg(1 << 22)->UseRealTime();
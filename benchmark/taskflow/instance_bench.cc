@@ -0,0 +1,85 @@
+// Copyright 2023 The titan-search Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "benchmark/benchmark.h"
+#include "rigel/taskflow/taskflow.h"
+
+// Requests per second of a request handler that runs the same graph of 500
+// tasks, 20 layers of 25 tasks with each task depending on two tasks of the
+// layer above, for every request. Each benchmark thread is a client that
+// runs and waits for one request per iteration on a shared executor of four
+// workers. With state.range(0) == 0 all clients run one shared taskflow,
+// whose runs queue up; with state.range(0) == 1 each client runs a clone of
+// the graph of its own; with state.range(0) == 2 all clients run one shared
+// taskflow with instancing enabled.
+
+constexpr size_t L = 20;
+constexpr size_t M = 25;
+
+static void build(rigel::Taskflow& taskflow, std::atomic<size_t>& counter) {
+  std::vector<rigel::Task> prev, curr;
+  for(size_t l=0; l<L; l++) {
+    curr.clear();
+    for(size_t m=0; m<M; m++) {
+      curr.push_back(taskflow.emplace([&](){
+        counter.fetch_add(1, std::memory_order_relaxed);
+      }));
+      if(l) {
+        curr.back().succeed(prev[m], prev[(m + 1) % M]);
+      }
+    }
+    std::swap(prev, curr);
+  }
+}
+
+static std::unique_ptr<rigel::Executor> executor;
+static std::unique_ptr<rigel::Taskflow> shared;
+static std::atomic<size_t> counter {0};
+
+static void BM_Requests(benchmark::State& state) {
+
+  const auto mode = state.range(0);
+
+  if(state.thread_index() == 0) {
+    executor = std::make_unique<rigel::Executor>(4);
+    shared = std::make_unique<rigel::Taskflow>();
+    build(*shared, counter);
+    shared->enable_instancing(mode == 2);
+  }
+
+  rigel::Taskflow clone;
+  if(mode == 1) {
+    build(clone, counter);
+  }
+
+  for(auto _ : state) {
+    executor->run(mode == 1 ? clone : *shared).wait();
+  }
+
+  state.SetItemsProcessed(state.iterations());
+
+  if(state.thread_index() == 0) {
+    shared.reset();
+    executor.reset();
+  }
+}
+
+BENCHMARK(BM_Requests)
+  ->Arg(0)
+  ->Arg(1)
+  ->Arg(2)
+  ->Threads(1)
+  ->Threads(8)
+  ->UseRealTime();
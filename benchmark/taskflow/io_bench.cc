@@ -0,0 +1,128 @@
+// Copyright 2023 The titan-search Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "benchmark/benchmark.h"
+#include "rigel/taskflow/taskflow.h"
+
+#include <cstdlib>
+#include <unistd.h>
+
+// Throughput of reading a temporary file in chunks of state.range(1) bytes.
+// BM_BlockingRead runs one task per chunk that calls pread, so each read
+// holds a worker. BM_AsyncRead issues the same reads with
+// Executor::async_read, which leaves the workers free while the reads are
+// in flight; the second template argument selects the io_uring or the
+// epoll backend. The file is 16 MiB and mostly served from the page cache.
+
+constexpr size_t FILE_SIZE = 16 << 20;
+
+struct TempFile {
+
+  int fd;
+
+  TempFile() {
+    char path[] = "/tmp/tf_io_bench_XXXXXX";
+    fd = ::mkstemp(path);
+    ::unlink(path);
+    std::vector<char> data(FILE_SIZE, 'x');
+    for(size_t off = 0; off < FILE_SIZE; ) {
+      auto n = ::pwrite(fd, data.data() + off, FILE_SIZE - off, off);
+      if(n <= 0) {
+        break;
+      }
+      off += static_cast<size_t>(n);
+    }
+  }
+
+  ~TempFile() {
+    ::close(fd);
+  }
+};
+
+static TempFile& temp_file() {
+  static TempFile file;
+  return file;
+}
+
+static void BM_BlockingRead(benchmark::State& state) {
+
+  rigel::Executor executor(static_cast<size_t>(state.range(0)));
+
+  const size_t B = static_cast<size_t>(state.range(1));
+  const size_t N = FILE_SIZE / B;
+  const int fd = temp_file().fd;
+
+  std::vector<char> buf(FILE_SIZE);
+  std::atomic<size_t> bytes {0};
+
+  for(auto _ : state) {
+    for(size_t i=0; i<N; i++) {
+      executor.silent_async([&, i](){
+        auto n = ::pread(fd, buf.data() + i*B, B, static_cast<off_t>(i*B));
+        bytes.fetch_add(n > 0 ? n : 0, std::memory_order_relaxed);
+      });
+    }
+    executor.wait_for_all();
+  }
+
+  benchmark::DoNotOptimize(bytes.load());
+  state.SetBytesProcessed(state.iterations() * FILE_SIZE);
+}
+
+template <rigel::IOBackend backend>
+static void BM_AsyncRead(benchmark::State& state) {
+
+  if(backend == rigel::IOBackend::EPOLL) {
+    ::setenv(TF_IO_BACKEND, "epoll", 1);
+  }
+  else {
+    ::unsetenv(TF_IO_BACKEND);
+  }
+
+  rigel::Executor executor(static_cast<size_t>(state.range(0)));
+
+  if(executor.io_backend() != backend) {
+    state.SkipWithError("backend unavailable");
+    return;
+  }
+
+  const size_t B = static_cast<size_t>(state.range(1));
+  const size_t N = FILE_SIZE / B;
+  const int fd = temp_file().fd;
+
+  std::vector<char> buf(FILE_SIZE);
+
+  for(auto _ : state) {
+    for(size_t i=0; i<N; i++) {
+      executor.async_read(fd, buf.data() + i*B, B, static_cast<int64_t>(i*B));
+    }
+    executor.wait_for_all();
+  }
+
+  benchmark::DoNotOptimize(buf.data());
+  state.SetBytesProcessed(state.iterations() * FILE_SIZE);
+}
+
+BENCHMARK(BM_BlockingRead)
+  ->ArgsProduct({{1, 4}, {4 << 10, 64 << 10, 1 << 20}})
+  ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_AsyncRead, rigel::IOBackend::IO_URING)
+  ->ArgsProduct({{1, 4}, {4 << 10, 64 << 10, 1 << 20}})
+  ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_AsyncRead, rigel::IOBackend::EPOLL)
+  ->ArgsProduct({{1, 4}, {4 << 10, 64 << 10, 1 << 20}})
+  ->UseRealTime();
@@ -0,0 +1,89 @@
+// Copyright 2023 The titan-search Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "benchmark/benchmark.h"
+#include "rigel/taskflow/taskflow.h"
+
+// Per-task cost of the scheduler metrics on a taskflow of 10K independent
+// tasks and on 10K asyncs spawned from a worker. Metrics are disabled by
+// default, in which case the scheduler pays one relaxed load per event.
+// BM_LatencySampling stamps one of every N ready tasks (0 disables).
+
+static constexpr size_t N = 10000;
+
+static void BM_Taskflow(benchmark::State& state) {
+
+  rigel::Executor executor;
+  executor.enable_metrics(state.range(0));
+
+  rigel::Taskflow taskflow;
+  for(size_t i=0; i<N; i++) {
+    taskflow.emplace([](){});
+  }
+
+  for(auto _ : state) {
+    executor.run(taskflow).wait();
+  }
+
+  state.SetItemsProcessed(state.iterations() * N);
+}
+
+static void BM_Async(benchmark::State& state) {
+
+  rigel::Executor executor;
+  executor.enable_metrics(state.range(0));
+
+  for(auto _ : state) {
+    executor.silent_async([&](){
+      for(size_t i=0; i<N; i++) {
+        executor.silent_async([](){});
+      }
+    });
+    executor.wait_for_all();
+  }
+
+  state.SetItemsProcessed(state.iterations() * N);
+}
+
+static void BM_LatencySampling(benchmark::State& state) {
+
+  rigel::Executor executor;
+  executor.enable_latency_sampling(state.range(0));
+
+  rigel::Taskflow taskflow;
+  for(size_t i=0; i<N; i++) {
+    taskflow.emplace([](){});
+  }
+
+  for(auto _ : state) {
+    executor.run(taskflow).wait();
+  }
+
+  state.SetItemsProcessed(state.iterations() * N);
+}
+
+static void BM_Snapshot(benchmark::State& state) {
+
+  rigel::Executor executor;
+  executor.enable_metrics();
+
+  for(auto _ : state) {
+    benchmark::DoNotOptimize(executor.metrics().dump_prometheus());
+  }
+}
+
+BENCHMARK(BM_Taskflow)->ArgName("metrics")->Arg(0)->Arg(1)->UseRealTime();
+BENCHMARK(BM_Async)->ArgName("metrics")->Arg(0)->Arg(1)->UseRealTime();
+BENCHMARK(BM_LatencySampling)->ArgName("period")->Arg(0)->Arg(1)->Arg(16)->UseRealTime();
+BENCHMARK(BM_Snapshot)->UseRealTime();
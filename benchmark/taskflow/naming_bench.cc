@@ -0,0 +1,90 @@
+// Copyright 2023 The titan-search Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "benchmark/benchmark.h"
+#include "rigel/taskflow/taskflow.h"
+#include "rigel/taskflow/algorithm/for_each.h"
+
+// Cost of naming the chunk tasks a runtime spawns. BM_SpawnString formats
+// "loop-<i>" into a string per task as launch_loop used to; BM_SpawnIndexed
+// passes an IndexedName that is formatted only when read. BM_ForEach runs a
+// small for_each, whose time is dominated by spawning and joining the chunk
+// tasks, so it shows the per-loop overhead of the algorithms.
+
+static void BM_SpawnString(benchmark::State& state) {
+
+  using namespace std::string_literals;
+
+  const size_t N = static_cast<size_t>(state.range(0));
+
+  rigel::Executor executor;
+  rigel::Taskflow taskflow;
+
+  taskflow.emplace([N](rigel::Runtime& rt){
+    for(size_t i=0; i<N; i++) {
+      rt.silent_async_unchecked("loop-"s + std::to_string(i), [](){});
+    }
+    rt.join();
+  });
+
+  for(auto _ : state) {
+    executor.run(taskflow).wait();
+  }
+
+  state.SetItemsProcessed(state.iterations() * N);
+}
+
+static void BM_SpawnIndexed(benchmark::State& state) {
+
+  const size_t N = static_cast<size_t>(state.range(0));
+
+  rigel::Executor executor;
+  rigel::Taskflow taskflow;
+
+  taskflow.emplace([N](rigel::Runtime& rt){
+    for(size_t i=0; i<N; i++) {
+      rt.silent_async_unchecked(rigel::IndexedName{"loop-", i}, [](){});
+    }
+    rt.join();
+  });
+
+  for(auto _ : state) {
+    executor.run(taskflow).wait();
+  }
+
+  state.SetItemsProcessed(state.iterations() * N);
+}
+
+static void BM_ForEach(benchmark::State& state) {
+
+  const size_t N = static_cast<size_t>(state.range(0));
+
+  std::vector<int> data(N);
+
+  rigel::Executor executor;
+  rigel::Taskflow taskflow;
+
+  taskflow.for_each(data.begin(), data.end(), [](int& i){ i++; }, rigel::StaticPartitioner(1));
+
+  for(auto _ : state) {
+    executor.run(taskflow).wait();
+  }
+
+  state.SetItemsProcessed(state.iterations() * N);
+}
+
+BENCHMARK(BM_SpawnString)->Arg(1000)->UseRealTime();
+BENCHMARK(BM_SpawnIndexed)->Arg(1000)->UseRealTime();
+BENCHMARK(BM_ForEach)->Arg(16)->Arg(64)->Arg(256)->UseRealTime();
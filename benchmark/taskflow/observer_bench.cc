@@ -0,0 +1,103 @@
+// Copyright 2023 The titan-search Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "benchmark/benchmark.h"
+#include "rigel/taskflow/taskflow.h"
+#include "rigel/taskflow/core/perf_observer.h"
+
+// Per-task cost of the built-in observers on a taskflow of 10K independent
+// named tasks. The Chrome and TFProf observers are cleared after each run so
+// their memory does not grow across iterations. BM_ObserverRemoved runs with
+// an executor whose only observer has been removed, which must cost the same
+// as an executor that never had one. The PerfCounterObserver reads its
+// counter group twice per task.
+
+static constexpr size_t N = 10000;
+
+static void make_taskflow(rigel::Taskflow& taskflow) {
+  for(size_t i=0; i<N; i++) {
+    taskflow.emplace([](){}).name("task-" + std::to_string(i));
+  }
+}
+
+static void BM_NoObserver(benchmark::State& state) {
+
+  rigel::Executor executor;
+  rigel::Taskflow taskflow;
+  make_taskflow(taskflow);
+
+  for(auto _ : state) {
+    executor.run(taskflow).wait();
+  }
+
+  state.SetItemsProcessed(state.iterations() * N);
+}
+
+template <typename O>
+static void BM_Observer(benchmark::State& state) {
+
+  rigel::Executor executor;
+  rigel::Taskflow taskflow;
+  make_taskflow(taskflow);
+
+  auto observer = executor.make_observer<O>();
+
+  for(auto _ : state) {
+    executor.run(taskflow).wait();
+    state.PauseTiming();
+    observer->clear();
+    state.ResumeTiming();
+  }
+
+  state.SetItemsProcessed(state.iterations() * N);
+}
+
+static void BM_ObserverRemoved(benchmark::State& state) {
+
+  rigel::Executor executor;
+  rigel::Taskflow taskflow;
+  make_taskflow(taskflow);
+
+  executor.remove_observer(executor.make_observer<rigel::ChromeObserver>());
+
+  for(auto _ : state) {
+    executor.run(taskflow).wait();
+  }
+
+  state.SetItemsProcessed(state.iterations() * N);
+}
+
+static void BM_TraceObserverAlwaysOn(benchmark::State& state) {
+
+  rigel::Executor executor;
+  rigel::Taskflow taskflow;
+  make_taskflow(taskflow);
+
+  auto observer = executor.make_observer<rigel::TraceObserver>(4096);
+
+  for(auto _ : state) {
+    executor.run(taskflow).wait();
+  }
+
+  state.SetItemsProcessed(state.iterations() * N);
+}
+
+BENCHMARK(BM_NoObserver)->UseRealTime();
+BENCHMARK(BM_ObserverRemoved)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Observer, rigel::ChromeObserver)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Observer, rigel::TFProfObserver)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Observer, rigel::TraceObserver)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Observer, rigel::PerfCounterObserver)->UseRealTime();
+BENCHMARK(BM_TraceObserverAlwaysOn)->UseRealTime();
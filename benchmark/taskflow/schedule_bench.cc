@@ -0,0 +1,75 @@
+// Copyright 2023 The titan-search Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "benchmark/benchmark.h"
+#include "rigel/taskflow/taskflow.h"
+
+// Cost of scheduling ready nodes from a worker. BM_WideFanOut runs one
+// source that releases state.range(1) successors, which a worker pushes as
+// one batch followed by a single notification. BM_SubflowSpawn spawns the
+// same number of children from a subflow and joins them, where the joining
+// worker keeps one child for itself and wakes thieves for the rest.
+
+static void BM_WideFanOut(benchmark::State& state) {
+
+  rigel::Executor executor(static_cast<size_t>(state.range(0)));
+  rigel::Taskflow taskflow;
+
+  std::atomic<size_t> counter {0};
+
+  auto src = taskflow.emplace([](){});
+  for(int64_t i=0; i<state.range(1); i++) {
+    src.precede(taskflow.emplace([&](){
+      counter.fetch_add(1, std::memory_order_relaxed);
+    }));
+  }
+
+  for(auto _ : state) {
+    executor.run(taskflow).wait();
+  }
+
+  benchmark::DoNotOptimize(counter.load());
+  state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+
+static void BM_SubflowSpawn(benchmark::State& state) {
+
+  rigel::Executor executor(static_cast<size_t>(state.range(0)));
+  rigel::Taskflow taskflow;
+
+  std::atomic<size_t> counter {0};
+  const auto N = state.range(1);
+
+  taskflow.emplace([&](rigel::Subflow& sf){
+    for(int64_t i=0; i<N; i++) {
+      sf.emplace([&](){ counter.fetch_add(1, std::memory_order_relaxed); });
+    }
+  });
+
+  for(auto _ : state) {
+    executor.run(taskflow).wait();
+  }
+
+  benchmark::DoNotOptimize(counter.load());
+  state.SetItemsProcessed(state.iterations() * N);
+}
+
+BENCHMARK(BM_WideFanOut)
+  ->ArgsProduct({{1, 2, 4, 8}, {16, 256, 4096}})
+  ->UseRealTime();
+
+BENCHMARK(BM_SubflowSpawn)
+  ->ArgsProduct({{1, 2, 4, 8}, {16, 256, 4096}})
+  ->UseRealTime();
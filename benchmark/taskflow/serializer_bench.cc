@@ -0,0 +1,160 @@
+// Copyright 2023 The titan-search Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "benchmark/benchmark.h"
+#include "rigel/taskflow/taskflow.h"
+
+// Throughput of the serializer over std::stringstream versus the memory
+// streams. The payload mimics a profile: N records of a short name and two
+// timestamps, plus a flat array of N timestamps. BM_LoadView reads the flat
+// array as an ArrayView, which points into the buffer instead of copying,
+// and BM_DeltaVarint reports the encoded size of the timestamps.
+
+struct Record {
+
+  std::string name;
+  uint64_t beg;
+  uint64_t end;
+
+  template <typename Archiver>
+  auto save(Archiver& ar) const { return ar(name, beg, end); }
+
+  template <typename Archiver>
+  auto load(Archiver& ar) { return ar(name, beg, end); }
+};
+
+static void make_payload(size_t N, std::vector<Record>& records, std::vector<uint64_t>& stamps) {
+  uint64_t t = 1700000000000000000ull;
+  records.resize(N);
+  stamps.resize(N);
+  for(size_t i=0; i<N; i++) {
+    records[i].name = "task-" + std::to_string(i % 100);
+    records[i].beg = (t += 10);
+    records[i].end = (t += 100);
+    stamps[i] = t;
+  }
+}
+
+static void BM_SaveStringStream(benchmark::State& state) {
+  std::vector<Record> records;
+  std::vector<uint64_t> stamps;
+  make_payload(static_cast<size_t>(state.range(0)), records, stamps);
+  for(auto _ : state) {
+    std::ostringstream oss;
+    rigel::Serializer<std::ostringstream> ar(oss);
+    benchmark::DoNotOptimize(ar(records, stamps));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_SaveBufferStream(benchmark::State& state) {
+  std::vector<Record> records;
+  std::vector<uint64_t> stamps;
+  make_payload(static_cast<size_t>(state.range(0)), records, stamps);
+  for(auto _ : state) {
+    rigel::BufferStream buffer;
+    rigel::Serializer<rigel::BufferStream> ar(buffer);
+    benchmark::DoNotOptimize(ar(records, stamps));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_LoadStringStream(benchmark::State& state) {
+  std::vector<Record> records;
+  std::vector<uint64_t> stamps;
+  make_payload(static_cast<size_t>(state.range(0)), records, stamps);
+  std::ostringstream oss;
+  rigel::Serializer<std::ostringstream> oar(oss);
+  oar(records, stamps);
+  auto bytes = oss.str();
+  for(auto _ : state) {
+    std::istringstream iss(bytes);
+    rigel::Deserializer<std::istringstream> ar(iss);
+    std::vector<Record> r;
+    std::vector<uint64_t> s;
+    benchmark::DoNotOptimize(ar(r, s));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_LoadViewStream(benchmark::State& state) {
+  std::vector<Record> records;
+  std::vector<uint64_t> stamps;
+  make_payload(static_cast<size_t>(state.range(0)), records, stamps);
+  rigel::BufferStream buffer;
+  rigel::Serializer<rigel::BufferStream> oar(buffer);
+  oar(records, stamps);
+  for(auto _ : state) {
+    rigel::ViewStream is(buffer.data(), buffer.size());
+    rigel::Deserializer<rigel::ViewStream> ar(is);
+    std::vector<Record> r;
+    std::vector<uint64_t> s;
+    benchmark::DoNotOptimize(ar(r, s));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_LoadVector(benchmark::State& state) {
+  std::vector<Record> records;
+  std::vector<uint64_t> stamps;
+  make_payload(static_cast<size_t>(state.range(0)), records, stamps);
+  rigel::BufferStream buffer;
+  rigel::Serializer<rigel::BufferStream> oar(buffer);
+  oar(stamps);
+  for(auto _ : state) {
+    rigel::ViewStream is(buffer.data(), buffer.size());
+    rigel::Deserializer<rigel::ViewStream> ar(is);
+    std::vector<uint64_t> s;
+    benchmark::DoNotOptimize(ar(s));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_LoadView(benchmark::State& state) {
+  std::vector<Record> records;
+  std::vector<uint64_t> stamps;
+  make_payload(static_cast<size_t>(state.range(0)), records, stamps);
+  rigel::BufferStream buffer;
+  rigel::Serializer<rigel::BufferStream> oar(buffer);
+  oar(stamps);
+  for(auto _ : state) {
+    rigel::ViewStream is(buffer.data(), buffer.size());
+    rigel::Deserializer<rigel::ViewStream> ar(is);
+    rigel::ArrayView<uint64_t> s;
+    benchmark::DoNotOptimize(ar(s));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_DeltaVarint(benchmark::State& state) {
+  std::vector<Record> records;
+  std::vector<uint64_t> stamps;
+  make_payload(static_cast<size_t>(state.range(0)), records, stamps);
+  for(auto _ : state) {
+    rigel::BufferStream buffer;
+    rigel::Serializer<rigel::BufferStream> ar(buffer);
+    ar(rigel::make_delta_varint_tag(stamps));
+    state.counters["bytes"] = static_cast<double>(buffer.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_SaveStringStream)->Arg(1 << 20)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_SaveBufferStream)->Arg(1 << 20)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_LoadStringStream)->Arg(1 << 20)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_LoadViewStream)->Arg(1 << 20)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_LoadVector)->Arg(1 << 20)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_LoadView)->Arg(1 << 20)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_DeltaVarint)->Arg(1 << 20)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,103 @@
+// Copyright 2023 The titan-search Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "benchmark/benchmark.h"
+#include "rigel/taskflow/taskflow.h"
+#include "rigel/taskflow/core/snapshot.h"
+
+// Rebuilding a large taskflow: BM_Build replays the code that creates a
+// layered graph of N named tasks with two successors each, BM_Save and
+// BM_Load write and read its snapshot in memory, and BM_Restore rebuilds
+// the taskflow from a loaded snapshot. BM_Dump is the GraphViz dump for
+// comparison.
+
+static void build(rigel::Taskflow& taskflow, size_t N) {
+  std::vector<rigel::Task> tasks(N);
+  for(size_t i=0; i<N; i++) {
+    tasks[i] = taskflow.emplace([](){}).name("task-" + std::to_string(i));
+  }
+  for(size_t i=0; 2*i+2<N; i++) {
+    tasks[i].precede(tasks[2*i+1], tasks[2*i+2]);
+  }
+}
+
+static void BM_Build(benchmark::State& state) {
+  const size_t N = static_cast<size_t>(state.range(0));
+  for(auto _ : state) {
+    rigel::Taskflow taskflow;
+    build(taskflow, N);
+    benchmark::DoNotOptimize(taskflow.num_tasks());
+  }
+  state.SetItemsProcessed(state.iterations() * N);
+}
+
+static void BM_Save(benchmark::State& state) {
+  const size_t N = static_cast<size_t>(state.range(0));
+  rigel::Taskflow taskflow;
+  build(taskflow, N);
+  for(auto _ : state) {
+    std::ostringstream oss;
+    rigel::TaskflowSnapshot(taskflow).save(oss);
+    state.counters["bytes"] = static_cast<double>(oss.tellp());
+  }
+  state.SetItemsProcessed(state.iterations() * N);
+}
+
+static void BM_Load(benchmark::State& state) {
+  const size_t N = static_cast<size_t>(state.range(0));
+  rigel::Taskflow taskflow;
+  build(taskflow, N);
+  std::ostringstream oss;
+  rigel::TaskflowSnapshot(taskflow).save(oss);
+  auto bytes = oss.str();
+  for(auto _ : state) {
+    std::istringstream iss(bytes);
+    rigel::TaskflowSnapshot snapshot;
+    snapshot.load(iss);
+    benchmark::DoNotOptimize(snapshot.num_tasks());
+  }
+  state.SetItemsProcessed(state.iterations() * N);
+}
+
+static void BM_Restore(benchmark::State& state) {
+  const size_t N = static_cast<size_t>(state.range(0));
+  rigel::Taskflow taskflow;
+  build(taskflow, N);
+  rigel::TaskflowSnapshot snapshot(taskflow);
+  for(auto _ : state) {
+    auto restored = snapshot.restore();
+    restored.bind(0, [](){});
+    benchmark::DoNotOptimize(restored.taskflow().num_tasks());
+  }
+  state.SetItemsProcessed(state.iterations() * N);
+}
+
+static void BM_Dump(benchmark::State& state) {
+  const size_t N = static_cast<size_t>(state.range(0));
+  rigel::Taskflow taskflow;
+  build(taskflow, N);
+  for(auto _ : state) {
+    std::ostringstream oss;
+    taskflow.dump(oss);
+    state.counters["bytes"] = static_cast<double>(oss.tellp());
+  }
+  state.SetItemsProcessed(state.iterations() * N);
+}
+
+BENCHMARK(BM_Build)->Arg(1 << 16)->Arg(1 << 20)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_Save)->Arg(1 << 16)->Arg(1 << 20)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_Load)->Arg(1 << 16)->Arg(1 << 20)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_Restore)->Arg(1 << 16)->Arg(1 << 20)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_Dump)->Arg(1 << 16)->Arg(1 << 20)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,119 @@
+// Copyright 2023 The titan-search Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "benchmark/benchmark.h"
+#include "rigel/taskflow/taskflow.h"
+#include "rigel/taskflow/algorithm/for_each.h"
+
+// Jacobi stencils on 2-D and 3-D grids, iterated either over a flattened
+// 1-D index range or over tiles of a rigel::IndexSpace.
+// The argument of the tiled benchmarks is the tile edge.
+
+static constexpr size_t N2 = 2048;
+static constexpr size_t N3 = 160;
+
+static void BM_Stencil2D_Flat(benchmark::State& state) {
+  std::vector<float> in(N2*N2, 1.0f), out(N2*N2, 0.0f);
+  rigel::Executor executor;
+  rigel::Taskflow taskflow;
+  taskflow.for_each_index(size_t{0}, (N2-2)*(N2-2), size_t{1}, [&](size_t x){
+    size_t i = x / (N2-2) + 1;
+    size_t j = x % (N2-2) + 1;
+    out[i*N2+j] = 0.2f*(in[i*N2+j] + in[(i-1)*N2+j] + in[(i+1)*N2+j] +
+                        in[i*N2+j-1] + in[i*N2+j+1]);
+  });
+  for(auto _ : state) {
+    executor.run(taskflow).wait();
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * (N2-2) * (N2-2));
+}
+
+static void BM_Stencil2D_Tiled(benchmark::State& state, rigel::TileOrder order) {
+  size_t tile = static_cast<size_t>(state.range(0));
+  std::vector<float> in(N2*N2, 1.0f), out(N2*N2, 0.0f);
+  rigel::Executor executor;
+  rigel::Taskflow taskflow;
+  rigel::IndexSpace<2> space({1, 1}, {N2-1, N2-1}, {tile, 4*tile}, order);
+  taskflow.for_each_index(space, [&](const rigel::IndexTile<2>& t){
+    for(size_t i=t.beg[0]; i<t.end[0]; i++) {
+      for(size_t j=t.beg[1]; j<t.end[1]; j++) {
+        out[i*N2+j] = 0.2f*(in[i*N2+j] + in[(i-1)*N2+j] + in[(i+1)*N2+j] +
+                            in[i*N2+j-1] + in[i*N2+j+1]);
+      }
+    }
+  });
+  for(auto _ : state) {
+    executor.run(taskflow).wait();
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * (N2-2) * (N2-2));
+}
+
+static void BM_Stencil3D_Flat(benchmark::State& state) {
+  std::vector<float> in(N3*N3*N3, 1.0f), out(N3*N3*N3, 0.0f);
+  rigel::Executor executor;
+  rigel::Taskflow taskflow;
+  constexpr size_t M = N3-2;
+  taskflow.for_each_index(size_t{0}, M*M*M, size_t{1}, [&](size_t x){
+    size_t i = x / (M*M) + 1;
+    size_t j = (x / M) % M + 1;
+    size_t k = x % M + 1;
+    size_t c = (i*N3 + j)*N3 + k;
+    out[c] = (in[c] + in[c-1] + in[c+1] + in[c-N3] + in[c+N3] +
+              in[c-N3*N3] + in[c+N3*N3]) / 7.0f;
+  });
+  for(auto _ : state) {
+    executor.run(taskflow).wait();
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * M * M * M);
+}
+
+static void BM_Stencil3D_Tiled(benchmark::State& state, rigel::TileOrder order) {
+  size_t tile = static_cast<size_t>(state.range(0));
+  std::vector<float> in(N3*N3*N3, 1.0f), out(N3*N3*N3, 0.0f);
+  rigel::Executor executor;
+  rigel::Taskflow taskflow;
+  constexpr size_t M = N3-2;
+  rigel::IndexSpace<3> space({1, 1, 1}, {N3-1, N3-1, N3-1}, {tile, tile, 4*tile}, order);
+  taskflow.for_each_index(space, [&](const rigel::IndexTile<3>& t){
+    for(size_t i=t.beg[0]; i<t.end[0]; i++) {
+      for(size_t j=t.beg[1]; j<t.end[1]; j++) {
+        for(size_t k=t.beg[2]; k<t.end[2]; k++) {
+          size_t c = (i*N3 + j)*N3 + k;
+          out[c] = (in[c] + in[c-1] + in[c+1] + in[c-N3] + in[c+N3] +
+                    in[c-N3*N3] + in[c+N3*N3]) / 7.0f;
+        }
+      }
+    }
+  });
+  for(auto _ : state) {
+    executor.run(taskflow).wait();
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * M * M * M);
+}
+
+BENCHMARK(BM_Stencil2D_Flat)->UseRealTime();
+BENCHMARK_CAPTURE(BM_Stencil2D_Tiled, row_major, rigel::TileOrder::ROW_MAJOR)
+  ->Arg(16)->Arg(64)->UseRealTime();
+BENCHMARK_CAPTURE(BM_Stencil2D_Tiled, morton, rigel::TileOrder::MORTON)
+  ->Arg(16)->Arg(64)->UseRealTime();
+BENCHMARK(BM_Stencil3D_Flat)->UseRealTime();
+BENCHMARK_CAPTURE(BM_Stencil3D_Tiled, row_major, rigel::TileOrder::ROW_MAJOR)
+  ->Arg(8)->Arg(16)->UseRealTime();
+BENCHMARK_CAPTURE(BM_Stencil3D_Tiled, morton, rigel::TileOrder::MORTON)
+  ->Arg(8)->Arg(16)->UseRealTime();
@@ -0,0 +1,99 @@
+// Copyright 2023 The titan-search Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "benchmark/benchmark.h"
+#include "rigel/taskflow/taskflow.h"
+
+// Cost of delayed tasks. BM_TimerInsertCancel inserts state.range(0)
+// timers with delays from one second to hours into the timer wheel and
+// cancels them all, which should take constant time per timer however many
+// are outstanding. BM_SleepingDelay and BM_TimerDelay both run
+// state.range(1) tasks 2 ms after they are issued: the former with tasks
+// that sleep on a worker, the latter with Executor::silent_async_after.
+
+static void BM_TimerInsertCancel(benchmark::State& state) {
+
+  rigel::Executor executor(1);
+
+  const auto N = state.range(0);
+
+  std::vector<rigel::TimerTask> timers;
+  timers.reserve(N);
+
+  for(auto _ : state) {
+    for(int64_t i=0; i<N; i++) {
+      timers.push_back(executor.silent_async_after(
+        std::chrono::milliseconds(1000 + i * 37), [](){}
+      ));
+    }
+    for(auto& timer : timers) {
+      timer.cancel();
+    }
+    timers.clear();
+  }
+
+  state.SetItemsProcessed(state.iterations() * N);
+}
+
+static void BM_SleepingDelay(benchmark::State& state) {
+
+  rigel::Executor executor(static_cast<size_t>(state.range(0)));
+
+  std::atomic<size_t> counter {0};
+
+  for(auto _ : state) {
+    for(int64_t i=0; i<state.range(1); i++) {
+      executor.silent_async([&](){
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        counter.fetch_add(1, std::memory_order_relaxed);
+      });
+    }
+    executor.wait_for_all();
+  }
+
+  benchmark::DoNotOptimize(counter.load());
+  state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+
+static void BM_TimerDelay(benchmark::State& state) {
+
+  rigel::Executor executor(static_cast<size_t>(state.range(0)));
+
+  std::atomic<size_t> counter {0};
+
+  for(auto _ : state) {
+    for(int64_t i=0; i<state.range(1); i++) {
+      executor.silent_async_after(std::chrono::milliseconds(2), [&](){
+        counter.fetch_add(1, std::memory_order_relaxed);
+      });
+    }
+    executor.wait_for_all();
+  }
+
+  benchmark::DoNotOptimize(counter.load());
+  state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+
+BENCHMARK(BM_TimerInsertCancel)
+  ->Arg(1000)->Arg(100000)->Arg(1000000)
+  ->UseRealTime();
+
+BENCHMARK(BM_SleepingDelay)
+  ->ArgsProduct({{1, 4}, {16, 256}})
+  ->UseRealTime();
+
+BENCHMARK(BM_TimerDelay)
+  ->ArgsProduct({{1, 4}, {16, 256}})
+  ->UseRealTime();
@@ -0,0 +1,68 @@
+// Copyright 2023 The titan-search Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "benchmark/benchmark.h"
+#include "rigel/taskflow/taskflow.h"
+
+// Wakeup latency of parked workers. Each iteration first lets every worker
+// park, then submits work and reports (as manual time) how long it takes
+// until the work starts: BM_WakeOne submits a single task and BM_WakeAll
+// submits a taskflow of as many independent tasks as workers, timed until
+// the last of them starts, which exercises the batched notify_n. On a
+// machine with fewer cores than workers the numbers mostly measure the
+// kernel scheduler.
+
+using clock_type = std::chrono::steady_clock;
+
+static constexpr auto park_time = std::chrono::microseconds(500);
+
+static void BM_WakeOne(benchmark::State& state) {
+
+  rigel::Executor executor(static_cast<size_t>(state.range(0)));
+
+  for(auto _ : state) {
+    std::this_thread::sleep_for(park_time);
+    clock_type::time_point started;
+    auto beg = clock_type::now();
+    executor.silent_async([&](){ started = clock_type::now(); });
+    executor.wait_for_all();
+    state.SetIterationTime(std::chrono::duration<double>(started - beg).count());
+  }
+}
+
+static void BM_WakeAll(benchmark::State& state) {
+
+  const size_t W = static_cast<size_t>(state.range(0));
+
+  rigel::Executor executor(W);
+  rigel::Taskflow taskflow;
+
+  std::vector<clock_type::time_point> started(W);
+
+  for(size_t i=0; i<W; i++) {
+    taskflow.emplace([&, i](){ started[i] = clock_type::now(); });
+  }
+
+  for(auto _ : state) {
+    std::this_thread::sleep_for(park_time);
+    auto beg = clock_type::now();
+    executor.run(taskflow).wait();
+    auto last = *std::max_element(started.begin(), started.end());
+    state.SetIterationTime(std::chrono::duration<double>(last - beg).count());
+  }
+}
+
+BENCHMARK(BM_WakeOne)->Arg(1)->Arg(4)->Arg(16)->UseManualTime()->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_WakeAll)->Arg(1)->Arg(4)->Arg(16)->UseManualTime()->Unit(benchmark::kMicrosecond);
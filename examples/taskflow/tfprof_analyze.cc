@@ -0,0 +1,66 @@
+// Copyright 2023 The titan-search Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This program analyzes a profile recorded with TF_ENABLE_PROFILER=<file>.tfp
+// and prints the per-run critical path, parallelism, idle time and
+// ready-to-start latency of each executor in the profile.
+//
+// usage: example_tfprof_analyze <profile.tfp> [graph.dot] [top-N]
+//
+// The optional graph is the dump of the profiled taskflow
+// (rigel::Taskflow::dump) and supplies the task dependencies.
+
+#include "rigel/taskflow/taskflow.h"
+#include "rigel/taskflow/core/analysis.h"
+
+int main(int argc, char* argv[]) {
+
+  if(argc < 2) {
+    std::cerr << "usage: " << argv[0] << " <profile.tfp> [graph.dot] [top-N]\n";
+    return EXIT_FAILURE;
+  }
+
+  rigel::ProfileData data;
+
+  // map the profile into memory instead of reading it through a stream
+  try {
+    rigel::MappedFile file(argv[1]);
+    auto is = file.stream();
+    data = rigel::load_tfprof(is);
+  }
+  catch(const std::exception& e) {
+    std::cerr << e.what() << '\n';
+    return EXIT_FAILURE;
+  }
+
+  rigel::ProfileGraph graph;
+
+  if(argc > 2) {
+    std::ifstream dot(argv[2]);
+    if(!dot) {
+      std::cerr << "failed to open " << argv[2] << '\n';
+      return EXIT_FAILURE;
+    }
+    graph.load_dot(dot);
+  }
+
+  size_t N = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 10;
+
+  for(const auto& timeline : data.timelines) {
+    rigel::ProfileAnalysis(timeline, graph).dump(std::cout, N);
+    std::cout << '\n';
+  }
+
+  return 0;
+}
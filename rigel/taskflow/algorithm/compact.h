@@ -0,0 +1,604 @@
+// Copyright 2023 The titan-search Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// reference:
+// - Merrill and Garland, Single-pass Parallel Prefix Scan with Decoupled Look-back
+
+#pragma once
+
+#include <memory>
+
+#include "rigel/taskflow/algorithm/launch.h"
+
+namespace rigel {
+
+    namespace detail {
+
+        // Compaction works on tiles of a fixed number of elements. The tile size
+        // is a multiple of 64 such that every word of the selection mask belongs
+        // to exactly one tile and can be written without synchronization.
+        constexpr size_t compact_tile_size = 2048;
+
+        // Each tile publishes its status to the look-back array as
+        // (count << 2) | flag, where the flag tells whether the count is the
+        // local aggregate of the tile or the inclusive prefix up to the tile.
+        constexpr size_t compact_tile_invalid = 0;
+        constexpr size_t compact_tile_aggregate = 1;
+        constexpr size_t compact_tile_prefix = 2;
+
+        // Function: compact_look_back
+        // publishes the number of selected elements of tile t and returns the
+        // number of selected elements in all its preceding tiles
+        inline size_t compact_look_back(
+                std::vector<std::atomic<size_t>> &tiles, size_t t, size_t count
+        ) {
+            if (t == 0) {
+                tiles[0].store((count << 2) | compact_tile_prefix, std::memory_order_release);
+                return 0;
+            }
+
+            tiles[t].store((count << 2) | compact_tile_aggregate, std::memory_order_release);
+
+            size_t prefix = 0;
+
+            for (size_t p = t; p-- > 0;) {
+                size_t s = tiles[p].load(std::memory_order_acquire);
+                // the predecessor has been claimed by a running worker
+                // but has not finished counting yet
+                while ((s & 3) == compact_tile_invalid) {
+                    std::this_thread::yield();
+                    s = tiles[p].load(std::memory_order_acquire);
+                }
+                prefix += (s >> 2);
+                if ((s & 3) == compact_tile_prefix) {
+                    break;
+                }
+            }
+
+            tiles[t].store(((prefix + count) << 2) | compact_tile_prefix, std::memory_order_release);
+
+            return prefix;
+        }
+
+        // Function: compact_mark
+        TF_FORCE_INLINE void compact_mark(std::vector<uint64_t> &mask, size_t x) {
+            mask[x >> 6] |= (uint64_t{1} << (x & 63));
+        }
+
+        // Function: compact_select
+        // marks the elements of tile t that satisfy the predicate and returns
+        // the number of marked elements
+        template<typename I, typename UOP>
+        TF_FORCE_INLINE size_t compact_select(
+                I beg, size_t N, size_t t, std::vector<uint64_t> &mask, UOP &&predicate
+        ) {
+            size_t curr_b = t * compact_tile_size;
+            size_t curr_e = std::min(curr_b + compact_tile_size, N);
+            size_t count = 0;
+
+            std::advance(beg, curr_b);
+
+            for (size_t x = curr_b; x < curr_e; x++, ++beg) {
+                if (predicate(*beg)) {
+                    compact_mark(mask, x);
+                    count++;
+                }
+            }
+            return count;
+        }
+
+        // Function: compact_visit_selected
+        // visits the marked elements of tile t in order, skipping empty words
+        template<typename I, typename F>
+        TF_FORCE_INLINE void compact_visit_selected(
+                I beg, size_t N, size_t t, const std::vector<uint64_t> &mask, F &&visit
+        ) {
+            size_t curr_b = t * compact_tile_size;
+            size_t curr_e = std::min(curr_b + compact_tile_size, N);
+
+            std::advance(beg, curr_b);
+
+            for (size_t x = curr_b; x < curr_e;) {
+                uint64_t bits = mask[x >> 6];
+                size_t word_e = std::min(x + 64, curr_e);
+                if (bits == 0) {
+                    std::advance(beg, word_e - x);
+                    x = word_e;
+                    continue;
+                }
+                for (; x < word_e; x++, ++beg) {
+                    if (bits & (uint64_t{1} << (x & 63))) {
+                        visit(beg);
+                    }
+                }
+            }
+        }
+
+        // Function: compact_visit_all
+        // visits all elements of tile t in order together with their marks
+        template<typename I, typename F>
+        TF_FORCE_INLINE void compact_visit_all(
+                I beg, size_t N, size_t t, const std::vector<uint64_t> &mask, F &&visit
+        ) {
+            size_t curr_b = t * compact_tile_size;
+            size_t curr_e = std::min(curr_b + compact_tile_size, N);
+
+            std::advance(beg, curr_b);
+
+            for (size_t x = curr_b; x < curr_e; x++, ++beg) {
+                visit(beg, (mask[x >> 6] >> (x & 63)) & 1);
+            }
+        }
+
+        // Function: compact_for_each_tile
+        // applies the function to every tile index in [0, T) using the partitioner
+        template<typename P, typename F>
+        TF_FORCE_INLINE void compact_for_each_tile(
+                Runtime &rt, size_t T, size_t W, P &part, F &&func
+        ) {
+            // static partitioner
+            if constexpr (std::is_same_v<std::decay_t<P>, StaticPartitioner>) {
+                size_t chunk_size;
+                for (size_t w = 0, curr_b = 0; w < W && curr_b < T; ++w, curr_b += chunk_size) {
+                    chunk_size = part.adjusted_chunk_size(T, W, w);
+                    launch_loop(W, w, rt, [=, &func, &part]() mutable {
+                        part.loop(T, W, curr_b, chunk_size, [&](size_t curr_b, size_t curr_e) {
+                            for (size_t t = curr_b; t < curr_e; t++) {
+                                func(t);
+                            }
+                        });
+                    });
+                }
+                rt.join();
+            }
+                // dynamic partitioner
+            else {
+                std::atomic<size_t> next(0);
+                launch_loop(T, W, rt, next, part, [=, &func, &next, &part]() mutable {
+                    part.loop(T, W, next, [&](size_t curr_b, size_t curr_e) {
+                        for (size_t t = curr_b; t < curr_e; t++) {
+                            func(t);
+                        }
+                    });
+                });
+            }
+        }
+
+        // Function: compact_loop
+        // counts the selected elements of every tile, computes the exclusive
+        // prefix of each tile, and emits each tile at its prefix;
+        // returns the total number of selected elements
+        template<typename P, typename C, typename M>
+        size_t compact_loop(
+                Runtime &rt, size_t T, size_t W, P &part, C &&count_tile, M &&emit_tile
+        ) {
+            // Static and affinity partitioners do not guarantee that a tile is
+            // claimed only after all its predecessors, so we count and emit in
+            // two rounds. Each worker emits the same tiles it counted, which are
+            // still warm in its cache when the chunks are small enough.
+            if constexpr (std::is_same_v<std::decay_t<P>, StaticPartitioner> ||
+                          std::is_same_v<std::decay_t<P>, AffinityPartitioner>) {
+                std::vector<size_t> offsets(T);
+                compact_for_each_tile(rt, T, W, part, [&](size_t t) {
+                    offsets[t] = count_tile(t);
+                });
+
+                size_t total = 0;
+                for (auto &offset: offsets) {
+                    size_t count = offset;
+                    offset = total;
+                    total += count;
+                }
+
+                compact_for_each_tile(rt, T, W, part, [&](size_t t) {
+                    emit_tile(t, offsets[t]);
+                });
+                return total;
+            }
+                // Dynamic partitioners claim tiles in increasing order, so every
+                // predecessor of a tile is owned by a running worker and we can
+                // resolve the prefix with a single-pass decoupled look-back.
+            else {
+                std::vector<std::atomic<size_t>> tiles(T);
+                compact_for_each_tile(rt, T, W, part, [&](size_t t) {
+                    emit_tile(t, compact_look_back(tiles, t, count_tile(t)));
+                });
+                return tiles[T - 1].load(std::memory_order_relaxed) >> 2;
+            }
+        }
+
+        // Class: compact_buffer
+        // uninitialized storage of N elements that the tiles construct in place,
+        // so the value type needs neither a default constructor nor N of them;
+        // the first size() elements are destroyed with the buffer
+        template<typename V>
+        class compact_buffer {
+
+        public:
+
+            explicit compact_buffer(size_t N) : _data{std::allocator<V>{}.allocate(N)}, _capacity{N} {
+            }
+
+            compact_buffer(const compact_buffer &) = delete;
+
+            compact_buffer &operator=(const compact_buffer &) = delete;
+
+            ~compact_buffer() {
+                for (size_t i = 0; i < _size; ++i) {
+                    _data[i].~V();
+                }
+                std::allocator<V>{}.deallocate(_data, _capacity);
+            }
+
+            template<typename T>
+            void construct(size_t i, T &&value) {
+                ::new(static_cast<void *>(_data + i)) V(std::forward<T>(value));
+            }
+
+            // marks the first n elements as constructed
+            void resize(size_t n) {
+                _size = n;
+            }
+
+            size_t size() const {
+                return _size;
+            }
+
+            V &operator[](size_t i) {
+                return _data[i];
+            }
+
+        private:
+
+            V *_data;
+            size_t _capacity;
+            size_t _size{0};
+        };
+
+        // Function: compact_move_back
+        // moves the first M elements of the buffer back to the range
+        template<typename I, typename V, typename P>
+        TF_FORCE_INLINE void compact_move_back(
+                Runtime &rt, size_t W, P &part, I beg, compact_buffer<V> &buf, size_t M
+        ) {
+            size_t T = (M + compact_tile_size - 1) / compact_tile_size;
+            if (T == 0) {
+                return;
+            }
+            compact_for_each_tile(rt, T, std::min(W, T), part, [&](size_t t) {
+                size_t curr_b = t * compact_tile_size;
+                size_t curr_e = std::min(curr_b + compact_tile_size, M);
+                auto itr = std::next(beg, curr_b);
+                for (size_t x = curr_b; x < curr_e; x++) {
+                    *itr++ = std::move(buf[x]);
+                }
+            });
+        }
+
+        // Function: make_copy_if_task
+        template<typename B, typename E, typename O, typename T, typename UOP, typename P>
+        TF_FORCE_INLINE auto make_copy_if_task(
+                B first, E last, O d_first, T &result, UOP predicate, P &&part
+        ) {
+
+            using B_t = std::decay_t<unwrap_ref_decay_t<B>>;
+            using E_t = std::decay_t<unwrap_ref_decay_t<E>>;
+            using O_t = std::decay_t<unwrap_ref_decay_t<O>>;
+
+            return
+                    [first, last, d_first, &result, predicate, part = std::forward<P>(part)]
+                            (Runtime &rt) mutable {
+
+                        // fetch the stateful values
+                        B_t beg = first;
+                        E_t end = last;
+                        O_t d_beg = d_first;
+
+                        size_t W = rt.executor().num_workers();
+                        size_t N = std::distance(beg, end);
+
+                        // only myself - no need to spawn another graph
+                        if (W <= 1 || N <= compact_tile_size) {
+                            result = std::copy_if(beg, end, d_beg, predicate);
+                            return;
+                        }
+
+                        size_t num_tiles = (N + compact_tile_size - 1) / compact_tile_size;
+
+                        if (num_tiles < W) {
+                            W = num_tiles;
+                        }
+
+                        std::vector<uint64_t> mask((N + 63) >> 6);
+
+                        size_t M = compact_loop(rt, num_tiles, W, part,
+                                [&](size_t t) {
+                                    return compact_select(beg, N, t, mask, predicate);
+                                },
+                                [&](size_t t, size_t offset) {
+                                    auto d_itr = std::next(d_beg, offset);
+                                    compact_visit_selected(beg, N, t, mask, [&](auto itr) {
+                                        *d_itr++ = *itr;
+                                    });
+                                }
+                        );
+
+                        result = std::next(d_beg, M);
+                    };
+        }
+
+        // Function: make_remove_if_task
+        template<typename B, typename E, typename T, typename UOP, typename P>
+        TF_FORCE_INLINE auto make_remove_if_task(
+                B first, E last, T &result, UOP predicate, P &&part
+        ) {
+
+            using B_t = std::decay_t<unwrap_ref_decay_t<B>>;
+            using E_t = std::decay_t<unwrap_ref_decay_t<E>>;
+            using value_type = typename std::iterator_traits<B_t>::value_type;
+
+            return
+                    [first, last, &result, predicate, part = std::forward<P>(part)]
+                            (Runtime &rt) mutable {
+
+                        // fetch the stateful values
+                        B_t beg = first;
+                        E_t end = last;
+
+                        size_t W = rt.executor().num_workers();
+                        size_t N = std::distance(beg, end);
+
+                        // only myself - no need to spawn another graph
+                        if (W <= 1 || N <= compact_tile_size) {
+                            result = std::remove_if(beg, end, predicate);
+                            return;
+                        }
+
+                        size_t num_tiles = (N + compact_tile_size - 1) / compact_tile_size;
+
+                        if (num_tiles < W) {
+                            W = num_tiles;
+                        }
+
+                        // Kept elements are compacted into a buffer first since the
+                        // destination of a tile can overlap the source of another tile.
+                        std::vector<uint64_t> mask((N + 63) >> 6);
+                        compact_buffer<value_type> buf(N);
+
+                        size_t M = compact_loop(rt, num_tiles, W, part,
+                                [&](size_t t) {
+                                    return compact_select(beg, N, t, mask, [&](const auto &v) {
+                                        return !predicate(v);
+                                    });
+                                },
+                                [&](size_t t, size_t offset) {
+                                    compact_visit_selected(beg, N, t, mask, [&](auto itr) {
+                                        buf.construct(offset++, std::move(*itr));
+                                    });
+                                }
+                        );
+
+                        buf.resize(M);
+
+                        compact_move_back(rt, W, part, beg, buf, M);
+
+                        result = std::next(beg, M);
+                    };
+        }
+
+        // Function: make_stable_partition_task
+        template<typename B, typename E, typename T, typename UOP, typename P>
+        TF_FORCE_INLINE auto make_stable_partition_task(
+                B first, E last, T &result, UOP predicate, P &&part
+        ) {
+
+            using B_t = std::decay_t<unwrap_ref_decay_t<B>>;
+            using E_t = std::decay_t<unwrap_ref_decay_t<E>>;
+            using value_type = typename std::iterator_traits<B_t>::value_type;
+
+            return
+                    [first, last, &result, predicate, part = std::forward<P>(part)]
+                            (Runtime &rt) mutable {
+
+                        // fetch the stateful values
+                        B_t beg = first;
+                        E_t end = last;
+
+                        size_t W = rt.executor().num_workers();
+                        size_t N = std::distance(beg, end);
+
+                        // only myself - no need to spawn another graph
+                        if (W <= 1 || N <= compact_tile_size) {
+                            result = std::stable_partition(beg, end, predicate);
+                            return;
+                        }
+
+                        size_t num_tiles = (N + compact_tile_size - 1) / compact_tile_size;
+
+                        if (num_tiles < W) {
+                            W = num_tiles;
+                        }
+
+                        std::vector<uint64_t> mask((N + 63) >> 6);
+                        compact_buffer<value_type> buf(N);
+
+                        // The number of rejected elements before a tile is the tile
+                        // offset minus the number of selected ones, so a single prefix
+                        // places both groups: selected elements fill the buffer from
+                        // the front and rejected ones from the back in reverse order.
+                        size_t M = compact_loop(rt, num_tiles, W, part,
+                                [&](size_t t) {
+                                    return compact_select(beg, N, t, mask, predicate);
+                                },
+                                [&](size_t t, size_t offset) {
+                                    size_t r = N - (t * compact_tile_size - offset);
+                                    compact_visit_all(beg, N, t, mask, [&](auto itr, bool selected) {
+                                        if (selected) {
+                                            buf.construct(offset++, std::move(*itr));
+                                        } else {
+                                            buf.construct(--r, std::move(*itr));
+                                        }
+                                    });
+                                }
+                        );
+
+                        buf.resize(N);
+
+                        // move back and restore the order of the rejected elements
+                        compact_for_each_tile(rt, num_tiles, W, part, [&](size_t t) {
+                            size_t curr_b = t * compact_tile_size;
+                            size_t curr_e = std::min(curr_b + compact_tile_size, N);
+                            auto itr = std::next(beg, curr_b);
+                            for (size_t x = curr_b; x < curr_e; x++) {
+                                *itr++ = std::move(x < M ? buf[x] : buf[N - 1 - (x - M)]);
+                            }
+                        });
+
+                        result = std::next(beg, M);
+                    };
+        }
+
+        // Function: make_unique_task
+        template<typename B, typename E, typename T, typename C, typename P>
+        TF_FORCE_INLINE auto make_unique_task(
+                B first, E last, T &result, C comp, P &&part
+        ) {
+
+            using B_t = std::decay_t<unwrap_ref_decay_t<B>>;
+            using E_t = std::decay_t<unwrap_ref_decay_t<E>>;
+            using value_type = typename std::iterator_traits<B_t>::value_type;
+
+            return
+                    [first, last, &result, comp, part = std::forward<P>(part)]
+                            (Runtime &rt) mutable {
+
+                        // fetch the stateful values
+                        B_t beg = first;
+                        E_t end = last;
+
+                        size_t W = rt.executor().num_workers();
+                        size_t N = std::distance(beg, end);
+
+                        // only myself - no need to spawn another graph
+                        if (W <= 1 || N <= compact_tile_size) {
+                            result = std::unique(beg, end, comp);
+                            return;
+                        }
+
+                        size_t num_tiles = (N + compact_tile_size - 1) / compact_tile_size;
+
+                        if (num_tiles < W) {
+                            W = num_tiles;
+                        }
+
+                        std::vector<uint64_t> mask((N + 63) >> 6);
+                        compact_buffer<value_type> buf(N);
+
+                        // Elements are copied rather than moved into the buffer because
+                        // the first element of a tile is compared against the last
+                        // element of its preceding tile, which may be emitted already.
+                        size_t M = compact_loop(rt, num_tiles, W, part,
+                                [&](size_t t) {
+                                    size_t curr_b = t * compact_tile_size;
+                                    size_t curr_e = std::min(curr_b + compact_tile_size, N);
+                                    size_t count = 0;
+                                    auto curr = std::next(beg, curr_b ? curr_b - 1 : 0);
+                                    if (curr_b == 0) {
+                                        compact_mark(mask, 0);
+                                        count++;
+                                        curr_b++;
+                                    }
+                                    for (size_t x = curr_b; x < curr_e; x++) {
+                                        auto prev = curr++;
+                                        if (!comp(*prev, *curr)) {
+                                            compact_mark(mask, x);
+                                            count++;
+                                        }
+                                    }
+                                    return count;
+                                },
+                                [&](size_t t, size_t offset) {
+                                    compact_visit_selected(beg, N, t, mask, [&](auto itr) {
+                                        buf.construct(offset++, *itr);
+                                    });
+                                }
+                        );
+
+                        buf.resize(M);
+
+                        compact_move_back(rt, W, part, beg, buf, M);
+
+                        result = std::next(beg, M);
+                    };
+        }
+
+    }  // end of namespace detail -------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// copy_if
+// ----------------------------------------------------------------------------
+
+// Function: copy_if
+    template<typename B, typename E, typename O, typename T, typename UOP, typename P>
+    Task FlowBuilder::copy_if(B first, E last, O d_first, T &result, UOP predicate, P &&part) {
+        return emplace(detail::make_copy_if_task(
+                first, last, d_first, result, predicate, std::forward<P>(part)
+        ));
+    }
+
+// ----------------------------------------------------------------------------
+// remove_if
+// ----------------------------------------------------------------------------
+
+// Function: remove_if
+    template<typename B, typename E, typename T, typename UOP, typename P>
+    Task FlowBuilder::remove_if(B first, E last, T &result, UOP predicate, P &&part) {
+        return emplace(detail::make_remove_if_task(
+                first, last, result, predicate, std::forward<P>(part)
+        ));
+    }
+
+// ----------------------------------------------------------------------------
+// partition
+// ----------------------------------------------------------------------------
+
+// Function: partition
+    template<typename B, typename E, typename T, typename UOP, typename P>
+    Task FlowBuilder::partition(B first, E last, T &result, UOP predicate, P &&part) {
+        return emplace(detail::make_stable_partition_task(
+                first, last, result, predicate, std::forward<P>(part)
+        ));
+    }
+
+// Function: stable_partition
+    template<typename B, typename E, typename T, typename UOP, typename P>
+    Task FlowBuilder::stable_partition(B first, E last, T &result, UOP predicate, P &&part) {
+        return emplace(detail::make_stable_partition_task(
+                first, last, result, predicate, std::forward<P>(part)
+        ));
+    }
+
+// ----------------------------------------------------------------------------
+// unique
+// ----------------------------------------------------------------------------
+
+// Function: unique
+    template<typename B, typename E, typename T, typename C, typename P>
+    Task FlowBuilder::unique(B first, E last, T &result, C comp, P &&part) {
+        return emplace(detail::make_unique_task(
+                first, last, result, comp, std::forward<P>(part)
+        ));
+    }
+
+}  // end of namespace rigel -----------------------------------------------------
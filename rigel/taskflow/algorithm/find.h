@@ -39,6 +39,7 @@ TF_FORCE_INLINE bool find_if_loop(
   for(size_t x = curr_b; x<curr_e; x++) {
     if(predicate(*beg++)) {
       atomic_min(offset, x);
+      prev_e = x + 1;
       return true;
     }
   }
@@ -65,6 +66,7 @@ TF_FORCE_INLINE bool find_if_not_loop(
   for(size_t x = curr_b; x<curr_e; x++) {
     if(!predicate(*beg++)) {
       atomic_min(offset, x);
+      prev_e = x + 1;
       return true;
     }
   }
@@ -323,6 +325,23 @@ TF_FORCE_INLINE auto make_min_element_task(
       }
       rt.join();
     }
+    // affinity partitioner
+    else if constexpr(std::is_same_v<std::decay_t<P>, AffinityPartitioner>) {
+      // chunks are not claimed in order, so each chunk is searched on its own
+      std::atomic<size_t> next(0);
+      launch_loop(N, W, rt, next, part,
+        [beg, N, W, &next, &comp, &mutex, &result, &part] () mutable {
+          part.loop(N, W, next, [&](size_t curr_b, size_t curr_e) {
+            auto first = std::next(beg, curr_b);
+            T smallest = std::min_element(first, std::next(first, curr_e - curr_b), comp);
+            std::lock_guard<std::mutex> lock(mutex);
+            if(comp(*smallest, *result)) {
+              result = smallest;
+            }
+          });
+        }
+      );
+    }
     // dynamic partitioner
     else {
       std::atomic<size_t> next(0);
@@ -466,6 +485,23 @@ TF_FORCE_INLINE auto make_max_element_task(B first, E last, T& result, C comp, P
       }
       rt.join();
     }
+    // affinity partitioner
+    else if constexpr(std::is_same_v<std::decay_t<P>, AffinityPartitioner>) {
+      // chunks are not claimed in order, so each chunk is searched on its own
+      std::atomic<size_t> next(0);
+      launch_loop(N, W, rt, next, part,
+        [beg, N, W, &next, &comp, &mutex, &result, &part] () mutable {
+          part.loop(N, W, next, [&](size_t curr_b, size_t curr_e) {
+            auto first = std::next(beg, curr_b);
+            T largest = std::max_element(first, std::next(first, curr_e - curr_b), comp);
+            std::lock_guard<std::mutex> lock(mutex);
+            if(comp(*result, *largest)) {
+              result = largest;
+            }
+          });
+        }
+      );
+    }
     // dynamic partitioner
     else {
       std::atomic<size_t> next(0);
@@ -16,6 +16,7 @@
 #pragma once
 
 #include "rigel/taskflow/algorithm/launch.h"
+#include "rigel/taskflow/algorithm/index_space.h"
 
 namespace rigel {
 
@@ -157,6 +158,75 @@ TF_FORCE_INLINE auto make_for_each_index_task(B beg, E end, S inc, C c, P&& part
   };
 }
 
+// Function: make_for_each_index_task
+template <typename R, typename C, typename P>
+TF_FORCE_INLINE auto make_for_each_index_task(R range, C c, P&& part){
+
+  using R_t = std::decay_t<unwrap_ref_decay_t<R>>;
+
+  return [r=range, c, part=std::forward<P>(part)] (Runtime& rt) mutable {
+
+    // fetch the index space
+    const R_t& space = r;
+
+    size_t W = rt.executor().num_workers();
+    size_t N = space.num_tiles();
+
+    // row-major ids of tiles in the scheduling order (empty if row-major)
+    std::vector<size_t> order = make_tile_order(space);
+
+    auto tile = [&](size_t t) {
+      return space.tile(order.empty() ? t : order[t]);
+    };
+
+    // only myself - no need to spawn another graph
+    if(W <= 1 || N <= part.chunk_size()) {
+      for(size_t t=0; t<N; t++) {
+        c(tile(t));
+      }
+      return;
+    }
+
+    if(N < W) {
+      W = N;
+    }
+
+    // static partitioner
+    if constexpr(std::is_same_v<std::decay_t<P>, StaticPartitioner>) {
+
+      size_t chunk_size;
+
+      for(size_t w=0, curr_b=0; w<W && curr_b < N; ++w, curr_b += chunk_size) {
+        chunk_size = part.adjusted_chunk_size(N, W, w);
+        launch_loop(W, w, rt, [=, &c, &tile, &part] () mutable {
+          part.loop(N, W, curr_b, chunk_size,
+            [&](size_t curr_b, size_t curr_e) {
+              for(size_t t=curr_b; t<curr_e; t++) {
+                c(tile(t));
+              }
+            }
+          );
+        });
+      }
+
+      rt.join();
+    }
+    // dynamic partitioner
+    else {
+      std::atomic<size_t> next(0);
+      launch_loop(N, W, rt, next, part, [=, &c, &tile, &next, &part] () mutable {
+        part.loop(N, W, next,
+          [&](size_t curr_b, size_t curr_e) {
+            for(size_t t=curr_b; t<curr_e; t++) {
+              c(tile(t));
+            }
+          }
+        );
+      });
+    }
+  };
+}
+
 }  // end of namespace detail -------------------------------------------------
 
 // ----------------------------------------------------------------------------
@@ -183,6 +253,16 @@ Task FlowBuilder::for_each_index(B beg, E end, S inc, C c, P&& part){
   );
 }
 
+// Function: for_each_index
+template <typename R, typename C, typename P,
+  std::enable_if_t<is_index_space_v<std::decay_t<unwrap_ref_decay_t<R>>>, void>*
+>
+Task FlowBuilder::for_each_index(R range, C c, P&& part){
+  return emplace(
+    detail::make_for_each_index_task(range, c, std::forward<P>(part))
+  );
+}
+
 
 }  // end of namespace rigel -----------------------------------------------------
 
@@ -0,0 +1,261 @@
+// Copyright 2023 The titan-search Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#pragma once
+
+#include "rigel/taskflow/algorithm/launch.h"
+
+namespace rigel {
+
+    namespace detail {
+
+        // number of bins below which the private bins are merged by a single worker
+        inline constexpr size_t histogram_merge_grain = 4096;
+
+        // Function: histogram_locals
+        // runs the partitioner over the N elements starting at beg; each loop
+        // task creates its private bins by make_local when it claims its first
+        // chunk and adds every element of its chunks by visit;
+        // returns the private bins of all loop tasks that claimed a chunk
+        template<typename L, typename B, typename P, typename M, typename F>
+        std::vector<L> histogram_locals(
+                Runtime &rt, B beg, size_t N, size_t W, P &part, M &&make_local, F &&visit
+        ) {
+            std::vector<L> locals(std::max(W, rt.executor().num_workers()));
+            std::atomic<size_t> num_locals(0);
+
+            auto claim = [&]() -> L & {
+                auto &local = locals[num_locals.fetch_add(1, std::memory_order_relaxed)];
+                local = make_local();
+                return local;
+            };
+
+            // static partitioner
+            if constexpr (std::is_same_v<std::decay_t<P>, StaticPartitioner>) {
+                size_t chunk_size;
+                for (size_t w = 0, curr_b = 0; w < W && curr_b < N; ++w, curr_b += chunk_size) {
+                    chunk_size = part.adjusted_chunk_size(N, W, w);
+                    launch_loop(W, w, rt, [=, &claim, &visit, &part]() mutable {
+                        L &local = claim();
+                        part.loop(N, W, curr_b, chunk_size,
+                                  [&, prev_e = size_t{0}](size_t curr_b, size_t curr_e) mutable {
+                                      std::advance(beg, curr_b - prev_e);
+                                      for (size_t x = curr_b; x < curr_e; x++) {
+                                          visit(local, *beg++);
+                                      }
+                                      prev_e = curr_e;
+                                  }
+                        );
+                    });
+                }
+                rt.join();
+            }
+                // dynamic partitioner
+            else {
+                std::atomic<size_t> next(0);
+                launch_loop(N, W, rt, next, part, [=, &claim, &visit, &next, &part]() mutable {
+                    L *local = nullptr;
+                    part.loop(N, W, next,
+                              [&, prev_e = size_t{0}](size_t curr_b, size_t curr_e) mutable {
+                                  if (local == nullptr) {
+                                      local = &claim();
+                                  }
+                                  std::advance(beg, curr_b - prev_e);
+                                  for (size_t x = curr_b; x < curr_e; x++) {
+                                      visit(*local, *beg++);
+                                  }
+                                  prev_e = curr_e;
+                              }
+                    );
+                });
+            }
+
+            locals.resize(num_locals.load(std::memory_order_relaxed));
+
+            return locals;
+        }
+
+        // Function: histogram_merge
+        // applies merge_bin to every bin in [0, num_bins), splitting the bins
+        // into contiguous blocks over the workers when there are enough of them
+        template<typename F>
+        void histogram_merge(Runtime &rt, size_t num_bins, size_t W, F &&merge_bin) {
+
+            W = std::min(W, (num_bins + histogram_merge_grain - 1) / histogram_merge_grain);
+
+            if (W <= 1) {
+                for (size_t k = 0; k < num_bins; k++) {
+                    merge_bin(k);
+                }
+                return;
+            }
+
+            size_t block = (num_bins + W - 1) / W;
+
+            for (size_t w = 0, curr_b = 0; w < W && curr_b < num_bins; ++w, curr_b += block) {
+                launch_loop(W, w, rt, [=, &merge_bin]() {
+                    for (size_t k = curr_b, curr_e = std::min(curr_b + block, num_bins); k < curr_e; k++) {
+                        merge_bin(k);
+                    }
+                });
+            }
+
+            rt.join();
+        }
+
+        // Function: make_histogram_task
+        template<typename B, typename E, typename O, typename K, typename P>
+        TF_FORCE_INLINE auto make_histogram_task(
+                B first, E last, O bins, size_t num_bins, K key, P &&part
+        ) {
+
+            using B_t = std::decay_t<unwrap_ref_decay_t<B>>;
+            using E_t = std::decay_t<unwrap_ref_decay_t<E>>;
+            using O_t = std::decay_t<unwrap_ref_decay_t<O>>;
+
+            return
+                    [first, last, bins, num_bins, key, part = std::forward<P>(part)]
+                            (Runtime &rt) mutable {
+
+                        // fetch the iterator values
+                        B_t beg = first;
+                        E_t end = last;
+                        O_t out = bins;
+
+                        size_t W = rt.executor().num_workers();
+                        size_t N = std::distance(beg, end);
+
+                        // only myself - no need to spawn another graph
+                        if (W <= 1 || N <= part.chunk_size()) {
+                            for (; beg != end; ++beg) {
+                                if (size_t k = key(*beg); k < num_bins) {
+                                    ++out[k];
+                                }
+                            }
+                            return;
+                        }
+
+                        if (N < W) {
+                            W = N;
+                        }
+
+                        auto locals = histogram_locals<std::vector<size_t>>(
+                                rt, beg, N, W, part,
+                                [num_bins]() { return std::vector<size_t>(num_bins, 0); },
+                                [&key, num_bins](std::vector<size_t> &local, auto &&item) {
+                                    if (size_t k = key(item); k < num_bins) {
+                                        ++local[k];
+                                    }
+                                }
+                        );
+
+                        histogram_merge(rt, num_bins, W, [&](size_t k) {
+                            for (auto &local: locals) {
+                                out[k] += local[k];
+                            }
+                        });
+                    };
+        }
+
+        // Function: make_histogram_reduce_task
+        template<typename B, typename E, typename O, typename K, typename V, typename BOP, typename P>
+        TF_FORCE_INLINE auto make_histogram_reduce_task(
+                B first, E last, O bins, size_t num_bins, K key, V value, BOP bop, P &&part
+        ) {
+
+            using B_t = std::decay_t<unwrap_ref_decay_t<B>>;
+            using E_t = std::decay_t<unwrap_ref_decay_t<E>>;
+            using O_t = std::decay_t<unwrap_ref_decay_t<O>>;
+            using T = typename std::iterator_traits<O_t>::value_type;
+
+            return
+                    [first, last, bins, num_bins, key, value, bop, part = std::forward<P>(part)]
+                            (Runtime &rt) mutable {
+
+                        // fetch the iterator values
+                        B_t beg = first;
+                        E_t end = last;
+                        O_t out = bins;
+
+                        size_t W = rt.executor().num_workers();
+                        size_t N = std::distance(beg, end);
+
+                        // only myself - no need to spawn another graph
+                        if (W <= 1 || N <= part.chunk_size()) {
+                            for (; beg != end; ++beg) {
+                                if (size_t k = key(*beg); k < num_bins) {
+                                    out[k] = bop(out[k], value(*beg));
+                                }
+                            }
+                            return;
+                        }
+
+                        if (N < W) {
+                            W = N;
+                        }
+
+                        // a private bin holds no value until an element falls into it,
+                        // so no identity of the reduction is needed
+                        using L = std::vector<std::optional<T>>;
+
+                        auto locals = histogram_locals<L>(
+                                rt, beg, N, W, part,
+                                [num_bins]() { return L(num_bins); },
+                                [&key, &value, &bop, num_bins](L &local, auto &&item) {
+                                    if (size_t k = key(item); k < num_bins) {
+                                        if (local[k]) {
+                                            *local[k] = bop(*local[k], value(item));
+                                        } else {
+                                            local[k] = value(item);
+                                        }
+                                    }
+                                }
+                        );
+
+                        histogram_merge(rt, num_bins, W, [&](size_t k) {
+                            for (auto &local: locals) {
+                                if (local[k]) {
+                                    out[k] = bop(out[k], *local[k]);
+                                }
+                            }
+                        });
+                    };
+        }
+
+    }  // end of namespace detail -------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// histogram
+// ----------------------------------------------------------------------------
+
+// Function: histogram
+    template<typename B, typename E, typename O, typename K, typename P>
+    Task FlowBuilder::histogram(B first, E last, O bins, size_t num_bins, K key, P &&part) {
+        return emplace(detail::make_histogram_task(
+                first, last, bins, num_bins, key, std::forward<P>(part)
+        ));
+    }
+
+// Function: histogram_reduce
+    template<typename B, typename E, typename O, typename K, typename V, typename BOP, typename P>
+    Task FlowBuilder::histogram_reduce(
+            B first, E last, O bins, size_t num_bins, K key, V value, BOP bop, P &&part
+    ) {
+        return emplace(detail::make_histogram_reduce_task(
+                first, last, bins, num_bins, key, value, bop, std::forward<P>(part)
+        ));
+    }
+
+}  // end of namespace rigel -----------------------------------------------------
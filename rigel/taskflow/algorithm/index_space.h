@@ -0,0 +1,293 @@
+// Copyright 2023 The titan-search Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#pragma once
+
+#include <array>
+#include <vector>
+#include <numeric>
+#include <algorithm>
+#include <cstdint>
+
+/**
+@file index_space.h
+@brief multi-dimensional index space include file
+*/
+
+namespace rigel {
+
+    // ----------------------------------------------------------------------------
+    // Tile Order
+    // ----------------------------------------------------------------------------
+
+    /**
+    @enum TileOrder
+
+    @brief enumeration of the orders in which the tiles of an index space are scheduled
+
+    Partitioners hand out consecutive tiles in this order, so a worker that
+    claims a chunk of tiles gets tiles that are close to each other.
+    */
+    enum class TileOrder : int {
+        /** @brief tiles are ordered row by row with the last dimension varying fastest */
+        ROW_MAJOR = 0,
+        /** @brief tiles are ordered along the Z-order (Morton) curve */
+        MORTON
+    };
+
+    // ----------------------------------------------------------------------------
+    // Index Tile
+    // ----------------------------------------------------------------------------
+
+    /**
+    @struct IndexTile
+
+    @brief struct to describe the bounds of a tile in a D-dimensional index space
+
+    The tile covers the indices <tt>[beg[d], end[d])</tt> in each dimension @c d.
+    */
+    template<size_t D>
+    struct IndexTile {
+
+        /**
+        @brief beginning index of each dimension (inclusive)
+        */
+        std::array<size_t, D> beg;
+
+        /**
+        @brief ending index of each dimension (exclusive)
+        */
+        std::array<size_t, D> end;
+    };
+
+    // ----------------------------------------------------------------------------
+    // Index Space
+    // ----------------------------------------------------------------------------
+
+    /**
+    @class IndexSpace
+
+    @brief class to describe a tiled D-dimensional index space
+
+    An index space is the box <tt>[beg[0], end[0]) x ... x [beg[D-1], end[D-1])</tt>
+    split into tiles of the given size.
+    Tiles at the upper boundary of a dimension may be smaller than the tile size.
+    Dimension @c 0 is the outermost one and dimension <tt>D-1</tt> the innermost one,
+    i.e., the one that is contiguous in a row-major array.
+
+    @code{.cpp}
+    // 1024x768 image split into 64x64 tiles scheduled in Morton order
+    rigel::IndexSpace<2> space({0, 0}, {1024, 768}, {64, 64}, rigel::TileOrder::MORTON);
+    @endcode
+
+    A tile size of zero is treated as one.
+    */
+    template<size_t D>
+    class IndexSpace {
+
+        static_assert(D == 2 || D == 3, "index space must be 2-D or 3-D");
+
+    public:
+
+        /**
+        @brief constructs an index space
+
+        @param beg beginning index of each dimension (inclusive)
+        @param end ending index of each dimension (exclusive)
+        @param tile tile size of each dimension
+        @param order order in which tiles are scheduled
+        */
+        IndexSpace(
+                const std::array<size_t, D> &beg,
+                const std::array<size_t, D> &end,
+                const std::array<size_t, D> &tile,
+                TileOrder order = TileOrder::MORTON
+        ) : _beg{beg}, _end{end}, _tile{tile}, _order{order} {
+            for (size_t d = 0; d < D; d++) {
+                _tile[d] = std::max(_tile[d], size_t{1});
+            }
+        }
+
+        /**
+        @brief queries the beginning index of each dimension
+        */
+        const std::array<size_t, D> &begin() const { return _beg; }
+
+        /**
+        @brief queries the ending index of each dimension
+        */
+        const std::array<size_t, D> &end() const { return _end; }
+
+        /**
+        @brief queries the tile size of each dimension
+        */
+        const std::array<size_t, D> &tile_size() const { return _tile; }
+
+        /**
+        @brief queries the order in which tiles are scheduled
+        */
+        TileOrder order() const { return _order; }
+
+        /**
+        @brief queries the number of indices in the given dimension
+        */
+        size_t size(size_t d) const {
+            return _end[d] > _beg[d] ? _end[d] - _beg[d] : 0;
+        }
+
+        /**
+        @brief queries the number of indices in the index space
+        */
+        size_t size() const {
+            size_t n = 1;
+            for (size_t d = 0; d < D; d++) {
+                n *= size(d);
+            }
+            return n;
+        }
+
+        /**
+        @brief queries the number of tiles in the given dimension
+        */
+        size_t num_tiles(size_t d) const {
+            return (size(d) + _tile[d] - 1) / _tile[d];
+        }
+
+        /**
+        @brief queries the number of tiles in the index space
+        */
+        size_t num_tiles() const {
+            size_t n = 1;
+            for (size_t d = 0; d < D; d++) {
+                n *= num_tiles(d);
+            }
+            return n;
+        }
+
+        /**
+        @brief queries the bounds of the tile with the given row-major tile id
+        */
+        IndexTile<D> tile(size_t id) const {
+            IndexTile<D> t;
+            for (size_t d = D; d-- > 0;) {
+                size_t n = num_tiles(d);
+                size_t c = id % n;
+                id /= n;
+                t.beg[d] = _beg[d] + c * _tile[d];
+                t.end[d] = std::min(t.beg[d] + _tile[d], _end[d]);
+            }
+            return t;
+        }
+
+    private:
+
+        std::array<size_t, D> _beg;
+        std::array<size_t, D> _end;
+        std::array<size_t, D> _tile;
+
+        TileOrder _order;
+    };
+
+    /**
+    @brief alias of a 2-D index space
+    */
+    using IndexSpace2D = IndexSpace<2>;
+
+    /**
+    @brief alias of a 3-D index space
+    */
+    using IndexSpace3D = IndexSpace<3>;
+
+    // ----------------------------------------------------------------------------
+    // is_index_space_v
+    // ----------------------------------------------------------------------------
+
+    /**
+    @private
+    */
+    template<typename T>
+    struct is_index_space : std::false_type {
+    };
+
+    /**
+    @private
+    */
+    template<size_t D>
+    struct is_index_space<IndexSpace<D>> : std::true_type {
+    };
+
+    /**
+    @brief determines if a type is a rigel::IndexSpace
+
+    An index space is an instantiation of the class template rigel::IndexSpace.
+    */
+    template<typename T>
+    inline constexpr bool is_index_space_v = is_index_space<T>::value;
+
+    namespace detail {
+
+        // Function: morton_code
+        // interleaves the bits of the tile coordinates with the innermost
+        // dimension at the lowest bit
+        template<size_t D>
+        uint64_t morton_code(const std::array<size_t, D> &coord) {
+            uint64_t code = 0;
+            for (size_t b = 0; b < 64 / D; b++) {
+                for (size_t d = 0; d < D; d++) {
+                    code |= static_cast<uint64_t>((coord[d] >> b) & 1) << (b * D + (D - 1 - d));
+                }
+            }
+            return code;
+        }
+
+        // Function: make_tile_order
+        // returns the row-major ids of the tiles in the scheduling order of the
+        // index space, or an empty vector if the order is row-major itself
+        template<size_t D>
+        std::vector<size_t> make_tile_order(const IndexSpace<D> &space) {
+
+            std::vector<size_t> order;
+
+            if (space.order() == TileOrder::ROW_MAJOR) {
+                return order;
+            }
+
+            size_t N = space.num_tiles();
+
+            std::vector<uint64_t> codes(N);
+            std::array<size_t, D> coord{};
+
+            for (size_t id = 0; id < N; id++) {
+                codes[id] = morton_code<D>(coord);
+                // advance the row-major tile coordinate
+                for (size_t d = D; d-- > 0;) {
+                    if (++coord[d] < space.num_tiles(d)) {
+                        break;
+                    }
+                    coord[d] = 0;
+                }
+            }
+
+            order.resize(N);
+            std::iota(order.begin(), order.end(), size_t{0});
+            std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+                return codes[a] < codes[b];
+            });
+
+            return order;
+        }
+
+    }  // end of namespace detail -------------------------------------------------
+
+}  // end of namespace rigel -----------------------------------------------------
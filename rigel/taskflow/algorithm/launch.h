@@ -32,24 +32,63 @@ namespace rigel {
 
         //static_assert(std::is_lvalue_reference_v<Loop>, "");
 
-        using namespace std::string_literals;
-
-        for (size_t w = 0; w < W; w++) {
-            auto r = N - next.load(std::memory_order_relaxed);
-            // no more loop work to do - finished by previous async tasks
-            if (!r) {
-                break;
-            }
-            // tail optimization
-            if (r <= part.chunk_size() || w == W - 1) {
+        // affinity partitioner - offer chunks to the workers that ran them last time
+        if constexpr (std::is_same_v<std::decay_t<P>, AffinityPartitioner>) {
+            auto &executor = rt.executor();
+            auto me = static_cast<size_t>(executor.this_worker_id());
+            // the executor may be resized meanwhile - plan and offer the
+            // chunks for the same number of workers
+            auto num_workers = executor.num_workers();
+            auto run = part.begin_loop(N, W, num_workers, [&executor]() {
+                return executor.this_worker_id();
+            });
+            // each loop task finds the run of this launch, not that of
+            // a concurrent launch of the same task
+            auto task = [r = run.get(), loop]() mutable {
+                detail::LoopRunScope scope(r);
                 loop();
-                break;
-            } else {
-                rt.silent_async_unchecked("loop-"s + std::to_string(w), loop);
+            };
+            for (size_t w = 0; w < num_workers; w++) {
+                if (w != me && part.num_chunks(*run, w)) {
+                    rt.silent_async_on(w, IndexedName{"loop-", w}, task);
+                }
             }
+            task();
+            rt.join();
+            part.end_loop(std::move(run), N);
+            return;
         }
 
-        rt.join();
+        auto spawn = [&](auto &task) {
+            for (size_t w = 0; w < W; w++) {
+                auto r = N - next.load(std::memory_order_relaxed);
+                // no more loop work to do - finished by previous async tasks
+                if (!r) {
+                    break;
+                }
+                // tail optimization
+                if (r <= part.chunk_size() || w == W - 1) {
+                    task();
+                    break;
+                } else {
+                    rt.silent_async_unchecked(IndexedName{"loop-", w}, task);
+                }
+            }
+            rt.join();
+        };
+
+        // adaptive partitioner - measure the run to tune the next one
+        if constexpr (std::is_same_v<std::decay_t<P>, AdaptivePartitioner>) {
+            auto run = part.begin_loop();
+            auto task = [r = run.get(), loop]() mutable {
+                detail::LoopRunScope scope(r);
+                loop();
+            };
+            spawn(task);
+            part.end_loop(std::move(run), N, W);
+        } else {
+            spawn(loop);
+        }
     }
 
 // Function: launch_loop
@@ -60,11 +99,10 @@ namespace rigel {
             Runtime &rt,
             Loop &&loop
     ) {
-        using namespace std::string_literals;
         if (w == W - 1) {
             loop();
         } else {
-            rt.silent_async_unchecked("loop-"s + std::to_string(w), loop);
+            rt.silent_async_unchecked(IndexedName{"loop-", w}, loop);
         }
     }
 
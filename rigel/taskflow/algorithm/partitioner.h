@@ -45,6 +45,8 @@ namespace rigel {
     + rigel::DynamicPartitioner to enable dynamic scheduling algorithm of equal chunk size
     + rigel::StaticPartitioner to enable static scheduling algorithm of static chunk size
     + rigel::RandomPartitioner to enable random scheduling algorithm of random chunk size
+    + rigel::AffinityPartitioner to replay the chunk-to-worker mapping across runs
+    + rigel::AdaptivePartitioner to tune the scheduling method from measured runs
 
     Depending on applications, partitioning algorithms can impact the performance
     a lot.
@@ -535,6 +537,704 @@ By default, @c alpha is <tt>0.01</tt> and @c beta is <tt>0.5</tt>, respectively.
 
     };
 
+// ----------------------------------------------------------------------------
+// LoopRunScope
+// ----------------------------------------------------------------------------
+
+    namespace detail {
+
+// class: LoopRunScope
+// makes the run of a launched loop the current run of its partitioner on the
+// calling thread, so that concurrent launches of the same loop task (e.g., the
+// instances of a taskflow) each keep their own run; scopes nest since a loop
+// task may run the loop tasks of other launches while it waits
+        template<typename Run>
+        class LoopRunScope {
+
+        public:
+
+            explicit LoopRunScope(Run *run) : _prev{_current} {
+                _current = run;
+            }
+
+            ~LoopRunScope() {
+                _current = _prev;
+            }
+
+            LoopRunScope(const LoopRunScope &) = delete;
+
+            LoopRunScope &operator=(const LoopRunScope &) = delete;
+
+            static Run *current() { return _current; }
+
+        private:
+
+            Run *_prev;
+
+            inline static thread_local Run *_current{nullptr};
+        };
+
+    }  // end of namespace detail -------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// AffinityPartitioner
+// ----------------------------------------------------------------------------
+
+/**
+@class AffinityPartitioner
+
+@brief class to construct an affinity partitioner for scheduling parallel algorithms
+
+The partitioner splits iterations into chunks of equal size and records
+which worker executed each chunk.
+When the algorithm runs again over the same number of iterations
+(e.g., a taskflow run by rigel::Executor::run_n or rigel::Executor::run_until),
+each chunk is first offered to the worker that executed it in the previous run,
+and the loop task of that worker is pushed to the worker's own mailbox.
+A worker that finishes its own chunks steals the remaining chunks of others,
+starting from the end of their lists, and the stolen chunks are recorded
+for the next run.
+This keeps data that fits in the private cache of a worker on the same worker
+across runs while still balancing the load.
+Since the chunks of a worker are not visited in increasing order,
+the partitioner requires random-access iterators.
+
+If the chunk size is not specified (default @c 0), the partitioner uses
+four chunks per worker.
+The mapping lives in the partitioner object owned by the task,
+and is discarded when the number of iterations changes.
+
+@code{.cpp}
+std::vector<float> data(1 << 16);
+taskflow.for_each(
+  data.begin(), data.end(), [](float& f){ f *= 0.5f; }, rigel::AffinityPartitioner()
+);
+executor.run_n(taskflow, 100).wait();
+@endcode
+*/
+    class AffinityPartitioner : public PartitionerBase {
+
+        // per-run scheduling state, owned by the launch of the loop
+        struct Run {
+            const AffinityPartitioner *partitioner;
+            size_t chunk_size;
+            size_t num_chunks;
+            std::vector<std::vector<size_t>> chunks;
+            std::unique_ptr<std::atomic<bool>[]> claimed;
+            std::vector<size_t> owners;
+            std::function<int()> this_worker;
+        };
+
+    public:
+
+        /**
+        @brief default constructor
+        */
+        AffinityPartitioner() : PartitionerBase{0} {}
+
+        /**
+        @brief construct an affinity partitioner with the given chunk size
+        */
+        explicit AffinityPartitioner(size_t sz) : PartitionerBase(sz) {}
+
+        /**
+        @brief copy constructor that copies the recorded mapping
+        */
+        AffinityPartitioner(const AffinityPartitioner &rhs) : PartitionerBase(rhs) {
+            std::lock_guard<std::mutex> lock(rhs._mutex);
+            _N = rhs._N;
+            _owners = rhs._owners;
+        }
+
+        /**
+        @brief move constructor
+        */
+        AffinityPartitioner(AffinityPartitioner &&rhs) :
+                PartitionerBase(rhs), _N{rhs._N}, _owners{std::move(rhs._owners)} {
+        }
+
+        /**
+        @brief copy assignment that copies the recorded mapping
+        */
+        AffinityPartitioner &operator=(const AffinityPartitioner &rhs) {
+            if (this != &rhs) {
+                std::scoped_lock lock(_mutex, rhs._mutex);
+                PartitionerBase::operator=(rhs);
+                _N = rhs._N;
+                _owners = rhs._owners;
+            }
+            return *this;
+        }
+
+        /**
+        @brief move assignment
+        */
+        AffinityPartitioner &operator=(AffinityPartitioner &&rhs) {
+            PartitionerBase::operator=(rhs);
+            _N = rhs._N;
+            _owners = std::move(rhs._owners);
+            return *this;
+        }
+
+        /**
+        @brief queries the adjusted chunk size
+
+        Returns the given chunk size if it is not zero, or returns
+        <tt>ceil(N/(4*W))</tt>, where @c N is the number of iterations and
+        @c W is the number of workers.
+        */
+        size_t adjusted_chunk_size(size_t N, size_t W) const {
+            return _chunk_size ? _chunk_size : std::max(size_t{1}, (N + 4 * W - 1) / (4 * W));
+        }
+
+        /**
+        @brief queries the recorded mapping
+
+        Returns the id of the worker that executed each chunk in the last run,
+        or an empty vector if the partitioner has not run yet.
+        The mapping is copied since runs that end concurrently replace it.
+        */
+        std::vector<size_t> affinity() const {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _owners;
+        }
+
+        /**
+        @brief discards the recorded mapping
+        */
+        void clear() {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _N = 0;
+            _owners.clear();
+        }
+
+        /**
+        @private
+        */
+        template<typename F>
+        std::unique_ptr<Run> begin_loop(size_t N, size_t W, size_t num_workers, F &&this_worker) {
+
+            auto ptr = std::make_unique<Run>();
+
+            auto &run = *ptr;
+
+            run.partitioner = this;
+            run.chunk_size = adjusted_chunk_size(N, W);
+            run.num_chunks = (N + run.chunk_size - 1) / run.chunk_size;
+            run.chunks.resize(num_workers);
+            run.claimed = std::make_unique<std::atomic<bool>[]>(run.num_chunks);
+            run.owners.resize(run.num_chunks);
+            run.this_worker = std::forward<F>(this_worker);
+
+            // replay the recorded mapping or start from a blocked one
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            bool replay = (_N == N && _owners.size() == run.num_chunks);
+
+            for (size_t c = 0; c < run.num_chunks; c++) {
+                size_t w = replay ? _owners[c] : c * W / run.num_chunks;
+                if (w >= num_workers) {
+                    w = c * W / run.num_chunks;
+                }
+                run.chunks[w].push_back(c);
+                run.owners[c] = w;
+            }
+
+            return ptr;
+        }
+
+        /**
+        @private
+        */
+        size_t num_chunks(const Run &run, size_t w) const {
+            return run.chunks[w].size();
+        }
+
+        /**
+        @private
+        */
+        void end_loop(std::unique_ptr<Run> run, size_t N) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _N = N;
+            _owners = std::move(run->owners);
+        }
+
+        // --------------------------------------------------------------------------
+        // scheduling methods
+        // --------------------------------------------------------------------------
+
+        /**
+        @private
+        */
+        template<typename F,
+                std::enable_if_t<std::is_invocable_r_v<void, F, size_t, size_t>, void> * = nullptr
+        >
+        void loop(
+                size_t N,
+                size_t W,
+                std::atomic<size_t> &next,
+                F &&func
+        ) const {
+            loop_until(N, W, next, [&](size_t curr_b, size_t curr_e) {
+                func(curr_b, curr_e);
+                return false;
+            });
+        }
+
+        /**
+        @private
+        */
+        template<typename F,
+                std::enable_if_t<std::is_invocable_r_v<bool, F, size_t, size_t>, void> * = nullptr
+        >
+        void loop_until(
+                size_t N,
+                size_t W,
+                std::atomic<size_t> &next,
+                F &&func
+        ) const {
+
+            auto current = detail::LoopRunScope<Run>::current();
+
+            // not launched with a recorded mapping - schedule like
+            // a dynamic partitioner
+            if (current == nullptr || current->partitioner != this) {
+                size_t chunk_size = adjusted_chunk_size(N, W);
+                size_t curr_b = next.fetch_add(chunk_size, std::memory_order_relaxed);
+                while (curr_b < N) {
+                    if (func(curr_b, std::min(curr_b + chunk_size, N))) {
+                        return;
+                    }
+                    curr_b = next.fetch_add(chunk_size, std::memory_order_relaxed);
+                }
+                return;
+            }
+
+            auto &run = *current;
+
+            int id = run.this_worker();
+            size_t me = (id < 0 || static_cast<size_t>(id) >= run.chunks.size()) ? 0 : id;
+
+            auto claim = [&](size_t c) {
+                if (run.claimed[c].load(std::memory_order_relaxed) ||
+                    run.claimed[c].exchange(true, std::memory_order_relaxed)) {
+                    return false;
+                }
+                run.owners[c] = me;
+                return true;
+            };
+
+            auto execute = [&](size_t c) {
+                size_t curr_b = c * run.chunk_size;
+                return func(curr_b, std::min(curr_b + run.chunk_size, N));
+            };
+
+            // a true from the function prunes every chunk from that one on;
+            // chunks with smaller indices are still visited since their
+            // owners are not guaranteed to reach them
+            size_t bound = run.num_chunks;
+
+            auto visit = [&](size_t c) {
+                if (c < bound && claim(c) && execute(c)) {
+                    bound = std::min(bound, c);
+                }
+            };
+
+            // my own chunks in increasing order
+            for (auto c: run.chunks[me]) {
+                if (c >= bound) {
+                    break;
+                }
+                visit(c);
+            }
+
+            // steal the others from the end of their lists
+            for (size_t k = 1; k < run.chunks.size(); k++) {
+                auto &victim = run.chunks[(me + k) % run.chunks.size()];
+                for (size_t i = victim.size(); i-- > 0;) {
+                    visit(victim[i]);
+                }
+            }
+        }
+
+    private:
+
+        // recorded mapping, updated by the runs that end concurrently
+        mutable std::mutex _mutex;
+
+        size_t _N{0};
+
+        std::vector<size_t> _owners;
+    };
+
+// ----------------------------------------------------------------------------
+// AdaptivePartitioner
+// ----------------------------------------------------------------------------
+
+/**
+@enum AdaptiveMode
+
+@brief enumeration of the scheduling modes chosen by rigel::AdaptivePartitioner
+*/
+    enum class AdaptiveMode : int {
+        /** @brief guided scheduling with the given chunk size, used before any measurement */
+        GUIDED = 0,
+        /** @brief dynamic scheduling with the tuned chunk size */
+        DYNAMIC,
+        /** @brief one contiguous block of iterations per worker */
+        STATIC
+    };
+
+/**
+@struct AdaptiveParameters
+
+@brief struct to describe the parameters chosen by rigel::AdaptivePartitioner
+and the measurements of the last run they were derived from
+*/
+    struct AdaptiveParameters {
+
+        /**
+        @brief scheduling mode of the next run
+        */
+        AdaptiveMode mode{AdaptiveMode::GUIDED};
+
+        /**
+        @brief chunk size of the next run
+        */
+        size_t chunk_size{1};
+
+        /**
+        @brief number of measured runs
+        */
+        size_t num_runs{0};
+
+        /**
+        @brief number of chunks executed in the last run
+        */
+        size_t num_chunks{0};
+
+        /**
+        @brief smoothed execution time per iteration in nanoseconds
+        */
+        double ns_per_iteration{0};
+
+        /**
+        @brief coefficient of variation of the per-iteration time across the chunks of the last run
+        */
+        double variation{0};
+
+        /**
+        @brief fraction of the worker time of the last run not spent in chunks
+        */
+        double idle_ratio{0};
+
+        /**
+        @brief fraction of the loop tasks of the last run executed by a worker
+        other than the one that launched the algorithm
+        */
+        double steal_ratio{0};
+    };
+
+/**
+@class AdaptivePartitioner
+
+@brief class to construct an adaptive partitioner for scheduling parallel algorithms
+
+The partitioner measures every run of the algorithm it is attached to:
+the execution time of each chunk, the time the participating workers spend
+outside chunks (waiting for work or scheduling), and how many loop tasks
+were stolen by other workers.
+At the end of the run it derives the parameters of the next run of the same task
+(e.g., a taskflow run by rigel::Executor::run_n or rigel::Executor::run_until):
+
++ the first run uses guided scheduling with the given chunk size
++ if the per-iteration time is regular across chunks and the workers were
+  rarely idle, the next run hands out one contiguous block per worker
+  like rigel::StaticPartitioner
++ otherwise, the next run uses dynamic scheduling with a chunk size that makes
+  each chunk last about the target chunk time, so the claim of a chunk
+  stays cheap compared to its work while leaving enough chunks to balance the load;
+  the chunk grows with the fraction of stolen loop tasks (up to twice the size),
+  since every thief contends on the shared counter
+
+All modes claim iterations in increasing order from the shared counter,
+so the partitioner works with every parallel algorithm that accepts
+rigel::DynamicPartitioner.
+Copies of an adaptive partitioner share the chosen parameters,
+so the partitioner passed to an algorithm can be kept to inspect them
+by rigel::AdaptivePartitioner::parameters.
+
+@code{.cpp}
+std::vector<float> data(1 << 20);
+rigel::AdaptivePartitioner part;
+taskflow.for_each(
+  data.begin(), data.end(), [](float& f){ f = std::sqrt(f); }, part
+);
+executor.run_n(taskflow, 100).wait();
+std::cout << part.parameters().chunk_size << '\n';
+@endcode
+
+The chunk size given at construction is the smallest chunk the partitioner uses.
+*/
+    class AdaptivePartitioner : public PartitionerBase {
+
+        // parameters shared by the copies of a partitioner
+        struct State {
+            std::mutex mutex;
+            AdaptiveParameters params;
+        };
+
+        // per-run parameters and measurements, owned by the launch of the loop
+        struct Run {
+            const AdaptivePartitioner *partitioner;
+            AdaptiveMode mode;
+            size_t chunk_size;
+            std::chrono::steady_clock::time_point start;
+            std::thread::id launcher;
+            std::mutex mutex;
+            size_t num_tasks{0};
+            size_t num_stolen{0};
+            size_t num_chunks{0};
+            uint64_t busy_ns{0};
+            double sum{0};
+            double sum_sq{0};
+        };
+
+    public:
+
+        /**
+        @brief default constructor
+        */
+        AdaptivePartitioner() : PartitionerBase{1} {
+            _state->params.chunk_size = 1;
+        }
+
+        /**
+        @brief construct an adaptive partitioner with the given minimum chunk size
+        and target chunk time
+        */
+        explicit AdaptivePartitioner(
+                size_t sz,
+                std::chrono::nanoseconds target = std::chrono::microseconds(20)
+        ) : PartitionerBase(sz), _target{target} {
+            _state->params.chunk_size = std::max(sz, size_t{1});
+        }
+
+        /**
+        @brief copy constructor that shares the chosen parameters
+        */
+        AdaptivePartitioner(const AdaptivePartitioner &rhs) :
+                PartitionerBase(rhs), _target{rhs._target}, _state{rhs._state} {
+        }
+
+        /**
+        @brief move constructor
+        */
+        AdaptivePartitioner(AdaptivePartitioner &&) = default;
+
+        /**
+        @brief copy assignment that shares the chosen parameters
+        */
+        AdaptivePartitioner &operator=(const AdaptivePartitioner &rhs) {
+            PartitionerBase::operator=(rhs);
+            _target = rhs._target;
+            _state = rhs._state;
+            return *this;
+        }
+
+        /**
+        @brief move assignment
+        */
+        AdaptivePartitioner &operator=(AdaptivePartitioner &&) = default;
+
+        /**
+        @brief queries the target execution time of a chunk
+        */
+        std::chrono::nanoseconds target_chunk_time() const { return _target; }
+
+        /**
+        @brief queries the parameters chosen for the next run
+        */
+        AdaptiveParameters parameters() const {
+            std::lock_guard<std::mutex> lock(_state->mutex);
+            return _state->params;
+        }
+
+        /**
+        @brief discards the measurements and restarts from guided scheduling
+        */
+        void clear() {
+            std::lock_guard<std::mutex> lock(_state->mutex);
+            _state->params = AdaptiveParameters{};
+            _state->params.chunk_size = std::max(_chunk_size, size_t{1});
+        }
+
+        /**
+        @private
+        */
+        std::unique_ptr<Run> begin_loop() const {
+            auto run = std::make_unique<Run>();
+            run->partitioner = this;
+            std::tie(run->mode, run->chunk_size) = _snapshot();
+            run->launcher = std::this_thread::get_id();
+            run->start = std::chrono::steady_clock::now();
+            return run;
+        }
+
+        /**
+        @private
+        */
+        void end_loop(std::unique_ptr<Run> run, size_t N, size_t W) {
+
+            auto wall = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - run->start
+            ).count();
+
+            if (N == 0 || run->num_chunks == 0) {
+                return;
+            }
+
+            std::lock_guard<std::mutex> lock(_state->mutex);
+
+            auto &p = _state->params;
+
+            double mean = run->sum / run->num_chunks;
+            double var = std::max(0.0, run->sum_sq / run->num_chunks - mean * mean);
+            double ns = static_cast<double>(run->busy_ns) / N;
+            double capacity = static_cast<double>(wall) * std::min(W, run->num_tasks);
+
+            p.num_chunks = run->num_chunks;
+            p.variation = mean > 0 ? std::sqrt(var) / mean : 0.0;
+            p.idle_ratio = capacity > 0 ? std::max(0.0, 1.0 - run->busy_ns / capacity) : 0.0;
+            p.steal_ratio = static_cast<double>(run->num_stolen) / run->num_tasks;
+            p.ns_per_iteration = p.num_runs ? 0.5 * (p.ns_per_iteration + ns) : ns;
+            p.num_runs++;
+
+            size_t block = (N + W - 1) / W;
+            size_t chunk = p.ns_per_iteration > 0 ?
+                           static_cast<size_t>(_target.count() / p.ns_per_iteration) : block;
+            chunk = std::clamp(chunk, std::max(_chunk_size, size_t{1}), std::max(block, size_t{1}));
+
+            // Every stolen loop task contends on the shared counter from another
+            // worker, so a high steal ratio grows the dynamic chunk to amortize
+            // the claims over more work.
+            chunk = std::min(
+                    static_cast<size_t>(chunk * (1.0 + p.steal_ratio)), std::max(block, size_t{1})
+            );
+
+            // Regular iterations are balanced by equal blocks without any further
+            // claims; a static run that left workers idle falls back to dynamic
+            // scheduling.
+            if (p.variation < 0.25 && p.idle_ratio < 0.1) {
+                p.mode = AdaptiveMode::STATIC;
+                p.chunk_size = block;
+            } else {
+                p.mode = AdaptiveMode::DYNAMIC;
+                p.chunk_size = chunk;
+            }
+        }
+
+        // --------------------------------------------------------------------------
+        // scheduling methods
+        // --------------------------------------------------------------------------
+
+        /**
+        @private
+        */
+        template<typename F,
+                std::enable_if_t<std::is_invocable_r_v<void, F, size_t, size_t>, void> * = nullptr
+        >
+        void loop(
+                size_t N,
+                size_t W,
+                std::atomic<size_t> &next,
+                F &&func
+        ) const {
+            loop_until(N, W, next, [&](size_t curr_b, size_t curr_e) {
+                func(curr_b, curr_e);
+                return false;
+            });
+        }
+
+        /**
+        @private
+        */
+        template<typename F,
+                std::enable_if_t<std::is_invocable_r_v<bool, F, size_t, size_t>, void> * = nullptr
+        >
+        void loop_until(
+                size_t N,
+                size_t W,
+                std::atomic<size_t> &next,
+                F &&func
+        ) const {
+
+            auto run = detail::LoopRunScope<Run>::current();
+
+            // not launched with measurements - schedule with the current parameters
+            if (run == nullptr || run->partitioner != this) {
+                auto [mode, chunk_size] = _snapshot();
+                _schedule(mode, chunk_size, N, W, next, func);
+                return;
+            }
+
+            size_t num_chunks{0};
+            uint64_t busy_ns{0};
+            double sum{0}, sum_sq{0};
+
+            _schedule(run->mode, run->chunk_size, N, W, next, [&](size_t curr_b, size_t curr_e) {
+                auto beg = std::chrono::steady_clock::now();
+                bool stop = func(curr_b, curr_e);
+                auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - beg
+                ).count();
+                double r = static_cast<double>(ns) / (curr_e - curr_b);
+                busy_ns += ns;
+                sum += r;
+                sum_sq += r * r;
+                num_chunks++;
+                return stop;
+            });
+
+            std::lock_guard<std::mutex> lock(run->mutex);
+            run->num_tasks++;
+            run->num_stolen += (std::this_thread::get_id() != run->launcher);
+            run->num_chunks += num_chunks;
+            run->busy_ns += busy_ns;
+            run->sum += sum;
+            run->sum_sq += sum_sq;
+        }
+
+    private:
+
+        std::chrono::nanoseconds _target{std::chrono::microseconds(20)};
+
+        std::shared_ptr<State> _state{std::make_shared<State>()};
+
+        std::pair<AdaptiveMode, size_t> _snapshot() const {
+            std::lock_guard<std::mutex> lock(_state->mutex);
+            return {_state->params.mode, _state->params.chunk_size};
+        }
+
+        template<typename F>
+        static void _schedule(
+                AdaptiveMode mode, size_t chunk_size,
+                size_t N, size_t W, std::atomic<size_t> &next, F &&func
+        ) {
+            switch (mode) {
+                case AdaptiveMode::GUIDED:
+                    GuidedPartitioner(chunk_size).loop_until(N, W, next, func);
+                    break;
+                case AdaptiveMode::DYNAMIC:
+                    DynamicPartitioner(chunk_size).loop_until(N, W, next, func);
+                    break;
+                case AdaptiveMode::STATIC:
+                    DynamicPartitioner((N + W - 1) / W).loop_until(N, W, next, func);
+                    break;
+            }
+        }
+    };
+
 /**
 @brief default partitioner set to rigel::GuidedPartitioner
 
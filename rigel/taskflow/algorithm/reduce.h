@@ -100,6 +100,34 @@ namespace rigel {
                                 });
                             }
                             rt.join();
+                        }
+                            // affinity partitioner
+                        else if constexpr (std::is_same_v<std::decay_t<P>, AffinityPartitioner>) {
+                            // chunks are not claimed in order, so each chunk is reduced on its own
+                            std::atomic<size_t> next(0);
+                            launch_loop(N, W, rt, next, part, [=, &bop, &mtx, &next, &r, &part]() mutable {
+                                part.loop(N, W, next, [&](size_t curr_b, size_t curr_e) {
+
+                                    auto itr = std::next(beg, curr_b);
+
+                                    if (curr_e - curr_b == 1) {
+                                        std::lock_guard<std::mutex> lock(mtx);
+                                        r = bop(r, *itr);
+                                        return;
+                                    }
+
+                                    auto beg1 = itr++;
+                                    auto beg2 = itr++;
+                                    T sum = bop(*beg1, *beg2);
+
+                                    for (size_t x = curr_b + 2; x < curr_e; x++, itr++) {
+                                        sum = bop(sum, *itr);
+                                    }
+
+                                    std::lock_guard<std::mutex> lock(mtx);
+                                    r = bop(r, sum);
+                                });
+                            });
                         }
                             // dynamic partitioner
                         else {
@@ -226,6 +254,35 @@ namespace rigel {
                             }
 
                             rt.join();
+                        }
+                            // affinity partitioner
+                        else if constexpr (std::is_same_v<std::decay_t<P>, AffinityPartitioner>) {
+                            // chunks are not claimed in order, so each chunk is reduced on its own
+                            std::atomic<size_t> next(0);
+
+                            launch_loop(N, W, rt, next, part, [=, &bop, &uop, &mtx, &next, &r, &part]() mutable {
+                                part.loop(N, W, next, [&](size_t curr_b, size_t curr_e) {
+
+                                    auto itr = std::next(beg, curr_b);
+
+                                    if (curr_e - curr_b == 1) {
+                                        std::lock_guard<std::mutex> lock(mtx);
+                                        r = bop(std::move(r), uop(*itr));
+                                        return;
+                                    }
+
+                                    auto beg1 = itr++;
+                                    auto beg2 = itr++;
+                                    T sum = bop(uop(*beg1), uop(*beg2));
+
+                                    for (size_t x = curr_b + 2; x < curr_e; x++, itr++) {
+                                        sum = bop(std::move(sum), uop(*itr));
+                                    }
+
+                                    std::lock_guard<std::mutex> lock(mtx);
+                                    r = bop(std::move(r), std::move(sum));
+                                });
+                            });
                         }
                             // dynamic partitioner
                         else {
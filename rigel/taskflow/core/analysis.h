@@ -0,0 +1,724 @@
+// Copyright 2023 The titan-search Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#pragma once
+
+#include <iomanip>
+#include <limits>
+#include <numeric>
+
+#include "rigel/taskflow/core/taskflow.h"
+#include "rigel/taskflow/core/observer.h"
+
+/**
+@file analysis.h
+@brief profile analysis include file
+*/
+
+namespace rigel {
+
+// ----------------------------------------------------------------------------
+// ProfileGraph
+// ----------------------------------------------------------------------------
+
+/**
+@class ProfileGraph
+
+@brief class to describe the task dependencies of a profile by task names
+
+A timeline records when each task ran but not why it waited.
+A profile graph supplies the missing dependencies such that
+rigel::ProfileAnalysis can link each task to the predecessors it waited for.
+Tasks are identified by their names; unnamed tasks cannot be matched
+and tasks with the same name share their predecessors.
+
+A profile graph can be built from a taskflow, from its dump
+(rigel::Taskflow::dump), or by hand:
+
+@code{.cpp}
+rigel::ProfileGraph graph(taskflow);
+
+std::ifstream ifs("taskflow.dot");
+rigel::ProfileGraph graph2;
+graph2.load_dot(ifs);
+@endcode
+*/
+class ProfileGraph {
+
+  public:
+
+    /**
+    @brief constructs an empty profile graph
+    */
+    ProfileGraph() = default;
+
+    /**
+    @brief constructs a profile graph from the top-level tasks of a taskflow
+
+    Tasks spawned at runtime (e.g., subflow tasks) and the tasks of
+    composed modules are not part of the top-level graph;
+    use rigel::ProfileGraph::load_dot on a dump taken after a run
+    to include them.
+    */
+    explicit ProfileGraph(const Taskflow& taskflow);
+
+    /**
+    @brief adds a dependency from task @c from to task @c to
+    */
+    void add_dependency(const std::string& from, const std::string& to);
+
+    /**
+    @brief loads the dependencies from a @GraphViz dump of rigel::Taskflow::dump
+
+    Edges that join a subflow back to its parent task are skipped,
+    because the parent task finishes after its subflow rather than
+    waiting to start.
+    */
+    void load_dot(std::istream& is);
+
+    /**
+    @brief queries the number of tasks that have at least one dependency
+    */
+    size_t num_tasks() const;
+
+    /**
+    @brief queries the number of dependencies
+    */
+    size_t num_dependencies() const;
+
+    /**
+    @brief queries if the graph has no dependencies
+    */
+    bool empty() const;
+
+    /**
+    @brief applies a visitor to the predecessors of the given task
+    */
+    template <typename V>
+    void for_each_predecessor(const std::string& name, V&& visitor) const;
+
+  private:
+
+    std::unordered_map<std::string, std::vector<std::string>> _predecessors;
+    std::unordered_set<std::string> _tasks;
+    size_t _num_dependencies {0};
+};
+
+// Constructor
+inline ProfileGraph::ProfileGraph(const Taskflow& taskflow) {
+  taskflow.for_each_task([&](Task task){
+    task.for_each_successor([&](Task succ){
+      add_dependency(task.name(), succ.name());
+    });
+  });
+}
+
+// Procedure: add_dependency
+inline void ProfileGraph::add_dependency(const std::string& from, const std::string& to) {
+
+  if(from.empty() || to.empty()) {
+    return;
+  }
+
+  auto& preds = _predecessors[to];
+
+  if(std::find(preds.begin(), preds.end(), from) == preds.end()) {
+    preds.push_back(from);
+    _tasks.insert(from);
+    _tasks.insert(to);
+    _num_dependencies++;
+  }
+}
+
+// Procedure: load_dot
+inline void ProfileGraph::load_dot(std::istream& is) {
+
+  // node ids (e.g., p0x7ffd2a1c) to task names
+  std::unordered_map<std::string, std::string> names;
+
+  std::vector<std::pair<std::string, std::string>> edges;
+  std::vector<std::string> clusters;
+
+  auto trim = [](std::string s){
+    auto b = s.find_first_not_of(" \t\r");
+    auto e = s.find_last_not_of(" \t\r");
+    return b == std::string::npos ? std::string() : s.substr(b, e - b + 1);
+  };
+
+  std::string line;
+
+  while(std::getline(is, line)) {
+
+    line = trim(line);
+
+    // subgraph cluster_<id> {
+    if(line.rfind("subgraph cluster_", 0) == 0) {
+      auto id = line.substr(17);
+      clusters.push_back(id.substr(0, id.find_first_of(" {")));
+      continue;
+    }
+
+    if(line == "}") {
+      if(!clusters.empty()) {
+        clusters.pop_back();
+      }
+      continue;
+    }
+
+    // <from> -> <to> [attributes];
+    if(auto arrow = line.find("->"); arrow != std::string::npos) {
+      auto from = trim(line.substr(0, arrow));
+      auto to = trim(line.substr(arrow + 2));
+      to = to.substr(0, to.find_first_of(" [;"));
+      // subflow join edge from a child to the task owning its cluster
+      if(std::find(clusters.begin(), clusters.end(), to) == clusters.end()) {
+        edges.emplace_back(std::move(from), std::move(to));
+      }
+      continue;
+    }
+
+    // <id>[label="<name>" ...];
+    if(auto bracket = line.find('['); bracket != std::string::npos) {
+      auto beg = line.find("label=\"", bracket);
+      if(beg == std::string::npos) {
+        continue;
+      }
+      beg += 7;
+      auto end = line.find('"', beg);
+      auto id = trim(line.substr(0, bracket));
+      auto name = line.substr(beg, end - beg);
+      // module tasks carry the id of their graph, e.g., "name [m1]"
+      if(line.find("shape=box3d") != std::string::npos) {
+        name = name.substr(0, name.rfind(" [m"));
+      }
+      // unnamed tasks are labelled by their id
+      if(name != id) {
+        names[id] = std::move(name);
+      }
+    }
+  }
+
+  for(const auto& [from, to] : edges) {
+    auto f = names.find(from);
+    auto t = names.find(to);
+    if(f != names.end() && t != names.end()) {
+      add_dependency(f->second, t->second);
+    }
+  }
+}
+
+// Function: num_tasks
+inline size_t ProfileGraph::num_tasks() const {
+  return _tasks.size();
+}
+
+// Function: num_dependencies
+inline size_t ProfileGraph::num_dependencies() const {
+  return _num_dependencies;
+}
+
+// Function: empty
+inline bool ProfileGraph::empty() const {
+  return _num_dependencies == 0;
+}
+
+// Procedure: for_each_predecessor
+template <typename V>
+void ProfileGraph::for_each_predecessor(const std::string& name, V&& visitor) const {
+  if(auto itr = _predecessors.find(name); itr != _predecessors.end()) {
+    for(const auto& pred : itr->second) {
+      visitor(pred);
+    }
+  }
+}
+
+// ----------------------------------------------------------------------------
+// RunAnalysis
+// ----------------------------------------------------------------------------
+
+/**
+@struct CriticalPathTask
+
+@brief struct to describe a task on a critical path
+
+All times are relative to the origin of the analyzed timeline.
+*/
+struct CriticalPathTask {
+
+  /** @brief name of the task */
+  std::string name;
+
+  /** @brief type of the task */
+  TaskType type;
+
+  /** @brief id of the worker that ran the task */
+  size_t worker;
+
+  /** @brief time the task started */
+  std::chrono::nanoseconds beg;
+
+  /** @brief time the task took to run */
+  std::chrono::nanoseconds span;
+
+  /** @brief time between the last predecessor finishing and the task starting */
+  std::chrono::nanoseconds latency;
+};
+
+/**
+@struct RunAnalysis
+
+@brief struct to hold the analysis of one run of a task graph
+
+Two task executions belong to the same run if one waited for the other
+through a dependency of the rigel::ProfileGraph.
+*/
+struct RunAnalysis {
+
+  /** @brief time the first task of the run started */
+  std::chrono::nanoseconds beg {0};
+
+  /** @brief time between the first task starting and the last task finishing */
+  std::chrono::nanoseconds makespan {0};
+
+  /** @brief total time of all top-level tasks of the run */
+  std::chrono::nanoseconds work {0};
+
+  /** @brief time the workers were not running a task of the run within its makespan */
+  std::chrono::nanoseconds idle {0};
+
+  /** @brief average ready-to-start latency of tasks with predecessors */
+  std::chrono::nanoseconds avg_latency {0};
+
+  /** @brief maximum ready-to-start latency of tasks with predecessors */
+  std::chrono::nanoseconds max_latency {0};
+
+  /** @brief total time of the tasks on the critical path */
+  std::chrono::nanoseconds critical_path_span {0};
+
+  /** @brief number of tasks in the run */
+  size_t num_tasks {0};
+
+  /** @brief tasks on the critical path from the first to the last */
+  std::vector<CriticalPathTask> critical_path;
+
+  /**
+  @brief queries the average parallelism (work divided by makespan)
+  */
+  float parallelism() const {
+    return makespan.count() ? static_cast<float>(work.count()) / makespan.count() : 0.0f;
+  }
+};
+
+// ----------------------------------------------------------------------------
+// ProfileAnalysis
+// ----------------------------------------------------------------------------
+
+/**
+@class ProfileAnalysis
+
+@brief class to analyze the timeline of a rigel::TFProfObserver
+
+The analysis links every recorded task to the latest execution of each of
+its predecessors (given by a rigel::ProfileGraph) that finished before it
+started, and splits the timeline into runs of connected executions.
+For each run it computes the critical path, i.e., the chain of dependent
+tasks with the largest total time, the average parallelism, the idle time,
+and the ready-to-start latency of the tasks.
+Without dependencies, the whole timeline is one run and the critical
+path is its longest task.
+
+@code{.cpp}
+auto observer = executor.make_observer<rigel::TFProfObserver>();
+executor.run_n(taskflow, 10).wait();
+
+rigel::ProfileAnalysis analysis(*observer, rigel::ProfileGraph(taskflow));
+analysis.dump(std::cout, 5);   // print the top-5 tasks on the critical paths
+@endcode
+
+The timelines in a @c .tfp file can be analyzed offline
+by the @c tfprof_analyze example.
+*/
+class ProfileAnalysis {
+
+  public:
+
+    /**
+    @brief analyzes the timeline recorded by an observer
+
+    The observer must not be recording tasks during the analysis.
+    */
+    ProfileAnalysis(const TFProfObserver& observer, const ProfileGraph& graph = {});
+
+    /**
+    @brief analyzes a timeline loaded from a profile (e.g., rigel::load_tfprof)
+    */
+    ProfileAnalysis(const Timeline& timeline, const ProfileGraph& graph = {});
+
+    /**
+    @brief queries the id of the analyzed executor
+    */
+    size_t uid() const { return _uid; }
+
+    /**
+    @brief queries the number of workers of the analyzed executor
+    */
+    size_t num_workers() const { return _num_workers; }
+
+    /**
+    @brief queries the runs in the order they started
+    */
+    const std::vector<RunAnalysis>& runs() const { return _runs; }
+
+    /**
+    @brief ranks tasks by their total time on the critical paths of all runs
+
+    @param N maximum number of tasks to return
+
+    Each returned entry aggregates all critical-path executions of a task
+    name: @c span is the total time and @c latency the total
+    ready-to-start latency.
+    */
+    std::vector<CriticalPathTask> top_critical_tasks(size_t N) const;
+
+    /**
+    @brief dumps the per-run metrics and the top-N critical tasks
+    */
+    void dump(std::ostream& ostream, size_t N = 10) const;
+
+    /**
+    @brief dumps the per-run metrics and the top-N critical tasks to a string
+    */
+    std::string dump(size_t N = 10) const;
+
+  private:
+
+    struct Instance {
+      const Segment* segment;
+      size_t worker;
+      size_t level;
+      size_t run;
+      size_t prev;
+      std::chrono::nanoseconds dist {0};
+      std::chrono::nanoseconds latency {0};
+      bool ready {false};
+    };
+
+    size_t _uid;
+    size_t _num_workers;
+
+    std::vector<RunAnalysis> _runs;
+
+    void _analyze(const Timeline&, const ProfileGraph&);
+};
+
+// Constructor
+inline ProfileAnalysis::ProfileAnalysis(
+  const TFProfObserver& observer, const ProfileGraph& graph
+) {
+  _analyze(observer._timeline, graph);
+}
+
+// Constructor
+inline ProfileAnalysis::ProfileAnalysis(
+  const Timeline& timeline, const ProfileGraph& graph
+) {
+  _analyze(timeline, graph);
+}
+
+// Procedure: _analyze
+inline void ProfileAnalysis::_analyze(const Timeline& timeline, const ProfileGraph& graph) {
+
+  using namespace std::chrono;
+
+  constexpr size_t NONE = std::numeric_limits<size_t>::max();
+
+  _uid = timeline.uid;
+  _num_workers = timeline.segments.size();
+
+  // gather all executions in the order they started
+  std::vector<Instance> instances;
+
+  for(size_t w=0; w<timeline.segments.size(); ++w) {
+    for(size_t l=0; l<timeline.segments[w].size(); ++l) {
+      for(const auto& s : timeline.segments[w][l]) {
+        instances.push_back(Instance{&s, w, l, 0, NONE});
+      }
+    }
+  }
+
+  std::sort(instances.begin(), instances.end(), [](const auto& a, const auto& b){
+    return std::tie(a.segment->beg, a.segment->end) < std::tie(b.segment->beg, b.segment->end);
+  });
+
+  // executions of each task name in the order they finished
+  std::unordered_map<std::string, std::vector<size_t>> executions;
+
+  for(size_t i=0; i<instances.size(); ++i) {
+    if(!instances[i].segment->name.empty()) {
+      executions[instances[i].segment->name].push_back(i);
+    }
+  }
+
+  for(auto& [name, ids] : executions) {
+    std::sort(ids.begin(), ids.end(), [&](size_t a, size_t b){
+      return instances[a].segment->end < instances[b].segment->end;
+    });
+  }
+
+  // union-find over executions linked by a dependency
+  std::vector<size_t> parents(instances.size());
+  std::iota(parents.begin(), parents.end(), size_t{0});
+
+  auto find = [&](size_t i){
+    while(parents[i] != i) {
+      i = parents[i] = parents[parents[i]];
+    }
+    return i;
+  };
+
+  // link each execution to the latest execution of each predecessor that
+  // finished before it started; predecessors started earlier, so their
+  // longest path is known already
+  for(size_t i=0; i<instances.size(); ++i) {
+
+    auto& inst = instances[i];
+    auto ready = inst.segment->beg;
+
+    graph.for_each_predecessor(inst.segment->name, [&](const std::string& pred){
+
+      auto itr = executions.find(pred);
+      if(itr == executions.end()) {
+        return;
+      }
+
+      const auto& ids = itr->second;
+      auto pos = std::upper_bound(ids.begin(), ids.end(), inst.segment->beg,
+        [&](const auto& beg, size_t id){ return beg < instances[id].segment->end; }
+      );
+      if(pos == ids.begin()) {
+        return;
+      }
+
+      size_t j = *std::prev(pos);
+      if(j == i) {
+        return;
+      }
+
+      const auto& p = instances[j];
+
+      if(!inst.ready || p.segment->end > ready) {
+        ready = p.segment->end;
+      }
+      inst.ready = true;
+
+      if(inst.prev == NONE || p.dist > instances[inst.prev].dist) {
+        inst.prev = j;
+      }
+
+      parents[find(i)] = find(j);
+    });
+
+    inst.dist = duration_cast<nanoseconds>(inst.segment->end - inst.segment->beg);
+
+    if(inst.prev != NONE) {
+      inst.dist += instances[inst.prev].dist;
+    }
+
+    if(inst.ready) {
+      inst.latency = duration_cast<nanoseconds>(inst.segment->beg - ready);
+    }
+  }
+
+  // without dependencies the whole timeline is one run
+  if(graph.empty()) {
+    std::fill(parents.begin(), parents.end(), size_t{0});
+  }
+
+  // number the runs in the order they started
+  std::unordered_map<size_t, size_t> runs;
+  std::vector<size_t> last;
+  std::vector<size_t> num_ready;
+
+  for(size_t i=0; i<instances.size(); ++i) {
+
+    auto& inst = instances[i];
+    auto [itr, inserted] = runs.try_emplace(find(i), _runs.size());
+
+    if(inserted) {
+      _runs.emplace_back();
+      _runs.back().beg = duration_cast<nanoseconds>(inst.segment->beg - timeline.origin);
+      last.push_back(i);
+      num_ready.push_back(0);
+    }
+
+    inst.run = itr->second;
+
+    auto& run = _runs[inst.run];
+    auto span = duration_cast<nanoseconds>(inst.segment->end - inst.segment->beg);
+    auto end = duration_cast<nanoseconds>(inst.segment->end - timeline.origin);
+
+    run.num_tasks++;
+    run.makespan = std::max(run.makespan, end - run.beg);
+
+    if(inst.level == 0) {
+      run.work += span;
+    }
+
+    if(inst.ready) {
+      run.avg_latency += inst.latency;
+      run.max_latency = std::max(run.max_latency, inst.latency);
+      num_ready[inst.run]++;
+    }
+
+    if(inst.dist > instances[last[inst.run]].dist) {
+      last[inst.run] = i;
+    }
+  }
+
+  for(size_t r=0; r<_runs.size(); ++r) {
+
+    auto& run = _runs[r];
+
+    if(num_ready[r]) {
+      run.avg_latency /= num_ready[r];
+    }
+
+    auto capacity = run.makespan * static_cast<nanoseconds::rep>(_num_workers);
+    run.idle = capacity > run.work ? capacity - run.work : nanoseconds{0};
+
+    run.critical_path_span = instances[last[r]].dist;
+
+    for(size_t i=last[r]; i!=NONE; i=instances[i].prev) {
+      const auto& inst = instances[i];
+      run.critical_path.push_back(CriticalPathTask{
+        inst.segment->name,
+        inst.segment->type,
+        inst.worker,
+        duration_cast<nanoseconds>(inst.segment->beg - timeline.origin),
+        duration_cast<nanoseconds>(inst.segment->end - inst.segment->beg),
+        inst.latency
+      });
+    }
+
+    std::reverse(run.critical_path.begin(), run.critical_path.end());
+  }
+}
+
+// Function: top_critical_tasks
+inline std::vector<CriticalPathTask> ProfileAnalysis::top_critical_tasks(size_t N) const {
+
+  std::vector<CriticalPathTask> tasks;
+  std::unordered_map<std::string, size_t> index;
+
+  for(const auto& run : _runs) {
+    for(const auto& t : run.critical_path) {
+      auto [itr, inserted] = index.try_emplace(t.name, tasks.size());
+      if(inserted) {
+        tasks.push_back(t);
+      }
+      else {
+        tasks[itr->second].span += t.span;
+        tasks[itr->second].latency += t.latency;
+      }
+    }
+  }
+
+  std::stable_sort(tasks.begin(), tasks.end(), [](const auto& a, const auto& b){
+    return a.span > b.span;
+  });
+
+  if(tasks.size() > N) {
+    tasks.resize(N);
+  }
+
+  return tasks;
+}
+
+// Procedure: dump
+inline void ProfileAnalysis::dump(std::ostream& os, size_t N) const {
+
+  auto us = [](std::chrono::nanoseconds ns){
+    return std::to_string(ns.count() / 1000);
+  };
+
+  os << "==Analysis " << _uid << ": " << _num_workers << " workers, "
+     << _runs.size() << " runs\n";
+
+  os << std::setw(6) << "-Run-"
+     << std::setw(8) << "Tasks"
+     << std::setw(14) << "Makespan(us)"
+     << std::setw(14) << "Critical(us)"
+     << std::setw(12) << "Work(us)"
+     << std::setw(12) << "Idle(us)"
+     << std::setw(13) << "Parallelism"
+     << std::setw(15) << "AvgLatency(us)"
+     << std::setw(15) << "MaxLatency(us)"
+     << '\n';
+
+  for(size_t r=0; r<_runs.size(); ++r) {
+    const auto& run = _runs[r];
+    os << std::setw(6) << r
+       << std::setw(8) << run.num_tasks
+       << std::setw(14) << us(run.makespan)
+       << std::setw(14) << us(run.critical_path_span)
+       << std::setw(12) << us(run.work)
+       << std::setw(12) << us(run.idle)
+       << std::setw(13) << std::to_string(run.parallelism())
+       << std::setw(15) << us(run.avg_latency)
+       << std::setw(15) << us(run.max_latency)
+       << '\n';
+  }
+
+  std::chrono::nanoseconds critical {0};
+  for(const auto& run : _runs) {
+    critical += run.critical_path_span;
+  }
+
+  auto tasks = top_critical_tasks(N);
+
+  os << "\nTop " << tasks.size() << " tasks on the critical paths:\n";
+
+  size_t name_w = 6;
+  for(const auto& t : tasks) {
+    name_w = std::max(name_w, t.name.size());
+  }
+
+  os << std::setw(name_w+2) << "-Task-"
+     << std::setw(10) << "Type"
+     << std::setw(12) << "Time(us)"
+     << std::setw(9) << "Share"
+     << std::setw(15) << "Latency(us)"
+     << '\n';
+
+  for(const auto& t : tasks) {
+    float share = critical.count() ? 100.0f * t.span.count() / critical.count() : 0.0f;
+    std::ostringstream pct;
+    pct << std::fixed << std::setprecision(1) << share << '%';
+    os << std::setw(name_w+2) << t.name
+       << std::setw(10) << to_string(t.type)
+       << std::setw(12) << us(t.span)
+       << std::setw(9) << pct.str()
+       << std::setw(15) << us(t.latency)
+       << '\n';
+  }
+}
+
+// Function: dump
+inline std::string ProfileAnalysis::dump(size_t N) const {
+  std::ostringstream oss;
+  dump(oss, N);
+  return oss.str();
+}
+
+}  // end of namespace rigel -----------------------------------------------------
@@ -41,9 +41,18 @@ namespace rigel {
                 _make_promised_async(std::move(p), std::forward<F>(f))
         );
 
+#ifdef TF_HAS_COROUTINE
+        // the returned future shares the node with the task
+        std::get_if<Node::Async>(&node->_handle)->refs.store(2, std::memory_order_relaxed);
+
+        _schedule_async_task(node);
+
+        return AsyncFuture<R>(std::move(fu), node);
+#else
         _schedule_async_task(node);
 
         return fu;
+#endif
     }
 
 // Function: async
@@ -76,6 +85,69 @@ namespace rigel {
         silent_async("", std::forward<F>(f));
     }
 
+// Function: silent_async_bulk
+    template<typename B, typename E, typename C>
+    void Executor::silent_async_bulk(B first, E last, C &&func) {
+        _silent_async_bulk(_this_worker(), nullptr, first, last, std::forward<C>(func));
+    }
+
+// Procedure: _silent_async_bulk
+// submits one async task per element of the range, joined by the parent if
+// any or counted as running tasks of the executor otherwise
+    template<typename B, typename E, typename C>
+    void Executor::_silent_async_bulk(Worker *w, Node *parent, B first, E last, C &&func) {
+
+        size_t n;
+        if constexpr (std::is_integral_v<B>) {
+            n = first < last ? static_cast<size_t>(last - first) : 0;
+        } else {
+            n = static_cast<size_t>(std::distance(first, last));
+        }
+
+        if (n == 0) {
+            return;
+        }
+
+        if (parent) {
+            parent->_join_counter.fetch_add(n, std::memory_order_relaxed);
+        } else {
+            _increment_topology(n);
+        }
+
+        // submits the tasks in chunks that workers can start on and recycle
+        // while the next chunk is created, as a single chunk of all the nodes
+        // would run out of the cache for large ranges
+        constexpr size_t chunk = 1024;
+
+        SmallVector<Node *> nodes;
+
+        for (size_t i = 0; i < n; i += chunk) {
+
+            size_t m = std::min(chunk, n - i);
+            nodes.resize(m);
+
+            node_pool.animate_n(
+                    nodes.data(), m, std::string(), 0u, parent ? parent->_topology : nullptr, parent, size_t{0},
+                    std::in_place_type_t<Node::Async>{}, std::function<void()>{}
+            );
+
+            for (size_t k = 0; k < m; ++k, ++first) {
+                auto &work = std::get_if<Node::Async>(&nodes[k]->_handle)->work;
+                if constexpr (std::is_integral_v<B>) {
+                    work = [func, first]() mutable { func(first); };
+                } else {
+                    work = [func, first]() mutable { func(*first); };
+                }
+            }
+
+            if (w) {
+                _schedule(*w, nodes);
+            } else {
+                _schedule(nodes);
+            }
+        }
+    }
+
 // ----------------------------------------------------------------------------
 // Async Helper Methods
 // ----------------------------------------------------------------------------
@@ -104,6 +176,18 @@ namespace rigel {
 
 // Procedure: _tear_down_async
     inline void Executor::_tear_down_async(Node *node) {
+
+#ifdef TF_HAS_COROUTINE
+        auto handle = std::get_if<Node::Async>(&node->_handle);
+
+        // resume the coroutine task awaiting the result, if any, on the
+        // executor running it
+        if (auto c = handle->continuation.exchange(handle, std::memory_order_acq_rel); c) {
+            auto promise = static_cast<Coro::promise_type *>(c);
+            promise->executor->_schedule_async_task(promise->node);
+        }
+#endif
+
         // from runtime
         if (node->_parent) {
             node->_parent->_join_counter.fetch_sub(1, std::memory_order_release);
@@ -112,9 +196,50 @@ namespace rigel {
         else {
             _decrement_topology_and_notify();
         }
+
+#ifdef TF_HAS_COROUTINE
+        if (handle->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+            return;
+        }
+#endif
         node_pool.recycle(node);
     }
 
+#ifdef TF_HAS_COROUTINE
+// ----------------------------------------------------------------------------
+// AsyncFuture
+// ----------------------------------------------------------------------------
+
+// Function: await_ready
+    template<typename T>
+    bool AsyncFuture<T>::await_ready() const noexcept {
+        if (!_node) {
+            return true;
+        }
+        auto handle = std::get_if<Node::Async>(&_node->_handle);
+        return handle->continuation.load(std::memory_order_acquire) == handle;
+    }
+
+// Procedure: await_suspend
+// the executor publishes the suspension after the resume has returned
+    template<typename T>
+    void AsyncFuture<T>::await_suspend(std::coroutine_handle<Coro::promise_type> h) noexcept {
+        h.promise().suspended_on = &std::get_if<Node::Async>(&_node->_handle)->continuation;
+    }
+
+// Procedure: _release
+    template<typename T>
+    void AsyncFuture<T>::_release() noexcept {
+        if (_node) {
+            auto handle = std::get_if<Node::Async>(&_node->_handle);
+            if (handle->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                node_pool.recycle(_node);
+            }
+            _node = nullptr;
+        }
+    }
+#endif
+
 // ----------------------------------------------------------------------------
 // Silent Dependent Async
 // ----------------------------------------------------------------------------
@@ -379,6 +504,11 @@ namespace rigel {
             if (auto s = node->_successors[i];
                     s->_join_counter.fetch_sub(1, std::memory_order_acq_rel) == 1
                     ) {
+                // successors of other groups go to their own workers
+                if (_group_of(&worker, s) != worker._group) {
+                    _schedule(worker, s);
+                    continue;
+                }
                 if (worker._cache) {
                     _schedule(worker, worker._cache);
                 }
@@ -400,5 +530,270 @@ namespace rigel {
     }
 
 
+// ----------------------------------------------------------------------------
+// Timers
+// ----------------------------------------------------------------------------
+
+// Function: silent_async_after
+    template<typename Rep, typename Period, typename F>
+    rigel::TimerTask Executor::silent_async_after(
+            const std::chrono::duration<Rep, Period> &delay, F &&func
+    ) {
+        return _make_timer(
+                std::chrono::duration_cast<std::chrono::steady_clock::duration>(delay),
+                std::chrono::steady_clock::duration::zero(),
+                std::forward<F>(func)
+        );
+    }
+
+// Function: silent_async_at
+    template<typename Clock, typename Duration, typename F>
+    rigel::TimerTask Executor::silent_async_at(
+            const std::chrono::time_point<Clock, Duration> &time, F &&func
+    ) {
+        return silent_async_after(time - Clock::now(), std::forward<F>(func));
+    }
+
+// Function: async_after
+    template<typename Rep, typename Period, typename F>
+    auto Executor::async_after(const std::chrono::duration<Rep, Period> &delay, F &&func) {
+
+        using R = std::invoke_result_t<std::decay_t<F>>;
+
+        std::promise<R> p;
+        auto fu{p.get_future()};
+
+        auto timer = silent_async_after(
+                delay, _make_promised_async(std::move(p), std::forward<F>(func))
+        );
+
+        return std::make_pair(std::move(timer), std::move(fu));
+    }
+
+// Function: async_at
+    template<typename Clock, typename Duration, typename F>
+    auto Executor::async_at(const std::chrono::time_point<Clock, Duration> &time, F &&func) {
+        return async_after(time - Clock::now(), std::forward<F>(func));
+    }
+
+// Function: silent_async_every
+    template<typename Rep, typename Period, typename F>
+    rigel::TimerTask Executor::silent_async_every(
+            const std::chrono::duration<Rep, Period> &period, F &&func
+    ) {
+        auto p = std::chrono::duration_cast<std::chrono::steady_clock::duration>(period);
+        return _make_timer(
+                p, std::max(p, std::chrono::steady_clock::duration(1)), std::forward<F>(func)
+        );
+    }
+
+// Function: _timer_wheel
+    inline TimerWheel &Executor::_timer_wheel() {
+        std::call_once(_timers_once, [this]() {
+            _timers = std::make_unique<TimerWheel>(
+                    [this](Timer &t) { _expire_timer(t); },
+                    [this](Timer &t) { _cancel_timer(t); }
+            );
+        });
+        return *_timers;
+    }
+
+// Function: _make_timer
+// A one-shot timer counts as a topology from now on; its task takes over
+// the count when the timer expires.
+    template<typename F>
+    rigel::TimerTask Executor::_make_timer(
+            std::chrono::steady_clock::duration delay,
+            std::chrono::steady_clock::duration period,
+            F &&func
+    ) {
+
+        auto &wheel = _timer_wheel();
+
+        auto timer = std::make_shared<Timer>();
+        timer->work = std::forward<F>(func);
+
+        if (period == std::chrono::steady_clock::duration::zero()) {
+            _increment_topology();
+        }
+
+        wheel.insert(timer, delay, period);
+
+        return TimerTask(std::move(timer));
+    }
+
+// Procedure: _expire_timer
+    inline void Executor::_expire_timer(Timer &timer) {
+        if (timer.period) {
+            silent_async(timer.work);
+        } else {
+            _schedule_async_task(node_pool.animate(
+                    "", 0, nullptr, nullptr, 0,
+                    std::in_place_type_t<Node::Async>{}, std::move(timer.work)
+            ));
+        }
+    }
+
+// Procedure: _cancel_timer
+    inline void Executor::_cancel_timer(Timer &timer) {
+        if (timer.period == 0) {
+            timer.work = nullptr;
+            _decrement_topology_and_notify();
+        }
+    }
+
+#ifdef TF_HAS_ASYNC_IO
+// ----------------------------------------------------------------------------
+// Asynchronous I/O
+// ----------------------------------------------------------------------------
+
+// Function: dependent_async_read
+    template<typename... Tasks,
+            std::enable_if_t<all_same_v<AsyncTask, std::decay_t<Tasks>...>, void> *
+    >
+    auto Executor::dependent_async_read(
+            int fd, void *buf, size_t count, int64_t offset, Tasks &&... tasks
+    ) {
+        return _dependent_async_io(
+                IORequest::READ, fd, buf, count, offset, std::forward<Tasks>(tasks)...
+        );
+    }
+
+// Function: dependent_async_write
+    template<typename... Tasks,
+            std::enable_if_t<all_same_v<AsyncTask, std::decay_t<Tasks>...>, void> *
+    >
+    auto Executor::dependent_async_write(
+            int fd, const void *buf, size_t count, int64_t offset, Tasks &&... tasks
+    ) {
+        return _dependent_async_io(
+                IORequest::WRITE, fd, const_cast<void *>(buf), count, offset,
+                std::forward<Tasks>(tasks)...
+        );
+    }
+
+// Function: io_backend
+    inline IOBackend Executor::io_backend() {
+        return _io_reactor().backend();
+    }
+
+// Function: _io_reactor
+    inline IOReactor &Executor::_io_reactor() {
+        std::call_once(_io_once, [this]() {
+            auto backend = get_env(TF_IO_BACKEND) == "epoll" ? IOBackend::EPOLL : IOBackend::IO_URING;
+            _io = std::make_unique<IOReactor>([this](IORequest *r) { _complete_io(r); }, backend);
+        });
+        return *_io;
+    }
+
+// Function: _async_io
+// The request completes an async node on the reactor thread: the node is
+// never scheduled to a worker, and its work only fulfills the promise.
+    inline auto Executor::_async_io(
+            IORequest::Op op, int fd, void *buf, size_t count, int64_t offset
+    ) {
+
+        auto &reactor = _io_reactor();
+
+        _increment_topology();
+
+        std::promise<ssize_t> p;
+        auto fu{p.get_future()};
+
+        auto request = new IORequest{op, fd, buf, count, offset};
+
+        auto node = node_pool.animate(
+                "", 0, nullptr, nullptr, 0,
+                std::in_place_type_t<Node::Async>{},
+                [p = make_moc(std::move(p)), r = make_moc(std::unique_ptr<IORequest>(request))]() mutable {
+                    p.object.set_value(r.object->result);
+                }
+        );
+
+        request->data = node;
+
+#ifdef TF_HAS_COROUTINE
+        std::get_if<Node::Async>(&node->_handle)->refs.store(2, std::memory_order_relaxed);
+
+        reactor.submit(request);
+
+        return AsyncFuture<ssize_t>(std::move(fu), node);
+#else
+        reactor.submit(request);
+
+        return fu;
+#endif
+    }
+
+// Function: async_read
+    inline auto Executor::async_read(int fd, void *buf, size_t count, int64_t offset) {
+        return _async_io(IORequest::READ, fd, buf, count, offset);
+    }
+
+// Function: async_write
+    inline auto Executor::async_write(int fd, const void *buf, size_t count, int64_t offset) {
+        return _async_io(IORequest::WRITE, fd, const_cast<void *>(buf), count, offset);
+    }
+
+// Function: _dependent_async_io
+// The returned task waits for the completion of the request, which is
+// submitted by a silent dependent async task if there are dependents.
+    template<typename... Tasks>
+    auto Executor::_dependent_async_io(
+            IORequest::Op op, int fd, void *buf, size_t count, int64_t offset, Tasks &&... tasks
+    ) {
+
+        auto &reactor = _io_reactor();
+
+        _increment_topology();
+
+        std::promise<ssize_t> p;
+        auto fu{p.get_future()};
+
+        auto request = new IORequest{op, fd, buf, count, offset};
+
+        std::shared_ptr<Node> node(
+                node_pool.animate(
+                        "", 0, nullptr, nullptr, 1,
+                        std::in_place_type_t<Node::DependentAsync>{},
+                        [p = make_moc(std::move(p)), r = make_moc(std::unique_ptr<IORequest>(request))]() mutable {
+                            p.object.set_value(r.object->result);
+                        }
+                ),
+                [&](Node *ptr) { node_pool.recycle(ptr); }
+        );
+
+        request->data = node.get();
+
+        {
+            std::scoped_lock lock(_asyncs_mutex);
+            _asyncs.insert(node);
+        }
+
+        if constexpr (sizeof...(Tasks) > 0) {
+            silent_dependent_async(
+                    [&reactor, request]() { reactor.submit(request); }, std::forward<Tasks>(tasks)...
+            );
+        } else {
+            reactor.submit(request);
+        }
+
+        return std::make_pair(AsyncTask(std::move(node)), std::move(fu));
+    }
+
+// Procedure: _complete_io
+    inline void Executor::_complete_io(IORequest *request) {
+
+        auto node = static_cast<Node *>(request->data);
+
+        if (auto handle = std::get_if<Node::Async>(&node->_handle); handle) {
+            handle->work();
+            _tear_down_async(node);
+        } else if (node->_join_counter.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            _schedule_async_task(node);
+        }
+    }
+#endif
+
 }  // end of namespace rigel -----------------------------------------------------
 
@@ -0,0 +1,352 @@
+// Copyright 2023 The titan-search Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#pragma once
+
+// coroutine tasks need the C++20 language support and library header;
+// everything in this file compiles to nothing otherwise
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#define TF_HAS_COROUTINE
+#endif
+
+#ifdef TF_HAS_COROUTINE
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "rigel/taskflow/core/declarations.h"
+
+/**
+@file coroutine.h
+@brief coroutine task include file
+*/
+
+namespace rigel {
+
+// ----------------------------------------------------------------------------
+// Class Definition: CoroFramePool
+// ----------------------------------------------------------------------------
+
+/**
+@private
+
+@brief per-thread free lists of coroutine frames
+
+Frames are rounded up to 64-byte classes and cached on the thread that
+frees them, which is the worker that ran the coroutine to completion.
+Frames above 2 KiB and frames beyond the per-class cache limit go to the
+global allocator.
+*/
+class CoroFramePool {
+
+  public:
+
+  static void* allocate(size_t bytes);
+
+  static void deallocate(void* ptr, size_t bytes) noexcept;
+
+  private:
+
+  constexpr static size_t BLOCK_SIZE = 64;
+  constexpr static size_t NUM_CLASSES = 32;
+  constexpr static size_t MAX_CACHED = 256;
+
+  struct Block {
+    Block* next;
+  };
+
+  struct Cache {
+    std::array<Block*, NUM_CLASSES> heads {};
+    std::array<size_t, NUM_CLASSES> sizes {};
+    ~Cache();
+  };
+
+  static Cache& _cache();
+};
+
+// Function: _cache
+inline CoroFramePool::Cache& CoroFramePool::_cache() {
+  static thread_local Cache cache;
+  return cache;
+}
+
+// Destructor
+inline CoroFramePool::Cache::~Cache() {
+  for(auto& head : heads) {
+    while(head) {
+      auto next = head->next;
+      ::operator delete(head);
+      head = next;
+    }
+  }
+}
+
+// Function: allocate
+inline void* CoroFramePool::allocate(size_t bytes) {
+  auto c = (bytes + BLOCK_SIZE - 1) / BLOCK_SIZE;
+  if(c == 0 || c > NUM_CLASSES) {
+    return ::operator new(bytes);
+  }
+  auto& cache = _cache();
+  if(auto block = cache.heads[c-1]; block) {
+    cache.heads[c-1] = block->next;
+    cache.sizes[c-1]--;
+    return block;
+  }
+  return ::operator new(c * BLOCK_SIZE);
+}
+
+// Procedure: deallocate
+inline void CoroFramePool::deallocate(void* ptr, size_t bytes) noexcept {
+  auto c = (bytes + BLOCK_SIZE - 1) / BLOCK_SIZE;
+  if(c == 0 || c > NUM_CLASSES) {
+    ::operator delete(ptr);
+    return;
+  }
+  auto& cache = _cache();
+  if(cache.sizes[c-1] >= MAX_CACHED) {
+    ::operator delete(ptr);
+    return;
+  }
+  auto block = static_cast<Block*>(ptr);
+  block->next = cache.heads[c-1];
+  cache.heads[c-1] = block;
+  cache.sizes[c-1]++;
+}
+
+// ----------------------------------------------------------------------------
+// Class Definition: Coro
+// ----------------------------------------------------------------------------
+
+/**
+@class Coro
+
+@brief class to create a coroutine task
+
+A coroutine task is a callable that returns rigel::Coro.
+Unlike a static task, it can suspend at a @c co_await without holding its
+worker: the worker goes on with other tasks and the executor schedules
+the task again once the awaited result is available, so the remaining
+part may run on a different worker.
+The successors of a coroutine task start after its coroutine returns.
+
+@code{.cpp}
+rigel::Executor executor;
+rigel::Taskflow taskflow;
+
+taskflow.emplace([&]() -> rigel::Coro {
+  int a = co_await executor.async([](){ return 1; });
+  int b = co_await executor.async([](){ return 2; });
+  std::cout << a + b << '\n';
+});
+
+executor.run(taskflow).wait();
+@endcode
+
+Coroutine frames are allocated from a per-worker pool.
+Awaiting anything other than an rigel::AsyncFuture that suspends, such as
+@c std::suspend_always, yields: the task goes back to the queue of its
+worker. Awaitables that resume the coroutine on their own are not supported.
+An exception escaping the coroutine cancels the rest of the run, and
+the future returned by rigel::Executor::run rethrows it from @c get;
+if several coroutines of a run throw, the first exception is kept.
+An exception escaping a coroutine task launched by rigel::Executor::corun
+has no future to go to and is dropped.
+Coroutine tasks are available when the compiler supports C++20 coroutines,
+in which case @c TF_HAS_COROUTINE is defined.
+*/
+class Coro {
+
+  friend class Executor;
+  friend class Node;
+
+  public:
+
+  /**
+  @private
+  */
+  struct promise_type {
+
+    // task node of the coroutine and the executor running it, which the
+    // awaited event schedules the node to
+    Node* node {nullptr};
+    Executor* executor {nullptr};
+
+    // continuation slot of the event the coroutine suspended on, published
+    // by the worker once the resume returns
+    std::atomic<void*>* suspended_on {nullptr};
+
+    std::exception_ptr exception {nullptr};
+
+    Coro get_return_object() {
+      return Coro{std::coroutine_handle<promise_type>::from_promise(*this)};
+    }
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+
+    std::suspend_always final_suspend() noexcept { return {}; }
+
+    void return_void() noexcept {}
+
+    void unhandled_exception() noexcept {
+      exception = std::current_exception();
+    }
+
+    static void* operator new(size_t bytes) {
+      return CoroFramePool::allocate(bytes);
+    }
+
+    static void operator delete(void* ptr, size_t bytes) noexcept {
+      CoroFramePool::deallocate(ptr, bytes);
+    }
+  };
+
+  /**
+  @brief move constructor
+  */
+  Coro(Coro&& rhs) noexcept : _frame {std::exchange(rhs._frame, nullptr)} {
+  }
+
+  /**
+  @brief move assignment
+  */
+  Coro& operator = (Coro&& rhs) noexcept {
+    if(this != &rhs) {
+      if(_frame) {
+        _frame.destroy();
+      }
+      _frame = std::exchange(rhs._frame, nullptr);
+    }
+    return *this;
+  }
+
+  /**
+  @brief destroys the coroutine frame if it was never handed to an executor
+  */
+  ~Coro() {
+    if(_frame) {
+      _frame.destroy();
+    }
+  }
+
+  private:
+
+  explicit Coro(std::coroutine_handle<promise_type> frame) : _frame {frame} {
+  }
+
+  std::coroutine_handle<promise_type> _frame;
+};
+
+// ----------------------------------------------------------------------------
+// Class Definition: AsyncFuture
+// ----------------------------------------------------------------------------
+
+/**
+@class AsyncFuture
+
+@brief class to access the result of an asynchronous task
+
+rigel::Executor::async returns an rigel::AsyncFuture when coroutine tasks
+are available.
+It is a @std_future (and converts to one) that a coroutine task can also
+@c co_await: the coroutine suspends until the asynchronous task finishes
+and then resumes with its result, without blocking a worker in between.
+
+@code{.cpp}
+taskflow.emplace([&]() -> rigel::Coro {
+  auto value = co_await executor.async([](){ return 42; });
+  assert(value == 42);
+});
+@endcode
+
+Only one coroutine may await a given future.
+*/
+template <typename T>
+class AsyncFuture : public std::future<T> {
+
+  friend class Executor;
+
+  public:
+
+  /**
+  @brief default constructor
+  */
+  AsyncFuture() = default;
+
+  /**
+  @brief move constructor
+  */
+  AsyncFuture(AsyncFuture&& rhs) noexcept :
+    std::future<T> {std::move(rhs)}, _node {std::exchange(rhs._node, nullptr)} {
+  }
+
+  /**
+  @brief move assignment
+  */
+  AsyncFuture& operator = (AsyncFuture&& rhs) noexcept {
+    if(this != &rhs) {
+      _release();
+      std::future<T>::operator = (std::move(rhs));
+      _node = std::exchange(rhs._node, nullptr);
+    }
+    return *this;
+  }
+
+  /**
+  @brief destructor
+  */
+  ~AsyncFuture() {
+    _release();
+  }
+
+  /**
+  @private
+  */
+  bool await_ready() const noexcept;
+
+  /**
+  @private
+  */
+  void await_suspend(std::coroutine_handle<Coro::promise_type>) noexcept;
+
+  /**
+  @private
+  */
+  T await_resume() {
+    return this->get();
+  }
+
+  private:
+
+  AsyncFuture(std::future<T>&& fu, Node* node) :
+    std::future<T> {std::move(fu)}, _node {node} {
+  }
+
+  // the asynchronous task, kept alive until both the task and this future
+  // have released it
+  Node* _node {nullptr};
+
+  void _release() noexcept;
+};
+
+}  // end of namespace rigel -----------------------------------------------------
+
+#endif
@@ -39,6 +39,8 @@ namespace rigel {
 
     class Taskflow;
 
+    class TaskflowSnapshot;
+
     class Topology;
 
     class TopologyBase;
@@ -55,8 +57,14 @@ namespace rigel {
 
     class TFProfObserver;
 
+    class TraceObserver;
+
     class TFProfManager;
 
+    class ProfileAnalysis;
+
+    struct ObserverSnapshot;
+
     template<typename T>
     class Future;
 
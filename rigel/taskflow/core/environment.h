@@ -15,6 +15,12 @@
 #pragma once
 
 #define TF_ENABLE_PROFILER "TF_ENABLE_PROFILER"
+#define TF_ENABLE_METRICS "TF_ENABLE_METRICS"
+#define TF_ENABLE_GUEST_WAITS "TF_ENABLE_GUEST_WAITS"
+#define TF_LATENCY_SAMPLING "TF_LATENCY_SAMPLING"
+#define TF_PROFILER_FLUSH_INTERVAL "TF_PROFILER_FLUSH_INTERVAL"
+#define TF_PROFILER_FLUSH_TASKS "TF_PROFILER_FLUSH_TASKS"
+#define TF_IO_BACKEND "TF_IO_BACKEND"
 
 namespace rigel {
 
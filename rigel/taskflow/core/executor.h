@@ -18,6 +18,8 @@
 #include "rigel/taskflow/core/observer.h"
 #include "rigel/taskflow/core/taskflow.h"
 #include "rigel/taskflow/core/async_task.h"
+#include "rigel/taskflow/core/io.h"
+#include "rigel/taskflow/core/timer.h"
 
 /**
 @file executor.hpp
@@ -72,6 +74,10 @@ namespace rigel {
 
         friend class Runtime;
 
+        template<typename T>
+        friend
+        class Future;
+
     public:
 
         /**
@@ -80,6 +86,8 @@ namespace rigel {
 
         @param N number of workers (default std::thread::hardware_concurrency)
         @param wix worker interface class to alter worker (thread) behaviors
+        @param max_workers maximum number of workers Executor::resize can
+                           grow the executor to (default @c N)
 
         The constructor spawns @c N worker threads to run tasks in a
         work-stealing loop. The number of workers must be greater than zero
@@ -92,6 +100,45 @@ namespace rigel {
         */
         explicit Executor(
                 size_t N = std::thread::hardware_concurrency(),
+                std::shared_ptr<WorkerInterface> wix = nullptr,
+                size_t max_workers = 0
+        );
+
+        /**
+        @brief constructs the executor with groups of workers
+
+        @param groups worker groups to spawn, in the order of their ids
+        @param wix worker interface class to alter worker (thread) behaviors
+
+        The workers of each group take consecutive ids and are pinned to the
+        CPUs of the group, if any.
+        A worker steals tasks only from the workers and the shared queue of
+        its own group, so a group of latency-critical tasks keeps its workers
+        to itself however many tasks the other groups have.
+        The idle workers of a group that lends them (rigel::WorkerGroup::lend)
+        also run the tasks of the other groups once those have no idle worker
+        left.
+        An empty list of groups or a group without workers throws an
+        exception.
+
+        @code{.cpp}
+        rigel::Executor executor({{"rt", 2, {0, 1}}, {"batch", 6, {2, 3, 4, 5, 6, 7}}});
+
+        rigel::Taskflow batch;
+        batch.group(executor.group_id("batch"));
+        batch.for_each_index(0, 1000000, 1, [](int i){ analyze(i); });
+        executor.run(batch);
+
+        // runs on the rt workers even though the batch workers are busy
+        executor.silent_async([](){ handle_request(); });
+        @endcode
+
+        Asynchronous tasks and taskflows without a group run in the group of
+        the worker that submits them, or in the first group if they are not
+        submitted by a worker.
+        */
+        explicit Executor(
+                const std::vector<WorkerGroup> &groups,
                 std::shared_ptr<WorkerInterface> wix = nullptr
         );
 
@@ -520,11 +567,50 @@ namespace rigel {
         */
         void wait_for_all();
 
+        /**
+        @brief enables or disables guest waits
+
+        @param flag @c true to let waiting threads run tasks or @c false to
+                    block them
+
+        While guest waits are enabled, a thread that is not a worker of any
+        executor and waits on rigel::Future::wait, rigel::Future::get, or
+        rigel::Executor::wait_for_all joins the work-stealing loop as a
+        guest instead of blocking.
+        The guest borrows a temporary worker slot, steals tasks from the
+        shared queue and the workers of the group its taskflow runs in
+        (the first group for @c wait_for_all), and returns as soon as what it
+        waits for completes.
+        When nothing is left to steal, it sleeps for a short while that grows
+        up to about a millisecond, or until the wait completes.
+
+        Guest waits are disabled by default unless the environment variable
+        @c TF_ENABLE_GUEST_WAITS is set when the executor is constructed.
+
+        @code{.cpp}
+        executor.enable_guest_waits();
+        // the calling thread runs tasks of the taskflow while it waits
+        executor.run(taskflow).wait();
+        @endcode
+
+        Tasks run by a guest see rigel::Executor::this_worker_id return @c -1,
+        are not reported to observers, and push the tasks they make ready to
+        the shared queue of their group.
+
+        This member function is thread-safe.
+        */
+        void enable_guest_waits(bool flag = true) noexcept;
+
+        /**
+        @brief queries if waiting threads run tasks as guests
+        */
+        bool guest_waits_enabled() const noexcept;
+
         /**
         @brief queries the number of worker threads
 
         Each worker represents one unique thread spawned by an executor
-        upon its construction time.
+        upon its construction time or by Executor::resize.
 
         @code{.cpp}
         rigel::Executor executor(4);
@@ -533,6 +619,64 @@ namespace rigel {
         */
         size_t num_workers() const noexcept;
 
+        /**
+        @brief queries the maximum number of worker threads
+
+        The maximum is fixed at the construction of the executor and bounds
+        the number of workers Executor::resize accepts.
+        Worker ids are always in the range of @c 0 to <tt>max_workers()-1</tt>,
+        so per-worker storage, such as the timelines of an observer, is sized
+        by this number.
+        */
+        size_t max_workers() const noexcept;
+
+        /**
+        @brief queries the number of worker groups
+
+        An executor constructed without groups has a single group of all its
+        workers.
+        */
+        size_t num_groups() const noexcept;
+
+        /**
+        @brief queries the id of the worker group with the given name
+
+        The id is the position of the group in the list given to the
+        constructor, to pass to rigel::Task::group or rigel::Taskflow::group.
+        An unknown name throws an exception.
+        */
+        size_t group_id(const std::string &name) const;
+
+        /**
+        @brief changes the number of worker threads
+
+        @param N new number of workers in the range of @c 1 to max_workers()
+
+        Shrinking retires the workers with ids from @c N upward: each one
+        finishes the task at hand, hands the tasks left in its queues over to
+        the shared queue of the executor, and sleeps until the executor grows
+        again.
+        Growing wakes up retired workers first and spawns new threads only
+        for ids that have never run, so worker ids and the results of
+        Executor::this_worker_id stay valid across resizes.
+        Running taskflows and asynchronous tasks are not interrupted.
+        A number out of range throws an exception, and so does an executor
+        with more than one worker group (see rigel::WorkerGroup).
+
+        A typical use is to follow the CPU quota of a container:
+
+        @code{.cpp}
+        rigel::Executor executor(rigel::cpu_quota(), nullptr,
+                                 std::thread::hardware_concurrency());
+        auto timer = executor.silent_async_every(std::chrono::seconds(1), [&](){
+          executor.resize(rigel::cpu_quota());
+        });
+        @endcode
+
+        This member function is thread-safe and can be called from a task.
+        */
+        void resize(size_t N);
+
         /**
         @brief queries the number of running topologies at the time of this call
 
@@ -596,7 +740,9 @@ namespace rigel {
         rigel::ObserverInterface::on_entry and rigel::ObserverInterface::on_exit
         will be called before and after the execution of a task.
 
-        This member function is not thread-safe.
+        Observers can be added while tasks are running.
+        A task that has started runs to its end with the observers it started with,
+        so an observer never sees the exit of a task without its entry.
         */
         template<typename Observer, typename... ArgsT>
         std::shared_ptr<Observer> make_observer(ArgsT &&... args);
@@ -604,7 +750,10 @@ namespace rigel {
         /**
         @brief removes an observer from the executor
 
-        This member function is not thread-safe.
+        Observers can be removed while tasks are running.
+        Tasks that have started with the observer still call its
+        rigel::ObserverInterface::on_exit, and the executor keeps the observer
+        alive until they have finished.
         */
         template<typename Observer>
         void remove_observer(std::shared_ptr<Observer> observer);
@@ -614,6 +763,81 @@ namespace rigel {
         */
         size_t num_observers() const noexcept;
 
+        // --------------------------------------------------------------------------
+        // Metrics methods
+        // --------------------------------------------------------------------------
+
+        /**
+        @brief enables or disables the collection of scheduler metrics
+
+        @param flag @c true to collect metrics or @c false to stop collecting them
+
+        Metrics are disabled by default unless the environment variable
+        @c TF_ENABLE_METRICS is set when the executor is constructed.
+        While disabled, the scheduler pays only a relaxed load per event.
+        Disabling metrics keeps the counters collected so far.
+
+        This member function is thread-safe.
+        */
+        void enable_metrics(bool flag = true) noexcept;
+
+        /**
+        @brief queries if the executor collects scheduler metrics
+        */
+        bool metrics_enabled() const noexcept;
+
+        /**
+        @brief takes a snapshot of the scheduler metrics
+
+        Each worker keeps its own counters of executed tasks by type,
+        steal attempts and successes, parks and unparks, idle time,
+        queue high-water mark, and queue resizes.
+        The snapshot reads them without synchronizing with the workers
+        and thus may be slightly behind the running tasks.
+
+        @code{.cpp}
+        executor.enable_metrics();
+        executor.run(taskflow).wait();
+        executor.metrics().dump_prometheus(std::cout);
+        @endcode
+
+        This member function is thread-safe.
+        */
+        ExecutorMetrics metrics() const;
+
+        /**
+        @brief samples the ready-to-start latency of tasks
+
+        @param period sample one of every @c period tasks made ready
+                      (@c 0 disables sampling)
+
+        A sampled task is stamped when it becomes ready (i.e., when it is
+        scheduled or picked as the next task of its worker) and the time
+        until a worker starts it is recorded in a per-worker
+        rigel::LatencyHistogram of its priority.
+        The histograms are part of rigel::Executor::metrics and are merged
+        on read by rigel::ExecutorMetrics::latency.
+        Sampling costs two clock reads per sampled task and a relaxed load
+        per scheduled task otherwise.
+        The environment variable @c TF_LATENCY_SAMPLING sets the period
+        when the executor is constructed.
+
+        @code{.cpp}
+        executor.enable_latency_sampling(16);  // every 16th task
+        executor.run(taskflow).wait();
+        auto p99 = executor.metrics().latency(rigel::TaskPriority::HIGH).percentile(99);
+        @endcode
+
+        This member function is thread-safe.
+        */
+        void enable_latency_sampling(size_t period = 1) noexcept;
+
+        /**
+        @brief queries the period of ready-to-start latency sampling
+               (@c 0 if disabled)
+        */
+        size_t latency_sampling_period() const noexcept;
+
         // --------------------------------------------------------------------------
         // Async Task Methods
         // --------------------------------------------------------------------------
@@ -630,6 +854,8 @@ namespace rigel {
         The method creates an asynchronous task to run the given function
         and return a @std_future object that eventually will hold the result
         of the return value.
+        If coroutine tasks are available, the returned object is an
+        rigel::AsyncFuture, which a rigel::Coro task can @c co_await.
 
         @code{.cpp}
         std::future<int> future = executor.async([](){
@@ -720,6 +946,41 @@ namespace rigel {
         template<typename F>
         void silent_async(const std::string &name, F &&func);
 
+        /**
+        @brief runs a callable on each element of a range as independent
+               asynchronous tasks
+
+        @tparam B beginning iterator or integral type
+        @tparam E ending iterator or integral type
+        @tparam C callable type
+
+        @param first iterator to the beginning (inclusive), or first index
+        @param last iterator to the end (exclusive), or last index
+        @param func callable object to apply to each dereferenced iterator,
+                    or to each index
+
+        The call has the effect of calling Executor::silent_async with a task
+        that calls <tt>func(*it)</tt> (or <tt>func(i)</tt>) for each element
+        of the range, but much less overhead: the tasks are taken from the
+        node pool in batches, counted as running tasks at once, pushed into
+        the queue under one lock, or into the queue of the calling worker, and
+        the idle workers are woken up with a single notification.
+        Each task holds its own copy of @c func.
+
+        @code{.cpp}
+        std::vector<Request> requests = ...;
+        executor.silent_async_bulk(requests.begin(), requests.end(), [](Request& r){
+          r.process();
+        });
+        executor.silent_async_bulk(0, 100000, [](int i){ handle(i); });
+        executor.wait_for_all();
+        @endcode
+
+        This member function is thread-safe.
+        */
+        template<typename B, typename E, typename C>
+        void silent_async_bulk(B first, E last, C &&func);
+
         // --------------------------------------------------------------------------
         // Silent Dependent Async Methods
         // --------------------------------------------------------------------------
@@ -1052,67 +1313,410 @@ namespace rigel {
         >
         auto dependent_async(const std::string &name, F &&func, I first, I last);
 
-    private:
+        /**
+        @brief runs the given function asynchronously after the given delay
+
+        @tparam Rep arithmetic type of the delay
+        @tparam Period tick period of the delay
+        @tparam F callable type
+
+        @param delay time to wait before the function runs
+        @param func callable object
+
+        @return a rigel::TimerTask handle to cancel the function
+
+        The function runs as an asynchronous task once the delay has passed.
+        In the meantime no worker waits for it: the executor keeps the
+        pending timers in a timer wheel driven by its own timer thread,
+        which inserts and cancels a timer in constant time.
+        Delays are rounded up to the next millisecond.
+        A pending timer counts as a running task for Executor::wait_for_all
+        and the destructor of the executor, unless it is cancelled.
+
+        @code{.cpp}
+        auto timer = executor.silent_async_after(
+          std::chrono::milliseconds(5), [](){ printf("5 ms later\n"); }
+        );
+        @endcode
+
+        This member function is thread-safe.
+        */
+        template<typename Rep, typename Period, typename F>
+        rigel::TimerTask silent_async_after(const std::chrono::duration<Rep, Period> &delay, F &&func);
+
+        /**
+        @brief runs the given function asynchronously at the given time point
+
+        @tparam Clock clock of the time point
+        @tparam Duration duration type of the time point
+        @tparam F callable type
+
+        @param time time point at which the function runs
+        @param func callable object
+
+        @return a rigel::TimerTask handle to cancel the function
+
+        This member function is equivalent to calling
+        Executor::silent_async_after with <tt>time - Clock::now()</tt>;
+        a time point in the past runs the function right away.
+
+        This member function is thread-safe.
+        */
+        template<typename Clock, typename Duration, typename F>
+        rigel::TimerTask silent_async_at(const std::chrono::time_point<Clock, Duration> &time, F &&func);
+
+        /**
+        @brief runs the given function asynchronously after the given delay
+               and returns its result in a future
 
-        const size_t _MAX_STEALS;
+        @tparam Rep arithmetic type of the delay
+        @tparam Period tick period of the delay
+        @tparam F callable type
+
+        @param delay time to wait before the function runs
+        @param func callable object
+
+        @return a pair of a rigel::TimerTask handle and a @std_future that
+                eventually holds the result of the function
+
+        Cancelling the timer destroys the function without running it, which
+        makes the future throw @c std::future_error with
+        @c std::future_errc::broken_promise.
+
+        @code{.cpp}
+        auto [timer, fu] = executor.async_after(
+          std::chrono::milliseconds(5), [](){ return 42; }
+        );
+        assert(fu.get() == 42);
+        @endcode
+
+        This member function is thread-safe.
+        */
+        template<typename Rep, typename Period, typename F>
+        auto async_after(const std::chrono::duration<Rep, Period> &delay, F &&func);
+
+        /**
+        @brief runs the given function asynchronously at the given time point
+               and returns its result in a future
+
+        @tparam Clock clock of the time point
+        @tparam Duration duration type of the time point
+        @tparam F callable type
+
+        @param time time point at which the function runs
+        @param func callable object
+
+        @return a pair of a rigel::TimerTask handle and a @std_future that
+                eventually holds the result of the function
+
+        This member function is equivalent to calling Executor::async_after
+        with <tt>time - Clock::now()</tt>.
+
+        This member function is thread-safe.
+        */
+        template<typename Clock, typename Duration, typename F>
+        auto async_at(const std::chrono::time_point<Clock, Duration> &time, F &&func);
+
+        /**
+        @brief runs the given function asynchronously every given period
+
+        @tparam Rep arithmetic type of the period
+        @tparam Period tick period of the period
+        @tparam F callable type
+
+        @param period time between two runs of the function
+        @param func callable object, which is copied for each run
+
+        @return a rigel::TimerTask handle to stop the function
+
+        The first run starts one period after the call.
+        Each run is a separate asynchronous task, so a run that takes longer
+        than the period overlaps with the next one.
+        Unlike one-shot timers, a periodic timer does not count as a running
+        task for Executor::wait_for_all; it runs until it is cancelled or the
+        executor is destroyed.
+
+        @code{.cpp}
+        auto timer = executor.silent_async_every(
+          std::chrono::milliseconds(100), [](){ printf("tick\n"); }
+        );
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        timer.cancel();
+        @endcode
+
+        This member function is thread-safe.
+        */
+        template<typename Rep, typename Period, typename F>
+        rigel::TimerTask silent_async_every(const std::chrono::duration<Rep, Period> &period, F &&func);
+
+#ifdef TF_HAS_ASYNC_IO
+        /**
+        @brief reads from a file descriptor asynchronously
+
+        @param fd file descriptor to read from
+        @param buf buffer to store the data
+        @param count maximum number of bytes to read
+        @param offset file offset to read at, or @c -1 to read at the current
+                      file position
+
+        @return a @std_future that eventually holds what @c read(2) returns,
+                or a negated @c errno value if the read fails
+
+        The read goes to the I/O backend of the executor and does not occupy
+        a worker while it is in flight.
+        On Linux, the executor submits it to an io_uring instance when the
+        kernel supports one and otherwise falls back to an epoll reactor,
+        which can also be chosen by setting the environment variable
+        @c TF_IO_BACKEND to @c epoll.
+        The buffer must stay valid until the future is ready.
+        Like Executor::async, the returned future can be awaited in a
+        coroutine task.
+
+        @code{.cpp}
+        std::vector<char> buf(4096);
+        auto fu = executor.async_read(fd, buf.data(), buf.size(), 0);
+        ssize_t n = fu.get();  // number of bytes read
+        @endcode
+
+        This member function is thread-safe.
+        */
+        auto async_read(int fd, void *buf, size_t count, int64_t offset = -1);
+
+        /**
+        @brief writes to a file descriptor asynchronously
+
+        @param fd file descriptor to write to
+        @param buf buffer that holds the data
+        @param count number of bytes to write
+        @param offset file offset to write at, or @c -1 to write at the current
+                      file position
+
+        @return a @std_future that eventually holds what @c write(2) returns,
+                or a negated @c errno value if the write fails
+
+        The write is carried out as in Executor::async_read.
+        The buffer must stay valid until the future is ready.
+
+        This member function is thread-safe.
+        */
+        auto async_write(int fd, const void *buf, size_t count, int64_t offset = -1);
+
+        /**
+        @brief reads from a file descriptor asynchronously when the given
+               dependents finish
+
+        @tparam Tasks task types convertible to rigel::AsyncTask
+
+        @param fd file descriptor to read from
+        @param buf buffer to store the data
+        @param count maximum number of bytes to read
+        @param offset file offset to read at, or @c -1 to read at the current
+                      file position
+        @param tasks asynchronous tasks on which the read depends
+
+        @return a pair of a rigel::AsyncTask handle and a @std_future that
+                eventually holds the result of the read
+
+        The read is submitted once all the dependents finish and the returned
+        task finishes when the read completes, so the read can appear in a
+        dependency graph of asynchronous tasks.
+        The example below writes a buffer to a file, reads it back, and then
+        checks the data:
+
+        @code{.cpp}
+        auto [W, fuW] = executor.dependent_async_write(fd, in.data(), in.size(), 0);
+        auto [R, fuR] = executor.dependent_async_read(fd, out.data(), out.size(), 0, W);
+        executor.silent_dependent_async([&](){ assert(in == out); }, R);
+        executor.wait_for_all();
+        @endcode
+
+        This member function is thread-safe.
+        */
+        template<typename... Tasks,
+                std::enable_if_t<all_same_v<AsyncTask, std::decay_t<Tasks>...>, void> * = nullptr
+        >
+        auto dependent_async_read(int fd, void *buf, size_t count, int64_t offset, Tasks &&... tasks);
+
+        /**
+        @brief writes to a file descriptor asynchronously when the given
+               dependents finish
+
+        @tparam Tasks task types convertible to rigel::AsyncTask
+
+        @param fd file descriptor to write to
+        @param buf buffer that holds the data
+        @param count number of bytes to write
+        @param offset file offset to write at, or @c -1 to write at the current
+                      file position
+        @param tasks asynchronous tasks on which the write depends
+
+        @return a pair of a rigel::AsyncTask handle and a @std_future that
+                eventually holds the result of the write
+
+        The write is carried out as in Executor::dependent_async_read.
+
+        This member function is thread-safe.
+        */
+        template<typename... Tasks,
+                std::enable_if_t<all_same_v<AsyncTask, std::decay_t<Tasks>...>, void> * = nullptr
+        >
+        auto dependent_async_write(int fd, const void *buf, size_t count, int64_t offset, Tasks &&... tasks);
+
+        /**
+        @brief queries the backend that carries out asynchronous I/O
+
+        The backend is set up by the first call to this function or to one of
+        the asynchronous I/O functions.
+        */
+        IOBackend io_backend();
+#endif
+
+    private:
 
         std::condition_variable _topology_cv;
         std::mutex _taskflows_mutex;
         std::mutex _topology_mutex;
-        std::mutex _wsq_mutex;
         std::mutex _asyncs_mutex;
 
-        size_t _num_topologies{0};
+        // counted without the lock, which only orders the notification of
+        // wait_for_all after the last decrement
+        std::atomic<size_t> _num_topologies{0};
 
-        std::unordered_map<std::thread::id, size_t> _wids;
         std::vector<std::thread> _threads;
         std::vector<Worker> _workers;
         std::list<Taskflow> _taskflows;
 
         std::unordered_set<std::shared_ptr<Node>> _asyncs;
 
-        Notifier _notifier;
+        // workers with ids in [beg, end) steal from each other and from the
+        // shared queue of their group, and sleep on the notifier of the group
+        struct Group {
+
+            Group(const WorkerGroup &, size_t);
 
-        TaskQueue<Node *> _wsq;
+            std::string name;
+            std::vector<int> cpus;
+            bool lend;
+            size_t beg;
+            size_t end;
+
+            std::mutex wsq_mutex;
+            TaskQueue<Node *> wsq;
+            Notifier notifier;
+        };
+
+        // a deque keeps the groups in place as they are neither copyable nor
+        // movable
+        std::deque<Group> _groups;
+
+        // whether any group lends its workers to the others
+        bool _lending{false};
 
         std::atomic<bool> _done{0};
 
+        // workers with ids from _num_workers up to _num_spawned are retired
+        std::atomic<size_t> _num_workers;
+        std::atomic<size_t> _num_spawned{0};
+        std::mutex _resize_mutex;
+        std::condition_variable _resize_cv;
+
         std::shared_ptr<WorkerInterface> _worker_interface;
+
+        std::mutex _observers_mutex;
         std::unordered_set<std::shared_ptr<ObserverInterface>> _observers;
+        std::atomic<ObserverSnapshot *> _observer_snapshot{nullptr};
+        std::vector<std::unique_ptr<ObserverSnapshot>> _observer_snapshots;
+
+        std::atomic<bool> _metrics{false};
+        std::atomic<size_t> _latency_period{0};
+        std::atomic<size_t> _latency_tick{0};
+
+        // worker slots lent to threads that run tasks while they wait
+        std::atomic<bool> _guest_waits{false};
+        std::mutex _guests_mutex;
+        std::condition_variable _guests_cv;
+        std::deque<Worker> _guests;
+        std::vector<Worker *> _free_guests;
+        size_t _num_guests{0};
+
+        std::once_flag _timers_once;
+        std::unique_ptr<TimerWheel> _timers;
+
+#ifdef TF_HAS_ASYNC_IO
+        std::once_flag _io_once;
+        std::unique_ptr<IOReactor> _io;
+#endif
+
+        Executor(const std::vector<WorkerGroup> &, size_t, std::shared_ptr<WorkerInterface>);
+
+        static size_t _num_workers_of(const std::vector<WorkerGroup> &);
+
+        size_t _max_steals() const;
 
         Worker *_this_worker();
 
         bool _wait_for_task(Worker &, Node *&);
 
-        void _observer_prologue(Worker &, Node *);
+        ObserverSnapshot *_observer_prologue(Worker &, Node *);
+
+        void _observer_epilogue(Worker &, Node *, ObserverSnapshot *);
 
-        void _observer_epilogue(Worker &, Node *);
+        void _publish_observers();
 
-        void _spawn(size_t);
+        void _spawn(size_t, size_t);
+
+        bool _retire(Worker &);
 
         void _exploit_task(Worker &, Node *&);
 
         void _explore_task(Worker &, Node *&);
 
+        Node *_borrow_task(Worker &);
+
+        bool _has_borrowable_task(const Worker &) const;
+
+        size_t _group_of(const Worker *, const Node *) const;
+
+        void _notify(Group &);
+
+        void _notify_n(Group &, size_t);
+
         void _schedule(Worker &, Node *);
 
         void _schedule(Node *);
 
-        void _schedule(Worker &, const SmallVector<Node *> &);
+        void _schedule(Worker &, const SmallVector<Node *> &, bool = false);
 
         void _schedule(const SmallVector<Node *> &);
 
+        void _schedule_affine(Worker &, Node *);
+
+        void _stamp_ready(Worker *, Node *);
+
+        void _record_ready(Worker &, Node *);
+
         void _set_up_topology(Worker *, Topology *);
 
         void _tear_down_topology(Worker &, Topology *);
 
+        void _set_up_instance(Worker *, Topology *);
+
+        void _tear_down_instance(Worker &, Topology *);
+
+        Node *_instantiate(Topology *, size_t);
+
+        void _invoke_instance(Worker &, Node *);
+
         void _tear_down_async(Node *);
 
         void _tear_down_dependent_async(Worker &, Node *);
 
         void _tear_down_invoke(Worker &, Node *);
 
-        void _increment_topology();
+        void _increment_topology(size_t = 1);
+
+        template<typename B, typename E, typename C>
+        void _silent_async_bulk(Worker *, Node *, B, E, C &&);
 
         void _decrement_topology();
 
@@ -1138,6 +1742,12 @@ namespace rigel {
 
         void _invoke_dependent_async_task(Worker &, Node *);
 
+#ifdef TF_HAS_COROUTINE
+        bool _invoke_coroutine_task(Worker &, Node *);
+
+        void _store_exception(Node *, std::exception_ptr);
+#endif
+
         void _process_async_dependent(Node *, rigel::AsyncTask &, size_t &);
 
         void _schedule_async_task(Node *);
@@ -1145,54 +1755,226 @@ namespace rigel {
         template<typename P>
         void _corun_until(Worker &, P &&);
 
+        template<typename P, typename I>
+        void _guest_until(size_t, P &&, I &&);
+
         template<typename R, typename F>
         auto _make_promised_async(std::promise<R> &&, F &&);
-    };
 
-// Constructor
-    inline Executor::Executor(size_t N, std::shared_ptr<WorkerInterface> wix) :
-            _MAX_STEALS{((N + 1) << 1)},
-            _threads{N},
-            _workers{N},
-            _notifier{N},
-            _worker_interface{std::move(wix)} {
+        TimerWheel &_timer_wheel();
 
-        if (N == 0) {
-            TF_THROW("no cpu workers to execute taskflows");
-        }
+        template<typename F>
+        rigel::TimerTask _make_timer(std::chrono::steady_clock::duration, std::chrono::steady_clock::duration, F &&);
 
-        _spawn(N);
+        void _expire_timer(Timer &);
 
-        // instantite the default observer if requested
-        if (has_env(TF_ENABLE_PROFILER)) {
+        void _cancel_timer(Timer &);
+
+#ifdef TF_HAS_ASYNC_IO
+        IOReactor &_io_reactor();
+
+        auto _async_io(IORequest::Op, int, void *, size_t, int64_t);
+
+        template<typename... Tasks>
+        auto _dependent_async_io(IORequest::Op, int, void *, size_t, int64_t, Tasks &&...);
+
+        void _complete_io(IORequest *);
+#endif
+    };
+
+// Constructor
+    inline Executor::Group::Group(const WorkerGroup &g, size_t first) :
+            name{g.name},
+            cpus{g.cpus},
+            lend{g.lend},
+            beg{first},
+            end{first + g.num_workers},
+            notifier{g.num_workers} {
+    }
+
+// Constructor
+    inline Executor::Executor(size_t N, std::shared_ptr<WorkerInterface> wix, size_t max_workers) :
+            Executor({WorkerGroup{"", std::max(N, max_workers)}}, N, std::move(wix)) {
+    }
+
+// Constructor
+    inline Executor::Executor(const std::vector<WorkerGroup> &groups, std::shared_ptr<WorkerInterface> wix) :
+            Executor(groups, _num_workers_of(groups), std::move(wix)) {
+    }
+
+// Constructor
+// spawns the first N of the workers of the groups
+    inline Executor::Executor(
+            const std::vector<WorkerGroup> &groups, size_t N, std::shared_ptr<WorkerInterface> wix
+    ) :
+            _threads{_num_workers_of(groups)},
+            _workers{_num_workers_of(groups)},
+            _num_workers{N},
+            _worker_interface{std::move(wix)} {
+
+        if (N == 0) {
+            TF_THROW("no cpu workers to execute taskflows");
+        }
+
+        for (const auto &g: groups) {
+            if (g.num_workers == 0) {
+                TF_THROW("no workers in worker group \"", g.name, "\"");
+            }
+            _groups.emplace_back(g, _groups.empty() ? 0 : _groups.back().end);
+            _lending |= (g.lend && groups.size() > 1);
+        }
+
+        for (size_t k = 0; k < _groups.size(); ++k) {
+            for (size_t id = _groups[k].beg; id < _groups[k].end; ++id) {
+                _workers[id]._id = id;
+                _workers[id]._vtm = id;
+                _workers[id]._group = k;
+                _workers[id]._executor = this;
+                _workers[id]._waiter = &_groups[k].notifier._waiters[id - _groups[k].beg];
+                _workers[id]._thread = &_threads[id];
+            }
+        }
+
+        _spawn(0, N);
+
+        // instantite the default observer if requested
+        if (has_env(TF_ENABLE_PROFILER)) {
             TFProfManager::get()._manage(make_observer<TFProfObserver>());
         }
+
+        if (has_env(TF_ENABLE_METRICS)) {
+            enable_metrics();
+        }
+
+        if (has_env(TF_ENABLE_GUEST_WAITS)) {
+            enable_guest_waits();
+        }
+
+        if (has_env(TF_LATENCY_SAMPLING)) {
+            enable_latency_sampling(std::strtoull(get_env(TF_LATENCY_SAMPLING).c_str(), nullptr, 10));
+        }
     }
 
 // Destructor
     inline Executor::~Executor() {
 
+        // periodic timers would keep adding tasks
+        if (_timers) {
+            _timers->stop_periodic();
+        }
+
         // wait for all topologies to complete
         wait_for_all();
 
+        // a thread waiting on a future may still run as a guest after the
+        // last topology completes
+        {
+            std::unique_lock<std::mutex> lock(_guests_mutex);
+            _guests_cv.wait(lock, [&]() { return _num_guests == 0; });
+        }
+
+        // every one-shot timer has expired or been cancelled
+        _timers.reset();
+
+#ifdef TF_HAS_ASYNC_IO
+        // every request has completed; stop the reactor before the workers
+        _io.reset();
+#endif
+
         // shut down the scheduler
         _done = true;
 
-        _notifier.notify(true);
+        for (auto &g: _groups) {
+            g.notifier.notify(true);
+        }
+
+        // wake up the retired workers
+        {
+            std::lock_guard<std::mutex> lock(_resize_mutex);
+        }
+        _resize_cv.notify_all();
 
         for (auto &t: _threads) {
-            t.join();
+            if (t.joinable()) {
+                t.join();
+            }
         }
     }
 
 // Function: num_workers
     inline size_t Executor::num_workers() const noexcept {
+        return _num_workers.load(std::memory_order_relaxed);
+    }
+
+// Function: max_workers
+    inline size_t Executor::max_workers() const noexcept {
         return _workers.size();
     }
 
+// Function: num_groups
+    inline size_t Executor::num_groups() const noexcept {
+        return _groups.size();
+    }
+
+// Function: group_id
+    inline size_t Executor::group_id(const std::string &name) const {
+        size_t k = 0;
+        while (k < _groups.size() && _groups[k].name != name) {
+            ++k;
+        }
+        if (k == _groups.size()) {
+            TF_THROW("no worker group named \"", name, "\"");
+        }
+        return k;
+    }
+
+// Function: _num_workers_of
+    inline size_t Executor::_num_workers_of(const std::vector<WorkerGroup> &groups) {
+        size_t n = 0;
+        for (const auto &g: groups) {
+            n += g.num_workers;
+        }
+        return n;
+    }
+
+// Function: _max_steals
+// Failed steals before a worker backs off, scaled with the active workers
+// since resize may change their number at any time.
+    inline size_t Executor::_max_steals() const {
+        return (_num_workers.load(std::memory_order_relaxed) + 1) << 1;
+    }
+
+// Procedure: resize
+    inline void Executor::resize(size_t N) {
+
+        // retiring workers could leave a group without any
+        if (_groups.size() > 1) {
+            TF_THROW("cannot resize an executor with worker groups");
+        }
+
+        if (N == 0 || N > _workers.size()) {
+            TF_THROW("cannot resize the executor to ", N, " workers (maximum ", _workers.size(), ")");
+        }
+
+        std::lock_guard<std::mutex> lock(_resize_mutex);
+
+        auto old = _num_workers.exchange(N, std::memory_order_seq_cst);
+
+        if (N > old) {
+            if (auto spawned = _num_spawned.load(std::memory_order_relaxed); N > spawned) {
+                _spawn(spawned, N);
+            }
+            _resize_cv.notify_all();
+        }
+        // parked workers that are now retired wake up to retire
+        else if (N < old) {
+            _groups[0].notifier.notify(true);
+        }
+    }
+
 // Function: num_topologies
     inline size_t Executor::num_topologies() const {
-        return _num_topologies;
+        return _num_topologies.load(std::memory_order_relaxed);
     }
 
 // Function: num_taskflows
@@ -1202,48 +1984,50 @@ namespace rigel {
 
 // Function: _this_worker
     inline Worker *Executor::_this_worker() {
-        auto itr = _wids.find(std::this_thread::get_id());
-        return itr == _wids.end() ? nullptr : &_workers[itr->second];
+        auto w = this_worker().worker;
+        return w && w->_executor == this ? w : nullptr;
     }
 
 // Function: this_worker_id
     inline int Executor::this_worker_id() const {
-        auto i = _wids.find(std::this_thread::get_id());
-        return i == _wids.end() ? -1 : static_cast<int>(_workers[i->second]._id);
+        auto w = this_worker().worker;
+        return w && w->_executor == this && !w->_guest ? static_cast<int>(w->_id) : -1;
     }
 
 // Procedure: _spawn
-    inline void Executor::_spawn(size_t N) {
+// spawns the workers with ids in [first, last)
+    inline void Executor::_spawn(size_t first, size_t last) {
 
         std::mutex mutex;
         std::condition_variable cond;
         size_t n = 0;
 
-        for (size_t id = 0; id < N; ++id) {
+        // workers can be victims once they are spawned
+        _num_spawned.store(last, std::memory_order_release);
 
-            _workers[id]._id = id;
-            _workers[id]._vtm = id;
-            _workers[id]._executor = this;
-            _workers[id]._waiter = &_notifier._waiters[id];
+        for (size_t id = first; id < last; ++id) {
 
             _threads[id] = std::thread([this](
-                    Worker &w, std::mutex &mutex, std::condition_variable &cond, size_t &n
+                    Worker &w, std::mutex &mutex, std::condition_variable &cond, size_t &n, size_t N
             ) -> void {
 
-                // assign the thread
-                w._thread = &_threads[w._id];
-
                 // enables the mapping
+                this_worker().worker = &w;
+
                 {
                     std::scoped_lock lock(mutex);
-                    _wids[std::this_thread::get_id()] = w._id;
-                    if (n++; n == num_workers()) {
+                    if (n++; n == N) {
                         cond.notify_one();
                     }
                 }
 
                 Node *t = nullptr;
 
+                // pin the worker to the CPUs of its group
+                if (auto &cpus = _groups[w._group].cpus; !cpus.empty()) {
+                    pin_this_thread(cpus);
+                }
+
                 // before entering the scheduler (work-stealing loop),
                 // call the user-specified prologue function
                 if (_worker_interface) {
@@ -1260,6 +2044,12 @@ namespace rigel {
                         // execute the tasks.
                         _exploit_task(w, t);
 
+                        // sleep while the worker is retired
+                        if (w._id >= _num_workers.load(std::memory_order_relaxed) &&
+                            _retire(w) == false) {
+                            break;
+                        }
+
                         // wait for tasks
                         if (_wait_for_task(w, t) == false) {
                             break;
@@ -1275,26 +2065,59 @@ namespace rigel {
                     _worker_interface->scheduler_epilogue(w, ptr);
                 }
 
-            }, std::ref(_workers[id]), std::ref(mutex), std::ref(cond), std::ref(n));
-
-            // POSIX-like system can use the following to affine threads to cores
-            //cpu_set_t cpuset;
-            //CPU_ZERO(&cpuset);
-            //CPU_SET(id, &cpuset);
-            //pthread_setaffinity_np(
-            //  _threads[id].native_handle(), sizeof(cpu_set_t), &cpuset
-            //);
+            }, std::ref(_workers[id]), std::ref(mutex), std::ref(cond), std::ref(n), last - first);
         }
 
         std::unique_lock<std::mutex> lock(mutex);
-        cond.wait(lock, [&]() { return n == N; });
+        cond.wait(lock, [&]() { return n == last - first; });
+    }
+
+// Function: _retire
+// Hands the queued tasks of a retired worker over to the shared queue and
+// sleeps until the worker is active again. Returns false if the executor
+// is shutting down instead.
+    inline bool Executor::_retire(Worker &w) {
+
+        auto &g = _groups[w._group];
+
+        size_t n = 0;
+        {
+            std::lock_guard<std::mutex> lock(g.wsq_mutex);
+            while (auto t = w._wsq.pop()) {
+                g.wsq.push(t, t->_priority);
+                ++n;
+            }
+            while (auto t = w._mailbox.steal()) {
+                g.wsq.push(t, t->_priority);
+                ++n;
+            }
+        }
+        g.notifier.notify_n(n);
+
+        std::unique_lock<std::mutex> lock(_resize_mutex);
+        _resize_cv.wait(lock, [&]() {
+            return _done || w._id < _num_workers.load(std::memory_order_relaxed);
+        });
+
+        w._vtm = w._id;
+
+        return !_done;
     }
 
 // Function: _corun_until
     template<typename P>
     void Executor::_corun_until(Worker &w, P &&stop_predicate) {
 
-        std::uniform_int_distribution<size_t> rdvtm(0, _workers.size() - 1);
+        auto &g = _groups[w._group];
+
+        // a group may have no spawned workers to steal from, and a guest
+        // (see _guest_until) is out of the range of victims, so it draws
+        // one more victim that stands for its own id, i.e., the shared queue
+        auto end = std::min(g.end, _num_spawned.load(std::memory_order_acquire));
+        const size_t num_victims = end > g.beg ? end - g.beg : 0;
+        const size_t num_draws = num_victims + (w._guest ? 1 : 0);
+
+        std::uniform_int_distribution<size_t> rdvtm(0, num_draws ? num_draws - 1 : 0);
 
         exploit:
 
@@ -1302,23 +2125,31 @@ namespace rigel {
 
             //exploit:
 
-            if (auto t = w._wsq.pop(); t) {
+            if (auto t = w._wsq.pop(); t || (t = w._mailbox.steal())) {
                 _invoke(w, t);
             } else {
                 size_t num_steals = 0;
 
                 explore:
 
-                t = (w._id == w._vtm) ? _wsq.steal() : _workers[w._vtm]._wsq.steal();
+                t = (w._id == w._vtm) ? g.wsq.steal() : _workers[w._vtm]._wsq.steal();
+
+                if (!t && w._id != w._vtm) {
+                    t = _workers[w._vtm]._mailbox.steal();
+                }
 
                 if (t) {
                     _invoke(w, t);
                     goto exploit;
                 } else if (!stop_predicate()) {
-                    if (num_steals++ > _MAX_STEALS) {
+                    if (num_steals++ > _max_steals()) {
                         std::this_thread::yield();
                     }
-                    w._vtm = rdvtm(w._rdgen);
+                    if (auto v = num_draws ? rdvtm(w._rdgen) : num_victims; v < num_victims) {
+                        w._vtm = g.beg + v;
+                    } else {
+                        w._vtm = w._id;
+                    }
                     goto explore;
                 } else {
                     break;
@@ -1327,6 +2158,92 @@ namespace rigel {
         }
     }
 
+// Procedure: _guest_until
+// lends a worker slot of the group to the calling thread, which is not a
+// worker, and steals tasks until the predicate holds; idle(d) blocks for at
+// most d or until the predicate may hold
+    template<typename P, typename I>
+    void Executor::_guest_until(size_t group, P &&stop_predicate, I &&idle) {
+
+        Worker *w;
+        {
+            std::lock_guard<std::mutex> lock(_guests_mutex);
+            if (_free_guests.empty()) {
+                auto &guest = _guests.emplace_back();
+                guest._id = _workers.size();
+                guest._executor = this;
+                guest._thread = nullptr;
+                guest._waiter = nullptr;
+                guest._guest = true;
+                _free_guests.push_back(&guest);
+            }
+            w = _free_guests.back();
+            _free_guests.pop_back();
+            ++_num_guests;
+        }
+
+        // notified under the lock since the destructor may return as soon
+        // as the last guest leaves
+        auto release = [&]() {
+            this_worker().worker = nullptr;
+            std::lock_guard<std::mutex> lock(_guests_mutex);
+            _free_guests.push_back(w);
+            if (--_num_guests == 0) {
+                _guests_cv.notify_all();
+            }
+        };
+
+        w->_group = group < _groups.size() ? group : 0;
+        w->_vtm = w->_id;
+
+        auto &g = _groups[w->_group];
+
+        // a group without spawned workers (e.g., all of them not yet spawned
+        // after a resize) leaves only its shared queue to steal from
+        auto end = std::min(g.end, _num_spawned.load(std::memory_order_acquire));
+        const bool has_victims = end > g.beg;
+
+        std::uniform_int_distribution<size_t> rdvtm(g.beg, has_victims ? end - 1 : g.beg);
+
+        constexpr std::chrono::microseconds min_idle{16};
+        constexpr std::chrono::microseconds max_idle{1024};
+
+        auto backoff = min_idle;
+        size_t num_steals = 0;
+
+        this_worker().worker = w;
+
+        try {
+            while (!stop_predicate()) {
+
+                // the first attempt goes to the shared queue of the group
+                auto t = (w->_id == w->_vtm) ? g.wsq.steal() : _workers[w->_vtm]._wsq.steal();
+
+                if (!t && w->_id != w->_vtm) {
+                    t = _workers[w->_vtm]._mailbox.steal();
+                }
+
+                w->_vtm = has_victims ? rdvtm(w->_rdgen) : w->_id;
+
+                if (t) {
+                    _invoke(*w, t);
+                    num_steals = 0;
+                    backoff = min_idle;
+                } else if (num_steals++ > _max_steals()) {
+                    idle(backoff);
+                    num_steals = 0;
+                    backoff = std::min(backoff * 2, max_idle);
+                    w->_vtm = w->_id;
+                }
+            }
+        } catch (...) {
+            release();
+            throw;
+        }
+
+        release();
+    }
+
 // Function: _explore_task
     inline void Executor::_explore_task(Worker &w, Node *&t) {
 
@@ -1336,18 +2253,38 @@ namespace rigel {
         size_t num_steals = 0;
         size_t num_yields = 0;
 
-        std::uniform_int_distribution<size_t> rdvtm(0, _workers.size() - 1);
+        auto &g = _groups[w._group];
+
+        // victims are the spawned workers of the group
+        std::uniform_int_distribution<size_t> rdvtm(
+                g.beg, std::min(g.end, _num_spawned.load(std::memory_order_acquire)) - 1
+        );
 
         // Here, we write do-while to make the worker steal at once
         // from the assigned victim.
         do {
-            t = (w._id == w._vtm) ? _wsq.steal() : _workers[w._vtm]._wsq.steal();
+            t = (w._id == w._vtm) ? g.wsq.steal() : _workers[w._vtm]._wsq.steal();
+
+            if (!t) {
+                t = _workers[w._vtm]._mailbox.steal();
+            }
+
+            if (_metrics.load(std::memory_order_relaxed)) {
+                WorkerCounters::add(w._counters.steal_attempts);
+                if (t) {
+                    WorkerCounters::add(w._counters.steals);
+                }
+            }
 
             if (t) {
                 break;
             }
 
-            if (num_steals++ > _MAX_STEALS) {
+            if (num_steals++ > _max_steals()) {
+                // nothing left in the group; help the other groups if lent
+                if (g.lend && (t = _borrow_task(w))) {
+                    break;
+                }
                 std::this_thread::yield();
                 if (num_yields++ > 100) {
                     break;
@@ -1359,17 +2296,76 @@ namespace rigel {
 
     }
 
+// Function: _borrow_task
+// steals a task of another group for an idle worker of a lending group,
+// starting from a random victim of each group
+    inline Node *Executor::_borrow_task(Worker &w) {
+
+        auto num_spawned = _num_spawned.load(std::memory_order_acquire);
+
+        for (size_t k = 1; k < _groups.size(); ++k) {
+
+            auto &g = _groups[(w._group + k) % _groups.size()];
+
+            if (auto t = g.wsq.steal()) {
+                return t;
+            }
+
+            auto end = std::min(g.end, num_spawned);
+            if (g.beg >= end) {
+                continue;
+            }
+
+            for (size_t i = 0, n = end - g.beg, vtm = w._rdgen() % n; i < n; ++i) {
+                if (auto t = _workers[g.beg + (vtm + i) % n]._wsq.steal()) {
+                    return t;
+                }
+            }
+        }
+
+        return nullptr;
+    }
+
+// Function: _has_borrowable_task
+    inline bool Executor::_has_borrowable_task(const Worker &w) const {
+
+        auto num_spawned = _num_spawned.load(std::memory_order_acquire);
+
+        for (size_t k = 0; k < _groups.size(); ++k) {
+
+            if (k == w._group) {
+                continue;
+            }
+
+            if (!_groups[k].wsq.empty()) {
+                return true;
+            }
+
+            for (size_t vtm = _groups[k].beg, end = std::min(_groups[k].end, num_spawned); vtm < end; ++vtm) {
+                if (!_workers[vtm]._wsq.empty()) {
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    }
+
 // Procedure: _exploit_task
     inline void Executor::_exploit_task(Worker &w, Node *&t) {
         while (t) {
             _invoke(w, t);
-            t = w._wsq.pop();
+            if (t = w._wsq.pop(); !t) {
+                t = w._mailbox.steal();
+            }
         }
     }
 
 // Function: _wait_for_task
     inline bool Executor::_wait_for_task(Worker &worker, Node *&t) {
 
+        auto &g = _groups[worker._group];
+
         explore_task:
 
         _explore_task(worker, t);
@@ -1377,37 +2373,76 @@ namespace rigel {
         // The last thief who successfully stole a task will wake up
         // another thief worker to avoid starvation.
         if (t) {
-            _notifier.notify(false);
+            g.notifier.notify(false);
             return true;
         }
 
         // ---- 2PC guard ----
-        _notifier.prepare_wait(worker._waiter);
+        g.notifier.prepare_wait(worker._waiter);
 
-        if (!_wsq.empty()) {
-            _notifier.cancel_wait(worker._waiter);
+        if (!g.wsq.empty()) {
+            g.notifier.cancel_wait(worker._waiter);
             worker._vtm = worker._id;
             goto explore_task;
         }
 
         if (_done) {
-            _notifier.cancel_wait(worker._waiter);
-            _notifier.notify(true);
+            g.notifier.cancel_wait(worker._waiter);
+            g.notifier.notify(true);
             return false;
         }
 
+        // retire before parking; resize notifies after shrinking
+        if (worker._id >= _num_workers.load(std::memory_order_relaxed)) {
+            g.notifier.cancel_wait(worker._waiter);
+            return true;
+        }
+
         // We need to use index-based scanning to avoid data race
         // with _spawn which may initialize a worker at the same time.
-        for (size_t vtm = 0; vtm < _workers.size(); vtm++) {
-            if (!_workers[vtm]._wsq.empty()) {
-                _notifier.cancel_wait(worker._waiter);
+        for (size_t vtm = g.beg, N = std::min(g.end, _num_spawned.load(std::memory_order_acquire)); vtm < N; vtm++) {
+            if (!_workers[vtm]._wsq.empty() || !_workers[vtm]._mailbox.empty()) {
+                g.notifier.cancel_wait(worker._waiter);
                 worker._vtm = vtm;
                 goto explore_task;
             }
         }
 
+        // a lent worker keeps helping while the other groups have tasks; it
+        // is not woken up by them once it sleeps, but by _notify when they
+        // have no idle worker left
+        if (g.lend && _has_borrowable_task(worker)) {
+            g.notifier.cancel_wait(worker._waiter);
+            goto explore_task;
+        }
+
         // Now I really need to relinguish my self to others
-        _notifier.commit_wait(worker._waiter);
+        if (_metrics.load(std::memory_order_relaxed)) {
+            WorkerCounters::add(worker._counters.parks);
+            auto beg = std::chrono::steady_clock::now();
+            g.notifier.commit_wait(worker._waiter);
+            auto end = std::chrono::steady_clock::now();
+            WorkerCounters::add(worker._counters.unparks);
+            WorkerCounters::add(
+                    worker._counters.idle_ns,
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(end - beg).count()
+            );
+        } else {
+            g.notifier.commit_wait(worker._waiter);
+        }
+
+        // the notifier cannot wake the target of an affine task, which may
+        // still be asleep, so the woken worker goes to the mailboxes first,
+        // starting from its own
+        worker._vtm = worker._id;
+        if (worker._mailbox.empty()) {
+            for (size_t vtm = g.beg, N = std::min(g.end, _num_spawned.load(std::memory_order_acquire)); vtm < N; vtm++) {
+                if (!_workers[vtm]._mailbox.empty()) {
+                    worker._vtm = vtm;
+                    break;
+                }
+            }
+        }
 
         goto explore_task;
     }
@@ -1426,7 +2461,9 @@ namespace rigel {
 
         ptr->set_up(_workers.size());
 
+        std::lock_guard<std::mutex> lock(_observers_mutex);
         _observers.emplace(std::static_pointer_cast<ObserverInterface>(ptr));
+        _publish_observers();
 
         return ptr;
     }
@@ -1440,12 +2477,170 @@ namespace rigel {
                 "Observer must be derived from ObserverInterface"
         );
 
+        std::lock_guard<std::mutex> lock(_observers_mutex);
         _observers.erase(std::static_pointer_cast<ObserverInterface>(ptr));
+        _publish_observers();
     }
 
 // Function: num_observers
     inline size_t Executor::num_observers() const noexcept {
-        return _observers.size();
+        auto snapshot = _observer_snapshot.load(std::memory_order_acquire);
+        return snapshot ? snapshot->observers.size() : 0;
+    }
+
+// Procedure: enable_metrics
+    inline void Executor::enable_metrics(bool flag) noexcept {
+        _metrics.store(flag, std::memory_order_relaxed);
+    }
+
+// Function: metrics_enabled
+    inline bool Executor::metrics_enabled() const noexcept {
+        return _metrics.load(std::memory_order_relaxed);
+    }
+
+// Procedure: enable_guest_waits
+    inline void Executor::enable_guest_waits(bool flag) noexcept {
+        _guest_waits.store(flag, std::memory_order_relaxed);
+    }
+
+// Function: guest_waits_enabled
+    inline bool Executor::guest_waits_enabled() const noexcept {
+        return _guest_waits.load(std::memory_order_relaxed);
+    }
+
+// Procedure: enable_latency_sampling
+    inline void Executor::enable_latency_sampling(size_t period) noexcept {
+        _latency_period.store(period, std::memory_order_relaxed);
+    }
+
+// Function: latency_sampling_period
+    inline size_t Executor::latency_sampling_period() const noexcept {
+        return _latency_period.load(std::memory_order_relaxed);
+    }
+
+// Function: metrics
+    inline ExecutorMetrics Executor::metrics() const {
+
+        ExecutorMetrics metrics;
+        metrics._workers.resize(_workers.size());
+
+        for (size_t i = 0; i < _workers.size(); i++) {
+            const auto &c = _workers[i]._counters;
+            auto &m = metrics._workers[i];
+            m.id = i;
+            for (size_t t = 0; t < m.tasks.size(); t++) {
+                m.tasks[t] = WorkerCounters::get(c.tasks[t]);
+            }
+            m.steal_attempts = WorkerCounters::get(c.steal_attempts);
+            m.steals = WorkerCounters::get(c.steals);
+            m.parks = WorkerCounters::get(c.parks);
+            m.unparks = WorkerCounters::get(c.unparks);
+            m.idle_ns = WorkerCounters::get(c.idle_ns);
+            m.queue_high_water = WorkerCounters::get(c.queue_high_water);
+            m.queue_resizes = _workers[i]._wsq.num_resizes();
+            m.queue_size = _workers[i]._wsq.size();
+            for (unsigned p = 0; p < NUM_TASK_PRIORITIES; p++) {
+                m.latency[p] = c.latency_histogram(p);
+            }
+        }
+
+        metrics._shared_queue_size = 0;
+        for (const auto &g: _groups) {
+            metrics._shared_queue_size += g.wsq.size();
+        }
+
+        return metrics;
+    }
+
+// Procedure: _publish_observers
+// publishes a new snapshot of the observers and reclaims the old snapshots
+// no worker is protecting; the caller must hold _observers_mutex
+    inline void Executor::_publish_observers() {
+
+        ObserverSnapshot *snapshot = nullptr;
+
+        if (!_observers.empty()) {
+            auto &s = _observer_snapshots.emplace_back(std::make_unique<ObserverSnapshot>());
+            s->observers.assign(_observers.begin(), _observers.end());
+            snapshot = s.get();
+        }
+
+        _observer_snapshot.store(snapshot, std::memory_order_seq_cst);
+
+        // A worker publishes the snapshot it is about to use before checking
+        // it is still current, so a retired snapshot no worker has published
+        // can no longer be picked up. Snapshots still in use are reclaimed by
+        // a later call or with the executor.
+        auto protected_by_worker = [this](ObserverSnapshot *s) {
+            for (auto &w: _workers) {
+                if (w._observers.load(std::memory_order_seq_cst) == s) {
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        _observer_snapshots.erase(
+                std::remove_if(_observer_snapshots.begin(), _observer_snapshots.end(), [&](auto &s) {
+                    return s.get() != snapshot && !protected_by_worker(s.get());
+                }),
+                _observer_snapshots.end()
+        );
+    }
+
+// Function: _group_of
+// resolves the group a node runs in: its own, that of its topology, or that
+// of the scheduling worker; must be called before the node is released
+    inline size_t Executor::_group_of(const Worker *worker, const Node *node) const {
+
+        if (_groups.size() == 1) {
+            return 0;
+        }
+
+        auto g = node->_group;
+
+        if (g == Node::NO_GROUP && node->_topology) {
+            g = node->_topology->_group;
+        }
+
+        if (g == Node::NO_GROUP) {
+            g = worker ? worker->_group : 0;
+        }
+
+        return g < _groups.size() ? g : 0;
+    }
+
+// Procedure: _notify
+// wakes up an idle worker of the group, or of a lending group if the group
+// has none
+    inline void Executor::_notify(Group &g) {
+
+        if (g.notifier.notify(false) || !_lending) {
+            return;
+        }
+
+        for (auto &h: _groups) {
+            if (&h != &g && h.lend && h.notifier.notify(false)) {
+                return;
+            }
+        }
+    }
+
+// Procedure: _notify_n
+    inline void Executor::_notify_n(Group &g, size_t n) {
+
+        if (n == 0) {
+            return;
+        }
+
+        if (!_lending) {
+            g.notifier.notify_n(n);
+            return;
+        }
+
+        // the last node calls for a lent worker if the group has run out
+        g.notifier.notify_n(n - 1);
+        _notify(g);
     }
 
 // Procedure: _schedule
@@ -1456,23 +2651,32 @@ namespace rigel {
         // void data race.
         auto p = node->_priority;
 
+        // a guest has no queue the workers steal from
+        auto w = worker._executor == this && !worker._guest ? &worker : nullptr;
+        auto &g = _groups[_group_of(w, node)];
+
+        _stamp_ready(w, node);
+
         node->_state.fetch_or(Node::READY, std::memory_order_release);
 
-        // caller is a worker to this pool - starting at v3.5 we do not use
-        // any complicated notification mechanism as the experimental result
-        // has shown no significant advantage.
-        if (worker._executor == this) {
+        // caller is a worker of the node's group - starting at v3.5 we do not
+        // use any complicated notification mechanism as the experimental
+        // result has shown no significant advantage.
+        if (w && &_groups[w->_group] == &g) {
             worker._wsq.push(node, p);
-            _notifier.notify(false);
+            if (_metrics.load(std::memory_order_relaxed)) {
+                WorkerCounters::max(worker._counters.queue_high_water, worker._wsq.size());
+            }
+            _notify(g);
             return;
         }
 
         {
-            std::lock_guard<std::mutex> lock(_wsq_mutex);
-            _wsq.push(node, p);
+            std::lock_guard<std::mutex> lock(g.wsq_mutex);
+            g.wsq.push(node, p);
         }
 
-        _notifier.notify(false);
+        _notify(g);
     }
 
 // Procedure: _schedule
@@ -1483,18 +2687,24 @@ namespace rigel {
         // void data race.
         auto p = node->_priority;
 
+        auto &g = _groups[_group_of(nullptr, node)];
+
+        _stamp_ready(nullptr, node);
+
         node->_state.fetch_or(Node::READY, std::memory_order_release);
 
         {
-            std::lock_guard<std::mutex> lock(_wsq_mutex);
-            _wsq.push(node, p);
+            std::lock_guard<std::mutex> lock(g.wsq_mutex);
+            g.wsq.push(node, p);
         }
 
-        _notifier.notify(false);
+        _notify(g);
     }
 
 // Procedure: _schedule
-    inline void Executor::_schedule(Worker &worker, const SmallVector<Node *> &nodes) {
+    // If exploit is true, the calling worker drains its own queue right
+    // after this call, so one of the nodes needs no thief to be woken up.
+    inline void Executor::_schedule(Worker &worker, const SmallVector<Node *> &nodes, bool exploit) {
 
         // We need to cacth the node count to avoid accessing the nodes
         // vector while the parent topology is removed!
@@ -1504,32 +2714,40 @@ namespace rigel {
             return;
         }
 
-        // caller is a worker to this pool - starting at v3.5 we do not use
-        // any complicated notification mechanism as the experimental result
-        // has shown no significant advantage.
-        if (worker._executor == this) {
+        // caller is a worker to this pool - push the whole batch first and
+        // wake up the idle workers with a single notification, such that a
+        // wide fan-out costs one pass over the notifier instead of one per
+        // node (notify_n never wakes more workers than are waiting); nodes
+        // of other groups go to the shared queues of their groups
+        if (worker._executor == this && !worker._guest) {
+            size_t n = 0;
             for (size_t i = 0; i < num_nodes; ++i) {
                 // We need to fetch p before the release such that the read
                 // operation is synchronized properly with other thread to
                 // void data race.
                 auto p = nodes[i]->_priority;
+                auto &g = _groups[_group_of(&worker, nodes[i])];
+                _stamp_ready(&worker, nodes[i]);
                 nodes[i]->_state.fetch_or(Node::READY, std::memory_order_release);
-                worker._wsq.push(nodes[i], p);
-                _notifier.notify(false);
+                if (&_groups[worker._group] == &g) {
+                    worker._wsq.push(nodes[i], p);
+                    ++n;
+                } else {
+                    {
+                        std::lock_guard<std::mutex> lock(g.wsq_mutex);
+                        g.wsq.push(nodes[i], p);
+                    }
+                    _notify(g);
+                }
             }
-            return;
-        }
-
-        {
-            std::lock_guard<std::mutex> lock(_wsq_mutex);
-            for (size_t k = 0; k < num_nodes; ++k) {
-                auto p = nodes[k]->_priority;
-                nodes[k]->_state.fetch_or(Node::READY, std::memory_order_release);
-                _wsq.push(nodes[k], p);
+            if (_metrics.load(std::memory_order_relaxed)) {
+                WorkerCounters::max(worker._counters.queue_high_water, worker._wsq.size());
             }
+            _notify_n(_groups[worker._group], (exploit && n) ? n - 1 : n);
+            return;
         }
 
-        _notifier.notify_n(num_nodes);
+        _schedule(nodes);
     }
 
 // Procedure: _schedule
@@ -1542,19 +2760,84 @@ namespace rigel {
             return;
         }
 
+        // the nodes may belong to different groups
+        if (_groups.size() > 1) {
+            for (size_t k = 0; k < num_nodes; ++k) {
+                _schedule(nodes[k]);
+            }
+            return;
+        }
+
+        auto &g = _groups[0];
+
         // We need to fetch p before the release such that the read
         // operation is synchronized properly with other thread to
         // void data race.
         {
-            std::lock_guard<std::mutex> lock(_wsq_mutex);
+            std::lock_guard<std::mutex> lock(g.wsq_mutex);
             for (size_t k = 0; k < num_nodes; ++k) {
                 auto p = nodes[k]->_priority;
+                _stamp_ready(nullptr, nodes[k]);
                 nodes[k]->_state.fetch_or(Node::READY, std::memory_order_release);
-                _wsq.push(nodes[k], p);
+                g.wsq.push(nodes[k], p);
+            }
+        }
+
+        g.notifier.notify_n(num_nodes);
+    }
+
+// Procedure: _schedule_affine
+    inline void Executor::_schedule_affine(Worker &target, Node *node) {
+
+        // We need to fetch p before the release such that the read
+        // operation is synchronized properly with other thread to
+        // void data race.
+        auto p = node->_priority;
+
+        _stamp_ready(nullptr, node);
+
+        node->_state.fetch_or(Node::READY, std::memory_order_release);
+
+        {
+            std::lock_guard<std::mutex> lock(target._mailbox_mutex);
+            target._mailbox.push(node, p);
+        }
+
+        // wakes up any sleeper of the group, which looks at the mailboxes
+        // before anything else (see _wait_for_task)
+        _notify(_groups[target._group]);
+    }
+
+// Procedure: _stamp_ready
+// stamps one of every _latency_period nodes made ready; a null worker means
+// the caller is not a worker of this executor and shares an atomic tick
+    inline void Executor::_stamp_ready(Worker *worker, Node *node) {
+
+        auto period = _latency_period.load(std::memory_order_relaxed);
+
+        // a node that waited as the cached task of its worker keeps its stamp
+        if (TF_LIKELY(period == 0) || node->_ready_at) {
+            return;
+        }
+
+        if (worker) {
+            if (++worker->_counters.latency_tick < period) {
+                return;
             }
+            worker->_counters.latency_tick = 0;
+        } else if (_latency_tick.fetch_add(1, std::memory_order_relaxed) % period) {
+            return;
         }
 
-        _notifier.notify_n(num_nodes);
+        node->_ready_at = std::max(latency_clock(), uint64_t{1});
+    }
+
+// Procedure: _record_ready
+    inline void Executor::_record_ready(Worker &worker, Node *node) {
+        auto now = latency_clock();
+        auto beg = node->_ready_at;
+        node->_ready_at = 0;
+        worker._counters.record_latency(node->_priority, now > beg ? now - beg : 0);
     }
 
 // Procedure: _invoke
@@ -1565,22 +2848,49 @@ namespace rigel {
 
         begin_invoke:
 
+        if (node->_handle.index() == Node::INSTANCE) {
+            _invoke_instance(worker, node);
+            return;
+        }
+
+        if (node->_ready_at) {
+            _record_ready(worker, node);
+        }
+
         // no need to do other things if the topology is cancelled
         if (node->_is_cancelled()) {
+#ifdef TF_HAS_COROUTINE
+            // a suspended coroutine is dropped where it stopped
+            if (node->_is_suspended()) {
+                auto &frame = std::get_if<Node::Coroutine>(&node->_handle)->frame;
+                frame.destroy();
+                frame = nullptr;
+            }
+#endif
             _tear_down_invoke(worker, node);
             return;
         }
 
+        // a resumed coroutine has already acquired its semaphores and been
+        // counted in the metrics
+        const bool resumed = node->_is_suspended();
+
         // if acquiring semaphore(s) exists, acquire them first
-        if (node->_semaphores && !node->_semaphores->to_acquire.empty()) {
+        if (!resumed && node->_semaphores && !node->_semaphores->to_acquire.empty()) {
             SmallVector<Node *> nodes;
             if (!node->_acquire_all(nodes)) {
-                _schedule(worker, nodes);
+                _schedule(worker, nodes, true);
                 return;
             }
             node->_state.fetch_or(Node::ACQUIRED, std::memory_order_release);
         }
 
+        if (!resumed && _metrics.load(std::memory_order_relaxed)) {
+            WorkerCounters::add(
+                    worker._counters.tasks[static_cast<size_t>(TaskView(*node).type())]
+            );
+        }
+
         // condition task
         //int cond = -1;
         SmallVector<int> conds;
@@ -1637,6 +2947,18 @@ namespace rigel {
             }
                 break;
 
+#ifdef TF_HAS_COROUTINE
+                // coroutine task
+            case Node::COROUTINE: {
+                // a suspended coroutine is scheduled again by the event
+                // it waits for
+                if (!_invoke_coroutine_task(worker, node)) {
+                    return;
+                }
+            }
+                break;
+#endif
+
                 // monostate (placeholder)
             default:
                 break;
@@ -1664,8 +2986,11 @@ namespace rigel {
                   node->_topology->_join_counter;
 
         // Here, we want to cache the latest successor with the highest priority
+        // of the worker's group and collect the others such that they are
+        // scheduled as one batch
         worker._cache = nullptr;
         auto max_p = static_cast<unsigned>(TaskPriority::MAX);
+        SmallVector<Node *> ready;
 
         // Invoke the task based on the corresponding type
         switch (node->_handle.index()) {
@@ -1679,14 +3004,15 @@ namespace rigel {
                         // zeroing the join counter for invariant
                         s->_join_counter.store(0, std::memory_order_relaxed);
                         j.fetch_add(1, std::memory_order_relaxed);
-                        if (s->_priority <= max_p) {
+                        if (s->_priority <= max_p && _group_of(&worker, s) == worker._group) {
                             if (worker._cache) {
-                                _schedule(worker, worker._cache);
+                                ready.push_back(worker._cache);
                             }
+                            _stamp_ready(&worker, s);
                             worker._cache = s;
                             max_p = s->_priority;
                         } else {
-                            _schedule(worker, s);
+                            ready.push_back(s);
                         }
                     }
                 }
@@ -1700,14 +3026,15 @@ namespace rigel {
                     if (auto s = node->_successors[i];
                             s->_join_counter.fetch_sub(1, std::memory_order_acq_rel) == 1) {
                         j.fetch_add(1, std::memory_order_relaxed);
-                        if (s->_priority <= max_p) {
+                        if (s->_priority <= max_p && _group_of(&worker, s) == worker._group) {
                             if (worker._cache) {
-                                _schedule(worker, worker._cache);
+                                ready.push_back(worker._cache);
                             }
+                            _stamp_ready(&worker, s);
                             worker._cache = s;
                             max_p = s->_priority;
                         } else {
-                            _schedule(worker, s);
+                            ready.push_back(s);
                         }
                     }
                 }
@@ -1715,6 +3042,10 @@ namespace rigel {
                 break;
         }
 
+        // the worker keeps the cached successor for itself, so every node
+        // in the batch needs a thief
+        _schedule(worker, ready);
+
         // tear_down the invoke
         _tear_down_invoke(worker, node);
 
@@ -1742,23 +3073,66 @@ namespace rigel {
         }
     }
 
-// Procedure: _observer_prologue
-    inline void Executor::_observer_prologue(Worker &worker, Node *node) {
-        for (auto &observer: _observers) {
+// Function: _observer_prologue
+// returns the observers to notify at the exit of the task, or nullptr if
+// there is none
+    inline ObserverSnapshot *Executor::_observer_prologue(Worker &worker, Node *node) {
+
+        auto snapshot = _observer_snapshot.load(std::memory_order_acquire);
+
+        // observers index their state by the ids of the workers
+        if (TF_LIKELY(snapshot == nullptr) || worker._guest) {
+            return nullptr;
+        }
+
+        // a task nested in an observed task uses the snapshot protected by
+        // the outermost one
+        if (worker._observer_depth == 0) {
+            // protect the snapshot and make sure it is still the current one
+            while (1) {
+                worker._observers.store(snapshot, std::memory_order_seq_cst);
+                auto current = _observer_snapshot.load(std::memory_order_seq_cst);
+                if (current == snapshot) {
+                    break;
+                }
+                if (current == nullptr) {
+                    worker._observers.store(nullptr, std::memory_order_release);
+                    return nullptr;
+                }
+                snapshot = current;
+            }
+        } else {
+            snapshot = worker._observers.load(std::memory_order_relaxed);
+        }
+
+        ++worker._observer_depth;
+
+        for (auto &observer: snapshot->observers) {
             observer->on_entry(WorkerView(worker), TaskView(*node));
         }
+
+        return snapshot;
     }
 
 // Procedure: _observer_epilogue
-    inline void Executor::_observer_epilogue(Worker &worker, Node *node) {
-        for (auto &observer: _observers) {
+    inline void Executor::_observer_epilogue(Worker &worker, Node *node, ObserverSnapshot *snapshot) {
+
+        if (TF_LIKELY(snapshot == nullptr)) {
+            return;
+        }
+
+        for (auto &observer: snapshot->observers) {
             observer->on_exit(WorkerView(worker), TaskView(*node));
         }
+
+        if (--worker._observer_depth == 0) {
+            worker._observers.store(nullptr, std::memory_order_release);
+        }
     }
 
 // Procedure: _invoke_static_task
     inline void Executor::_invoke_static_task(Worker &worker, Node *node) {
-        _observer_prologue(worker, node);
+        auto observers = _observer_prologue(worker, node);
         auto &work = std::get_if<Node::Static>(&node->_handle)->work;
         switch (work.index()) {
             case 0:
@@ -1770,13 +3144,13 @@ namespace rigel {
                 std::get_if<1>(&work)->operator()(rt);
                 break;
         }
-        _observer_epilogue(worker, node);
+        _observer_epilogue(worker, node, observers);
     }
 
 // Procedure: _invoke_dynamic_task
     inline void Executor::_invoke_dynamic_task(Worker &w, Node *node) {
 
-        _observer_prologue(w, node);
+        auto observers = _observer_prologue(w, node);
 
         auto handle = std::get_if<Node::Dynamic>(&node->_handle);
 
@@ -1790,7 +3164,7 @@ namespace rigel {
             _consume_graph(w, node, handle->subgraph);
         }
 
-        _observer_epilogue(w, node);
+        _observer_epilogue(w, node, observers);
     }
 
 // Procedure: _detach_dynamic_task
@@ -1847,7 +3221,7 @@ namespace rigel {
         }
         p->_join_counter.fetch_add(src.size(), std::memory_order_relaxed);
 
-        _schedule(w, src);
+        _schedule(w, src, true);
         _corun_until(w, [p]() -> bool { return p->_join_counter.load(std::memory_order_acquire) == 0; });
     }
 
@@ -1855,7 +3229,7 @@ namespace rigel {
     inline void Executor::_invoke_condition_task(
             Worker &worker, Node *node, SmallVector<int> &conds
     ) {
-        _observer_prologue(worker, node);
+        auto observers = _observer_prologue(worker, node);
         auto &work = std::get_if<Node::Condition>(&node->_handle)->work;
         switch (work.index()) {
             case 0:
@@ -1867,14 +3241,14 @@ namespace rigel {
                 conds = {std::get_if<1>(&work)->operator()(rt)};
                 break;
         }
-        _observer_epilogue(worker, node);
+        _observer_epilogue(worker, node, observers);
     }
 
 // Procedure: _invoke_multi_condition_task
     inline void Executor::_invoke_multi_condition_task(
             Worker &worker, Node *node, SmallVector<int> &conds
     ) {
-        _observer_prologue(worker, node);
+        auto observers = _observer_prologue(worker, node);
         auto &work = std::get_if<Node::MultiCondition>(&node->_handle)->work;
         switch (work.index()) {
             case 0:
@@ -1886,31 +3260,108 @@ namespace rigel {
                 conds = std::get_if<1>(&work)->operator()(rt);
                 break;
         }
-        _observer_epilogue(worker, node);
+        _observer_epilogue(worker, node, observers);
     }
 
 // Procedure: _invoke_module_task
     inline void Executor::_invoke_module_task(Worker &w, Node *node) {
-        _observer_prologue(w, node);
+        auto observers = _observer_prologue(w, node);
         _consume_graph(
                 w, node, std::get_if<Node::Module>(&node->_handle)->graph
         );
-        _observer_epilogue(w, node);
+        _observer_epilogue(w, node, observers);
     }
 
 // Procedure: _invoke_async_task
     inline void Executor::_invoke_async_task(Worker &w, Node *node) {
-        _observer_prologue(w, node);
+        auto observers = _observer_prologue(w, node);
         std::get_if<Node::Async>(&node->_handle)->work();
-        _observer_epilogue(w, node);
+        _observer_epilogue(w, node, observers);
     }
 
 // Procedure: _invoke_dependent_async_task
     inline void Executor::_invoke_dependent_async_task(Worker &w, Node *node) {
-        _observer_prologue(w, node);
+        auto observers = _observer_prologue(w, node);
         std::get_if<Node::DependentAsync>(&node->_handle)->work();
-        _observer_epilogue(w, node);
+        _observer_epilogue(w, node, observers);
+    }
+
+#ifdef TF_HAS_COROUTINE
+// Function: _invoke_coroutine_task
+    inline bool Executor::_invoke_coroutine_task(Worker &w, Node *node) {
+
+        auto handle = std::get_if<Node::Coroutine>(&node->_handle);
+
+        if (!handle->frame) {
+            auto coro = handle->work();
+            handle->frame = std::exchange(coro._frame, nullptr);
+            handle->frame.promise().node = node;
+            handle->frame.promise().executor = this;
+        }
+
+        auto frame = handle->frame;
+        auto &promise = frame.promise();
+
+        while (true) {
+
+            auto observers = _observer_prologue(w, node);
+            frame.resume();
+            _observer_epilogue(w, node, observers);
+
+            if (frame.done()) {
+                break;
+            }
+
+            // Nobody else can resume the coroutine before its continuation
+            // is published, so the suspension is announced only after this
+            // worker is done with the node.
+            auto slot = std::exchange(promise.suspended_on, nullptr);
+
+            // suspended on something else - yield
+            if (slot == nullptr) {
+                _schedule(w, node);
+                return false;
+            }
+
+            void *expected = nullptr;
+            if (slot->compare_exchange_strong(expected, &promise,
+                                              std::memory_order_acq_rel,
+                                              std::memory_order_acquire)) {
+                return false;
+            }
+
+            // the awaited task has finished in the meantime
+        }
+
+        auto exception = std::exchange(promise.exception, nullptr);
+
+        handle->frame = nullptr;
+        frame.destroy();
+
+        // the worker carries on; the exception goes to the future of the run
+        if (exception) {
+            _store_exception(node, std::move(exception));
+        }
+
+        return true;
+    }
+
+// Procedure: _store_exception
+// Keeps the first exception of a topology and cancels the rest of the run.
+    inline void Executor::_store_exception(Node *node, std::exception_ptr exception) {
+
+        auto tpg = node->_topology;
+
+        if (tpg == nullptr || tpg->_has_exception.exchange(true, std::memory_order_relaxed)) {
+            return;
+        }
+
+        // read by the worker that tears down the topology after the join
+        // counter of the run drops to zero
+        tpg->_exception = std::move(exception);
+        tpg->_is_cancelled.store(true, std::memory_order_relaxed);
     }
+#endif
 
 // Function: run
     inline rigel::Future<void> Executor::run(Taskflow &f) {
@@ -1981,9 +3432,11 @@ namespace rigel {
         // Need to check the empty under the lock since dynamic task may
         // define detached blocks that modify the taskflow at the same time
         bool empty;
+        std::shared_ptr<const InstancePlan> plan;
         {
             std::lock_guard<std::mutex> lock(f._mutex);
             empty = f.empty();
+            plan = f._instance_plan();
         }
 
         // No need to create a real topology but returns an dummy future
@@ -1998,9 +3451,26 @@ namespace rigel {
         // create a topology for this run
         auto t = std::make_shared<Topology>(f, std::forward<P>(p), std::forward<C>(c));
 
+        // a taskflow without a group runs in that of the submitting worker
+        t->_group = f._group;
+        if (t->_group == Node::NO_GROUP) {
+            auto w = _this_worker();
+            t->_group = w ? w->_group : 0;
+        }
+        t->_executor = this;
+
         // need to create future before the topology got torn down quickly
         rigel::Future<void> future(t->_promise.get_future(), t);
 
+        // an instanced run starts at once and keeps its state to itself
+        if (plan) {
+            t->_plan = std::move(plan);
+            t->_join_counters = std::make_unique<std::atomic<size_t>[]>(t->_plan->nodes.size());
+            t->_self = t;
+            _set_up_instance(_this_worker(), t.get());
+            return future;
+        }
+
         // modifying topology needs to be protected under the lock
         {
             std::lock_guard<std::mutex> lock(f._mutex);
@@ -2056,29 +3526,41 @@ namespace rigel {
     }
 
 // Procedure: _increment_topology
-    inline void Executor::_increment_topology() {
-        std::lock_guard<std::mutex> lock(_topology_mutex);
-        ++_num_topologies;
+    inline void Executor::_increment_topology(size_t n) {
+        _num_topologies.fetch_add(n, std::memory_order_relaxed);
     }
 
 // Procedure: _decrement_topology_and_notify
     inline void Executor::_decrement_topology_and_notify() {
-        std::lock_guard<std::mutex> lock(_topology_mutex);
-        if (--_num_topologies == 0) {
+        if (_num_topologies.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard<std::mutex> lock(_topology_mutex);
             _topology_cv.notify_all();
         }
     }
 
 // Procedure: _decrement_topology
     inline void Executor::_decrement_topology() {
-        std::lock_guard<std::mutex> lock(_topology_mutex);
-        --_num_topologies;
+        _num_topologies.fetch_sub(1, std::memory_order_acq_rel);
     }
 
 // Procedure: wait_for_all
     inline void Executor::wait_for_all() {
+
+        if (_guest_waits.load(std::memory_order_relaxed) && this_worker().worker == nullptr) {
+            _guest_until(
+                    0,
+                    [this]() { return _num_topologies.load(std::memory_order_acquire) == 0; },
+                    [this](auto d) {
+                        std::unique_lock<std::mutex> lock(_topology_mutex);
+                        _topology_cv.wait_for(lock, d, [&]() {
+                            return _num_topologies.load(std::memory_order_acquire) == 0;
+                        });
+                    }
+            );
+        }
+
         std::unique_lock<std::mutex> lock(_topology_mutex);
-        _topology_cv.wait(lock, [&]() { return _num_topologies == 0; });
+        _topology_cv.wait(lock, [&]() { return _num_topologies.load(std::memory_order_acquire) == 0; });
     }
 
 // Function: _set_up_topology
@@ -2124,7 +3606,7 @@ namespace rigel {
             //assert(tpg->_join_counter == 0);
             std::lock_guard<std::mutex> lock(f._mutex);
             tpg->_join_counter.store(tpg->_sources.size(), std::memory_order_relaxed);
-            _schedule(worker, tpg->_sources);
+            _schedule(worker, tpg->_sources, true);
         }
             // case 2: the final run of this topology
         else {
@@ -2139,7 +3621,11 @@ namespace rigel {
                 //assert(tpg->_join_counter == 0);
 
                 // Set the promise
-                tpg->_promise.set_value();
+                if (tpg->_exception) {
+                    tpg->_promise.set_exception(std::move(tpg->_exception));
+                } else {
+                    tpg->_promise.set_value();
+                }
                 f._topologies.pop();
                 tpg = f._topologies.front().get();
 
@@ -2155,6 +3641,7 @@ namespace rigel {
                 // Need to back up the promise first here becuz taskflow might be
                 // destroy soon after calling get
                 auto p{std::move(tpg->_promise)};
+                auto e{std::move(tpg->_exception)};
 
                 // Back up lambda capture in case it has the topology pointer,
                 // to avoid it releasing on pop_front ahead of _mutex.unlock &
@@ -2172,7 +3659,11 @@ namespace rigel {
 
                 // We set the promise in the end in case taskflow leaves the scope.
                 // After set_value, the caller will return from wait
-                p.set_value();
+                if (e) {
+                    p.set_exception(std::move(e));
+                } else {
+                    p.set_value();
+                }
 
                 _decrement_topology_and_notify();
 
@@ -2187,6 +3678,244 @@ namespace rigel {
         }
     }
 
+// Procedure: _set_up_instance
+    inline void Executor::_set_up_instance(Worker *worker, Topology *tpg) {
+
+        auto &plan = *tpg->_plan;
+
+        for (size_t i = 0; i < plan.joins.size(); ++i) {
+            tpg->_join_counters[i].store(plan.joins[i], std::memory_order_relaxed);
+        }
+
+        SmallVector<Node *> sources;
+        for (auto i: plan.sources) {
+            sources.push_back(_instantiate(tpg, i));
+        }
+
+        tpg->_join_counter.store(sources.size(), std::memory_order_relaxed);
+
+        if (worker) {
+            _schedule(*worker, sources);
+        } else {
+            _schedule(sources);
+        }
+    }
+
+// Procedure: _tear_down_instance
+    inline void Executor::_tear_down_instance(Worker &worker, Topology *tpg) {
+
+        // case 1: we still need to run the instance again
+        if (!tpg->_is_cancelled && !tpg->_pred()) {
+            _set_up_instance(&worker, tpg);
+            return;
+        }
+
+        // case 2: the final run of this instance
+        if (tpg->_call != nullptr) {
+            tpg->_call();
+        }
+
+        // the taskflow may be destroyed as soon as the promise is set, and the
+        // topology with the last of these
+        auto p{std::move(tpg->_promise)};
+        auto e{std::move(tpg->_exception)};
+        auto c{std::move(tpg->_call)};
+        auto self{std::move(tpg->_self)};
+        auto s{tpg->_taskflow._satellite};
+
+        if (e) {
+            p.set_exception(std::move(e));
+        } else {
+            p.set_value();
+        }
+
+        _decrement_topology_and_notify();
+
+        if (s) {
+            std::scoped_lock<std::mutex> lock(_taskflows_mutex);
+            _taskflows.erase(*s);
+        }
+    }
+
+// Function: _instantiate
+// creates the node of an instanced run that stands for the node of the plan
+// at the index while it is ready or running
+    inline Node *Executor::_instantiate(Topology *tpg, size_t i) {
+        auto task = tpg->_plan->nodes[i];
+        auto node = node_pool.animate(
+                IndexedName{nullptr, 0}, task->_priority, tpg, nullptr, 0,
+                std::in_place_type_t<Node::Instance>{}, i
+        );
+        node->_group = task->_group;
+        return node;
+    }
+
+// Procedure: _invoke_instance
+// runs the task of the plan that the node stands for, counts down the join
+// counters of its successors in the topology and recycles the node
+    inline void Executor::_invoke_instance(Worker &worker, Node *node) {
+
+        begin_invoke:
+
+        auto tpg = node->_topology;
+        auto &plan = *tpg->_plan;
+        auto i = std::get_if<Node::Instance>(&node->_handle)->index;
+        auto task = plan.nodes[i];
+
+        if (node->_ready_at) {
+            _record_ready(worker, node);
+        }
+
+        // the node itself if it runs a successor next
+        Node *cache = nullptr;
+
+        // no need to do other things if the instance is cancelled
+        if (!tpg->_is_cancelled.load(std::memory_order_relaxed)) {
+
+            if (_metrics.load(std::memory_order_relaxed)) {
+                WorkerCounters::add(
+                        worker._counters.tasks[static_cast<size_t>(TaskView(*task).type())]
+                );
+            }
+
+            SmallVector<int> conds;
+
+            auto observers = _observer_prologue(worker, task);
+
+            // tasks spawned through the runtime join on the node of the run
+            switch (task->_handle.index()) {
+                case Node::STATIC: {
+                    auto &work = std::get_if<Node::Static>(&task->_handle)->work;
+                    if (work.index() == 0) {
+                        std::get_if<0>(&work)->operator()();
+                    } else {
+                        Runtime rt(*this, worker, node);
+                        std::get_if<1>(&work)->operator()(rt);
+                    }
+                }
+                    break;
+
+                case Node::CONDITION: {
+                    auto &work = std::get_if<Node::Condition>(&task->_handle)->work;
+                    if (work.index() == 0) {
+                        conds = {std::get_if<0>(&work)->operator()()};
+                    } else {
+                        Runtime rt(*this, worker, node);
+                        conds = {std::get_if<1>(&work)->operator()(rt)};
+                    }
+                }
+                    break;
+
+                case Node::MULTI_CONDITION: {
+                    auto &work = std::get_if<Node::MultiCondition>(&task->_handle)->work;
+                    if (work.index() == 0) {
+                        conds = std::get_if<0>(&work)->operator()();
+                    } else {
+                        Runtime rt(*this, worker, node);
+                        conds = std::get_if<1>(&work)->operator()(rt);
+                    }
+                }
+                    break;
+
+                default:
+                    break;
+            }
+
+            _observer_epilogue(worker, task, observers);
+
+            // the node goes back to the pool, so it must outlive the tasks
+            // that the runtime left unjoined
+            if (node->_join_counter.load(std::memory_order_acquire)) {
+                _corun_until(worker, [node]() -> bool {
+                    return node->_join_counter.load(std::memory_order_acquire) == 0;
+                });
+            }
+
+            // reset the join counter to support the cyclic control flow
+            // before any successor can run
+            tpg->_join_counters[i].fetch_add(plan.joins[i], std::memory_order_relaxed);
+
+            auto beg = plan.offsets[i];
+            auto num_successors = plan.offsets[i + 1] - beg;
+
+            SmallVector<size_t> successors;
+
+            if (task->_is_conditioner()) {
+                for (auto cond: conds) {
+                    if (cond >= 0 && static_cast<size_t>(cond) < num_successors) {
+                        auto s = plan.successors[beg + cond];
+                        // zeroing the join counter for invariant
+                        tpg->_join_counters[s].store(0, std::memory_order_relaxed);
+                        successors.push_back(s);
+                    }
+                }
+            } else {
+                for (size_t k = 0; k < num_successors; ++k) {
+                    auto s = plan.successors[beg + k];
+                    if (tpg->_join_counters[s].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                        successors.push_back(s);
+                    }
+                }
+            }
+
+            tpg->_join_counter.fetch_add(successors.size(), std::memory_order_relaxed);
+
+            // a successor runs in its own group or in that of the instance
+            auto group_of = [&](const Node *n) -> size_t {
+                if (_groups.size() == 1) {
+                    return 0;
+                }
+                auto g = n->_group != Node::NO_GROUP ? n->_group : tpg->_group;
+                return g < _groups.size() ? g : 0;
+            };
+
+            // as _invoke, keep the latest successor with the highest priority
+            // of the worker's group and schedule the others as one batch
+            auto max_p = static_cast<unsigned>(TaskPriority::MAX);
+            auto keep = successors.size();
+
+            for (size_t k = 0; k < successors.size(); ++k) {
+                auto n = plan.nodes[successors[k]];
+                if (n->_priority <= max_p && group_of(n) == worker._group) {
+                    keep = k;
+                    max_p = n->_priority;
+                }
+            }
+
+            SmallVector<Node *> ready;
+            for (size_t k = 0; k < successors.size(); ++k) {
+                if (k != keep) {
+                    ready.push_back(_instantiate(tpg, successors[k]));
+                }
+            }
+
+            _schedule(worker, ready);
+
+            // the node stands for the kept successor from now on, which saves
+            // a trip through the pool along a chain
+            if (keep < successors.size()) {
+                auto n = plan.nodes[successors[keep]];
+                std::get_if<Node::Instance>(&node->_handle)->index = successors[keep];
+                node->_priority = n->_priority;
+                node->_group = n->_group;
+                _stamp_ready(&worker, node);
+                cache = node;
+            }
+        }
+
+        if (cache == nullptr) {
+            node_pool.recycle(node);
+        }
+
+        if (tpg->_join_counter.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            _tear_down_instance(worker, tpg);
+        }
+
+        if (cache) {
+            goto begin_invoke;
+        }
+    }
+
 // ############################################################################
 // Forward Declaration: Subflow
 // ############################################################################
@@ -2224,6 +3953,11 @@ namespace rigel {
 // Procedure: schedule
     inline void Runtime::schedule(Task task) {
 
+        // the tasks of an instanced run are not the nodes that run them
+        if (std::holds_alternative<Node::Instance>(_parent->_handle)) {
+            TF_THROW("cannot schedule a task in an instanced run");
+        }
+
         auto node = task._node;
         // need to keep the invariant: when scheduling a task, the task must have
         // zero dependency (join counter is 0)
@@ -2262,19 +3996,38 @@ namespace rigel {
     }
 
 // Function: _silent_async
-    template<typename F>
-    void Runtime::_silent_async(Worker &w, const std::string &name, F &&f) {
+    template<typename N, typename F>
+    void Runtime::_silent_async(Worker &w, N &&name, F &&f) {
 
         _parent->_join_counter.fetch_add(1, std::memory_order_relaxed);
 
         auto node = node_pool.animate(
-                name, 0, _parent->_topology, _parent, 0,
+                std::forward<N>(name), 0, _parent->_topology, _parent, 0,
                 std::in_place_type_t<Node::Async>{}, std::forward<F>(f)
         );
 
         _executor._schedule(w, node);
     }
 
+// Function: _silent_async_on
+    template<typename N, typename F>
+    void Runtime::_silent_async_on(size_t w, N &&name, F &&f) {
+
+        if (w >= _executor.num_workers()) {
+            _silent_async(_worker, std::forward<N>(name), std::forward<F>(f));
+            return;
+        }
+
+        _parent->_join_counter.fetch_add(1, std::memory_order_relaxed);
+
+        auto node = node_pool.animate(
+                std::forward<N>(name), 0, _parent->_topology, _parent, 0,
+                std::in_place_type_t<Node::Async>{}, std::forward<F>(f)
+        );
+
+        _executor._schedule_affine(_executor._workers[w], node);
+    }
+
 // Function: silent_async
     template<typename F>
     void Runtime::silent_async(F &&f) {
@@ -2287,12 +4040,36 @@ namespace rigel {
         _silent_async(*_executor._this_worker(), name, std::forward<F>(f));
     }
 
+// Function: silent_async_bulk
+    template<typename B, typename E, typename C>
+    void Runtime::silent_async_bulk(B first, E last, C &&func) {
+        _executor._silent_async_bulk(_executor._this_worker(), _parent, first, last, std::forward<C>(func));
+    }
+
 // Function: silent_async_unchecked
     template<typename F>
     void Runtime::silent_async_unchecked(const std::string &name, F &&f) {
         _silent_async(_worker, name, std::forward<F>(f));
     }
 
+// Function: silent_async_unchecked
+    template<typename F>
+    void Runtime::silent_async_unchecked(IndexedName name, F &&f) {
+        _silent_async(_worker, name, std::forward<F>(f));
+    }
+
+// Function: silent_async_on
+    template<typename F>
+    void Runtime::silent_async_on(size_t w, const std::string &name, F &&f) {
+        _silent_async_on(w, name, std::forward<F>(f));
+    }
+
+// Function: silent_async_on
+    template<typename F>
+    void Runtime::silent_async_on(size_t w, IndexedName name, F &&f) {
+        _silent_async_on(w, name, std::forward<F>(f));
+    }
+
 // Function: _async
     template<typename F>
     auto Runtime::_async(Worker &w, const std::string &name, F &&f) {
@@ -2341,10 +4118,42 @@ namespace rigel {
         });
     }
 
-}  // end of namespace rigel -----------------------------------------------------
-
-
-
+// ############################################################################
+// Forward Declaration: Future
+// ############################################################################
 
+// Procedure: wait
+    template<typename T>
+    void Future<T>::wait() const {
+        if (auto handle = std::get_if<std::weak_ptr<Topology>>(&_handle);
+                handle && this_worker().worker == nullptr) {
+            Executor *executor = nullptr;
+            size_t group = 0;
+            if (auto tpg = handle->lock(); tpg && tpg->_executor &&
+                                           tpg->_executor->_guest_waits.load(std::memory_order_relaxed)) {
+                executor = tpg->_executor;
+                group = tpg->_group;
+            }
+            // the topology is released before helping, since the taskflow
+            // drops it as soon as the run completes
+            if (executor) {
+                executor->_guest_until(
+                        group,
+                        [this]() {
+                            return std::future<T>::wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+                        },
+                        [this](auto d) { std::future<T>::wait_for(d); }
+                );
+            }
+        }
+        std::future<T>::wait();
+    }
 
+// Function: get
+    template<typename T>
+    T Future<T>::get() {
+        wait();
+        return std::future<T>::get();
+    }
 
+}  // end of namespace rigel -----------------------------------------------------
@@ -16,6 +16,7 @@
 
 #include "rigel/taskflow/core/task.h"
 #include "rigel/taskflow/algorithm/partitioner.h"
+#include "rigel/taskflow/algorithm/index_space.h"
 
 /**
 @file flow_builder.hpp
@@ -92,6 +93,33 @@ namespace rigel {
         >
         Task emplace(C &&callable);
 
+#ifdef TF_HAS_COROUTINE
+        /**
+        @brief creates a coroutine task
+
+        @tparam C callable type constructible from std::function<rigel::Coro()>
+
+        @param callable callable to construct a coroutine task
+
+        @return a rigel::Task handle
+
+        The following example creates a coroutine task that waits for
+        an asynchronous task without blocking its worker.
+
+        @code{.cpp}
+        rigel::Task coroutine_task = taskflow.emplace([&]() -> rigel::Coro {
+          int value = co_await executor.async([](){ return 1; });
+        });
+        @endcode
+
+        Please refer to rigel::Coro for details.
+        */
+        template<typename C,
+                std::enable_if_t<is_coroutine_task_v<C>, void> * = nullptr
+        >
+        Task emplace(C &&callable);
+#endif
+
         /**
         @brief creates a condition task
 
@@ -408,6 +436,61 @@ namespace rigel {
                 B first, E last, S step, C callable, P &&part = P()
         );
 
+        /**
+        @brief constructs a tiled parallel-for task over a 2-D or 3-D index space
+
+        @tparam R index space type (rigel::IndexSpace)
+        @tparam C callable type
+        @tparam P partitioner type (default rigel::GuidedPartitioner)
+
+        @param range index space to iterate
+        @param callable callable object to apply to each tile of the index space
+        @param part partitioning algorithm to schedule parallel iterations
+
+        @return a rigel::Task handle
+
+        The task spawns asynchronous tasks that applies the callable object to
+        each tile of the index space.
+        The partitioner schedules tiles rather than indices and hands out
+        consecutive tiles in the order of the index space
+        (rigel::TileOrder::MORTON or rigel::TileOrder::ROW_MAJOR),
+        such that the chunk size of the partitioner is counted in tiles.
+        The callable receives the bounds of a tile as a rigel::IndexTile and
+        iterates the indices itself, which keeps the innermost loop contiguous
+        and vectorizable.
+        For a 2-D index space, this method is equivalent to the parallel
+        execution of the following loop:
+
+        @code{.cpp}
+        for(auto tile : tiles of range in the tile order) {
+          callable(tile);
+        }
+        @endcode
+
+        For example, the code below applies a 5-point stencil to the interior
+        of an @c H by @c W grid using 32x256 tiles:
+
+        @code{.cpp}
+        rigel::IndexSpace<2> space({1, 1}, {H-1, W-1}, {32, 256});
+        taskflow.for_each_index(space, [&](const rigel::IndexTile<2>& t){
+          for(size_t i=t.beg[0]; i<t.end[0]; i++) {
+            for(size_t j=t.beg[1]; j<t.end[1]; j++) {
+              out[i*W+j] = 0.2f*(in[i*W+j] + in[(i-1)*W+j] + in[(i+1)*W+j] +
+                                 in[i*W+j-1] + in[i*W+j+1]);
+            }
+          }
+        });
+        @endcode
+
+        The index space is templated to enable stateful range using std::reference_wrapper.
+
+        Please refer to @ref ParallelIterations for details.
+        */
+        template<typename R, typename C, typename P = GuidedPartitioner,
+                std::enable_if_t<is_index_space_v<std::decay_t<unwrap_ref_decay_t<R>>>, void> * = nullptr
+        >
+        Task for_each_index(R range, C callable, P &&part = P());
+
         // ------------------------------------------------------------------------
         // transform
         // ------------------------------------------------------------------------
@@ -1044,6 +1127,353 @@ namespace rigel {
         template<typename B, typename E, typename T, typename C, typename P>
         Task max_element(B first, E last, T &result, C comp, P &&part);
 
+        // ------------------------------------------------------------------------
+        // compaction
+        // ------------------------------------------------------------------------
+
+        /**
+        @brief constructs a task to perform STL-styled parallel copy-if algorithm
+
+        @tparam B beginning iterator type
+        @tparam E ending iterator type
+        @tparam O output iterator type
+        @tparam T resulting iterator type
+        @tparam UOP unary predicate type
+        @tparam P partitioner type
+
+        @param first start of the input range
+        @param last end of the input range
+        @param d_first start of the output range (may be the same as input range)
+        @param result resulting iterator past the last element copied to the output range
+        @param predicate unary predicate which returns @c true for the elements to copy
+        @param part partitioning algorithm (default rigel::GuidedPartitioner)
+
+        Copies the elements in the range <tt>[first, last)</tt> that satisfy
+        the given criteria to the range beginning at @c d_first,
+        preserving their relative order.
+        This method is equivalent to the parallel execution of the following loop:
+
+        @code{.cpp}
+        for (; first != last; ++first) {
+          if (predicate(*first)) {
+            *d_first++ = *first;
+          }
+        }
+        result = d_first;
+        @endcode
+
+        The predicate is applied exactly once to each element.
+        Each worker counts the selected elements of the tiles it claims and
+        writes them out right away once the number of selected elements before
+        the tile is known, so the input is traversed in one pass.
+
+        For example, the code below copies the even elements of an input range
+        of 10 elements:
+
+        @code{.cpp}
+        std::vector<int> input = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+        std::vector<int> output(input.size());
+        std::vector<int>::iterator result;
+        taskflow.copy_if(
+          input.begin(), input.end(), output.begin(), result,
+          [](int i){ return i % 2 == 0; }
+        );
+        executor.run(taskflow).wait();
+        assert(result - output.begin() == 5);
+        @endcode
+
+        Iterators are templated to enable stateful range using std::reference_wrapper.
+        */
+        template<typename B, typename E, typename O, typename T, typename UOP, typename P = GuidedPartitioner>
+        Task copy_if(B first, E last, O d_first, T &result, UOP predicate, P &&part = P());
+
+        /**
+        @brief constructs a task to perform STL-styled parallel remove-if algorithm
+
+        @tparam B beginning iterator type
+        @tparam E ending iterator type
+        @tparam T resulting iterator type
+        @tparam UOP unary predicate type
+        @tparam P partitioner type
+
+        @param first start of the input range
+        @param last end of the input range
+        @param result resulting iterator past the last kept element
+        @param predicate unary predicate which returns @c true for the elements to remove
+        @param part partitioning algorithm (default rigel::GuidedPartitioner)
+
+        Removes the elements in the range <tt>[first, last)</tt> that satisfy
+        the given criteria by moving the kept elements to the beginning of
+        the range, preserving their relative order.
+        The new end of the range is stored in @c result.
+        This method is equivalent to the parallel execution of the following loop:
+
+        @code{.cpp}
+        auto d_first = first;
+        for (; first != last; ++first) {
+          if (!predicate(*first)) {
+            *d_first++ = std::move(*first);
+          }
+        }
+        result = d_first;
+        @endcode
+
+        The kept elements are moved through a temporary buffer of
+        the size of the input range.
+
+        For example, the code below removes the odd elements from an input range:
+
+        @code{.cpp}
+        std::vector<int> input = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+        std::vector<int>::iterator result;
+        taskflow.remove_if(
+          input.begin(), input.end(), result, [](int i){ return i % 2 == 1; }
+        );
+        executor.run(taskflow).wait();
+        input.erase(result, input.end());  // input = {2, 4, 6, 8, 10}
+        @endcode
+
+        Iterators are templated to enable stateful range using std::reference_wrapper.
+        */
+        template<typename B, typename E, typename T, typename UOP, typename P = GuidedPartitioner>
+        Task remove_if(B first, E last, T &result, UOP predicate, P &&part = P());
+
+        /**
+        @brief constructs a task to perform STL-styled parallel partition algorithm
+
+        @tparam B beginning iterator type
+        @tparam E ending iterator type
+        @tparam T resulting iterator type
+        @tparam UOP unary predicate type
+        @tparam P partitioner type
+
+        @param first start of the input range
+        @param last end of the input range
+        @param result resulting iterator to the first element of the second group
+        @param predicate unary predicate which returns @c true for the elements of the first group
+        @param part partitioning algorithm (default rigel::GuidedPartitioner)
+
+        Reorders the elements in the range <tt>[first, last)</tt> such that
+        all elements satisfying the given criteria precede the others.
+        The iterator to the first element of the second group is stored in @c result.
+
+        The parallel implementation is stable and is the same as
+        rigel::FlowBuilder::stable_partition.
+
+        Iterators are templated to enable stateful range using std::reference_wrapper.
+        */
+        template<typename B, typename E, typename T, typename UOP, typename P = GuidedPartitioner>
+        Task partition(B first, E last, T &result, UOP predicate, P &&part = P());
+
+        /**
+        @brief constructs a task to perform STL-styled parallel stable-partition algorithm
+
+        @tparam B beginning iterator type
+        @tparam E ending iterator type
+        @tparam T resulting iterator type
+        @tparam UOP unary predicate type
+        @tparam P partitioner type
+
+        @param first start of the input range
+        @param last end of the input range
+        @param result resulting iterator to the first element of the second group
+        @param predicate unary predicate which returns @c true for the elements of the first group
+        @param part partitioning algorithm (default rigel::GuidedPartitioner)
+
+        Reorders the elements in the range <tt>[first, last)</tt> such that
+        all elements satisfying the given criteria precede the others,
+        preserving the relative order of the elements in each group.
+        The iterator to the first element of the second group is stored in @c result.
+
+        Both groups are placed with a single prefix over the number of
+        selected elements: the elements of the second group before a tile
+        are the elements before the tile minus the selected ones.
+        The elements are moved through a temporary buffer of
+        the size of the input range.
+
+        For example, the code below moves the even elements in front of
+        the odd elements:
+
+        @code{.cpp}
+        std::vector<int> input = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+        std::vector<int>::iterator result;
+        taskflow.stable_partition(
+          input.begin(), input.end(), result, [](int i){ return i % 2 == 0; }
+        );
+        executor.run(taskflow).wait();
+        // input = {2, 4, 6, 8, 10, 1, 3, 5, 7, 9}
+        @endcode
+
+        Iterators are templated to enable stateful range using std::reference_wrapper.
+        */
+        template<typename B, typename E, typename T, typename UOP, typename P = GuidedPartitioner>
+        Task stable_partition(B first, E last, T &result, UOP predicate, P &&part = P());
+
+        /**
+        @brief constructs a task to perform STL-styled parallel unique algorithm
+
+        @tparam B beginning iterator type
+        @tparam E ending iterator type
+        @tparam T resulting iterator type
+        @tparam C binary predicate type
+        @tparam P partitioner type
+
+        @param first start of the input range
+        @param last end of the input range
+        @param result resulting iterator past the last kept element
+        @param comp binary predicate which returns @c true if two elements are equal
+        @param part partitioning algorithm (default rigel::GuidedPartitioner)
+
+        Eliminates all except the first element from every consecutive group
+        of equivalent elements in the range <tt>[first, last)</tt>.
+        The new end of the range is stored in @c result.
+        This method is equivalent to the parallel execution of the following loop:
+
+        @code{.cpp}
+        if (first == last) {
+          return last;
+        }
+        auto d_first = first;
+        while (++first != last) {
+          if (!comp(*d_first, *first)) {
+            *++d_first = std::move(*first);
+          }
+        }
+        result = ++d_first;
+        @endcode
+
+        The kept elements are copied through a temporary buffer of
+        the size of the input range.
+
+        Iterators are templated to enable stateful range using std::reference_wrapper.
+        */
+        template<
+                typename B, typename E, typename T, typename C = std::equal_to<void>,
+                typename P = GuidedPartitioner
+        >
+        Task unique(B first, E last, T &result, C comp = C(), P &&part = P());
+
+        // ------------------------------------------------------------------------
+        // histogram
+        // ------------------------------------------------------------------------
+
+        /**
+        @brief constructs a task to perform parallel histogram algorithm
+
+        @tparam B beginning iterator type
+        @tparam E ending iterator type
+        @tparam O bin iterator type
+        @tparam K key function type
+        @tparam P partitioner type
+
+        @param first start of the input range
+        @param last end of the input range
+        @param bins start of the range of bins
+        @param num_bins number of bins
+        @param key unary function that returns the bin index of an element
+        @param part partitioning algorithm (default rigel::GuidedPartitioner)
+
+        Counts the elements in the range <tt>[first, last)</tt> by bin and adds
+        the counts to the range <tt>[bins, bins + num_bins)</tt>.
+        This method is equivalent to the parallel execution of the following loop:
+
+        @code{.cpp}
+        for (; first != last; ++first) {
+          if (size_t k = key(*first); k < num_bins) {
+            ++bins[k];
+          }
+        }
+        @endcode
+
+        Elements whose bin index is not less than @c num_bins are ignored.
+        Each worker counts the chunks it claims into private bins,
+        so no atomic operation is involved in counting,
+        and the private bins are merged in parallel by splitting the bins
+        into contiguous blocks.
+        The bin iterator must be a random-access iterator.
+
+        For example, the code below counts the elements of an input range
+        by their last digit:
+
+        @code{.cpp}
+        std::vector<int> input = {11, 21, 12, 33, 43, 53, 19};
+        std::vector<size_t> bins(10, 0);
+        taskflow.histogram(
+          input.begin(), input.end(), bins.begin(), bins.size(),
+          [](int i){ return static_cast<size_t>(i % 10); }
+        );
+        executor.run(taskflow).wait();
+        assert(bins[3] == 3);
+        @endcode
+
+        Iterators are templated to enable stateful range using std::reference_wrapper.
+        */
+        template<typename B, typename E, typename O, typename K, typename P = GuidedPartitioner>
+        Task histogram(B first, E last, O bins, size_t num_bins, K key, P &&part = P());
+
+        /**
+        @brief constructs a task to perform parallel reduction by bin
+
+        @tparam B beginning iterator type
+        @tparam E ending iterator type
+        @tparam O bin iterator type
+        @tparam K key function type
+        @tparam V value function type
+        @tparam BOP binary reducer type
+        @tparam P partitioner type
+
+        @param first start of the input range
+        @param last end of the input range
+        @param bins start of the range of bins
+        @param num_bins number of bins
+        @param key unary function that returns the bin index of an element
+        @param value unary function that returns the value of an element to reduce
+        @param bop binary operator that will be applied in unspecified order to the values of a bin
+        @param part partitioning algorithm (default rigel::GuidedPartitioner)
+
+        Reduces the values of the elements in the range <tt>[first, last)</tt>
+        by bin into the range <tt>[bins, bins + num_bins)</tt>,
+        which holds the initial value of each bin.
+        This method is equivalent to the parallel execution of the following loop:
+
+        @code{.cpp}
+        for (; first != last; ++first) {
+          if (size_t k = key(*first); k < num_bins) {
+            bins[k] = bop(bins[k], value(*first));
+          }
+        }
+        @endcode
+
+        Elements whose bin index is not less than @c num_bins are ignored.
+        The reducer must be associative and commutative.
+        A private bin of a worker holds no value until an element falls into it,
+        so the reduction does not need an identity element.
+
+        For example, the code below finds the largest value of each key:
+
+        @code{.cpp}
+        std::vector<std::pair<size_t, int>> input = {{0, 3}, {1, 5}, {0, 7}, {1, 2}};
+        std::vector<int> bins(2, std::numeric_limits<int>::min());
+        taskflow.histogram_reduce(
+          input.begin(), input.end(), bins.begin(), bins.size(),
+          [](const auto& p){ return p.first; },
+          [](const auto& p){ return p.second; },
+          [](int a, int b){ return std::max(a, b); }
+        );
+        executor.run(taskflow).wait();
+        assert(bins[0] == 7 && bins[1] == 5);
+        @endcode
+
+        Iterators are templated to enable stateful range using std::reference_wrapper.
+        */
+        template<
+                typename B, typename E, typename O, typename K, typename V, typename BOP,
+                typename P = GuidedPartitioner
+        >
+        Task histogram_reduce(
+                B first, E last, O bins, size_t num_bins, K key, V value, BOP bop, P &&part = P()
+        );
+
         // ------------------------------------------------------------------------
         // sort
         // ------------------------------------------------------------------------
@@ -1124,6 +1554,16 @@ namespace rigel {
         ));
     }
 
+#ifdef TF_HAS_COROUTINE
+// Function: emplace
+    template<typename C, std::enable_if_t<is_coroutine_task_v<C>, void> *>
+    Task FlowBuilder::emplace(C &&c) {
+        return Task(_graph._emplace_back("", 0, nullptr, nullptr, 0,
+                                         std::in_place_type_t<Node::Coroutine>{}, std::forward<C>(c)
+        ));
+    }
+#endif
+
 // Function: emplace
     template<typename C, std::enable_if_t<is_condition_task_v<C>, void> *>
     Task FlowBuilder::emplace(C &&c) {
@@ -14,6 +14,9 @@
 //
 #pragma once
 
+#include <mutex>
+#include <utility>
+
 #include "rigel/taskflow/utility/traits.h"
 #include "rigel/taskflow/utility/iterator.h"
 #include "rigel/taskflow/utility/object_pool.h"
@@ -23,6 +26,7 @@
 #include "rigel/taskflow/utility/serializer.h"
 #include "rigel/taskflow/core/error.h"
 #include "rigel/taskflow/core/declarations.h"
+#include "rigel/taskflow/core/coroutine.h"
 #include "rigel/taskflow/core/semaphore.h"
 #include "rigel/taskflow/core/environment.h"
 #include "rigel/taskflow/core/topology.h"
@@ -64,6 +68,8 @@ namespace rigel {
 
         friend class Taskflow;
 
+        friend class TaskflowSnapshot;
+
         friend class Executor;
 
     public:
@@ -117,6 +123,10 @@ namespace rigel {
 
         std::vector<Node *> _nodes;
 
+        // unique across graphs and renewed whenever a node is added or
+        // removed, so a plan of the graph can tell it is out of date
+        size_t _version{unique_id<size_t>()};
+
         void _clear();
 
         void _clear_detached();
@@ -134,6 +144,41 @@ namespace rigel {
 
 // ----------------------------------------------------------------------------
 
+/**
+@struct IndexedName
+
+@brief struct to name a task by a static prefix and an index
+
+Assigning a task an indexed name costs neither a memory allocation nor
+any formatting.
+The name is formatted into a string, e.g., @c "loop-3",
+only when it is read by an observer, a dump, or rigel::Task::name.
+The prefix must outlive the task, which string literals do.
+
+@code{.cpp}
+taskflow.emplace([&](rigel::Runtime& rt){
+  for(size_t i=0; i<4; i++) {
+    rt.silent_async_unchecked(rigel::IndexedName{"chunk-", i}, [](){});
+  }
+  rt.join();
+});
+@endcode
+*/
+struct IndexedName {
+
+  /**
+  @brief static prefix of the name
+  */
+  const char* prefix;
+
+  /**
+  @brief index appended to the prefix
+  */
+  size_t index;
+};
+
+// ----------------------------------------------------------------------------
+
 /**
 @class Runtime
 
@@ -221,6 +266,9 @@ that runs the task.
         going through the normal taskflow graph scheduling process.
         At this moment, task @c C is active because its parent taskflow is running.
         When the taskflow finishes, we will see both @c B and @c C in the output.
+
+        Scheduling a task throws an exception in a run of a taskflow
+        with instancing enabled (see rigel::Taskflow::enable_instancing).
         */
         void schedule(Task task);
 
@@ -346,6 +394,34 @@ that runs the task.
         template<typename F>
         void silent_async(const std::string &name, F &&f);
 
+        /**
+        @brief runs a callable on each element of a range as independent
+               asynchronous tasks joined by this runtime
+
+        @tparam B beginning iterator or integral type
+        @tparam E ending iterator or integral type
+        @tparam C callable type
+
+        @param first iterator to the beginning (inclusive), or first index
+        @param last iterator to the end (exclusive), or last index
+        @param func callable object to apply to each dereferenced iterator,
+                    or to each index
+
+        The tasks are submitted as with rigel::Executor::silent_async_bulk
+        and joined as with rigel::Runtime::silent_async.
+
+        @code{.cpp}
+        taskflow.emplace([&](rigel::Runtime& rt){
+          rt.silent_async_bulk(0, 1000, [&](int i){ data[i]++; });
+          rt.join();
+        });
+        @endcode
+
+        This member function is thread-safe.
+        */
+        template<typename B, typename E, typename C>
+        void silent_async_bulk(B first, E last, C &&func);
+
         /**
         @brief similar to rigel::Runtime::silent_async but the caller must be the worker of the runtime
 
@@ -368,6 +444,60 @@ that runs the task.
         template<typename F>
         void silent_async_unchecked(const std::string &name, F &&f);
 
+        /**
+        @brief similar to rigel::Runtime::silent_async_unchecked but assigns
+               the task a name formatted only when it is read
+
+        @tparam F callable type
+
+        @param name indexed name of the task
+        @param f callable
+        */
+        template<typename F>
+        void silent_async_unchecked(IndexedName name, F &&f);
+
+        /**
+        @brief similar to rigel::Runtime::silent_async_unchecked but offers the task
+               to the given worker first
+
+        @tparam F callable type
+
+        @param w id of the worker to run the task
+        @param name assigned name to the task
+        @param f callable
+
+        The task is pushed to the mailbox of worker @c w, which the worker
+        checks before stealing from others.
+        Other workers can still steal the task from the mailbox, so the task
+        is not guaranteed to run on worker @c w.
+        If @c w is not a valid worker id, the method is equivalent to
+        rigel::Runtime::silent_async_unchecked.
+        Like rigel::Runtime::silent_async_unchecked, the method can only be
+        called by the worker of this runtime.
+
+        @code{.cpp}
+        taskflow.emplace([&](rigel::Runtime& rt){
+          rt.silent_async_on(1, "my task", [](){});
+          rt.join();
+        });
+        @endcode
+        */
+        template<typename F>
+        void silent_async_on(size_t w, const std::string &name, F &&f);
+
+        /**
+        @brief similar to rigel::Runtime::silent_async_on but assigns
+               the task a name formatted only when it is read
+
+        @tparam F callable type
+
+        @param w id of the worker to run the task
+        @param name indexed name of the task
+        @param f callable
+        */
+        template<typename F>
+        void silent_async_on(size_t w, IndexedName name, F &&f);
+
         /**
         @brief co-runs the given target and waits until it completes
 
@@ -482,8 +612,14 @@ that runs the task.
         /**
         @private
         */
-        template<typename F>
-        void _silent_async(Worker &w, const std::string &name, F &&f);
+        template<typename N, typename F>
+        void _silent_async(Worker &w, N &&name, F &&f);
+
+        /**
+        @private
+        */
+        template<typename N, typename F>
+        void _silent_async_on(size_t w, N &&name, F &&f);
     };
 
 // constructor
@@ -528,6 +664,15 @@ that runs the task.
 
         friend class Runtime;
 
+        friend class TaskflowSnapshot;
+
+        friend class TraceObserver;
+
+#ifdef TF_HAS_COROUTINE
+        template<typename T>
+        friend class AsyncFuture;
+#endif
+
         enum class AsyncState : int {
             UNFINISHED = 0,
             LOCKED = 1,
@@ -542,6 +687,9 @@ that runs the task.
         constexpr static int ACQUIRED = 4;
         constexpr static int READY = 8;
 
+        // group id of a node that runs in the group of its taskflow
+        constexpr static size_t NO_GROUP = std::numeric_limits<size_t>::max();
+
         using Placeholder = std::monostate;
 
         // static work handle
@@ -603,6 +751,15 @@ that runs the task.
             Async(T &&);
 
             std::function<void()> work;
+
+#ifdef TF_HAS_COROUTINE
+            // promise of the coroutine task to resume once the task has finished,
+            // or this handle itself after it has finished
+            std::atomic<void *> continuation{nullptr};
+
+            // held by the task and by its rigel::AsyncFuture if any
+            std::atomic<int> refs{1};
+#endif
         };
 
         // silent dependent async
@@ -616,6 +773,31 @@ that runs the task.
             std::atomic<AsyncState> state{AsyncState::UNFINISHED};
         };
 
+        // node of an instanced run standing for the node of the plan at
+        // the index
+        struct Instance {
+
+            Instance(size_t);
+
+            size_t index;
+        };
+
+#ifdef TF_HAS_COROUTINE
+        // coroutine work handle
+        struct Coroutine {
+
+            template<typename C>
+            Coroutine(C &&);
+
+            ~Coroutine();
+
+            std::function<Coro()> work;
+
+            // frame of the running coroutine, null between runs
+            std::coroutine_handle<Coro::promise_type> frame;
+        };
+#endif
+
         using handle_t = std::variant<
                 Placeholder,      // placeholder
                 Static,           // static tasking
@@ -624,7 +806,11 @@ that runs the task.
                 MultiCondition,   // multi-conditional tasking
                 Module,           // composable tasking
                 Async,            // async tasking
-                DependentAsync    // dependent async tasking (no future)
+                DependentAsync,   // dependent async tasking (no future)
+                Instance          // node of an instanced run
+#ifdef TF_HAS_COROUTINE
+                , Coroutine       // coroutine tasking
+#endif
         >;
 
         struct Semaphores {
@@ -643,12 +829,19 @@ that runs the task.
         constexpr static auto MODULE = get_index_v<Module, handle_t>;
         constexpr static auto ASYNC = get_index_v<Async, handle_t>;
         constexpr static auto DEPENDENT_ASYNC = get_index_v<DependentAsync, handle_t>;
+        constexpr static auto INSTANCE = get_index_v<Instance, handle_t>;
+#ifdef TF_HAS_COROUTINE
+        constexpr static auto COROUTINE = get_index_v<Coroutine, handle_t>;
+#endif
 
         Node() = default;
 
         template<typename... Args>
         Node(const std::string &, unsigned, Topology *, Node *, size_t, Args &&... args);
 
+        template<typename... Args>
+        Node(IndexedName, unsigned, Topology *, Node *, size_t, Args &&... args);
+
         ~Node();
 
         size_t num_successors() const;
@@ -663,10 +856,22 @@ that runs the task.
 
     private:
 
-        std::string _name;
+        // formatted lazily from the indexed name if its prefix is set;
+        // observers on different workers may read the name concurrently
+        mutable std::string _name;
+
+        IndexedName _indexed_name{nullptr, 0};
+
+        mutable std::once_flag _name_formatted;
 
         unsigned _priority{0};
 
+        size_t _group{NO_GROUP};
+
+        // time (rigel::latency_clock) the node became ready if it is sampled
+        // for ready-to-start latency, or zero
+        uint64_t _ready_at{0};
+
         Topology *_topology{nullptr};
         Node *_parent{nullptr};
 
@@ -690,6 +895,8 @@ that runs the task.
 
         bool _is_conditioner() const;
 
+        bool _is_suspended() const;
+
         bool _acquire_all(SmallVector<Node *> &);
 
         SmallVector<Node *> _release_all();
@@ -767,6 +974,32 @@ that runs the task.
     Node::DependentAsync::DependentAsync(C &&c) : work{std::forward<C>(c)} {
     }
 
+// ----------------------------------------------------------------------------
+// Definition for Node::Instance
+// ----------------------------------------------------------------------------
+
+// Constructor
+    inline Node::Instance::Instance(size_t i) : index{i} {
+    }
+
+#ifdef TF_HAS_COROUTINE
+// ----------------------------------------------------------------------------
+// Definition for Node::Coroutine
+// ----------------------------------------------------------------------------
+
+// Constructor
+    template<typename C>
+    Node::Coroutine::Coroutine(C &&c) : work{std::forward<C>(c)} {
+    }
+
+// Destructor
+    inline Node::Coroutine::~Coroutine() {
+        if (frame) {
+            frame.destroy();
+        }
+    }
+#endif
+
 // ----------------------------------------------------------------------------
 // Definition for Node
 // ----------------------------------------------------------------------------
@@ -789,6 +1022,20 @@ that runs the task.
             _handle{std::forward<Args>(args)...} {
     }
 
+// Constructor
+    template<typename... Args>
+    Node::Node(
+            IndexedName name,
+            unsigned priority,
+            Topology *topology,
+            Node *parent,
+            size_t join_counter,
+            Args &&... args
+    ) :
+            Node(std::string(), priority, topology, parent, join_counter, std::forward<Args>(args)...) {
+        _indexed_name = name;
+    }
+
 //Node::Node(Args&&... args): _handle{std::forward<Args>(args)...} {
 //}
 
@@ -874,6 +1121,12 @@ that runs the task.
 
 // Function: name
     inline const std::string &Node::name() const {
+        std::call_once(_name_formatted, [this]() {
+            if (_indexed_name.prefix) {
+                _name = _indexed_name.prefix;
+                _name += std::to_string(_indexed_name.index);
+            }
+        });
         return _name;
     }
 
@@ -883,6 +1136,18 @@ that runs the task.
                _handle.index() == Node::MULTI_CONDITION;
     }
 
+// Function: _is_suspended
+// a coroutine task that has started but not yet finished is resumed rather
+// than invoked from the beginning
+    inline bool Node::_is_suspended() const {
+#ifdef TF_HAS_COROUTINE
+        if (_handle.index() == Node::COROUTINE) {
+            return static_cast<bool>(std::get_if<Coroutine>(&_handle)->frame);
+        }
+#endif
+        return false;
+    }
+
 // Function: _is_cancelled
     inline bool Node::_is_cancelled() const {
         return _topology && _topology->_is_cancelled.load(std::memory_order_relaxed);
@@ -958,13 +1223,15 @@ that runs the task.
 
 // Move constructor
     inline Graph::Graph(Graph &&other) :
-            _nodes{std::move(other._nodes)} {
+            _nodes{std::move(other._nodes)},
+            _version{std::exchange(other._version, unique_id<size_t>())} {
     }
 
 // Move assignment
     inline Graph &Graph::operator=(Graph &&other) {
         _clear();
         _nodes = std::move(other._nodes);
+        _version = std::exchange(other._version, unique_id<size_t>());
         return *this;
     }
 
@@ -979,6 +1246,7 @@ that runs the task.
             node_pool.recycle(node);
         }
         _nodes.clear();
+        _version = unique_id<size_t>();
     }
 
 // Procedure: clear_detached
@@ -1007,6 +1275,7 @@ that runs the task.
         if (auto I = std::find(_nodes.begin(), _nodes.end(), node); I != _nodes.end()) {
             _nodes.erase(I);
             node_pool.recycle(node);
+            _version = unique_id<size_t>();
         }
     }
 
@@ -1026,6 +1295,7 @@ that runs the task.
     template<typename ...ArgsT>
     Node *Graph::_emplace_back(ArgsT &&... args) {
         _nodes.push_back(node_pool.animate(std::forward<ArgsT>(args)...));
+        _version = unique_id<size_t>();
         return _nodes.back();
     }
 
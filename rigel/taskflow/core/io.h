@@ -0,0 +1,618 @@
+// Copyright 2023 The titan-search Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#pragma once
+
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// asynchronous I/O needs POSIX file descriptors
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#define TF_HAS_ASYNC_IO
+#endif
+
+#if defined(TF_HAS_ASYNC_IO) && defined(__linux__)
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#define TF_HAS_EPOLL
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#define TF_HAS_IO_URING
+#endif
+#endif
+
+#include "rigel/taskflow/core/error.h"
+
+/**
+@file io.h
+@brief asynchronous I/O include file
+*/
+
+#ifdef TF_HAS_ASYNC_IO
+
+namespace rigel {
+
+// ----------------------------------------------------------------------------
+// IOBackend
+// ----------------------------------------------------------------------------
+
+/**
+@enum IOBackend
+
+@brief enumeration of the mechanisms the executor uses for asynchronous I/O
+*/
+enum class IOBackend : int {
+  /** @brief requests go to an io_uring instance and complete in the kernel */
+  IO_URING = 0,
+  /** @brief a reactor thread waits on epoll for pipes and sockets and runs
+             pread/pwrite itself for regular files, one request at a time */
+  EPOLL
+};
+
+/**
+@brief convert an I/O backend to a human-readable string
+*/
+inline const char* to_string(IOBackend backend) {
+  switch(backend) {
+    case IOBackend::IO_URING: return "io_uring";
+    case IOBackend::EPOLL:    return "epoll";
+    default:                  return "undefined";
+  }
+}
+
+// ----------------------------------------------------------------------------
+// IORequest
+// ----------------------------------------------------------------------------
+
+/**
+@private
+*/
+struct IORequest {
+
+  enum Op : int {
+    READ = 0,
+    WRITE
+  };
+
+  Op op;
+  int fd;
+  void* buf;
+  size_t count;
+
+  // file offset, or -1 for the current file position
+  int64_t offset;
+
+  // what read(2)/write(2) would return, with -errno for failures
+  ssize_t result {0};
+
+  // owner of the request (the task node completed by the executor)
+  void* data {nullptr};
+};
+
+// ----------------------------------------------------------------------------
+// Class Definition: IOReactor
+// ----------------------------------------------------------------------------
+
+/**
+@private
+
+@brief class to run I/O requests off the workers of an executor
+
+The reactor owns one thread that reaps completions and passes each
+finished request to the callback given at construction.
+With io_uring, submitters write the submission queue directly and the
+thread only waits for completions; the number of requests in flight is
+bounded by the completion queue.
+With epoll, submitters hand requests to the thread through a queue: it
+runs regular-file requests with pread/pwrite and waits on epoll for the
+others (pipes, sockets) to become ready.
+Regular-file requests are therefore serialized on the reactor thread, and
+a slow disk delays the readiness of pipes and sockets as well; the epoll
+backend is a fallback for kernels without io_uring, not a thread pool.
+
+Destroying the reactor always joins its thread.
+Requests the epoll thread still waits for complete with @c -ECANCELED;
+requests handed to io_uring cannot be taken back from the kernel, which
+may still write their buffers, so they must complete before the reactor
+is destroyed (the executor waits for all its tasks first).
+*/
+class IOReactor {
+
+  public:
+
+  IOReactor(std::function<void(IORequest*)> on_complete, IOBackend backend);
+
+  ~IOReactor();
+
+  IOBackend backend() const { return _backend; }
+
+  void submit(IORequest* request);
+
+  private:
+
+  constexpr static unsigned NUM_ENTRIES = 256;
+
+  std::function<void(IORequest*)> _on_complete;
+
+  IOBackend _backend;
+
+  std::thread _thread;
+
+  std::mutex _mutex;
+
+  static ssize_t _perform(IORequest& request);
+
+#ifdef TF_HAS_IO_URING
+  struct Ring {
+    int fd {-1};
+    void* sq_ptr {nullptr};
+    void* cq_ptr {nullptr};
+    size_t sq_size {0};
+    size_t cq_size {0};
+    io_uring_sqe* sqes {nullptr};
+    size_t sqes_size {0};
+    unsigned* sq_head;
+    unsigned* sq_tail;
+    unsigned* sq_mask;
+    unsigned* sq_array;
+    unsigned* cq_head;
+    unsigned* cq_tail;
+    unsigned* cq_mask;
+    io_uring_cqe* cqes;
+    unsigned cq_entries;
+  } _ring;
+
+  std::condition_variable _ring_cv;
+  size_t _num_inflight {0};
+
+  // the destructor asks the ring thread to stop, which it acknowledges
+  // once it has left its loop
+  std::atomic<bool> _stop_ring {false};
+  std::atomic<bool> _ring_done {false};
+
+  bool _ring_setup();
+  void _ring_teardown();
+  int _ring_push(uint8_t opcode, IORequest* request);
+  void _ring_loop();
+#endif
+
+#ifdef TF_HAS_EPOLL
+  int _epfd {-1};
+  int _evfd {-1};
+  std::unordered_map<int, std::deque<IORequest*>> _pending;
+#endif
+
+  // submissions not yet seen by the epoll thread; nullptr stops it
+  std::vector<IORequest*> _submitted;
+  bool _stop {false};
+
+  std::condition_variable _cv;
+
+  void _poll_loop();
+  void _poll_start(IORequest* request);
+  void _poll_ready(int fd);
+  void _poll_wake();
+};
+
+// Constructor
+inline IOReactor::IOReactor(std::function<void(IORequest*)> on_complete, IOBackend backend) :
+  _on_complete {std::move(on_complete)},
+  _backend     {backend} {
+
+#ifdef TF_HAS_IO_URING
+  if(_backend == IOBackend::IO_URING && _ring_setup()) {
+    _thread = std::thread([this](){ _ring_loop(); });
+    return;
+  }
+#endif
+
+  _backend = IOBackend::EPOLL;
+
+#ifdef TF_HAS_EPOLL
+  _epfd = ::epoll_create1(EPOLL_CLOEXEC);
+  _evfd = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if(_epfd == -1 || _evfd == -1) {
+    TF_THROW("failed to create the I/O reactor (", std::strerror(errno), ")");
+  }
+  epoll_event ev {};
+  ev.events = EPOLLIN;
+  ev.data.fd = _evfd;
+  ::epoll_ctl(_epfd, EPOLL_CTL_ADD, _evfd, &ev);
+#endif
+
+  _thread = std::thread([this](){ _poll_loop(); });
+}
+
+// Destructor
+inline IOReactor::~IOReactor() {
+
+#ifdef TF_HAS_IO_URING
+  if(_backend == IOBackend::IO_URING) {
+    // the NOP wakes the reactor up to stop it; a ring that refuses it for
+    // now is retried, and one that is broken fails the wait of the reactor
+    // as well, which then sees the stop flag
+    _stop_ring.store(true, std::memory_order_release);
+    while(!_ring_done.load(std::memory_order_acquire)) {
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if(_ring_push(IORING_OP_NOP, nullptr) == 0) {
+          break;
+        }
+      }
+      std::this_thread::yield();
+    }
+    _thread.join();
+    _ring_teardown();
+    return;
+  }
+#endif
+
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stop = true;
+  }
+  _poll_wake();
+  _thread.join();
+
+#ifdef TF_HAS_EPOLL
+  ::close(_evfd);
+  ::close(_epfd);
+#endif
+}
+
+// Function: _perform
+inline ssize_t IOReactor::_perform(IORequest& r) {
+  ssize_t n;
+  do {
+    if(r.op == IORequest::READ) {
+      n = r.offset < 0 ? ::read(r.fd, r.buf, r.count) :
+                         ::pread(r.fd, r.buf, r.count, static_cast<off_t>(r.offset));
+    }
+    else {
+      n = r.offset < 0 ? ::write(r.fd, r.buf, r.count) :
+                         ::pwrite(r.fd, r.buf, r.count, static_cast<off_t>(r.offset));
+    }
+  } while(n == -1 && errno == EINTR);
+  return n == -1 ? -errno : n;
+}
+
+// Procedure: submit
+inline void IOReactor::submit(IORequest* request) {
+
+#ifdef TF_HAS_IO_URING
+  if(_backend == IOBackend::IO_URING) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _ring_cv.wait(lock, [&](){ return _num_inflight < _ring.cq_entries; });
+    if(auto e = _ring_push(
+         request->op == IORequest::READ ? IORING_OP_READ : IORING_OP_WRITE, request
+       ); e) {
+      lock.unlock();
+      request->result = -e;
+      _on_complete(request);
+    }
+    return;
+  }
+#endif
+
+  bool wake;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    wake = _submitted.empty();
+    _submitted.push_back(request);
+  }
+  if(wake) {
+    _poll_wake();
+  }
+}
+
+#ifdef TF_HAS_IO_URING
+
+// Function: _ring_setup
+inline bool IOReactor::_ring_setup() {
+
+  io_uring_params params;
+  std::memset(&params, 0, sizeof(params));
+
+  _ring.fd = static_cast<int>(::syscall(__NR_io_uring_setup, NUM_ENTRIES, &params));
+
+  if(_ring.fd < 0) {
+    return false;
+  }
+
+  _ring.sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  _ring.cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+  const bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+
+  if(single) {
+    _ring.sq_size = _ring.cq_size = std::max(_ring.sq_size, _ring.cq_size);
+  }
+
+  _ring.sq_ptr = ::mmap(nullptr, _ring.sq_size, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, _ring.fd, IORING_OFF_SQ_RING);
+  if(_ring.sq_ptr == MAP_FAILED) {
+    ::close(_ring.fd);
+    return false;
+  }
+
+  _ring.cq_ptr = single ? _ring.sq_ptr :
+                 ::mmap(nullptr, _ring.cq_size, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, _ring.fd, IORING_OFF_CQ_RING);
+  if(_ring.cq_ptr == MAP_FAILED) {
+    ::munmap(_ring.sq_ptr, _ring.sq_size);
+    ::close(_ring.fd);
+    return false;
+  }
+
+  _ring.sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+  auto sqes = ::mmap(nullptr, _ring.sqes_size, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE, _ring.fd, IORING_OFF_SQES);
+  if(sqes == MAP_FAILED) {
+    if(!single) {
+      ::munmap(_ring.cq_ptr, _ring.cq_size);
+    }
+    ::munmap(_ring.sq_ptr, _ring.sq_size);
+    ::close(_ring.fd);
+    return false;
+  }
+  _ring.sqes = static_cast<io_uring_sqe*>(sqes);
+
+  auto sq = static_cast<char*>(_ring.sq_ptr);
+  auto cq = static_cast<char*>(_ring.cq_ptr);
+
+  _ring.sq_head  = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+  _ring.sq_tail  = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+  _ring.sq_mask  = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+  _ring.sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+  _ring.cq_head  = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+  _ring.cq_tail  = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+  _ring.cq_mask  = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+  _ring.cqes     = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+  // leave room for the NOP that stops the reactor
+  _ring.cq_entries = params.cq_entries - 1;
+
+  return true;
+}
+
+// Procedure: _ring_teardown
+inline void IOReactor::_ring_teardown() {
+  ::munmap(_ring.sqes, _ring.sqes_size);
+  if(_ring.cq_ptr != _ring.sq_ptr) {
+    ::munmap(_ring.cq_ptr, _ring.cq_size);
+  }
+  ::munmap(_ring.sq_ptr, _ring.sq_size);
+  ::close(_ring.fd);
+}
+
+// Function: _ring_push
+// Submitters hold _mutex. The kernel consumes the entry in io_uring_enter,
+// so the submission queue never holds more than one entry and a failed
+// submission can be taken back. Returns the errno of a failed submission.
+inline int IOReactor::_ring_push(uint8_t opcode, IORequest* request) {
+
+  auto tail = *_ring.sq_tail;
+  auto index = tail & *_ring.sq_mask;
+
+  auto& sqe = _ring.sqes[index];
+  std::memset(&sqe, 0, sizeof(sqe));
+  sqe.opcode = opcode;
+  sqe.user_data = reinterpret_cast<uint64_t>(request);
+
+  if(request) {
+    sqe.fd = request->fd;
+    sqe.addr = reinterpret_cast<uint64_t>(request->buf);
+    sqe.len = static_cast<uint32_t>(request->count);
+    sqe.off = static_cast<uint64_t>(request->offset);
+    ++_num_inflight;
+  }
+  else {
+    sqe.fd = -1;
+  }
+
+  _ring.sq_array[index] = index;
+  __atomic_store_n(_ring.sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+  while(::syscall(__NR_io_uring_enter, _ring.fd, 1, 0, 0, nullptr, 0) < 0) {
+    if(errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+      auto e = errno;
+      __atomic_store_n(_ring.sq_tail, tail, __ATOMIC_RELEASE);
+      if(request) {
+        --_num_inflight;
+      }
+      return e;
+    }
+    std::this_thread::yield();
+  }
+
+  return 0;
+}
+
+// Procedure: _ring_loop
+inline void IOReactor::_ring_loop() {
+
+  bool stop = false;
+
+  while(!stop) {
+
+    if(::syscall(__NR_io_uring_enter, _ring.fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0 &&
+       errno != EINTR) {
+      if(_stop_ring.load(std::memory_order_acquire)) {
+        break;
+      }
+      std::this_thread::yield();
+    }
+
+    auto head = *_ring.cq_head;
+    auto tail = __atomic_load_n(_ring.cq_tail, __ATOMIC_ACQUIRE);
+
+    size_t num_completed = 0;
+
+    for(; head != tail; ++head) {
+      auto& cqe = _ring.cqes[head & *_ring.cq_mask];
+      auto request = reinterpret_cast<IORequest*>(cqe.user_data);
+      if(request == nullptr) {
+        stop = true;
+        continue;
+      }
+      request->result = cqe.res;
+      _on_complete(request);
+      ++num_completed;
+    }
+
+    __atomic_store_n(_ring.cq_head, head, __ATOMIC_RELEASE);
+
+    if(num_completed) {
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _num_inflight -= num_completed;
+      }
+      _ring_cv.notify_all();
+    }
+  }
+
+  _ring_done.store(true, std::memory_order_release);
+}
+
+#endif
+
+// Procedure: _poll_wake
+inline void IOReactor::_poll_wake() {
+#ifdef TF_HAS_EPOLL
+  uint64_t one = 1;
+  [[maybe_unused]] auto n = ::write(_evfd, &one, sizeof(one));
+#else
+  _cv.notify_one();
+#endif
+}
+
+// Procedure: _poll_start
+// Regular files cannot be registered to epoll (EPERM) and never block on
+// readiness, so their requests run right away.
+inline void IOReactor::_poll_start(IORequest* request) {
+#ifdef TF_HAS_EPOLL
+  if(auto itr = _pending.find(request->fd); itr != _pending.end()) {
+    itr->second.push_back(request);
+    return;
+  }
+  epoll_event ev {};
+  ev.events = (request->op == IORequest::READ ? EPOLLIN : EPOLLOUT) | EPOLLONESHOT;
+  ev.data.fd = request->fd;
+  if(::epoll_ctl(_epfd, EPOLL_CTL_ADD, request->fd, &ev) == 0) {
+    _pending[request->fd].push_back(request);
+    return;
+  }
+#endif
+  request->result = _perform(*request);
+  _on_complete(request);
+}
+
+// Procedure: _poll_ready
+inline void IOReactor::_poll_ready([[maybe_unused]] int fd) {
+#ifdef TF_HAS_EPOLL
+  auto itr = _pending.find(fd);
+  if(itr == _pending.end()) {
+    return;
+  }
+
+  auto& queue = itr->second;
+  auto request = queue.front();
+  queue.pop_front();
+
+  request->result = _perform(*request);
+  _on_complete(request);
+
+  if(queue.empty()) {
+    ::epoll_ctl(_epfd, EPOLL_CTL_DEL, fd, nullptr);
+    _pending.erase(itr);
+    return;
+  }
+
+  epoll_event ev {};
+  ev.events = (queue.front()->op == IORequest::READ ? EPOLLIN : EPOLLOUT) | EPOLLONESHOT;
+  ev.data.fd = fd;
+  ::epoll_ctl(_epfd, EPOLL_CTL_MOD, fd, &ev);
+#endif
+}
+
+// Procedure: _poll_loop
+inline void IOReactor::_poll_loop() {
+
+  std::vector<IORequest*> submitted;
+
+  while(true) {
+
+#ifdef TF_HAS_EPOLL
+    epoll_event events[64];
+    auto n = ::epoll_wait(_epfd, events, 64, -1);
+    for(int i=0; i<n; ++i) {
+      if(events[i].data.fd == _evfd) {
+        uint64_t count;
+        [[maybe_unused]] auto r = ::read(_evfd, &count, sizeof(count));
+      }
+      else {
+        _poll_ready(events[i].data.fd);
+      }
+    }
+#endif
+
+    bool stop;
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+#ifndef TF_HAS_EPOLL
+      _cv.wait(lock, [&](){ return _stop || !_submitted.empty(); });
+#endif
+      stop = _stop;
+      submitted.swap(_submitted);
+    }
+
+    for(auto request : submitted) {
+      _poll_start(request);
+    }
+    submitted.clear();
+
+    // nothing wakes the thread up again once it is stopped
+    if(stop) {
+      break;
+    }
+  }
+
+#ifdef TF_HAS_EPOLL
+  // requests still waiting for readiness have not touched their buffers
+  for(auto& [fd, queue] : _pending) {
+    ::epoll_ctl(_epfd, EPOLL_CTL_DEL, fd, nullptr);
+    for(auto request : queue) {
+      request->result = -ECANCELED;
+      _on_complete(request);
+    }
+  }
+  _pending.clear();
+#endif
+}
+
+}  // end of namespace rigel -----------------------------------------------------
+
+#endif
@@ -0,0 +1,585 @@
+// Copyright 2023 The titan-search Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "rigel/taskflow/core/task.h"
+
+/**
+@file metrics.h
+@brief executor metrics include file
+*/
+
+namespace rigel {
+
+// ----------------------------------------------------------------------------
+// Class Definition: LatencyHistogram
+// ----------------------------------------------------------------------------
+
+/**
+@class LatencyHistogram
+
+@brief class to hold a log-linear histogram of latencies in nanoseconds
+
+Like an HDR histogram, each power-of-two range of values is split into
+16 equal sub-buckets, so a recorded value is known to within 6.25%
+(values below 16 are exact) while the whole 64-bit range takes
+976 buckets.
+Histograms of different workers can be merged bucket by bucket.
+
+@code{.cpp}
+auto metrics = executor.metrics();
+auto histogram = metrics.latency(rigel::TaskPriority::HIGH);
+std::cout << histogram.count() << " tasks, p99 = "
+          << histogram.percentile(99) << " ns\n";
+@endcode
+*/
+class LatencyHistogram {
+
+  friend struct WorkerCounters;
+
+  public:
+
+    /**
+    @brief number of bits of the linear sub-buckets of each power of two
+    */
+    static constexpr size_t SUB_BUCKET_BITS = 4;
+
+    /**
+    @brief number of linear sub-buckets of each power of two
+    */
+    static constexpr size_t SUB_BUCKETS = size_t{1} << SUB_BUCKET_BITS;
+
+    /**
+    @brief number of buckets covering the 64-bit range of values
+    */
+    static constexpr size_t NUM_BUCKETS = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    /**
+    @brief queries the bucket of a value
+    */
+    static size_t bucket(uint64_t value) {
+      if(value < SUB_BUCKETS) {
+        return static_cast<size_t>(value);
+      }
+#if defined(__GNUC__)
+      size_t e = 63 - static_cast<size_t>(__builtin_clzll(value));
+#else
+      size_t e = static_cast<size_t>(log2(value));
+#endif
+      size_t sub = static_cast<size_t>(value >> (e - SUB_BUCKET_BITS)) - SUB_BUCKETS;
+      return (e - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + sub;
+    }
+
+    /**
+    @brief queries the smallest value of a bucket
+    */
+    static uint64_t lowest_value(size_t b) {
+      if(b < SUB_BUCKETS) {
+        return b;
+      }
+      return static_cast<uint64_t>(SUB_BUCKETS + b % SUB_BUCKETS) << (b / SUB_BUCKETS - 1);
+    }
+
+    /**
+    @brief queries the largest value of a bucket
+    */
+    static uint64_t highest_value(size_t b) {
+      return b + 1 < NUM_BUCKETS ? lowest_value(b + 1) - 1 : ~uint64_t{0};
+    }
+
+    /**
+    @brief records a value
+    */
+    void record(uint64_t value, uint64_t count = 1) {
+      _counts[bucket(value)] += count;
+      _count += count;
+      _sum += value * count;
+      _max = std::max(_max, value);
+    }
+
+    /**
+    @brief adds the values of another histogram to this histogram
+    */
+    void merge(const LatencyHistogram& rhs) {
+      for(size_t b=0; b<NUM_BUCKETS; b++) {
+        _counts[b] += rhs._counts[b];
+      }
+      _count += rhs._count;
+      _sum += rhs._sum;
+      _max = std::max(_max, rhs._max);
+    }
+
+    /**
+    @brief removes all values
+    */
+    void clear() {
+      _counts.fill(0);
+      _count = _sum = _max = 0;
+    }
+
+    /**
+    @brief queries the number of recorded values
+    */
+    uint64_t count() const { return _count; }
+
+    /**
+    @brief queries the sum of the recorded values
+    */
+    uint64_t sum() const { return _sum; }
+
+    /**
+    @brief queries the largest recorded value
+    */
+    uint64_t max() const { return _max; }
+
+    /**
+    @brief queries the smallest recorded value (up to the bucket precision)
+    */
+    uint64_t min() const {
+      for(size_t b=0; b<NUM_BUCKETS; b++) {
+        if(_counts[b]) {
+          return lowest_value(b);
+        }
+      }
+      return 0;
+    }
+
+    /**
+    @brief queries the average of the recorded values
+    */
+    double mean() const {
+      return _count ? static_cast<double>(_sum) / _count : 0.0;
+    }
+
+    /**
+    @brief queries the value below which the given percentage of values fall
+
+    @param p percentage in <tt>[0, 100]</tt>
+
+    The result is the largest value of the bucket that holds the percentile,
+    capped by the largest recorded value.
+    */
+    uint64_t percentile(double p) const {
+      if(_count == 0) {
+        return 0;
+      }
+      auto rank = static_cast<uint64_t>(std::ceil(std::clamp(p, 0.0, 100.0) / 100.0 * _count));
+      rank = std::max(rank, uint64_t{1});
+      uint64_t seen = 0;
+      for(size_t b=0; b<NUM_BUCKETS; b++) {
+        if(seen += _counts[b]; seen >= rank) {
+          return std::min(highest_value(b), _max);
+        }
+      }
+      return _max;
+    }
+
+    /**
+    @brief queries the number of values in a bucket
+    */
+    uint64_t count(size_t b) const { return _counts[b]; }
+
+  private:
+
+    std::array<uint64_t, NUM_BUCKETS> _counts {};
+
+    uint64_t _count {0};
+    uint64_t _sum {0};
+    uint64_t _max {0};
+};
+
+/**
+@private
+*/
+inline constexpr size_t NUM_TASK_PRIORITIES = static_cast<size_t>(TaskPriority::MAX);
+
+/**
+@private
+*/
+inline uint64_t latency_clock() {
+  return static_cast<uint64_t>(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()
+    ).count()
+  );
+}
+
+// ----------------------------------------------------------------------------
+// Class Definition: WorkerCounters
+// ----------------------------------------------------------------------------
+
+/**
+@private
+
+@brief per-worker scheduler counters
+
+Each worker is the only writer of its counters, so an update is a relaxed
+load followed by a relaxed store rather than a locked read-modify-write.
+Readers (rigel::Executor::metrics) may see slightly stale values.
+The block is cacheline-aligned such that counters of different workers
+never share a line.
+*/
+struct alignas(2*TF_CACHELINE_SIZE) WorkerCounters {
+
+  std::array<std::atomic<uint64_t>, TASK_TYPES.size()> tasks {};
+
+  std::atomic<uint64_t> steal_attempts {0};
+  std::atomic<uint64_t> steals {0};
+  std::atomic<uint64_t> parks {0};
+  std::atomic<uint64_t> unparks {0};
+  std::atomic<uint64_t> idle_ns {0};
+  std::atomic<uint64_t> queue_high_water {0};
+
+  // ready-to-start latency of the tasks the worker started, by priority
+  struct Latency {
+    std::array<std::atomic<uint64_t>, LatencyHistogram::NUM_BUCKETS> counts {};
+    std::atomic<uint64_t> count {0};
+    std::atomic<uint64_t> sum {0};
+    std::atomic<uint64_t> max {0};
+  };
+
+  std::array<Latency, NUM_TASK_PRIORITIES> latency;
+
+  // number of tasks this worker made ready since its last sample
+  size_t latency_tick {0};
+
+  void record_latency(unsigned p, uint64_t ns) {
+    auto& l = latency[p];
+    add(l.counts[LatencyHistogram::bucket(ns)]);
+    add(l.count);
+    add(l.sum, ns);
+    max(l.max, ns);
+  }
+
+  LatencyHistogram latency_histogram(unsigned p) const {
+    LatencyHistogram h;
+    const auto& l = latency[p];
+    for(size_t b=0; b<LatencyHistogram::NUM_BUCKETS; b++) {
+      h._counts[b] = get(l.counts[b]);
+    }
+    h._count = get(l.count);
+    h._sum = get(l.sum);
+    h._max = get(l.max);
+    return h;
+  }
+
+  static void add(std::atomic<uint64_t>& c, uint64_t v = 1) {
+    c.store(c.load(std::memory_order_relaxed) + v, std::memory_order_relaxed);
+  }
+
+  static void max(std::atomic<uint64_t>& c, uint64_t v) {
+    if(v > c.load(std::memory_order_relaxed)) {
+      c.store(v, std::memory_order_relaxed);
+    }
+  }
+
+  static uint64_t get(const std::atomic<uint64_t>& c) {
+    return c.load(std::memory_order_relaxed);
+  }
+};
+
+// ----------------------------------------------------------------------------
+// Class Definition: WorkerMetrics
+// ----------------------------------------------------------------------------
+
+/**
+@struct WorkerMetrics
+
+@brief struct to hold the scheduler metrics of one worker
+
+The values are a snapshot taken by rigel::Executor::metrics.
+Counters accumulate from the time metrics were enabled.
+*/
+struct WorkerMetrics {
+
+  /**
+  @brief id of the worker
+  */
+  size_t id {0};
+
+  /**
+  @brief number of tasks executed by the worker indexed by rigel::TaskType
+  */
+  std::array<uint64_t, TASK_TYPES.size()> tasks {};
+
+  /**
+  @brief number of attempts to steal a task from another queue
+  */
+  uint64_t steal_attempts {0};
+
+  /**
+  @brief number of successful steals
+  */
+  uint64_t steals {0};
+
+  /**
+  @brief number of times the worker went to sleep
+  */
+  uint64_t parks {0};
+
+  /**
+  @brief number of times the worker woke up from sleep
+  */
+  uint64_t unparks {0};
+
+  /**
+  @brief total time in nanoseconds the worker spent sleeping
+  */
+  uint64_t idle_ns {0};
+
+  /**
+  @brief largest number of tasks observed in the queue of the worker
+  */
+  uint64_t queue_high_water {0};
+
+  /**
+  @brief number of times the queue of the worker grew its capacity
+  */
+  uint64_t queue_resizes {0};
+
+  /**
+  @brief number of tasks in the queue of the worker at the snapshot
+  */
+  uint64_t queue_size {0};
+
+  /**
+  @brief ready-to-start latency of the tasks started by the worker,
+         indexed by rigel::TaskPriority
+
+  Only sampled tasks are recorded (see rigel::Executor::enable_latency_sampling).
+  */
+  std::array<LatencyHistogram, NUM_TASK_PRIORITIES> latency;
+
+  /**
+  @brief queries the number of tasks of all types executed by the worker
+  */
+  uint64_t num_tasks() const {
+    uint64_t n = 0;
+    for(auto t : tasks) {
+      n += t;
+    }
+    return n;
+  }
+};
+
+// ----------------------------------------------------------------------------
+// Class Definition: ExecutorMetrics
+// ----------------------------------------------------------------------------
+
+/**
+@class ExecutorMetrics
+
+@brief class to hold a snapshot of the scheduler metrics of an executor
+
+Metrics are opt-in: they are collected only after
+rigel::Executor::enable_metrics or when the environment variable
+@c TF_ENABLE_METRICS is set at the construction of the executor.
+
+@code{.cpp}
+rigel::Executor executor;
+executor.enable_metrics();
+executor.run(taskflow).wait();
+
+auto metrics = executor.metrics();
+std::cout << metrics.total().num_tasks() << '\n';
+metrics.dump_prometheus(std::cout);
+@endcode
+*/
+class ExecutorMetrics {
+
+  friend class Executor;
+
+  public:
+
+    /**
+    @brief queries the metrics of each worker
+    */
+    const std::vector<WorkerMetrics>& workers() const { return _workers; }
+
+    /**
+    @brief queries the number of tasks in the shared queue of the executor
+    */
+    size_t shared_queue_size() const { return _shared_queue_size; }
+
+    /**
+    @brief accumulates the metrics of all workers
+
+    Counters are summed and the queue high-water mark is the maximum
+    over all workers.
+    The id of the returned object is the number of workers.
+    */
+    WorkerMetrics total() const;
+
+    /**
+    @brief dumps the metrics in the Prometheus text exposition format
+
+    @param ostream output stream
+    @param prefix prefix of every metric name
+
+    Each metric carries a @c worker label, and task counts additionally
+    carry a @c type label with the name returned by rigel::to_string.
+    */
+    void dump_prometheus(
+      std::ostream& ostream, const std::string& prefix = "rigel_executor"
+    ) const;
+
+    /**
+    @brief dumps the metrics in the Prometheus text exposition format to a string
+    */
+    std::string dump_prometheus(const std::string& prefix = "rigel_executor") const;
+
+    /**
+    @brief merges the ready-to-start latency of all workers at the given priority
+    */
+    LatencyHistogram latency(TaskPriority priority = TaskPriority::HIGH) const;
+
+  private:
+
+    std::vector<WorkerMetrics> _workers;
+    size_t _shared_queue_size {0};
+};
+
+// Function: total
+inline WorkerMetrics ExecutorMetrics::total() const {
+
+  WorkerMetrics m;
+  m.id = _workers.size();
+
+  for(const auto& w : _workers) {
+    for(size_t t=0; t<m.tasks.size(); t++) {
+      m.tasks[t] += w.tasks[t];
+    }
+    m.steal_attempts += w.steal_attempts;
+    m.steals += w.steals;
+    m.parks += w.parks;
+    m.unparks += w.unparks;
+    m.idle_ns += w.idle_ns;
+    m.queue_high_water = std::max(m.queue_high_water, w.queue_high_water);
+    m.queue_resizes += w.queue_resizes;
+    m.queue_size += w.queue_size;
+    for(size_t p=0; p<NUM_TASK_PRIORITIES; p++) {
+      m.latency[p].merge(w.latency[p]);
+    }
+  }
+
+  return m;
+}
+
+// Function: latency
+inline LatencyHistogram ExecutorMetrics::latency(TaskPriority priority) const {
+  LatencyHistogram h;
+  for(const auto& w : _workers) {
+    h.merge(w.latency[static_cast<size_t>(priority)]);
+  }
+  return h;
+}
+
+// Procedure: dump_prometheus
+inline void ExecutorMetrics::dump_prometheus(
+  std::ostream& os, const std::string& prefix
+) const {
+
+  auto header = [&](const char* name, const char* type, const char* help) {
+    os << "# HELP " << prefix << '_' << name << ' ' << help << '\n'
+       << "# TYPE " << prefix << '_' << name << ' ' << type << '\n';
+  };
+
+  auto sample = [&](const char* name, const WorkerMetrics& w, auto value) {
+    os << prefix << '_' << name << "{worker=\"" << w.id << "\"} " << value << '\n';
+  };
+
+  header("tasks_total", "counter", "Number of tasks executed.");
+  for(const auto& w : _workers) {
+    for(auto type : TASK_TYPES) {
+      os << prefix << "_tasks_total{worker=\"" << w.id << "\",type=\""
+         << to_string(type) << "\"} " << w.tasks[static_cast<size_t>(type)] << '\n';
+    }
+  }
+
+  header("steal_attempts_total", "counter", "Number of attempts to steal a task.");
+  for(const auto& w : _workers) {
+    sample("steal_attempts_total", w, w.steal_attempts);
+  }
+
+  header("steals_total", "counter", "Number of successful steals.");
+  for(const auto& w : _workers) {
+    sample("steals_total", w, w.steals);
+  }
+
+  header("parks_total", "counter", "Number of times a worker went to sleep.");
+  for(const auto& w : _workers) {
+    sample("parks_total", w, w.parks);
+  }
+
+  header("unparks_total", "counter", "Number of times a worker woke up.");
+  for(const auto& w : _workers) {
+    sample("unparks_total", w, w.unparks);
+  }
+
+  header("idle_seconds_total", "counter", "Time a worker spent sleeping.");
+  for(const auto& w : _workers) {
+    sample("idle_seconds_total", w, static_cast<double>(w.idle_ns) * 1e-9);
+  }
+
+  header("queue_high_water", "gauge", "Largest observed queue depth.");
+  for(const auto& w : _workers) {
+    sample("queue_high_water", w, w.queue_high_water);
+  }
+
+  header("queue_resizes_total", "counter", "Number of queue capacity growths.");
+  for(const auto& w : _workers) {
+    sample("queue_resizes_total", w, w.queue_resizes);
+  }
+
+  header("queue_depth", "gauge", "Number of tasks in a queue.");
+  for(const auto& w : _workers) {
+    sample("queue_depth", w, w.queue_size);
+  }
+  os << prefix << "_queue_depth{worker=\"shared\"} " << _shared_queue_size << '\n';
+
+  header("ready_latency_seconds", "summary", "Time from a task becoming ready to starting.");
+  for(size_t p=0; p<NUM_TASK_PRIORITIES; p++) {
+    const char* priority = (p == 0) ? "high" : (p == 1) ? "normal" : "low";
+    auto h = latency(static_cast<TaskPriority>(p));
+    for(auto q : {0.5, 0.9, 0.99, 0.999}) {
+      os << prefix << "_ready_latency_seconds{priority=\"" << priority
+         << "\",quantile=\"" << q << "\"} " << h.percentile(q * 100) * 1e-9 << '\n';
+    }
+    os << prefix << "_ready_latency_seconds_sum{priority=\"" << priority << "\"} "
+       << h.sum() * 1e-9 << '\n';
+    os << prefix << "_ready_latency_seconds_count{priority=\"" << priority << "\"} "
+       << h.count() << '\n';
+  }
+}
+
+// Function: dump_prometheus
+inline std::string ExecutorMetrics::dump_prometheus(const std::string& prefix) const {
+  std::ostringstream oss;
+  dump_prometheus(oss, prefix);
+  return oss.str();
+}
+
+}  // end of namespace rigel -----------------------------------------------------
@@ -31,6 +31,13 @@
 #include <numeric>
 #include <cassert>
 
+#if defined(__linux__)
+  #include <linux/futex.h>
+  #include <sys/syscall.h>
+  #include <unistd.h>
+  #define TF_HAS_FUTEX 1
+#endif
+
 // This file is part of Eigen, a lightweight C++ template library
 // for linear algebra.
 //
@@ -76,6 +83,10 @@ namespace rigel {
 // and won't block, or notifying thread will see _state change and will unblock
 // the waiter, or both. But it can't happen that both threads don't see each
 // other changes, which would lead to deadlock.
+//
+// Committed waiters park on their own state word: a futex on Linux, or a
+// mutex and condition variable elsewhere. notify_n pops up to n waiters
+// in a single CAS and wakes them without touching the shared state again.
 class Notifier {
 
   friend class Executor;
@@ -84,11 +95,14 @@ class Notifier {
 
   struct Waiter {
     std::atomic<Waiter*> next;
+    uint64_t epoch;
+    // futex word on Linux
+    std::atomic<uint32_t> state;
+#if !defined(TF_HAS_FUTEX)
     std::mutex mu;
     std::condition_variable cv;
-    uint64_t epoch;
-    unsigned state;
-    enum {
+#endif
+    enum : uint32_t {
       kNotSignaled,
       kWaiting,
       kSignaled,
@@ -116,7 +130,7 @@ class Notifier {
 
   // commit_wait commits waiting.
   void commit_wait(Waiter* w) {
-    w->state = Waiter::kNotSignaled;
+    w->state.store(Waiter::kNotSignaled, std::memory_order_relaxed);
     // Modification epoch of this waiter.
     uint64_t epoch =
         (w->epoch & kEpochMask) +
@@ -172,15 +186,16 @@ class Notifier {
     }
   }
 
-  // notify wakes one or all waiting threads.
+  // notify wakes one or all waiting threads and returns false if there was
+  // no thread to wake.
   // Must be called after changing the associated wait predicate.
-  void notify(bool all) {
+  bool notify(bool all) {
     std::atomic_thread_fence(std::memory_order_seq_cst);
     uint64_t state = _state.load(std::memory_order_acquire);
     for (;;) {
       // Easy case: no waiters.
       if ((state & kStackMask) == kStackMask && (state & kWaiterMask) == 0)
-        return;
+        return false;
       uint64_t waiters = (state & kWaiterMask) >> kWaiterShift;
       uint64_t newstate;
       if (all) {
@@ -204,24 +219,66 @@ class Notifier {
       }
       if (_state.compare_exchange_weak(state, newstate,
                                        std::memory_order_acquire)) {
-        if (!all && waiters) return;  // unblocked pre-wait thread
-        if ((state & kStackMask) == kStackMask) return;
+        if (!all && waiters) return true;  // unblocked pre-wait thread
+        if ((state & kStackMask) == kStackMask) return waiters != 0;
         Waiter* w = &_waiters[state & kStackMask];
         if (!all) w->next.store(nullptr, std::memory_order_relaxed);
         _unpark(w);
-        return;
+        return true;
       }
     }
   }
 
-  // notify n workers
+  // notify_n wakes up to n waiting threads, which is equivalent to
+  // calling notify(false) n times but takes a single CAS: threads in the
+  // pre-wait state are unblocked first, then the rest are popped off the
+  // wait list together and unparked.
+  // Must be called after changing the associated wait predicate.
   void notify_n(size_t n) {
+
+    if(n == 0) {
+      return;
+    }
+
     if(n >= _waiters.size()) {
       notify(true);
+      return;
     }
-    else {
-      for(size_t k=0; k<n; ++k) {
-        notify(false);
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    uint64_t state = _state.load(std::memory_order_acquire);
+
+    for (;;) {
+      // Easy case: no waiters.
+      if ((state & kStackMask) == kStackMask && (state & kWaiterMask) == 0)
+        return;
+
+      // Unblock up to n threads in the pre-wait state.
+      uint64_t waiters = (state & kWaiterMask) >> kWaiterShift;
+      uint64_t k = std::min<uint64_t>(n, waiters);
+      uint64_t newstate = state + kEpochInc * k - kWaiterInc * k;
+
+      // Pop the remaining ones off the wait list. As in notify, a waiter
+      // walked here can only be re-pushed after an epoch increment, which
+      // fails the CAS below.
+      size_t m = n - k;
+      uint64_t top = state & kStackMask;
+      Waiter* last = nullptr;
+      while (m && top != kStackMask) {
+        last = &_waiters[top];
+        Waiter* wnext = last->next.load(std::memory_order_relaxed);
+        top = wnext ? static_cast<uint64_t>(wnext - &_waiters[0]) : kStackMask;
+        --m;
+      }
+      newstate = (newstate & ~kStackMask) | top;
+
+      if (_state.compare_exchange_weak(state, newstate,
+                                       std::memory_order_acquire)) {
+        if (last) {
+          last->next.store(nullptr, std::memory_order_relaxed);
+          _unpark(&_waiters[state & kStackMask]);
+        }
+        return;
       }
     }
   }
@@ -250,10 +307,50 @@ class Notifier {
   std::atomic<uint64_t> _state;
   std::vector<Waiter> _waiters;
 
+#if defined(TF_HAS_FUTEX)
+
+  static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex word must be 32-bit");
+
+  static void _futex_wait(std::atomic<uint32_t>* addr, uint32_t expected) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr), FUTEX_WAIT_PRIVATE,
+            expected, nullptr, nullptr, 0);
+  }
+
+  static void _futex_wake(std::atomic<uint32_t>* addr) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr), FUTEX_WAKE_PRIVATE,
+            1, nullptr, nullptr, 0);
+  }
+
+  void _park(Waiter* w) {
+    uint32_t state = Waiter::kNotSignaled;
+    // Signaled between commit and park.
+    if (!w->state.compare_exchange_strong(state, Waiter::kWaiting,
+                                          std::memory_order_acquire)) {
+      return;
+    }
+    while (w->state.load(std::memory_order_acquire) == Waiter::kWaiting) {
+      _futex_wait(&w->state, Waiter::kWaiting);
+    }
+  }
+
+  void _unpark(Waiter* waiters) {
+    Waiter* next = nullptr;
+    for (Waiter* w = waiters; w; w = next) {
+      next = w->next.load(std::memory_order_relaxed);
+      // Avoid the syscall if it wasn't waiting.
+      if (w->state.exchange(Waiter::kSignaled, std::memory_order_release) ==
+          Waiter::kWaiting) {
+        _futex_wake(&w->state);
+      }
+    }
+  }
+
+#else
+
   void _park(Waiter* w) {
     std::unique_lock<std::mutex> lock(w->mu);
-    while (w->state != Waiter::kSignaled) {
-      w->state = Waiter::kWaiting;
+    while (w->state.load(std::memory_order_relaxed) != Waiter::kSignaled) {
+      w->state.store(Waiter::kWaiting, std::memory_order_relaxed);
       w->cv.wait(lock);
     }
   }
@@ -262,17 +359,19 @@ class Notifier {
     Waiter* next = nullptr;
     for (Waiter* w = waiters; w; w = next) {
       next = w->next.load(std::memory_order_relaxed);
-      unsigned state;
+      uint32_t state;
       {
         std::unique_lock<std::mutex> lock(w->mu);
-        state = w->state;
-        w->state = Waiter::kSignaled;
+        state = w->state.load(std::memory_order_relaxed);
+        w->state.store(Waiter::kSignaled, std::memory_order_relaxed);
       }
       // Avoid notifying if it wasn't waiting.
       if (state == Waiter::kWaiting) w->cv.notify_one();
     }
   }
 
+#endif
+
 };
 
 
@@ -121,6 +121,146 @@ struct ProfileData {
   }
 };
 
+/**
+@private
+
+@brief loads a @c .tfp stream written by rigel::TFProfManager
+
+A streamed profile is a sequence of rigel::ProfileData chunks,
+each holding the segments recorded since the previous flush.
+Chunks of the same observer (i.e., with the same uid) are merged
+into a single timeline in the order they were written.
+
+The stream can be a @c std::istream or a rigel::ViewStream,
+e.g., over a rigel::MappedFile to load a large profile without
+going through stream buffers.
+*/
+template <typename Stream>
+ProfileData load_tfprof(Stream& is) {
+
+  ProfileData data;
+  std::unordered_map<size_t, size_t> index;
+
+  Deserializer<Stream> deserializer(is);
+
+  while(is.peek() != std::char_traits<char>::eof()) {
+
+    ProfileData chunk;
+    deserializer(chunk);
+
+    if(!is) {
+      break;
+    }
+
+    for(auto& timeline : chunk.timelines) {
+
+      auto [itr, inserted] = index.try_emplace(timeline.uid, data.timelines.size());
+
+      if(inserted) {
+        data.timelines.push_back(std::move(timeline));
+        continue;
+      }
+
+      auto& merged = data.timelines[itr->second];
+
+      if(merged.segments.size() < timeline.segments.size()) {
+        merged.segments.resize(timeline.segments.size());
+      }
+
+      for(size_t w=0; w<timeline.segments.size(); ++w) {
+        if(merged.segments[w].size() < timeline.segments[w].size()) {
+          merged.segments[w].resize(timeline.segments[w].size());
+        }
+        for(size_t l=0; l<timeline.segments[w].size(); ++l) {
+          auto& segments = merged.segments[w][l];
+          segments.insert(
+            segments.end(),
+            std::make_move_iterator(timeline.segments[w][l].begin()),
+            std::make_move_iterator(timeline.segments[w][l].end())
+          );
+        }
+      }
+    }
+  }
+
+  return data;
+}
+
+/**
+@private
+*/
+inline void dump_tfprof(std::ostream& os, const Timeline& timeline) {
+
+  using namespace std::chrono;
+
+  size_t first;
+
+  for(first = 0; first<timeline.segments.size(); ++first) {
+    if(timeline.segments[first].size() > 0) { 
+      break; 
+    }
+  }
+  
+  // not timeline data to dump
+  if(first == timeline.segments.size()) {
+    os << "{}\n";
+    return;
+  }
+
+  os << "{\"executor\":\"" << timeline.uid << "\",\"data\":[";
+
+  bool comma = false;
+
+  for(size_t w=first; w<timeline.segments.size(); w++) {
+    for(size_t l=0; l<timeline.segments[w].size(); l++) {
+
+      if(timeline.segments[w][l].empty()) {
+        continue;
+      }
+
+      if(comma) {
+        os << ',';
+      }
+      else {
+        comma = true;
+      }
+
+      os << "{\"worker\":" << w << ",\"level\":" << l << ",\"data\":[";
+      for(size_t i=0; i<timeline.segments[w][l].size(); ++i) {
+
+        const auto& s = timeline.segments[w][l][i];
+
+        if(i) os << ',';
+        
+        // span 
+        os << "{\"span\":[" 
+           << duration_cast<microseconds>(s.beg - timeline.origin).count() 
+           << ","
+           << duration_cast<microseconds>(s.end - timeline.origin).count() 
+           << "],";
+        
+        // name
+        os << "\"name\":\""; 
+        if(s.name.empty()) {
+          os << w << '_' << i;
+        }
+        else {
+          os << s.name;
+        }
+        os << "\",";
+    
+        // e.g., category "type": "Condition Task"
+        os << "\"type\":\"" << to_string(s.type) << "\"";
+
+        os << "}";
+      }
+      os << "]}";
+    }
+  }
+
+  os << "]}\n";
+}
+
 // ----------------------------------------------------------------------------
 // observer interface 
 // ----------------------------------------------------------------------------
@@ -210,6 +350,16 @@ class ObserverInterface {
   virtual void on_exit(WorkerView wv, TaskView task_view) = 0;
 };
 
+/**
+@private
+
+immutable array of observers published by an executor; a snapshot is
+replaced, never modified, when an observer is added or removed
+*/
+struct ObserverSnapshot {
+  std::vector<std::shared_ptr<ObserverInterface>> observers;
+};
+
 // ----------------------------------------------------------------------------
 // ChromeObserver definition
 // ----------------------------------------------------------------------------
@@ -456,6 +606,7 @@ class TFProfObserver : public ObserverInterface {
 
   friend class Executor;
   friend class TFProfManager;
+  friend class ProfileAnalysis;
 
   /** @private overall task summary */
   struct TaskSummary {
@@ -536,6 +687,14 @@ class TFProfObserver : public ObserverInterface {
     Timeline _timeline;
   
     std::vector<std::stack<observer_stamp_t>> _stacks;
+
+    // per-worker locks that let rigel::TFProfManager take the recorded
+    // segments away while workers keep appending to them
+    std::unique_ptr<CachelineAligned<std::mutex>[]> _mutexes;
+
+    Timeline _extract();
+
+    size_t _num_buffered() const;
     
     inline void set_up(size_t num_workers) override final;
     inline void on_entry(WorkerView, TaskView) override final;
@@ -697,6 +856,7 @@ inline void TFProfObserver::set_up(size_t num_workers) {
   _timeline.origin = observer_stamp_t::clock::now();
   _timeline.segments.resize(num_workers);
   _stacks.resize(num_workers);
+  _mutexes = std::make_unique<CachelineAligned<std::mutex>[]>(num_workers);
 }
 
 // Procedure: on_entry
@@ -710,22 +870,27 @@ inline void TFProfObserver::on_exit(WorkerView wv, TaskView tv) {
   size_t w = wv.id();
 
   assert(!_stacks[w].empty());
+
+  auto beg = _stacks[w].top();
+  auto end = observer_stamp_t::clock::now();
   
+  std::lock_guard<std::mutex> lock(_mutexes[w].data);
+
   if(_stacks[w].size() > _timeline.segments[w].size()) {
     _timeline.segments[w].resize(_stacks[w].size());
   }
 
-  auto beg = _stacks[w].top();
   _stacks[w].pop();
 
   _timeline.segments[w][_stacks[w].size()].emplace_back(
-    tv.name(), tv.type(), beg, observer_stamp_t::clock::now()
+    tv.name(), tv.type(), beg, end
   );
 }
 
 // Function: clear
 inline void TFProfObserver::clear() {
   for(size_t w=0; w<_timeline.segments.size(); ++w) {
+    std::lock_guard<std::mutex> lock(_mutexes[w].data);
     for(size_t l=0; l<_timeline.segments[w].size(); ++l) {
       _timeline.segments[w][l].clear();
     }
@@ -735,77 +900,42 @@ inline void TFProfObserver::clear() {
   }
 }
 
-// Procedure: dump
-inline void TFProfObserver::dump(std::ostream& os) const {
-
-  using namespace std::chrono;
+// Function: _extract
+// moves the recorded segments out of the observer and leaves an empty
+// timeline with the same uid and origin behind
+inline Timeline TFProfObserver::_extract() {
 
-  size_t first;
+  Timeline timeline;
+  timeline.uid = _timeline.uid;
+  timeline.origin = _timeline.origin;
+  timeline.segments.resize(_timeline.segments.size());
 
-  for(first = 0; first<_timeline.segments.size(); ++first) {
-    if(_timeline.segments[first].size() > 0) { 
-      break; 
+  for(size_t w=0; w<_timeline.segments.size(); ++w) {
+    std::lock_guard<std::mutex> lock(_mutexes[w].data);
+    timeline.segments[w].resize(_timeline.segments[w].size());
+    for(size_t l=0; l<_timeline.segments[w].size(); ++l) {
+      timeline.segments[w][l].swap(_timeline.segments[w][l]);
     }
   }
-  
-  // not timeline data to dump
-  if(first == _timeline.segments.size()) {
-    os << "{}\n";
-    return;
-  }
-
-  os << "{\"executor\":\"" << _timeline.uid << "\",\"data\":[";
-
-  bool comma = false;
-
-  for(size_t w=first; w<_timeline.segments.size(); w++) {
-    for(size_t l=0; l<_timeline.segments[w].size(); l++) {
-
-      if(_timeline.segments[w][l].empty()) {
-        continue;
-      }
-
-      if(comma) {
-        os << ',';
-      }
-      else {
-        comma = true;
-      }
-
-      os << "{\"worker\":" << w << ",\"level\":" << l << ",\"data\":[";
-      for(size_t i=0; i<_timeline.segments[w][l].size(); ++i) {
-
-        const auto& s = _timeline.segments[w][l][i];
 
-        if(i) os << ',';
-        
-        // span 
-        os << "{\"span\":[" 
-           << duration_cast<microseconds>(s.beg - _timeline.origin).count() 
-           << ","
-           << duration_cast<microseconds>(s.end - _timeline.origin).count() 
-           << "],";
-        
-        // name
-        os << "\"name\":\""; 
-        if(s.name.empty()) {
-          os << w << '_' << i;
-        }
-        else {
-          os << s.name;
-        }
-        os << "\",";
-    
-        // e.g., category "type": "Condition Task"
-        os << "\"type\":\"" << to_string(s.type) << "\"";
+  return timeline;
+}
 
-        os << "}";
-      }
-      os << "]}";
+// Function: _num_buffered
+inline size_t TFProfObserver::_num_buffered() const {
+  size_t s = 0;
+  for(size_t w=0; w<_timeline.segments.size(); ++w) {
+    std::lock_guard<std::mutex> lock(_mutexes[w].data);
+    for(size_t l=0; l<_timeline.segments[w].size(); ++l) {
+      s += _timeline.segments[w][l].size();
     }
   }
+  return s;
+}
 
-  os << "]}\n";
+// Procedure: dump
+inline void TFProfObserver::dump(std::ostream& os) const {
+  dump_tfprof(os, _timeline);
 }
 
 // Function: dump
@@ -939,39 +1069,135 @@ inline size_t TFProfObserver::num_workers() const {
 // ----------------------------------------------------------------------------
 
 /**
-@private
+@class TFProfManager
+
+@brief class to manage the default profiler enabled by @c TF_ENABLE_PROFILER
+
+When the environment variable @c TF_ENABLE_PROFILER is set, every executor
+registers a rigel::TFProfObserver with the manager and the recorded
+timelines are written to the file named by the variable:
+a binary profile if the name ends with @c .tfp, or a JSON profile otherwise.
+If the file cannot be opened, a summary report is written to @c stderr.
+
+By default, the timelines stay in memory and are written when the program
+exits.
+Long-running programs can stream them instead:
+each flush moves the segments recorded since the previous flush out of
+the observers and appends them to the file as one chunk,
+so memory stays bounded and the file is usable while the program runs.
+A @c .tfp stream is a sequence of rigel::ProfileData chunks
+that rigel::load_tfprof merges back into one profile.
+
+@code{.cpp}
+// flush every second or whenever 100K tasks are buffered
+rigel::TFProfManager::get().stream(std::chrono::seconds(1), 100000);
+
+// flush right now, e.g., from a signal-driven admin command
+rigel::TFProfManager::get().flush();
+@endcode
+
+Streaming can also be enabled without code changes through
+the environment variables @c TF_PROFILER_FLUSH_INTERVAL (milliseconds)
+and @c TF_PROFILER_FLUSH_TASKS (number of buffered tasks).
 */
 class TFProfManager {
 
   friend class Executor;
 
   public:
-    
+
     ~TFProfManager();
-    
+
     TFProfManager(const TFProfManager&) = delete;
     TFProfManager& operator=(const TFProfManager&) = delete;
 
+    /**
+    @brief acquires the process-wide manager
+    */
     static TFProfManager& get();
 
+    /**
+    @brief dumps the timelines buffered in the managed observers
+           into a @TFProf format through an output stream
+    */
     void dump(std::ostream& ostream) const;
 
+    /**
+    @brief writes the timelines buffered so far to the profiler file
+
+    The recorded segments are moved out of the observers and
+    appended to the file as one chunk.
+    Nothing is written if no task has finished since the previous flush
+    or if the file cannot be opened.
+
+    This member function is thread-safe.
+    */
+    void flush();
+
+    /**
+    @brief starts or reconfigures the background flusher
+
+    @param interval time between two flushes (zero to flush by size only)
+    @param max_tasks number of buffered tasks that triggers a flush
+                     (zero to flush by time only)
+
+    Passing zero to both stops the flusher.
+    The buffered size is checked at most every 100 milliseconds.
+
+    This member function is thread-safe.
+    */
+    void stream(std::chrono::milliseconds interval, size_t max_tasks = 0);
+
   private:
-    
+
     const std::string _fpath;
+    const bool _binary;
 
-    std::mutex _mutex;
+    mutable std::mutex _mutex;
     std::vector<std::shared_ptr<TFProfObserver>> _observers;
-    
+
+    // file state, guarded by the flush mutex
+    std::mutex _flush_mutex;
+    std::ofstream _ofs;
+    bool _opened {false};
+    size_t _num_chunks {0};
+    size_t _num_objects {0};
+
+    // background flusher, configured under the stream mutex
+    std::mutex _stream_mutex;
+    std::condition_variable _stream_cv;
+    std::thread _flusher;
+    bool _stop {false};
+    std::chrono::milliseconds _interval {0};
+    size_t _max_tasks {0};
+
     TFProfManager();
 
     void _manage(std::shared_ptr<TFProfObserver> observer);
+
+    bool _open();
+
+    void _flush(bool);
+
+    void _flush_loop();
+
+    size_t _num_buffered() const;
 };
 
 // constructor
 inline TFProfManager::TFProfManager() :
-  _fpath {get_env(TF_ENABLE_PROFILER)} {
+  _fpath  {get_env(TF_ENABLE_PROFILER)},
+  _binary {_fpath.rfind(".tfp") != std::string::npos} {
+
+  auto interval = get_env(TF_PROFILER_FLUSH_INTERVAL);
+  auto max_tasks = get_env(TF_PROFILER_FLUSH_TASKS);
 
+  if(!interval.empty() || !max_tasks.empty()) {
+    stream(
+      std::chrono::milliseconds(std::strtoull(interval.c_str(), nullptr, 10)),
+      std::strtoull(max_tasks.c_str(), nullptr, 10)
+    );
+  }
 }
 
 // Procedure: manage
@@ -982,50 +1208,808 @@ inline void TFProfManager::_manage(std::shared_ptr<TFProfObserver> observer) {
 
 // Procedure: dump
 inline void TFProfManager::dump(std::ostream& os) const {
+  std::lock_guard lock(_mutex);
   for(size_t i=0; i<_observers.size(); ++i) {
     if(i) os << ',';
-    _observers[i]->dump(os); 
+    _observers[i]->dump(os);
   }
 }
 
-// Destructor
-inline TFProfManager::~TFProfManager() {
-  std::ofstream ofs(_fpath);
-  if(ofs) {
-    // .tfp
-    if(_fpath.rfind(".tfp") != std::string::npos) {
-      ProfileData data;
-      data.timelines.reserve(_observers.size());
-      for(size_t i=0; i<_observers.size(); ++i) {
-        data.timelines.push_back(std::move(_observers[i]->_timeline));
-      }
-      Serializer<std::ofstream> serializer(ofs); 
-      serializer(data);
+// Procedure: flush
+inline void TFProfManager::flush() {
+  _flush(false);
+}
+
+// Procedure: stream
+inline void TFProfManager::stream(std::chrono::milliseconds interval, size_t max_tasks) {
+
+  std::thread flusher;
+
+  {
+    std::lock_guard lock(_stream_mutex);
+
+    _interval = interval;
+    _max_tasks = max_tasks;
+
+    if(_interval.count() == 0 && _max_tasks == 0) {
+      _stop = true;
+      flusher = std::move(_flusher);
     }
-    // .json
-    else { // if(_fpath.rfind(".json") != std::string::npos) {
-      ofs << "[\n";
-      for(size_t i=0; i<_observers.size(); ++i) {
-        if(i) ofs << ',';
-        _observers[i]->dump(ofs);
-      }
-      ofs << "]\n";
+    else if(!_flusher.joinable()) {
+      _stop = false;
+      _flusher = std::thread([this](){ _flush_loop(); });
     }
   }
-  // do a summary report in stderr for each observer
-  else {
-    std::ostringstream oss;
-    for(size_t i=0; i<_observers.size(); ++i) {
-      _observers[i]->summary(oss);
+
+  _stream_cv.notify_one();
+
+  if(flusher.joinable()) {
+    flusher.join();
+  }
+}
+
+// Function: _open
+// opens the profiler file on the first flush
+inline bool TFProfManager::_open() {
+  if(!_opened) {
+    _opened = true;
+    if(!_fpath.empty()) {
+      _ofs.open(_fpath, _binary ? std::ios::out | std::ios::binary : std::ios::out);
     }
-    fprintf(stderr, "%s", oss.str().c_str());
   }
+  return _ofs.is_open() && _ofs.good();
 }
-    
-// Function: get
-inline TFProfManager& TFProfManager::get() {
-  static TFProfManager mgr;
-  return mgr;
+
+// Procedure: _flush
+// appends the buffered timelines to the file as one chunk; the final flush
+// writes a chunk even if nothing was recorded so the file is never empty
+inline void TFProfManager::_flush(bool final) {
+
+  std::lock_guard flush_lock(_flush_mutex);
+
+  // keep the timelines in memory for the summary report
+  if(!_open()) {
+    return;
+  }
+
+  std::vector<std::shared_ptr<TFProfObserver>> observers;
+  {
+    std::lock_guard lock(_mutex);
+    observers = _observers;
+  }
+
+  ProfileData data;
+  data.timelines.reserve(observers.size());
+
+  size_t num_tasks = 0;
+
+  for(auto& observer : observers) {
+    data.timelines.push_back(observer->_extract());
+    for(const auto& worker : data.timelines.back().segments) {
+      for(const auto& level : worker) {
+        num_tasks += level.size();
+      }
+    }
+  }
+
+  bool force = final && _num_chunks == 0;
+
+  if(num_tasks == 0 && !force) {
+    return;
+  }
+
+  // .tfp
+  if(_binary) {
+    BufferStream buffer;
+    Serializer<BufferStream> serializer(buffer);
+    serializer(data);
+    _ofs.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+  }
+  // .json
+  else {
+    if(_num_chunks == 0) {
+      _ofs << "[\n";
+    }
+    for(const auto& timeline : data.timelines) {
+      bool empty = std::all_of(
+        timeline.segments.begin(), timeline.segments.end(),
+        [](const auto& worker){
+          return std::all_of(worker.begin(), worker.end(),
+            [](const auto& level){ return level.empty(); }
+          );
+        }
+      );
+      if(empty && !force) {
+        continue;
+      }
+      if(_num_objects++) {
+        _ofs << ',';
+      }
+      dump_tfprof(_ofs, timeline);
+    }
+  }
+
+  _num_chunks++;
+  _ofs.flush();
+}
+
+// Procedure: _flush_loop
+inline void TFProfManager::_flush_loop() {
+
+  using namespace std::chrono;
+
+  constexpr milliseconds poll {100};
+
+  auto last = steady_clock::now();
+
+  std::unique_lock lock(_stream_mutex);
+
+  while(!_stop) {
+
+    auto interval = _interval;
+    auto max_tasks = _max_tasks;
+
+    auto timeout = max_tasks ? poll : interval;
+    if(interval.count() && interval < timeout) {
+      timeout = interval;
+    }
+
+    if(_stream_cv.wait_for(lock, timeout, [&](){ return _stop; })) {
+      break;
+    }
+
+    interval = _interval;
+    max_tasks = _max_tasks;
+
+    lock.unlock();
+
+    auto now = steady_clock::now();
+
+    if((interval.count() && now - last >= interval) ||
+       (max_tasks && _num_buffered() >= max_tasks)) {
+      _flush(false);
+      last = now;
+    }
+
+    lock.lock();
+  }
+}
+
+// Function: _num_buffered
+inline size_t TFProfManager::_num_buffered() const {
+  std::lock_guard lock(_mutex);
+  size_t s = 0;
+  for(const auto& observer : _observers) {
+    s += observer->_num_buffered();
+  }
+  return s;
+}
+
+// Destructor
+inline TFProfManager::~TFProfManager() {
+
+  stream(std::chrono::milliseconds(0), 0);
+
+  _flush(true);
+
+  if(_ofs.is_open()) {
+    if(!_binary) {
+      _ofs << "]\n";
+    }
+  }
+  // do a summary report in stderr for each observer
+  else {
+    std::ostringstream oss;
+    for(size_t i=0; i<_observers.size(); ++i) {
+      _observers[i]->summary(oss);
+    }
+    fprintf(stderr, "%s", oss.str().c_str());
+  }
+}
+
+// Function: get
+inline TFProfManager& TFProfManager::get() {
+  static TFProfManager mgr;
+  return mgr;
+}
+
+// ----------------------------------------------------------------------------
+// TraceObserver definition
+// ----------------------------------------------------------------------------
+
+/**
+@private
+*/
+struct TraceEvent {
+
+  uint64_t beg;
+  uint64_t end;
+  uint32_t name;
+  uint16_t level;
+  uint8_t type;
+
+  template <typename Archiver>
+  auto save(Archiver& ar) const {
+    return ar(beg, end, name, level, type);
+  }
+
+  template <typename Archiver>
+  auto load(Archiver& ar) {
+    return ar(beg, end, name, level, type);
+  }
+};
+
+/**
+@class TraceData
+
+@brief class to hold the binary trace recorded by a rigel::TraceObserver
+
+A trace data object is a snapshot of the ring buffers of a rigel::TraceObserver.
+It can be saved into a binary stream and converted offline into
+the @ChromeTracing or the @TFProf format:
+
+@code{.cpp}
+// offline conversion of a trace saved by TraceObserver::save
+std::ifstream ifs("trace.bin", std::ios::binary);
+rigel::TraceData data;
+rigel::Deserializer<std::ifstream> deserializer(ifs);
+deserializer(data);
+data.dump_chrome(std::cout);
+@endcode
+*/
+class TraceData {
+
+  friend class TraceObserver;
+
+  public:
+
+    /**
+    @brief dumps the trace into a @ChromeTracing format through an output stream
+    */
+    inline void dump_chrome(std::ostream& ostream) const;
+
+    /**
+    @brief dumps the trace into a @TFProf format through an output stream
+    */
+    inline void dump_tfprof(std::ostream& ostream) const;
+
+    /**
+    @brief queries the number of recorded tasks
+    */
+    inline size_t num_tasks() const;
+
+    /**
+    @brief queries the number of tasks overwritten by newer ones
+    */
+    inline size_t num_overwritten() const;
+
+    /**
+    @brief converts the trace into the timeline of a @TFProf profile
+    */
+    inline Timeline timeline() const;
+
+    /**
+    @private
+    */
+    template <typename Archiver>
+    auto save(Archiver& ar) const {
+      return ar(_uid, _ns_per_tick, _origin, _names, _events, _overwritten);
+    }
+
+    /**
+    @private
+    */
+    template <typename Archiver>
+    auto load(Archiver& ar) {
+      return ar(_uid, _ns_per_tick, _origin, _names, _events, _overwritten);
+    }
+
+  private:
+
+    size_t _uid {0};
+    double _ns_per_tick {1.0};
+    uint64_t _origin {0};
+
+    // _names[0] is the empty name
+    std::vector<std::string> _names;
+    std::vector<std::vector<TraceEvent>> _events;
+    std::vector<uint64_t> _overwritten;
+};
+
+// Function: timeline
+inline Timeline TraceData::timeline() const {
+
+  Timeline timeline;
+
+  timeline.uid = _uid;
+  timeline.origin = observer_stamp_t{};
+  timeline.segments.resize(_events.size());
+
+  auto stamp = [&](uint64_t tick) {
+    auto ns = static_cast<double>(tick - _origin) * _ns_per_tick;
+    return timeline.origin + std::chrono::duration_cast<observer_stamp_t::duration>(
+      std::chrono::duration<double, std::nano>(tick < _origin ? 0.0 : ns)
+    );
+  };
+
+  for(size_t w=0; w<_events.size(); ++w) {
+    for(const auto& e : _events[w]) {
+      if(e.level >= timeline.segments[w].size()) {
+        timeline.segments[w].resize(e.level + 1);
+      }
+      timeline.segments[w][e.level].emplace_back(
+        e.name < _names.size() ? _names[e.name] : std::string(),
+        static_cast<TaskType>(e.type), stamp(e.beg), stamp(e.end)
+      );
+    }
+  }
+
+  return timeline;
+}
+
+// Procedure: dump_tfprof
+inline void TraceData::dump_tfprof(std::ostream& os) const {
+  rigel::dump_tfprof(os, timeline());
+}
+
+// Procedure: dump_chrome
+inline void TraceData::dump_chrome(std::ostream& os) const {
+
+  using namespace std::chrono;
+
+  os << '[';
+
+  bool comma = false;
+
+  for(size_t w=0; w<_events.size(); ++w) {
+    for(size_t i=0; i<_events[w].size(); ++i) {
+
+      const auto& e = _events[w][i];
+
+      if(comma) {
+        os << ',';
+      }
+      else {
+        comma = true;
+      }
+
+      os << '{' << "\"cat\":\"TraceObserver\",";
+
+      // name field
+      os << "\"name\":\"";
+      if(e.name == 0 || e.name >= _names.size()) {
+        os << w << '_' << i;
+      }
+      else {
+        os << _names[e.name];
+      }
+      os << "\",";
+
+      auto beg = e.beg < _origin ? 0.0 : (e.beg - _origin) * _ns_per_tick;
+      auto end = e.end < e.beg ? 0.0 : (e.end - e.beg) * _ns_per_tick;
+
+      // segment field
+      os << "\"ph\":\"X\","
+         << "\"pid\":1,"
+         << "\"tid\":" << w << ','
+         << "\"ts\":" << static_cast<uint64_t>(beg / 1000) << ','
+         << "\"dur\":" << static_cast<uint64_t>(end / 1000) << ','
+         << "\"args\":{\"type\":\"" << to_string(static_cast<TaskType>(e.type)) << "\"}"
+         << '}';
+    }
+  }
+
+  os << "]\n";
+}
+
+// Function: num_tasks
+inline size_t TraceData::num_tasks() const {
+  return std::accumulate(
+    _events.begin(), _events.end(), size_t{0},
+    [](size_t sum, const auto& events){
+      return sum + events.size();
+    }
+  );
+}
+
+// Function: num_overwritten
+inline size_t TraceData::num_overwritten() const {
+  return std::accumulate(_overwritten.begin(), _overwritten.end(), size_t{0});
+}
+
+/**
+@class TraceObserver
+
+@brief class to create an observer that records tasks into per-worker
+binary ring buffers
+
+A rigel::TraceObserver inherits rigel::ObserverInterface and records each
+executed task as a fixed-size binary event with the time stamp counter values
+at the entry and the exit, the task type, the nesting level, and the id of the
+task name interned by the worker.
+Each worker owns a ring buffer of a fixed capacity, and a new event overwrites
+the oldest one when the buffer is full, so the memory of the observer
+is bounded and tracing can be left on.
+Recording a task allocates nothing once the worker has seen the task,
+and only the first execution of a task copies its name.
+An indexed name (rigel::IndexedName) is interned by its prefix and index
+and formatted only when a snapshot is taken.
+
+The recorded events can be dumped into the @ChromeTracing or the @TFProf format,
+or saved into a binary stream by rigel::TraceObserver::save and converted offline
+through rigel::TraceData.
+
+@code{.cpp}
+rigel::Taskflow taskflow;
+rigel::Executor executor;
+
+// insert tasks into taskflow
+// ...
+
+// keep the last 4096 tasks of each worker
+auto observer = executor.make_observer<rigel::TraceObserver>(4096);
+
+// run the taskflow
+executor.run(taskflow).wait();
+
+// save the binary trace for offline conversion
+std::ofstream ofs("trace.bin", std::ios::binary);
+observer->save(ofs);
+@endcode
+
+A snapshot can be taken, dumped, or saved while the executor is running.
+Each ring slot carries the sequence number of the event it holds, and
+the snapshot drops the events overwritten while being copied and counts them
+as overwritten.
+The names interned by a worker are kept in an append-only table that
+grows by fixed-size blocks, so a snapshot never reads a table being
+reallocated.
+Only rigel::TraceObserver::clear must not run concurrently with the executor.
+*/
+class TraceObserver : public ObserverInterface {
+
+  friend class Executor;
+
+  // maximum nesting level with a recorded entry stamp
+  constexpr static size_t MAX_LEVELS = 64;
+
+  // maximum number of names interned by a worker
+  constexpr static size_t MAX_NAMES = 1 << 16;
+
+  // number of names in a block of the name table
+  constexpr static size_t NAME_BLOCK = 1 << 8;
+
+  // an event slot stored in relaxed atomic words, valid only while seq
+  // equals one past the index of the event it holds
+  struct Slot {
+    std::atomic<uint64_t> seq {0};
+    std::atomic<uint64_t> beg {0};
+    std::atomic<uint64_t> end {0};
+    std::atomic<uint64_t> info {0};
+  };
+
+  // an interned name, either an indexed name or a copied string
+  struct Name {
+    const char* prefix {nullptr};
+    size_t index {0};
+    std::string name;
+  };
+
+  struct IndexedNameHash {
+    size_t operator()(const IndexedName& n) const {
+      return std::hash<const void*>()(n.prefix) ^ (n.index * 0x9e3779b97f4a7c15ULL);
+    }
+  };
+
+  struct IndexedNameEqual {
+    bool operator()(const IndexedName& a, const IndexedName& b) const {
+      return a.prefix == b.prefix && a.index == b.index;
+    }
+  };
+
+  struct Buffer {
+    std::unique_ptr<Slot[]> slots;
+    std::atomic<uint64_t> head {0};
+    size_t level {0};
+    std::array<uint64_t, MAX_LEVELS> stack;
+    std::unordered_map<const Node*, uint32_t> node_ids;
+    std::unordered_map<IndexedName, uint32_t, IndexedNameHash, IndexedNameEqual> indexed_ids;
+    // append-only blocks allocated on demand, published by num_names
+    std::array<std::unique_ptr<Name[]>, MAX_NAMES / NAME_BLOCK> names;
+    std::atomic<uint32_t> num_names {0};
+  };
+
+  public:
+
+    /**
+    @brief constructs a trace observer
+
+    @param capacity number of events kept by each worker, rounded up to a power of two
+    */
+    explicit TraceObserver(size_t capacity = 65536);
+
+    /**
+    @brief queries the number of events kept by each worker
+    */
+    size_t capacity() const;
+
+    /**
+    @brief queries the number of tasks currently held in the ring buffers
+    */
+    size_t num_tasks() const;
+
+    /**
+    @brief takes a snapshot of the ring buffers
+    */
+    TraceData data() const;
+
+    /**
+    @brief saves a snapshot of the ring buffers into a binary stream
+    */
+    void save(std::ostream& ostream) const;
+
+    /**
+    @brief dumps the ring buffers into a @ChromeTracing format through
+           an output stream
+    */
+    void dump(std::ostream& ostream) const;
+
+    /**
+    @brief dumps the ring buffers into a @ChromeTracing format
+    */
+    std::string dump() const;
+
+    /**
+    @brief clears the ring buffers
+
+    The executor must not run any task while the ring buffers are cleared.
+    */
+    void clear();
+
+  private:
+
+    size_t _uid;
+    size_t _capacity;
+
+    uint64_t _origin;
+    observer_stamp_t _origin_stamp;
+
+    std::vector<CachelineAligned<Buffer>> _buffers;
+
+    inline void set_up(size_t num_workers) override final;
+    inline void on_entry(WorkerView, TaskView) override final;
+    inline void on_exit(WorkerView, TaskView) override final;
+
+    uint32_t _intern(Buffer&, const TaskView&);
+    uint32_t _append(Buffer&, Name&&);
+
+    static const Name& _name(const Buffer&, size_t);
+};
+
+// constructor
+inline TraceObserver::TraceObserver(size_t capacity) :
+  _uid {unique_id<size_t>()},
+  _capacity {std::max(size_t{1}, next_pow2(capacity))} {
+}
+
+// Procedure: set_up
+inline void TraceObserver::set_up(size_t num_workers) {
+  _buffers = std::vector<CachelineAligned<Buffer>>(num_workers);
+  for(auto& b : _buffers) {
+    b.data.slots = std::make_unique<Slot[]>(_capacity);
+    // id 0 stands for the empty name and has no entry
+    b.data.num_names.store(1, std::memory_order_relaxed);
+  }
+  _origin = read_tsc();
+  _origin_stamp = observer_stamp_t::clock::now();
+}
+
+// Function: _name
+inline const TraceObserver::Name& TraceObserver::_name(const Buffer& b, size_t id) {
+  return b.names[id / NAME_BLOCK][id % NAME_BLOCK];
+}
+
+// Function: _append
+inline uint32_t TraceObserver::_append(Buffer& b, Name&& name) {
+
+  auto id = b.num_names.load(std::memory_order_relaxed);
+
+  if(id >= MAX_NAMES) {
+    return 0;
+  }
+
+  auto& block = b.names[id / NAME_BLOCK];
+  if(!block) {
+    block = std::make_unique<Name[]>(NAME_BLOCK);
+  }
+  block[id % NAME_BLOCK] = std::move(name);
+  b.num_names.store(id + 1, std::memory_order_release);
+  return id;
+}
+
+// Function: _intern
+inline uint32_t TraceObserver::_intern(Buffer& b, const TaskView& tv) {
+
+  const auto& node = tv._node;
+
+  // an indexed name is formatted only when a snapshot is taken
+  if(const auto& indexed = node._indexed_name; indexed.prefix) {
+    if(auto itr = b.indexed_ids.find(indexed); itr != b.indexed_ids.end()) {
+      return itr->second;
+    }
+    auto id = _append(b, Name{indexed.prefix, indexed.index, {}});
+    if(id) {
+      b.indexed_ids.emplace(indexed, id);
+    }
+    return id;
+  }
+
+  const auto& name = node._name;
+
+  if(name.empty()) {
+    return 0;
+  }
+
+  // the node of a destroyed task may be reused by another task
+  if(auto itr = b.node_ids.find(&node); itr != b.node_ids.end()) {
+    if(_name(b, itr->second).name == name) {
+      return itr->second;
+    }
+  }
+
+  auto id = _append(b, Name{nullptr, 0, name});
+  if(id) {
+    b.node_ids[&node] = id;
+  }
+  return id;
+}
+
+// Procedure: on_entry
+inline void TraceObserver::on_entry(WorkerView wv, TaskView) {
+  auto& b = _buffers[wv.id()].data;
+  if(b.level < MAX_LEVELS) {
+    b.stack[b.level] = read_tsc();
+  }
+  ++b.level;
+}
+
+// Procedure: on_exit
+inline void TraceObserver::on_exit(WorkerView wv, TaskView tv) {
+
+  auto& b = _buffers[wv.id()].data;
+
+  assert(b.level > 0);
+
+  auto end = read_tsc();
+  auto level = --b.level;
+  auto head = b.head.load(std::memory_order_relaxed);
+
+  auto& s = b.slots[head & (_capacity - 1)];
+
+  uint64_t info = _intern(b, tv);
+  info |= uint64_t{static_cast<uint16_t>(std::min(level, size_t{UINT16_MAX}))} << 32;
+  info |= uint64_t{static_cast<uint8_t>(tv.type())} << 48;
+
+  // invalidate the slot before overwriting it (seqlock write)
+  s.seq.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  s.beg.store(level < MAX_LEVELS ? b.stack[level] : end, std::memory_order_relaxed);
+  s.end.store(end, std::memory_order_relaxed);
+  s.info.store(info, std::memory_order_relaxed);
+  s.seq.store(head + 1, std::memory_order_release);
+
+  b.head.store(head + 1, std::memory_order_release);
+}
+
+// Function: capacity
+inline size_t TraceObserver::capacity() const {
+  return _capacity;
+}
+
+// Function: num_tasks
+inline size_t TraceObserver::num_tasks() const {
+  size_t n = 0;
+  for(const auto& b : _buffers) {
+    n += std::min<size_t>(b.data.head.load(std::memory_order_acquire), _capacity);
+  }
+  return n;
+}
+
+// Function: data
+inline TraceData TraceObserver::data() const {
+
+  TraceData data;
+
+  data._uid = _uid;
+  data._origin = _origin;
+  data._names.emplace_back();
+  data._events.resize(_buffers.size());
+  data._overwritten.resize(_buffers.size());
+
+  // calibrate the time stamp counter against the steady clock
+  auto ticks = read_tsc() - _origin;
+  auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+    observer_stamp_t::clock::now() - _origin_stamp
+  ).count();
+  data._ns_per_tick = ticks ? static_cast<double>(ns) / ticks : 1.0;
+
+  for(size_t w=0; w<_buffers.size(); ++w) {
+
+    const auto& b = _buffers[w].data;
+
+    uint64_t head = b.head.load(std::memory_order_acquire);
+    uint64_t size = std::min<uint64_t>(head, _capacity);
+
+    data._overwritten[w] = head - size;
+    data._events[w].reserve(size);
+
+    // copy each slot and keep it only if the worker did not overwrite it
+    // in the meantime (seqlock read)
+    for(uint64_t i=head-size; i<head; ++i) {
+      const auto& s = b.slots[i & (_capacity - 1)];
+      if(s.seq.load(std::memory_order_acquire) != i + 1) {
+        data._overwritten[w]++;
+        continue;
+      }
+      TraceEvent e;
+      e.beg = s.beg.load(std::memory_order_relaxed);
+      e.end = s.end.load(std::memory_order_relaxed);
+      auto info = s.info.load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if(s.seq.load(std::memory_order_relaxed) != i + 1) {
+        data._overwritten[w]++;
+        continue;
+      }
+      e.name = static_cast<uint32_t>(info);
+      e.level = static_cast<uint16_t>(info >> 32);
+      e.type = static_cast<uint8_t>(info >> 48);
+      data._events[w].push_back(e);
+    }
+
+    // map the names interned by the worker to the names of the trace;
+    // the names of the copied events were published before their slots
+    size_t num_names = b.num_names.load(std::memory_order_acquire);
+    std::vector<uint32_t> ids(num_names, 0);
+    for(size_t i=1; i<num_names; ++i) {
+      ids[i] = static_cast<uint32_t>(data._names.size());
+      const auto& name = _name(b, i);
+      data._names.push_back(
+        name.prefix ? name.prefix + std::to_string(name.index) : name.name
+      );
+    }
+
+    for(auto& e : data._events[w]) {
+      e.name = e.name < num_names ? ids[e.name] : 0;
+    }
+  }
+
+  return data;
+}
+
+// Procedure: save
+inline void TraceObserver::save(std::ostream& os) const {
+  Serializer<std::ostream> serializer(os);
+  serializer(data());
+}
+
+// Procedure: dump
+inline void TraceObserver::dump(std::ostream& os) const {
+  data().dump_chrome(os);
+}
+
+// Function: dump
+inline std::string TraceObserver::dump() const {
+  std::ostringstream oss;
+  dump(oss);
+  return oss.str();
+}
+
+// Procedure: clear
+inline void TraceObserver::clear() {
+  for(auto& b : _buffers) {
+    b.data.head.store(0, std::memory_order_relaxed);
+    b.data.level = 0;
+  }
 }
 
 // ----------------------------------------------------------------------------
@@ -1040,6 +2024,8 @@ inline TFProfManager& TFProfManager::get() {
 enum class ObserverType : int {
   TFPROF = 0,
   CHROME,
+  TRACE,
+  PERF,
   UNDEFINED
 };
 
@@ -1050,6 +2036,8 @@ inline const char* to_string(ObserverType type) {
   switch(type) {
     case ObserverType::TFPROF: return "tfprof";
     case ObserverType::CHROME: return "chrome";
+    case ObserverType::TRACE:  return "trace";
+    case ObserverType::PERF:   return "perf";
     default:                   return "undefined";
   }
 }
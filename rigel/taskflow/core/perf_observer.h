@@ -0,0 +1,565 @@
+// Copyright 2023 The titan-search Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#pragma once
+
+#include <cstring>
+#include <iomanip>
+
+#include "rigel/taskflow/core/taskflow.h"
+#include "rigel/taskflow/core/observer.h"
+
+#if defined(__linux__)
+  #include <linux/perf_event.h>
+  #include <sys/ioctl.h>
+  #include <sys/syscall.h>
+  #include <unistd.h>
+  #define TF_HAS_PERF_EVENT 1
+#endif
+
+/**
+@file perf_observer.h
+@brief hardware performance counter observer include file
+*/
+
+namespace rigel {
+
+// ----------------------------------------------------------------------------
+// PerfCounters
+// ----------------------------------------------------------------------------
+
+/**
+@enum PerfEvent
+
+@brief enumeration of the hardware events counted by rigel::PerfCounterObserver
+*/
+enum class PerfEvent : int {
+  /** @brief CPU cycles */
+  CYCLES = 0,
+  /** @brief retired instructions */
+  INSTRUCTIONS,
+  /** @brief last-level cache misses */
+  LLC_MISSES,
+  /** @brief mispredicted branches */
+  BRANCH_MISSES,
+  /** @brief conventional value for iterating events */
+  MAX
+};
+
+/**
+@brief convert a performance event to a human-readable string
+*/
+inline const char* to_string(PerfEvent event) {
+  switch(event) {
+    case PerfEvent::CYCLES:        return "cycles";
+    case PerfEvent::INSTRUCTIONS:  return "instructions";
+    case PerfEvent::LLC_MISSES:    return "llc_misses";
+    case PerfEvent::BRANCH_MISSES: return "branch_misses";
+    default:                       return "undefined";
+  }
+}
+
+/**
+@private
+*/
+inline constexpr size_t NUM_PERF_EVENTS = static_cast<size_t>(PerfEvent::MAX);
+
+/**
+@struct PerfCounters
+
+@brief struct to hold the counters accumulated over a set of task executions
+*/
+struct PerfCounters {
+
+  /** @brief number of task executions */
+  uint64_t count {0};
+
+  /** @brief wall-clock time of the executions in nanoseconds */
+  uint64_t ns {0};
+
+  /** @brief hardware event counts indexed by rigel::PerfEvent */
+  std::array<uint64_t, NUM_PERF_EVENTS> events {};
+
+  /**
+  @brief queries the count of a hardware event
+  */
+  uint64_t operator [] (PerfEvent e) const { return events[static_cast<size_t>(e)]; }
+
+  /**
+  @brief queries the instructions per cycle
+  */
+  double ipc() const {
+    auto c = (*this)[PerfEvent::CYCLES];
+    return c ? static_cast<double>((*this)[PerfEvent::INSTRUCTIONS]) / c : 0.0;
+  }
+
+  /**
+  @brief queries the last-level cache misses per thousand instructions
+  */
+  double llc_mpki() const {
+    auto i = (*this)[PerfEvent::INSTRUCTIONS];
+    return i ? 1000.0 * (*this)[PerfEvent::LLC_MISSES] / i : 0.0;
+  }
+
+  /**
+  @brief adds the counters of another set of executions
+  */
+  PerfCounters& operator += (const PerfCounters& rhs) {
+    count += rhs.count;
+    ns += rhs.ns;
+    for(size_t e=0; e<NUM_PERF_EVENTS; e++) {
+      events[e] += rhs.events[e];
+    }
+    return *this;
+  }
+};
+
+/**
+@struct PerfCounterRecord
+
+@brief struct to hold the counters of one task name in one taskflow
+*/
+struct PerfCounterRecord {
+
+  /** @brief name of the taskflow (empty for tasks outside a taskflow) */
+  std::string taskflow;
+
+  /** @brief name of the task */
+  std::string name;
+
+  /** @brief type of the task */
+  TaskType type;
+
+  /** @brief counters accumulated over all executions of the task */
+  PerfCounters counters;
+};
+
+// ----------------------------------------------------------------------------
+// PerfCounterObserver
+// ----------------------------------------------------------------------------
+
+/**
+@class PerfCounterObserver
+
+@brief class to create an observer that reads hardware performance counters
+
+Each worker opens a @c perf_event group of CPU cycles, retired instructions,
+last-level cache misses and branch misses for its own thread
+(user space only) the first time it runs a task.
+The counters are read before and after each task and the differences are
+accumulated per taskflow and task name, which tells memory-bound tasks
+(high cache misses per instruction, low instructions per cycle)
+from compute-bound ones.
+
+@code{.cpp}
+auto observer = executor.make_observer<rigel::PerfCounterObserver>();
+executor.run(taskflow).wait();
+observer->dump(std::cout);
+@endcode
+
+If the counters are unavailable (e.g., a non-Linux system, a kernel
+without perf support, or a restrictive @c perf_event_paranoid setting),
+the observer still counts executions and their wall-clock time and
+rigel::PerfCounterObserver::available returns @c false.
+Counts of a task include the tasks it runs inline (e.g., a subflow it joins).
+*/
+class PerfCounterObserver : public ObserverInterface {
+
+  friend class Executor;
+
+  public:
+
+    /**
+    @brief destructs the observer and closes the counters
+    */
+    ~PerfCounterObserver();
+
+    /**
+    @brief queries if any worker reads hardware counters
+    */
+    bool available() const;
+
+    /**
+    @brief queries if the given event is counted by any worker
+    */
+    bool available(PerfEvent event) const;
+
+    /**
+    @brief queries the counters of each task name in each taskflow
+
+    The records are merged across workers and sorted by decreasing cycles
+    (or wall-clock time if cycles are unavailable).
+    */
+    std::vector<PerfCounterRecord> records() const;
+
+    /**
+    @brief queries the counters of each taskflow
+    */
+    std::vector<PerfCounterRecord> taskflows() const;
+
+    /**
+    @brief queries the number of task executions observed
+    */
+    size_t num_tasks() const;
+
+    /**
+    @brief clears the counters
+    */
+    void clear();
+
+    /**
+    @brief dumps a report of the counters through an output stream
+    */
+    void dump(std::ostream& ostream) const;
+
+    /**
+    @brief dumps a report of the counters to a string
+    */
+    std::string dump() const;
+
+  private:
+
+    struct Sample {
+      uint64_t ns;
+      std::array<uint64_t, NUM_PERF_EVENTS> events;
+    };
+
+    struct Worker {
+      mutable std::mutex mutex;
+      bool opened {false};
+      int leader {-1};
+      std::array<int, NUM_PERF_EVENTS> fds;
+      // position of each event in a group read, or -1 if not counted
+      std::array<int, NUM_PERF_EVENTS> slots;
+      size_t num_slots {0};
+      std::vector<Sample> stack;
+      std::unordered_map<std::string, PerfCounterRecord> records;
+    };
+
+    std::vector<std::unique_ptr<CachelineAligned<Worker>>> _workers;
+
+    void set_up(size_t num_workers) override final;
+    void on_entry(WorkerView, TaskView) override final;
+    void on_exit(WorkerView, TaskView) override final;
+
+    static void _open(Worker&);
+    static void _close(Worker&);
+    static void _read(const Worker&, Sample&);
+
+    template <typename K>
+    std::vector<PerfCounterRecord> _merge(K&&) const;
+};
+
+// Destructor
+inline PerfCounterObserver::~PerfCounterObserver() {
+  for(auto& w : _workers) {
+    _close(w->data);
+  }
+}
+
+// Procedure: set_up
+inline void PerfCounterObserver::set_up(size_t num_workers) {
+  _workers.resize(num_workers);
+  for(auto& w : _workers) {
+    w = std::make_unique<CachelineAligned<Worker>>();
+    w->data.fds.fill(-1);
+    w->data.slots.fill(-1);
+  }
+}
+
+// Procedure: _open
+// opens the counter group of the calling thread; events the hardware
+// or the kernel does not support are left out of the group
+inline void PerfCounterObserver::_open(Worker& w) {
+
+  w.opened = true;
+
+#if defined(TF_HAS_PERF_EVENT)
+
+  constexpr std::array<uint64_t, NUM_PERF_EVENTS> configs = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES
+  };
+
+  for(size_t e=0; e<NUM_PERF_EVENTS; e++) {
+
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = configs[e];
+    attr.read_format = PERF_FORMAT_GROUP;
+    attr.disabled = (w.leader == -1);
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    int fd = static_cast<int>(
+      syscall(SYS_perf_event_open, &attr, 0, -1, w.leader, 0)
+    );
+
+    if(fd == -1) {
+      continue;
+    }
+
+    if(w.leader == -1) {
+      w.leader = fd;
+    }
+
+    w.fds[e] = fd;
+    w.slots[e] = static_cast<int>(w.num_slots++);
+  }
+
+  if(w.leader != -1) {
+    ioctl(w.leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(w.leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  }
+#endif
+}
+
+// Procedure: _close
+inline void PerfCounterObserver::_close(Worker& w) {
+#if defined(TF_HAS_PERF_EVENT)
+  for(auto& fd : w.fds) {
+    if(fd != -1) {
+      close(fd);
+      fd = -1;
+    }
+  }
+#endif
+  w.leader = -1;
+}
+
+// Procedure: _read
+inline void PerfCounterObserver::_read(const Worker& w, Sample& s) {
+
+  s.ns = static_cast<uint64_t>(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()
+    ).count()
+  );
+
+  s.events.fill(0);
+
+#if defined(TF_HAS_PERF_EVENT)
+  if(w.leader != -1) {
+    // { nr, values[nr] }
+    uint64_t buf[1 + NUM_PERF_EVENTS];
+    if(::read(w.leader, buf, sizeof(buf)) > 0) {
+      for(size_t e=0; e<NUM_PERF_EVENTS; e++) {
+        if(w.slots[e] != -1 && static_cast<uint64_t>(w.slots[e]) < buf[0]) {
+          s.events[e] = buf[1 + w.slots[e]];
+        }
+      }
+    }
+  }
+#endif
+}
+
+// Procedure: on_entry
+inline void PerfCounterObserver::on_entry(WorkerView wv, TaskView) {
+
+  auto& w = _workers[wv.id()]->data;
+
+  // workers open their counters from their own thread
+  if(!w.opened) {
+    _open(w);
+  }
+
+  w.stack.emplace_back();
+  _read(w, w.stack.back());
+}
+
+// Procedure: on_exit
+inline void PerfCounterObserver::on_exit(WorkerView wv, TaskView tv) {
+
+  auto& w = _workers[wv.id()]->data;
+
+  assert(!w.stack.empty());
+
+  Sample end;
+  _read(w, end);
+
+  auto beg = w.stack.back();
+  w.stack.pop_back();
+
+  auto taskflow = tv.taskflow();
+
+  // taskflow and task names separated by a unit separator
+  std::string key = taskflow ? taskflow->name() : std::string();
+  key += '\x1f';
+  key += tv.name();
+
+  std::lock_guard<std::mutex> lock(w.mutex);
+
+  auto [itr, inserted] = w.records.try_emplace(std::move(key));
+  auto& r = itr->second;
+
+  if(inserted) {
+    r.taskflow = taskflow ? taskflow->name() : std::string();
+    r.name = tv.name();
+    r.type = tv.type();
+  }
+
+  r.counters.count++;
+  r.counters.ns += end.ns - beg.ns;
+  for(size_t e=0; e<NUM_PERF_EVENTS; e++) {
+    r.counters.events[e] += end.events[e] - beg.events[e];
+  }
+}
+
+// Function: available
+inline bool PerfCounterObserver::available() const {
+  for(const auto& w : _workers) {
+    std::lock_guard<std::mutex> lock(w->data.mutex);
+    if(w->data.leader != -1) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Function: available
+inline bool PerfCounterObserver::available(PerfEvent event) const {
+  for(const auto& w : _workers) {
+    std::lock_guard<std::mutex> lock(w->data.mutex);
+    if(w->data.slots[static_cast<size_t>(event)] != -1) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Function: _merge
+template <typename K>
+std::vector<PerfCounterRecord> PerfCounterObserver::_merge(K&& key) const {
+
+  std::vector<PerfCounterRecord> records;
+  std::unordered_map<std::string, size_t> index;
+
+  for(const auto& w : _workers) {
+    std::lock_guard<std::mutex> lock(w->data.mutex);
+    for(const auto& [k, r] : w->data.records) {
+      auto [itr, inserted] = index.try_emplace(key(k, r), records.size());
+      if(inserted) {
+        records.push_back(r);
+      }
+      else {
+        records[itr->second].counters += r.counters;
+      }
+    }
+  }
+
+  std::sort(records.begin(), records.end(), [](const auto& a, const auto& b){
+    auto ca = a.counters[PerfEvent::CYCLES];
+    auto cb = b.counters[PerfEvent::CYCLES];
+    return ca != cb ? ca > cb : a.counters.ns > b.counters.ns;
+  });
+
+  return records;
+}
+
+// Function: records
+inline std::vector<PerfCounterRecord> PerfCounterObserver::records() const {
+  return _merge([](const std::string& k, const PerfCounterRecord&){ return k; });
+}
+
+// Function: taskflows
+inline std::vector<PerfCounterRecord> PerfCounterObserver::taskflows() const {
+  auto records = _merge([](const std::string&, const PerfCounterRecord& r){
+    return r.taskflow;
+  });
+  for(auto& r : records) {
+    r.name.clear();
+    r.type = TaskType::UNDEFINED;
+  }
+  return records;
+}
+
+// Function: num_tasks
+inline size_t PerfCounterObserver::num_tasks() const {
+  size_t n = 0;
+  for(const auto& w : _workers) {
+    std::lock_guard<std::mutex> lock(w->data.mutex);
+    for(const auto& [k, r] : w->data.records) {
+      n += r.counters.count;
+    }
+  }
+  return n;
+}
+
+// Procedure: clear
+inline void PerfCounterObserver::clear() {
+  for(auto& w : _workers) {
+    std::lock_guard<std::mutex> lock(w->data.mutex);
+    w->data.records.clear();
+  }
+}
+
+// Procedure: dump
+inline void PerfCounterObserver::dump(std::ostream& os) const {
+
+  auto records = this->records();
+
+  os << "==PerfCounterObserver: " << num_tasks() << " tasks"
+     << (available() ? "" : " (hardware counters unavailable)") << '\n';
+
+  size_t tf_w = 10, name_w = 6;
+  for(const auto& r : records) {
+    tf_w = std::max(tf_w, r.taskflow.size());
+    name_w = std::max(name_w, r.name.size());
+  }
+
+  os << std::setw(tf_w+2) << "-Taskflow-"
+     << std::setw(name_w+2) << "-Task-"
+     << std::setw(10) << "Type"
+     << std::setw(10) << "Count"
+     << std::setw(12) << "Time(us)"
+     << std::setw(16) << "Cycles"
+     << std::setw(16) << "Instructions"
+     << std::setw(8) << "IPC"
+     << std::setw(14) << "LLC-Misses"
+     << std::setw(8) << "MPKI"
+     << std::setw(14) << "Br-Misses"
+     << '\n';
+
+  for(const auto& r : records) {
+    const auto& c = r.counters;
+    std::ostringstream ipc, mpki;
+    ipc << std::fixed << std::setprecision(2) << c.ipc();
+    mpki << std::fixed << std::setprecision(2) << c.llc_mpki();
+    os << std::setw(tf_w+2) << r.taskflow
+       << std::setw(name_w+2) << r.name
+       << std::setw(10) << to_string(r.type)
+       << std::setw(10) << c.count
+       << std::setw(12) << c.ns / 1000
+       << std::setw(16) << c[PerfEvent::CYCLES]
+       << std::setw(16) << c[PerfEvent::INSTRUCTIONS]
+       << std::setw(8) << ipc.str()
+       << std::setw(14) << c[PerfEvent::LLC_MISSES]
+       << std::setw(8) << mpki.str()
+       << std::setw(14) << c[PerfEvent::BRANCH_MISSES]
+       << '\n';
+  }
+}
+
+// Function: dump
+inline std::string PerfCounterObserver::dump() const {
+  std::ostringstream oss;
+  dump(oss);
+  return oss.str();
+}
+
+}  // end of namespace rigel -----------------------------------------------------
@@ -0,0 +1,569 @@
+// Copyright 2023 The titan-search Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#pragma once
+
+#include <deque>
+#include <string_view>
+
+#include "rigel/taskflow/core/taskflow.h"
+
+/**
+@file snapshot.h
+@brief taskflow snapshot include file
+*/
+
+namespace rigel {
+
+// ----------------------------------------------------------------------------
+// SnapshotGraph
+// ----------------------------------------------------------------------------
+
+/**
+@class SnapshotGraph
+
+@brief class to hold the structure of one graph in a rigel::TaskflowSnapshot
+
+Tasks are identified by their positions in the graph, i.e., the order
+in which they were created.
+The structure is laid out as flat arrays
+(task names concatenated into one string and successors in compressed
+sparse rows) such that saving and loading a graph moves a handful of
+contiguous blocks regardless of its size.
+*/
+class SnapshotGraph {
+
+  friend class TaskflowSnapshot;
+
+  public:
+
+    /**
+    @brief queries the number of tasks
+    */
+    size_t size() const { return _types.size(); }
+
+    /**
+    @brief queries the number of dependencies
+    */
+    size_t num_dependencies() const { return _successors.size(); }
+
+    /**
+    @brief queries the name of a task
+    */
+    std::string_view name(size_t id) const {
+      return std::string_view(_names).substr(
+        _name_offsets[id], _name_offsets[id+1] - _name_offsets[id]
+      );
+    }
+
+    /**
+    @brief queries the type of a task
+    */
+    TaskType type(size_t id) const { return static_cast<TaskType>(_types[id]); }
+
+    /**
+    @brief queries the priority of a task
+    */
+    TaskPriority priority(size_t id) const {
+      return static_cast<TaskPriority>(_priorities[id]);
+    }
+
+    /**
+    @brief queries the number of successors of a task
+    */
+    size_t num_successors(size_t id) const {
+      return _successor_offsets[id+1] - _successor_offsets[id];
+    }
+
+    /**
+    @brief applies a visitor to the ids of the successors of a task
+    */
+    template <typename V>
+    void for_each_successor(size_t id, V&& visitor) const {
+      for(auto i=_successor_offsets[id]; i<_successor_offsets[id+1]; ++i) {
+        visitor(static_cast<size_t>(_successors[i]));
+      }
+    }
+
+    /**
+    @brief serializes the graph (used by rigel::Serializer)
+    */
+    template <typename Archiver>
+    auto save(Archiver& ar) const {
+      return ar(
+        _types, _priorities, _name_offsets, _names,
+        _successor_offsets, _successors,
+        _module_tasks, _module_graphs,
+        _acquire_tasks, _acquire_semaphores,
+        _release_tasks, _release_semaphores
+      );
+    }
+
+    /**
+    @brief deserializes the graph (used by rigel::Deserializer)
+    */
+    template <typename Archiver>
+    auto load(Archiver& ar) {
+      return ar(
+        _types, _priorities, _name_offsets, _names,
+        _successor_offsets, _successors,
+        _module_tasks, _module_graphs,
+        _acquire_tasks, _acquire_semaphores,
+        _release_tasks, _release_semaphores
+      );
+    }
+
+  private:
+
+    std::vector<uint8_t> _types;
+    std::vector<uint8_t> _priorities;
+
+    std::vector<uint64_t> _name_offsets {0};
+    std::string _names;
+
+    std::vector<uint64_t> _successor_offsets {0};
+    std::vector<uint32_t> _successors;
+
+    // module tasks and the graphs they compose, in task order
+    std::vector<uint32_t> _module_tasks;
+    std::vector<uint32_t> _module_graphs;
+
+    // (task, semaphore) pairs in the order the task acquires/releases them
+    std::vector<uint32_t> _acquire_tasks;
+    std::vector<uint32_t> _acquire_semaphores;
+    std::vector<uint32_t> _release_tasks;
+    std::vector<uint32_t> _release_semaphores;
+};
+
+// ----------------------------------------------------------------------------
+// RestoredTaskflow
+// ----------------------------------------------------------------------------
+
+/**
+@class RestoredTaskflow
+
+@brief class to own a taskflow rebuilt from a rigel::TaskflowSnapshot
+
+A restored taskflow owns the rebuilt top-level taskflow together with
+the taskflows of its modules and the semaphores its tasks acquire,
+so it must outlive every run of the taskflow.
+Module tasks are composed of their restored modules;
+all other tasks come back as placeholders with their names,
+priorities, dependencies and semaphores,
+and their callables are bound by task name or by task id:
+
+@code{.cpp}
+auto restored = snapshot.restore();
+restored.bind("load", [](){ load(); });
+restored.bind("check", [](){ return valid() ? 0 : 1; });
+restored.bind(0, [](rigel::Subflow& sf){ expand(sf); });
+executor.run(restored.taskflow()).wait();
+@endcode
+
+Unbound tasks run as placeholders, doing nothing.
+A condition task must be bound before the run, or
+the weak dependencies it had become strong ones.
+*/
+class RestoredTaskflow {
+
+  friend class TaskflowSnapshot;
+
+  public:
+
+    /**
+    @brief queries the rebuilt top-level taskflow
+    */
+    Taskflow& taskflow() { return _taskflow; }
+
+    /**
+    @brief queries the number of graphs (the top-level graph and its modules)
+    */
+    size_t num_graphs() const { return _tasks.size(); }
+
+    /**
+    @brief queries the task of the given id in the given graph
+
+    Graph 0 is the top-level graph and the others are modules,
+    following rigel::TaskflowSnapshot::graph.
+    */
+    Task task(size_t id, size_t graph = 0) const { return _tasks[graph][id]; }
+
+    /**
+    @brief binds a callable to every task of the given name in all graphs
+
+    @return the number of tasks bound
+    */
+    template <typename C>
+    size_t bind(const std::string& name, C&& callable);
+
+    /**
+    @brief binds a callable to the task of the given id in the top-level graph
+    */
+    template <typename C>
+    RestoredTaskflow& bind(size_t id, C&& callable);
+
+  private:
+
+    RestoredTaskflow() = default;
+
+    Taskflow _taskflow;
+    std::deque<Taskflow> _modules;
+    std::deque<Semaphore> _semaphores;
+
+    std::vector<std::vector<Task>> _tasks;
+
+    // built on the first bind by name
+    std::unordered_map<std::string, std::vector<Task>> _index;
+};
+
+// Function: bind
+template <typename C>
+size_t RestoredTaskflow::bind(const std::string& name, C&& callable) {
+
+  if(_index.empty()) {
+    for(const auto& tasks : _tasks) {
+      for(const auto& task : tasks) {
+        if(!task.name().empty() && task.type() != TaskType::MODULE) {
+          _index[task.name()].push_back(task);
+        }
+      }
+    }
+  }
+
+  auto itr = _index.find(name);
+
+  if(itr == _index.end()) {
+    return 0;
+  }
+
+  for(auto task : itr->second) {
+    task.work(callable);
+  }
+
+  return itr->second.size();
+}
+
+// Function: bind
+template <typename C>
+RestoredTaskflow& RestoredTaskflow::bind(size_t id, C&& callable) {
+  _tasks[0][id].work(std::forward<C>(callable));
+  return *this;
+}
+
+// ----------------------------------------------------------------------------
+// TaskflowSnapshot
+// ----------------------------------------------------------------------------
+
+/**
+@class TaskflowSnapshot
+
+@brief class to save and load the structure of a taskflow in a binary form
+
+A snapshot captures everything about a taskflow except its callables:
+task names, types, priorities, dependencies, semaphores
+and the graphs of composed modules.
+Loading a snapshot and restoring it is much faster than replaying the
+code that built a large taskflow, and the binary form is far more
+compact than a GraphViz dump.
+
+@code{.cpp}
+// save
+std::ofstream ofs("taskflow.snapshot", std::ios::binary);
+rigel::TaskflowSnapshot(taskflow).save(ofs);
+
+// load and restore with the callables bound by name
+std::ifstream ifs("taskflow.snapshot", std::ios::binary);
+rigel::TaskflowSnapshot snapshot;
+snapshot.load(ifs);
+auto restored = snapshot.restore();
+restored.bind("A", [](){ std::cout << "A\n"; });
+executor.run(restored.taskflow()).wait();
+@endcode
+
+Tasks spawned at runtime (e.g., subflow tasks) are not part of a taskflow
+and are not captured; subflow tasks are restored and rebuild their
+subflows when they run.
+*/
+class TaskflowSnapshot {
+
+  public:
+
+    /**
+    @brief constructs an empty snapshot
+    */
+    TaskflowSnapshot() = default;
+
+    /**
+    @brief captures the structure of a taskflow
+
+    The taskflow must not be running.
+    */
+    explicit TaskflowSnapshot(const Taskflow& taskflow);
+
+    /**
+    @brief queries the name of the captured taskflow
+    */
+    const std::string& name() const { return _name; }
+
+    /**
+    @brief queries the number of graphs (the top-level graph and its modules)
+    */
+    size_t num_graphs() const { return _graphs.size(); }
+
+    /**
+    @brief queries a graph
+
+    Graph 0 is the top-level graph of the taskflow and the others are
+    the graphs of composed modules in the order they are first reached.
+    */
+    const SnapshotGraph& graph(size_t g = 0) const { return _graphs[g]; }
+
+    /**
+    @brief queries the number of tasks in all graphs
+    */
+    size_t num_tasks() const;
+
+    /**
+    @brief queries the number of semaphores
+    */
+    size_t num_semaphores() const { return _semaphores.size(); }
+
+    /**
+    @brief queries the graph composed by a module task, or @c -1
+           if the task is not a module task
+    */
+    size_t module_of(size_t id, size_t g = 0) const;
+
+    /**
+    @brief saves the snapshot into a binary stream
+
+    The stream can be a @c std::ostream or a rigel::BufferStream.
+    */
+    template <typename Stream>
+    void save(Stream& stream) const;
+
+    /**
+    @brief loads a snapshot saved by rigel::TaskflowSnapshot::save
+
+    The stream can be a @c std::istream or a rigel::ViewStream,
+    e.g., over a rigel::MappedFile.
+
+    @throws std::runtime_error if the stream does not hold a snapshot
+    */
+    template <typename Stream>
+    void load(Stream& stream);
+
+    /**
+    @brief rebuilds the taskflow from the snapshot
+    */
+    RestoredTaskflow restore() const;
+
+  private:
+
+    static constexpr uint32_t MAGIC = 0x53465452;  // "RTFS"
+    static constexpr uint32_t VERSION = 1;
+
+    std::string _name;
+    std::vector<uint64_t> _semaphores;
+    std::vector<SnapshotGraph> _graphs;
+};
+
+// Constructor
+inline TaskflowSnapshot::TaskflowSnapshot(const Taskflow& taskflow) :
+  _name {taskflow.name()} {
+
+  std::vector<const Graph*> graphs {&taskflow._graph};
+  std::unordered_map<const Graph*, uint32_t> graph_ids {{&taskflow._graph, 0}};
+  std::unordered_map<const Semaphore*, uint32_t> semaphore_ids;
+
+  std::unordered_map<const Node*, uint32_t> ids;
+
+  auto semaphore_id = [&](Semaphore* s){
+    auto [itr, inserted] = semaphore_ids.try_emplace(
+      s, static_cast<uint32_t>(_semaphores.size())
+    );
+    if(inserted) {
+      _semaphores.push_back(s->count());
+    }
+    return itr->second;
+  };
+
+  // graphs of modules are appended as they are reached
+  for(size_t g=0; g<graphs.size(); ++g) {
+
+    const auto& nodes = graphs[g]->_nodes;
+
+    SnapshotGraph sg;
+    sg._types.reserve(nodes.size());
+    sg._priorities.reserve(nodes.size());
+    sg._name_offsets.reserve(nodes.size() + 1);
+    sg._successor_offsets.reserve(nodes.size() + 1);
+
+    ids.clear();
+    ids.reserve(nodes.size());
+    for(size_t i=0; i<nodes.size(); ++i) {
+      ids[nodes[i]] = static_cast<uint32_t>(i);
+    }
+
+    for(size_t i=0; i<nodes.size(); ++i) {
+
+      auto node = nodes[i];
+      auto type = Task(node).type();
+
+      sg._types.push_back(static_cast<uint8_t>(type));
+      sg._priorities.push_back(static_cast<uint8_t>(node->_priority));
+
+      sg._names += node->name();
+      sg._name_offsets.push_back(sg._names.size());
+
+      for(auto succ : node->_successors) {
+        sg._successors.push_back(ids.at(succ));
+      }
+      sg._successor_offsets.push_back(sg._successors.size());
+
+      if(type == TaskType::MODULE) {
+        const Graph* module = &std::get_if<Node::Module>(&node->_handle)->graph;
+        auto [itr, inserted] = graph_ids.try_emplace(
+          module, static_cast<uint32_t>(graphs.size())
+        );
+        if(inserted) {
+          graphs.push_back(module);
+        }
+        sg._module_tasks.push_back(static_cast<uint32_t>(i));
+        sg._module_graphs.push_back(itr->second);
+      }
+
+      if(node->_semaphores) {
+        for(auto s : node->_semaphores->to_acquire) {
+          sg._acquire_tasks.push_back(static_cast<uint32_t>(i));
+          sg._acquire_semaphores.push_back(semaphore_id(s));
+        }
+        for(auto s : node->_semaphores->to_release) {
+          sg._release_tasks.push_back(static_cast<uint32_t>(i));
+          sg._release_semaphores.push_back(semaphore_id(s));
+        }
+      }
+    }
+
+    _graphs.push_back(std::move(sg));
+  }
+}
+
+// Function: num_tasks
+inline size_t TaskflowSnapshot::num_tasks() const {
+  size_t n = 0;
+  for(const auto& g : _graphs) {
+    n += g.size();
+  }
+  return n;
+}
+
+// Function: module_of
+inline size_t TaskflowSnapshot::module_of(size_t id, size_t g) const {
+  const auto& tasks = _graphs[g]._module_tasks;
+  auto itr = std::lower_bound(tasks.begin(), tasks.end(), static_cast<uint32_t>(id));
+  if(itr == tasks.end() || *itr != id) {
+    return static_cast<size_t>(-1);
+  }
+  return _graphs[g]._module_graphs[itr - tasks.begin()];
+}
+
+// Procedure: save
+template <typename Stream>
+void TaskflowSnapshot::save(Stream& os) const {
+  Serializer<Stream> serializer(os);
+  serializer(MAGIC, VERSION, _name, _semaphores, _graphs);
+}
+
+// Procedure: load
+template <typename Stream>
+void TaskflowSnapshot::load(Stream& is) {
+
+  Deserializer<Stream> deserializer(is);
+
+  uint32_t magic {0}, version {0};
+  deserializer(magic, version);
+
+  if(magic != MAGIC || version != VERSION) {
+    TF_THROW("not a taskflow snapshot (magic=", magic, ", version=", version, ")");
+  }
+
+  _name.clear();
+  _semaphores.clear();
+  _graphs.clear();
+
+  deserializer(_name, _semaphores, _graphs);
+
+  if(!is) {
+    TF_THROW("truncated taskflow snapshot");
+  }
+}
+
+// Function: restore
+inline RestoredTaskflow TaskflowSnapshot::restore() const {
+
+  RestoredTaskflow r;
+
+  r._taskflow.name(_name);
+
+  for(auto count : _semaphores) {
+    r._semaphores.emplace_back(static_cast<size_t>(count));
+  }
+
+  for(size_t g=1; g<_graphs.size(); ++g) {
+    r._modules.emplace_back();
+  }
+
+  r._tasks.resize(_graphs.size());
+
+  for(size_t g=0; g<_graphs.size(); ++g) {
+
+    const auto& sg = _graphs[g];
+    auto& graph = g ? r._modules[g-1]._graph : r._taskflow._graph;
+    auto& tasks = r._tasks[g];
+
+    tasks.reserve(sg.size());
+    graph._nodes.reserve(sg.size());
+
+    for(size_t i=0; i<sg.size(); ++i) {
+      auto node = graph._emplace_back(
+        std::string(sg.name(i)), static_cast<unsigned>(sg._priorities[i]),
+        nullptr, nullptr, 0, std::in_place_type_t<Node::Placeholder>{}
+      );
+      tasks.push_back(Task(node));
+    }
+
+    for(size_t i=0; i<sg.size(); ++i) {
+      sg.for_each_successor(i, [&](size_t s){
+        tasks[i]._node->_precede(tasks[s]._node);
+      });
+    }
+
+    for(size_t m=0; m<sg._module_tasks.size(); ++m) {
+      tasks[sg._module_tasks[m]].composed_of(r._modules[sg._module_graphs[m] - 1]);
+    }
+
+    for(size_t k=0; k<sg._acquire_tasks.size(); ++k) {
+      tasks[sg._acquire_tasks[k]].acquire(r._semaphores[sg._acquire_semaphores[k]]);
+    }
+
+    for(size_t k=0; k<sg._release_tasks.size(); ++k) {
+      tasks[sg._release_tasks[k]].release(r._semaphores[sg._release_semaphores[k]]);
+    }
+  }
+
+  return r;
+}
+
+}  // end of namespace rigel -----------------------------------------------------
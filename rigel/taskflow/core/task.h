@@ -45,6 +45,8 @@ enum class TaskType : int {
   MODULE,
   /** @brief asynchronous task type */
   ASYNC,
+  /** @brief coroutine task type */
+  COROUTINE,
   /** @brief undefined task type (for internal use only) */
   UNDEFINED
 };
@@ -53,13 +55,14 @@ enum class TaskType : int {
 @private
 @brief array of all task types (used for iterating task types)
 */
-inline constexpr std::array<TaskType, 6> TASK_TYPES = {
+inline constexpr std::array<TaskType, 7> TASK_TYPES = {
   TaskType::PLACEHOLDER,
   TaskType::STATIC,
   TaskType::DYNAMIC,
   TaskType::CONDITION,
   TaskType::MODULE,
   TaskType::ASYNC,
+  TaskType::COROUTINE,
 };
 
 /**
@@ -74,6 +77,7 @@ TaskType::DYNAMIC         ->  "subflow"
 TaskType::CONDITION       ->  "condition"
 TaskType::MODULE          ->  "module"
 TaskType::ASYNC           ->  "async"
+TaskType::COROUTINE       ->  "coroutine"
 @endcode
 */
 inline const char* to_string(TaskType type) {
@@ -87,6 +91,7 @@ inline const char* to_string(TaskType type) {
     case TaskType::CONDITION:        val = "condition";       break;
     case TaskType::MODULE:           val = "module";          break;
     case TaskType::ASYNC:            val = "async";           break;
+    case TaskType::COROUTINE:        val = "coroutine";       break;
     default:                         val = "undefined";       break;
   }
 
@@ -131,6 +136,21 @@ constexpr bool is_multi_condition_task_v =
   std::is_invocable_r_v<SmallVector<int>, C, Runtime&>) &&
   !is_dynamic_task_v<C>;
 
+/**
+@brief determines if a callable is a coroutine task
+
+A coroutine task is a callable object constructible from
+std::function<rigel::Coro()>.
+It is always false if the compiler does not support coroutines.
+*/
+template <typename C>
+constexpr bool is_coroutine_task_v =
+#ifdef TF_HAS_COROUTINE
+  std::is_invocable_r_v<Coro, C>;
+#else
+  false;
+#endif
+
 /**
 @brief determines if a callable is a static task
 
@@ -140,6 +160,7 @@ or std::function<void(rigel::Runtime&)>.
 template <typename C>
 constexpr bool is_static_task_v =
   (std::is_invocable_r_v<void, C> || std::is_invocable_r_v<void, C, Runtime&>) &&
+  !is_coroutine_task_v<C> &&
   !is_condition_task_v<C> &&
   !is_multi_condition_task_v<C> &&
   !is_dynamic_task_v<C>;
@@ -166,6 +187,7 @@ class Task {
   friend class Runtime;
   friend class Taskflow;
   friend class TaskView;
+  friend class TaskflowSnapshot;
   friend class Executor;
 
   public:
@@ -338,6 +360,23 @@ class Task {
     */
     TaskPriority priority() const;
 
+    /**
+    @brief assigns the task to a worker group of the executor
+
+    The task runs on the workers of the group with the given id
+    (see rigel::WorkerGroup and rigel::Executor::group_id) instead of the
+    group of its taskflow.
+    An id out of the range of the executor's groups denotes the first group.
+    */
+    Task& group(size_t id);
+
+    /**
+    @brief queries the worker group of the task, or
+           <tt>std::numeric_limits<size_t>::max()</tt> if the task runs in
+           the group of its taskflow
+    */
+    size_t group() const;
+
     /**
     @brief resets the task handle to null
     */
@@ -454,6 +493,7 @@ inline bool Task::operator != (const Task& rhs) const {
 // Function: name
 inline Task& Task::name(const std::string& name) {
   _node->_name = name;
+  _node->_indexed_name.prefix = nullptr;
   return *this;
 }
 
@@ -488,7 +528,7 @@ inline void Task::reset_work() {
 
 // Function: name
 inline const std::string& Task::name() const {
-  return _node->_name;
+  return _node->name();
 }
 
 // Function: num_dependents
@@ -532,6 +572,9 @@ inline TaskType Task::type() const {
     case Node::MODULE:          return TaskType::MODULE;
     case Node::ASYNC:           return TaskType::ASYNC;
     case Node::DEPENDENT_ASYNC: return TaskType::ASYNC;
+#ifdef TF_HAS_COROUTINE
+    case Node::COROUTINE:       return TaskType::COROUTINE;
+#endif
     default:                    return TaskType::UNDEFINED;
   }
 }
@@ -581,6 +624,11 @@ Task& Task::work(C&& c) {
   else if constexpr(is_multi_condition_task_v<C>) {
     _node->_handle.emplace<Node::MultiCondition>(std::forward<C>(c));
   }
+#ifdef TF_HAS_COROUTINE
+  else if constexpr(is_coroutine_task_v<C>) {
+    _node->_handle.emplace<Node::Coroutine>(std::forward<C>(c));
+  }
+#endif
   else {
     static_assert(dependent_false_v<C>, "invalid task callable");
   }
@@ -609,6 +657,17 @@ inline TaskPriority Task::priority() const {
   return static_cast<TaskPriority>(_node->_priority);
 }
 
+// Function: group
+inline Task& Task::group(size_t id) {
+  _node->_group = id;
+  return *this;
+}
+
+// Function: group
+inline size_t Task::group() const {
+  return _node->_group;
+}
+
 // ----------------------------------------------------------------------------
 // global ostream
 // ----------------------------------------------------------------------------
@@ -633,6 +692,7 @@ inline std::ostream& operator << (std::ostream& os, const Task& task) {
 class TaskView {
 
   friend class Executor;
+  friend class TraceObserver;
 
   public:
 
@@ -683,6 +743,14 @@ class TaskView {
     */
     size_t hash_value() const;
 
+    /**
+    @brief queries the taskflow the task runs for
+
+    The result is @c nullptr if the task does not run as part of
+    a taskflow (e.g., an asynchronous task launched by an executor).
+    */
+    const Taskflow* taskflow() const;
+
   private:
 
     TaskView(const Node&);
@@ -697,7 +765,7 @@ inline TaskView::TaskView(const Node& node) : _node {node} {
 
 // Function: name
 inline const std::string& TaskView::name() const {
-  return _node._name;
+  return _node.name();
 }
 
 // Function: num_dependents
@@ -731,6 +799,9 @@ inline TaskType TaskView::type() const {
     case Node::MODULE:          return TaskType::MODULE;
     case Node::ASYNC:           return TaskType::ASYNC;
     case Node::DEPENDENT_ASYNC: return TaskType::ASYNC;
+#ifdef TF_HAS_COROUTINE
+    case Node::COROUTINE:       return TaskType::COROUTINE;
+#endif
     default:                    return TaskType::UNDEFINED;
   }
 }
@@ -740,6 +811,11 @@ inline size_t TaskView::hash_value() const {
   return std::hash<const Node*>{}(&_node);
 }
 
+// Function: taskflow
+inline const Taskflow* TaskView::taskflow() const {
+  return _node._topology ? &_node._topology->_taskflow : nullptr;
+}
+
 // Function: for_each_successor
 template <typename V>
 void TaskView::for_each_successor(V&& visitor) const {
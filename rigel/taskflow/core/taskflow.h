@@ -83,6 +83,7 @@ class Taskflow : public FlowBuilder {
   friend class Topology;
   friend class Executor;
   friend class FlowBuilder;
+  friend class TaskflowSnapshot;
 
   struct Dumper {
     size_t id;
@@ -235,6 +236,75 @@ class Taskflow : public FlowBuilder {
     */
     const std::string& name() const;
 
+    /**
+    @brief assigns the taskflow to a worker group of the executor
+
+    The tasks of the taskflow run on the workers of the group with the
+    given id (see rigel::WorkerGroup and rigel::Executor::group_id),
+    except those assigned to a group by rigel::Task::group.
+    By default, a taskflow runs in the group of the worker that submits it,
+    or in the first group if it is not submitted by a worker.
+
+    @code{.cpp}
+    taskflow.group(executor.group_id("batch"));
+    @endcode
+    */
+    void group(size_t id);
+
+    /**
+    @brief queries the worker group of the taskflow, or
+           <tt>std::numeric_limits<size_t>::max()</tt> if it has none
+    */
+    size_t group() const;
+
+    /**
+    @brief enables or disables concurrent instances of the taskflow
+
+    @param flag @c true to run instances concurrently or @c false to queue
+                the runs of the taskflow
+
+    By default, the runs of a taskflow queue up behind each other because
+    each task keeps the state of the run it takes part in.
+    While instancing is enabled, every run (rigel::Executor::run and its
+    variants) starts at once as an instance of its own that keeps the
+    join counters of the tasks in a compact array indexed by the position
+    of the task in the graph, such that many runs of the same graph execute
+    concurrently without cloning it.
+    The instances share the task callables, which hence must be safe to
+    call concurrently.
+    Asynchronous tasks that a runtime task spawns and leaves unjoined are
+    joined before its successors run.
+
+    @code{.cpp}
+    taskflow.enable_instancing();
+    // the runs below execute concurrently
+    auto fu1 = executor.run(taskflow);
+    auto fu2 = executor.run(taskflow);
+    @endcode
+
+    Enabling instancing takes a plan of the graph as it is.
+    Adding or removing a task (e.g., rigel::FlowBuilder::emplace,
+    rigel::FlowBuilder::erase, or rigel::Taskflow::clear) drops the plan,
+    after which the runs queue up again until instancing is enabled again;
+    dependencies changed afterwards likewise take effect only once instancing
+    is enabled again.
+    Instancing supports static, runtime, condition, and multi-condition
+    tasks and placeholders; it throws an exception if the graph has other
+    tasks (e.g., subflow or module tasks) or tasks with semaphores.
+    A runtime task of an instance cannot schedule a task of the graph
+    directly, and rigel::Runtime::schedule throws an exception in it.
+    Parallel algorithms keep the state of each run of their partitioner
+    (e.g., rigel::AffinityPartitioner, rigel::AdaptivePartitioner) to the
+    instance running it, while what the partitioner learns from a run
+    is shared by all instances.
+    */
+    void enable_instancing(bool flag = true);
+
+    /**
+    @brief queries if the runs of the taskflow execute as concurrent instances
+    */
+    bool instancing_enabled() const;
+
     /**
     @brief clears the associated task dependency graph
 
@@ -275,10 +345,16 @@ class Taskflow : public FlowBuilder {
 
     std::string _name;
 
+    size_t _group {Node::NO_GROUP};
+
     Graph _graph;
 
+    std::shared_ptr<const InstancePlan> _plan;
+
     std::queue<std::shared_ptr<Topology>> _topologies;
 
+    std::shared_ptr<const InstancePlan> _instance_plan();
+
     std::optional<std::list<Taskflow>::iterator> _satellite;
 
     void _dump(std::ostream&, const Graph*) const;
@@ -302,7 +378,9 @@ inline Taskflow::Taskflow(Taskflow&& rhs) : FlowBuilder{_graph} {
   std::scoped_lock<std::mutex> lock(rhs._mutex);
 
   _name = std::move(rhs._name);
+  _group = rhs._group;
   _graph = std::move(rhs._graph);
+  _plan = std::move(rhs._plan);
   _topologies = std::move(rhs._topologies);
   _satellite = rhs._satellite;
 
@@ -314,7 +392,9 @@ inline Taskflow& Taskflow::operator = (Taskflow&& rhs) {
   if(this != &rhs) {
     std::scoped_lock<std::mutex, std::mutex> lock(_mutex, rhs._mutex);
     _name = std::move(rhs._name);
+    _group = rhs._group;
     _graph = std::move(rhs._graph);
+    _plan = std::move(rhs._plan);
     _topologies = std::move(rhs._topologies);
     _satellite = rhs._satellite;
     rhs._satellite.reset();
@@ -325,6 +405,8 @@ inline Taskflow& Taskflow::operator = (Taskflow&& rhs) {
 // Procedure:
 inline void Taskflow::clear() {
   _graph._clear();
+  std::lock_guard<std::mutex> lock(_mutex);
+  _plan.reset();
 }
 
 // Function: num_tasks
@@ -347,6 +429,93 @@ inline const std::string& Taskflow::name() const {
   return _name;
 }
 
+// Procedure: group
+inline void Taskflow::group(size_t id) {
+  _group = id;
+}
+
+// Function: group
+inline size_t Taskflow::group() const {
+  return _group;
+}
+
+// Procedure: enable_instancing
+inline void Taskflow::enable_instancing(bool flag) {
+
+  std::shared_ptr<InstancePlan> plan;
+
+  if(flag) {
+
+    plan = std::make_shared<InstancePlan>();
+    plan->version = _graph._version;
+
+    const auto& nodes = _graph._nodes;
+
+    std::unordered_map<const Node*, size_t> index;
+    index.reserve(nodes.size());
+    for(size_t i=0; i<nodes.size(); ++i) {
+      index[nodes[i]] = i;
+    }
+
+    plan->nodes = nodes;
+    plan->joins.reserve(nodes.size());
+    plan->offsets.reserve(nodes.size() + 1);
+
+    for(size_t i=0; i<nodes.size(); ++i) {
+
+      auto node = nodes[i];
+
+      switch(node->_handle.index()) {
+        case Node::PLACEHOLDER:
+        case Node::STATIC:
+        case Node::CONDITION:
+        case Node::MULTI_CONDITION:
+        break;
+
+        default:
+          TF_THROW("task ", node->name(), " of taskflow ", _name, " cannot be instanced");
+      }
+
+      if(node->_semaphores && (!node->_semaphores->to_acquire.empty() ||
+                               !node->_semaphores->to_release.empty())) {
+        TF_THROW("task ", node->name(), " of taskflow ", _name, " cannot be instanced with semaphores");
+      }
+
+      plan->joins.push_back(node->num_strong_dependents());
+      plan->offsets.push_back(plan->successors.size());
+
+      if(node->num_dependents() == 0) {
+        plan->sources.push_back(i);
+      }
+
+      for(auto s : node->_successors) {
+        plan->successors.push_back(index.at(s));
+      }
+    }
+
+    plan->offsets.push_back(plan->successors.size());
+  }
+
+  std::lock_guard<std::mutex> lock(_mutex);
+  _plan = std::move(plan);
+}
+
+// Function: instancing_enabled
+inline bool Taskflow::instancing_enabled() const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _plan != nullptr && _plan->version == _graph._version;
+}
+
+// Function: _instance_plan
+// Returns the plan of the graph, dropping one that the graph has outgrown.
+// The caller holds _mutex.
+inline std::shared_ptr<const InstancePlan> Taskflow::_instance_plan() {
+  if(_plan && _plan->version != _graph._version) {
+    _plan.reset();
+  }
+  return _plan;
+}
+
 // Function: graph
 inline Graph& Taskflow::graph() {
   return _graph;
@@ -414,8 +583,8 @@ inline void Taskflow::_dump(
 ) const {
 
   os << 'p' << node << "[label=\"";
-  if(node->_name.empty()) os << 'p' << node;
-  else os << node->_name;
+  if(node->name().empty()) os << 'p' << node;
+  else os << node->name();
   os << "\" ";
 
   // shape for node
@@ -456,8 +625,8 @@ inline void Taskflow::_dump(
       auto& sbg = std::get_if<Node::Dynamic>(&node->_handle)->subgraph;
       if(!sbg.empty()) {
         os << "subgraph cluster_p" << node << " {\nlabel=\"Subflow: ";
-        if(node->_name.empty()) os << 'p' << node;
-        else os << node->_name;
+        if(node->name().empty()) os << 'p' << node;
+        else os << node->name();
 
         os << "\";\n" << "color=blue\n";
         _dump(os, &sbg, dumper);
@@ -488,8 +657,8 @@ inline void Taskflow::_dump(
       auto module = &(std::get_if<Node::Module>(&n->_handle)->graph);
 
       os << 'p' << n << "[shape=box3d, color=blue, label=\"";
-      if(n->_name.empty()) os << 'p' << n;
-      else os << n->_name;
+      if(n->name().empty()) os << 'p' << n;
+      else os << n->name();
 
       if(dumper.visited.find(module) == dumper.visited.end()) {
         dumper.visited[module] = dumper.id++;
@@ -595,6 +764,30 @@ class Future : public std::future<T>  {
     */
     bool cancel();
 
+    /**
+    @brief waits until the result becomes available
+
+    If the executor has guest waits enabled (see
+    rigel::Executor::enable_guest_waits) and the calling thread is not a
+    worker, the thread runs tasks of the executor until the execution
+    associated with this future object completes.
+    Otherwise, this function blocks as std::future::wait does.
+
+    This function hides, and does not override, std::future::wait,
+    which is not virtual: a call through a reference or a pointer to
+    the std::future base (e.g., a rigel::Future moved into a
+    std::future) blocks without running tasks.
+    */
+    void wait() const;
+
+    /**
+    @brief waits until the result becomes available and retrieves it
+
+    The wait is the same as rigel::Future::wait, and std::future::get
+    is hidden in the same way.
+    */
+    T get();
+
   private:
 
     handle_t _handle;
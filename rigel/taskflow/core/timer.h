@@ -0,0 +1,484 @@
+// Copyright 2023 The titan-search Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "rigel/taskflow/core/declarations.h"
+
+/**
+@file timer.h
+@brief timer include file
+*/
+
+namespace rigel {
+
+class TimerWheel;
+
+// ----------------------------------------------------------------------------
+// Timer
+// ----------------------------------------------------------------------------
+
+/**
+@private
+*/
+struct Timer {
+
+  // links in the slot list of the wheel
+  Timer* prev {nullptr};
+  Timer* next {nullptr};
+
+  // expiry and period in ticks; a period of zero makes a one-shot timer
+  uint64_t expiry {0};
+  uint64_t period {0};
+
+  // level of the wheel holding the timer, or -1 if it is not linked
+  int level {-1};
+
+  // the wheel keeps the timer alive while the timer is linked
+  std::shared_ptr<Timer> self;
+
+  // wheel that can still cancel the timer
+  std::atomic<TimerWheel*> wheel {nullptr};
+
+  std::function<void()> work;
+};
+
+// ----------------------------------------------------------------------------
+// Class Definition: TimerTask
+// ----------------------------------------------------------------------------
+
+/**
+@class TimerTask
+
+@brief class to handle a delayed or periodic task of an executor
+
+A timer task is returned by the timer functions of rigel::Executor,
+such as Executor::silent_async_after and Executor::silent_async_every,
+and is used to cancel the task before it runs.
+
+@code{.cpp}
+rigel::TimerTask timer = executor.silent_async_after(
+  std::chrono::milliseconds(100), [](){ printf("100 ms later\n"); }
+);
+timer.cancel();  // true if the task had not started yet
+@endcode
+*/
+class TimerTask {
+
+  friend class Executor;
+
+  public:
+
+  /**
+  @brief constructs an empty timer task handle
+  */
+  TimerTask() = default;
+
+  /**
+  @brief cancels the timer
+
+  @return @c true if the timer was pending and is now cancelled,
+          or @c false if it was empty, cancelled, or already expired
+
+  A cancelled one-shot timer never runs its task, and a cancelled periodic
+  timer does not start another run, although a run that has already been
+  started goes on.
+  Cancellation takes constant time and is thread-safe.
+  */
+  bool cancel();
+
+  /**
+  @brief checks if the handle refers to no timer
+  */
+  bool empty() const { return _timer == nullptr; }
+
+  /**
+  @brief checks if the handle refers to a periodic timer
+  */
+  bool is_periodic() const { return _timer && _timer->period != 0; }
+
+  private:
+
+  explicit TimerTask(std::shared_ptr<Timer> timer) : _timer {std::move(timer)} {
+  }
+
+  std::shared_ptr<Timer> _timer;
+};
+
+// ----------------------------------------------------------------------------
+// Class Definition: TimerWheel
+// ----------------------------------------------------------------------------
+
+/**
+@private
+
+@brief class to run the timers of an executor
+
+The wheel has six levels of 64 slots, each slot holding an intrusive
+list of timers.
+Level @c l covers expiries that share all but the lowest <tt>6(l+1)</tt>
+bits of their tick with the current tick, so inserting and cancelling a
+timer takes constant time, and a timer moves down at most five times
+before it expires.
+A bitmap of the non-empty slots per level lets the wheel thread sleep
+until the next tick with anything to do, rather than wake up every tick.
+Expiries are counted in ticks of one millisecond from the construction of
+the wheel and are limited to 2^36 ticks (about two years) ahead.
+*/
+class TimerWheel {
+
+  public:
+
+  using clock = std::chrono::steady_clock;
+
+  constexpr static clock::duration TICK = std::chrono::milliseconds(1);
+
+  TimerWheel(std::function<void(Timer&)> on_expire,
+             std::function<void(Timer&)> on_cancel);
+
+  ~TimerWheel();
+
+  void insert(std::shared_ptr<Timer> timer, clock::duration delay, clock::duration period);
+
+  bool cancel(Timer& timer);
+
+  void stop_periodic();
+
+  private:
+
+  constexpr static int BITS = 6;
+  constexpr static int LEVELS = 6;
+  constexpr static uint64_t SLOTS = uint64_t{1} << BITS;
+  constexpr static uint64_t MASK = SLOTS - 1;
+  constexpr static uint64_t RANGE = uint64_t{1} << (BITS * LEVELS);
+  constexpr static uint64_t NEVER = std::numeric_limits<uint64_t>::max();
+
+  std::function<void(Timer&)> _on_expire;
+  std::function<void(Timer&)> _on_cancel;
+
+  const clock::time_point _start {clock::now()};
+
+  // all timers expiring at or before _now have expired
+  uint64_t _now {0};
+
+  // tick the thread sleeps until (NEVER if there is none), or zero while
+  // it is awake and about to look for the next tick anyway
+  uint64_t _wake {0};
+
+  bool _stop {false};
+
+  std::array<std::array<Timer*, SLOTS>, LEVELS> _slots {};
+  std::array<uint64_t, LEVELS> _occupied {};
+
+  std::mutex _mutex;
+  std::mutex _expire_mutex;
+  std::condition_variable _cv;
+  std::thread _thread;
+
+  uint64_t _ticks(clock::duration d, bool round_up) const;
+
+  void _link(Timer* timer);
+  void _unlink(Timer* timer);
+  uint64_t _next_tick() const;
+  void _process(uint64_t tick, std::vector<std::shared_ptr<Timer>>& expired);
+  void _loop();
+};
+
+// Constructor
+inline TimerWheel::TimerWheel(
+  std::function<void(Timer&)> on_expire, std::function<void(Timer&)> on_cancel
+) :
+  _on_expire {std::move(on_expire)},
+  _on_cancel {std::move(on_cancel)} {
+  _thread = std::thread([this](){ _loop(); });
+}
+
+// Destructor
+inline TimerWheel::~TimerWheel() {
+  stop_periodic();
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stop = true;
+  }
+  _cv.notify_one();
+  _thread.join();
+}
+
+// Function: _ticks
+inline uint64_t TimerWheel::_ticks(clock::duration d, bool round_up) const {
+  if(d <= clock::duration::zero()) {
+    return 0;
+  }
+  auto t = static_cast<uint64_t>(d / TICK);
+  return (round_up && d % TICK != clock::duration::zero()) ? t + 1 : t;
+}
+
+// Procedure: insert
+inline void TimerWheel::insert(
+  std::shared_ptr<Timer> timer, clock::duration delay, clock::duration period
+) {
+
+  auto raw = timer.get();
+  auto expiry = _ticks(clock::now() - _start + std::min(delay, TICK * static_cast<clock::rep>(RANGE)), true);
+
+  std::lock_guard<std::mutex> lock(_mutex);
+
+  raw->expiry = std::max(expiry, _now + 1);
+  raw->period = period > clock::duration::zero() ? std::max<uint64_t>(_ticks(period, true), 1) : 0;
+  raw->self = std::move(timer);
+  raw->wheel.store(this, std::memory_order_relaxed);
+
+  _link(raw);
+
+  if(raw->expiry < _wake) {
+    _cv.notify_one();
+  }
+}
+
+// Function: cancel
+inline bool TimerWheel::cancel(Timer& timer) {
+
+  std::shared_ptr<Timer> self;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if(timer.level < 0) {
+      return false;
+    }
+    _unlink(&timer);
+    timer.wheel.store(nullptr, std::memory_order_relaxed);
+    self = std::move(timer.self);
+  }
+
+  _on_cancel(timer);
+
+  return true;
+}
+
+// Procedure: stop_periodic
+// unlinks every periodic timer and waits for the expired timers being run,
+// after which no periodic timer runs again
+inline void TimerWheel::stop_periodic() {
+
+  std::vector<std::shared_ptr<Timer>> stopped;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    for(int l=0; l<LEVELS; ++l) {
+      for(auto head : _slots[l]) {
+        for(auto t = head; t; ) {
+          auto next = t->next;
+          if(t->period) {
+            _unlink(t);
+            t->wheel.store(nullptr, std::memory_order_relaxed);
+            stopped.push_back(std::move(t->self));
+          }
+          t = next;
+        }
+      }
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(_expire_mutex);
+}
+
+// Procedure: _link
+inline void TimerWheel::_link(Timer* timer) {
+
+  if(timer->expiry - _now >= RANGE) {
+    timer->expiry = _now + RANGE - 1;
+  }
+
+  // lowest level whose slot distinguishes the expiry from the current tick
+  auto diff = timer->expiry ^ _now;
+  int l = 0;
+  while(l < LEVELS - 1 && (diff >> (BITS * (l + 1))) != 0) {
+    ++l;
+  }
+
+  auto s = (timer->expiry >> (BITS * l)) & MASK;
+
+  timer->level = l;
+  timer->prev = nullptr;
+  timer->next = _slots[l][s];
+  if(timer->next) {
+    timer->next->prev = timer;
+  }
+  _slots[l][s] = timer;
+  _occupied[l] |= uint64_t{1} << s;
+}
+
+// Procedure: _unlink
+inline void TimerWheel::_unlink(Timer* timer) {
+
+  auto l = timer->level;
+  auto s = (timer->expiry >> (BITS * l)) & MASK;
+
+  if(timer->prev) {
+    timer->prev->next = timer->next;
+  }
+  else {
+    _slots[l][s] = timer->next;
+    if(timer->next == nullptr) {
+      _occupied[l] &= ~(uint64_t{1} << s);
+    }
+  }
+  if(timer->next) {
+    timer->next->prev = timer->prev;
+  }
+
+  timer->prev = timer->next = nullptr;
+  timer->level = -1;
+}
+
+// Function: _next_tick
+// Below the top level, an occupied slot is always ahead of the digit of the
+// current tick; slots of the top level at or behind it belong to the next
+// round of the wheel.
+inline uint64_t TimerWheel::_next_tick() const {
+
+  uint64_t next = NEVER;
+
+  for(int l=0; l<LEVELS; ++l) {
+
+    if(_occupied[l] == 0) {
+      continue;
+    }
+
+    const int shift = BITS * l;
+    const uint64_t digit = (_now >> shift) & MASK;
+    const uint64_t base = (_now >> (shift + BITS)) << (shift + BITS);
+
+    auto ahead = digit == MASK ? 0 : _occupied[l] & (~uint64_t{0} << (digit + 1));
+
+    uint64_t tick;
+    if(ahead) {
+      tick = base + (static_cast<uint64_t>(__builtin_ctzll(ahead)) << shift);
+    }
+    else {
+      tick = base + (uint64_t{1} << (shift + BITS)) +
+             (static_cast<uint64_t>(__builtin_ctzll(_occupied[l])) << shift);
+    }
+
+    next = std::min(next, tick);
+  }
+
+  return next;
+}
+
+// Procedure: _process
+// moves the slots starting at the given tick down the wheel and expires the
+// timers of the lowest level
+inline void TimerWheel::_process(uint64_t tick, std::vector<std::shared_ptr<Timer>>& expired) {
+
+  _now = tick;
+
+  for(int l=LEVELS-1; l>0; --l) {
+    if((tick & ((uint64_t{1} << (BITS * l)) - 1)) != 0) {
+      continue;
+    }
+    auto s = (tick >> (BITS * l)) & MASK;
+    auto t = _slots[l][s];
+    _slots[l][s] = nullptr;
+    _occupied[l] &= ~(uint64_t{1} << s);
+    while(t) {
+      auto next = t->next;
+      _link(t);
+      t = next;
+    }
+  }
+
+  auto s = tick & MASK;
+  auto t = _slots[0][s];
+  _slots[0][s] = nullptr;
+  _occupied[0] &= ~(uint64_t{1} << s);
+
+  while(t) {
+    auto next = t->next;
+    t->prev = t->next = nullptr;
+    t->level = -1;
+    if(t->period) {
+      t->expiry = tick + t->period;
+      _link(t);
+      expired.push_back(t->self);
+    }
+    else {
+      t->wheel.store(nullptr, std::memory_order_relaxed);
+      expired.push_back(std::move(t->self));
+    }
+    t = next;
+  }
+}
+
+// Procedure: _loop
+inline void TimerWheel::_loop() {
+
+  std::vector<std::shared_ptr<Timer>> expired;
+
+  std::unique_lock<std::mutex> lock(_mutex);
+
+  while(!_stop) {
+
+    if(auto next = _next_tick(); next == NEVER) {
+      _wake = NEVER;
+      _cv.wait(lock);
+    }
+    else if(next > _now) {
+      _wake = next;
+      _cv.wait_until(lock, _start + TICK * static_cast<clock::rep>(next));
+    }
+    _wake = 0;
+
+    auto target = _ticks(clock::now() - _start, false);
+
+    for(auto next = _next_tick(); next <= target; next = _next_tick()) {
+      _process(next, expired);
+    }
+    _now = std::max(_now, target);
+
+    if(expired.empty()) {
+      continue;
+    }
+
+    // stop_periodic waits on _expire_mutex for the timers expired so far
+    std::lock_guard<std::mutex> expire_lock(_expire_mutex);
+    lock.unlock();
+    for(auto& t : expired) {
+      _on_expire(*t);
+    }
+    expired.clear();
+    lock.lock();
+  }
+}
+
+// Function: cancel
+inline bool TimerTask::cancel() {
+  if(!_timer) {
+    return false;
+  }
+  auto wheel = _timer->wheel.load(std::memory_order_relaxed);
+  return wheel ? wheel->cancel(*_timer) : false;
+}
+
+}  // end of namespace rigel -----------------------------------------------------
@@ -14,6 +14,11 @@
 //
 #pragma once
 
+#include <exception>
+#include <limits>
+#include <memory>
+#include <vector>
+
 namespace rigel {
 
 // ----------------------------------------------------------------------------
@@ -36,6 +41,22 @@ namespace rigel {
 
 // ----------------------------------------------------------------------------
 
+// class: InstancePlan
+// graph of a taskflow as seen by its instanced runs: node i starts with
+// joins[i] and has the successors successors[offsets[i]..offsets[i+1]);
+// the plan is valid as long as the graph keeps the version it was made of
+    struct InstancePlan {
+
+        size_t version;
+        std::vector<Node *> nodes;
+        std::vector<size_t> joins;
+        std::vector<size_t> offsets;
+        std::vector<size_t> successors;
+        std::vector<size_t> sources;
+    };
+
+// ----------------------------------------------------------------------------
+
 // class: Topology
     class Topology : public TopologyBase {
 
@@ -43,6 +64,12 @@ namespace rigel {
 
         friend class Runtime;
 
+        friend class TaskView;
+
+        template<typename T>
+        friend
+        class Future;
+
     public:
 
         template<typename P, typename C>
@@ -60,6 +87,25 @@ namespace rigel {
         std::function<void()> _call;
 
         std::atomic<size_t> _join_counter{0};
+
+        // first exception escaping a task of the run, delivered through the
+        // future of the run once the topology is torn down
+        std::atomic<bool> _has_exception{false};
+        std::exception_ptr _exception;
+
+        // worker group of the taskflow when the run was submitted
+        // (Node::NO_GROUP if the taskflow has none)
+        size_t _group{std::numeric_limits<size_t>::max()};
+
+        // executor running the topology, whose workers a waiting thread joins
+        // as a guest
+        Executor *_executor{nullptr};
+
+        // an instanced run keeps the join counters of the nodes of the plan
+        // and owns itself until it completes
+        std::shared_ptr<const InstancePlan> _plan;
+        std::unique_ptr<std::atomic<size_t>[]> _join_counters;
+        std::shared_ptr<Topology> _self;
     };
 
 // Constructor
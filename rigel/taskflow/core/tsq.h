@@ -171,6 +171,9 @@ class TaskQueue {
   std::atomic<Array*> _array[TF_MAX_PRIORITY];
   std::vector<Array*> _garbage[TF_MAX_PRIORITY];
 
+  // number of times the queue outgrew its array (written by the owner only)
+  std::atomic<size_t> _num_resizes {0};
+
   //std::atomic<T> _cache {nullptr};
 
   public:
@@ -218,6 +221,14 @@ class TaskQueue {
     */
     int64_t capacity(unsigned priority) const noexcept;
 
+    /**
+    @brief queries the number of times the queue has grown its capacity
+
+    Each resize doubles the array of one priority level and is
+    the slow path of rigel::TaskQueue::push.
+    */
+    size_t num_resizes() const noexcept;
+
     /**
     @brief inserts an item to the queue
 
@@ -438,12 +449,21 @@ int64_t TaskQueue<T, TF_MAX_PRIORITY>::capacity(unsigned p) const noexcept {
   return _array[p].load(std::memory_order_relaxed)->capacity();
 }
 
+// Function: num_resizes
+template <typename T, unsigned TF_MAX_PRIORITY>
+size_t TaskQueue<T, TF_MAX_PRIORITY>::num_resizes() const noexcept {
+  return _num_resizes.load(std::memory_order_relaxed);
+}
+
 template <typename T, unsigned TF_MAX_PRIORITY>
 TF_NO_INLINE typename TaskQueue<T, TF_MAX_PRIORITY>::Array*
   TaskQueue<T, TF_MAX_PRIORITY>::resize_array(Array* a, unsigned p, std::int64_t b, std::int64_t t) {
 
   Array* tmp = a->resize(b, t);
   _garbage[p].push_back(a);
+  _num_resizes.store(
+    _num_resizes.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed
+  );
   std::swap(a, tmp);
   _array[p].store(a, std::memory_order_release);
   // Note: the original paper using relaxed causes t-san to complain
@@ -17,6 +17,7 @@
 #include "rigel/taskflow/core/declarations.h"
 #include "rigel/taskflow/core/tsq.h"
 #include "rigel/taskflow/core/notifier.h"
+#include "rigel/taskflow/core/metrics.h"
 
 /**
 @file worker.hpp
@@ -25,6 +26,53 @@
 
 namespace rigel {
 
+// ----------------------------------------------------------------------------
+// Class Definition: WorkerGroup
+// ----------------------------------------------------------------------------
+
+/**
+@struct WorkerGroup
+
+@brief structure to describe a group of workers in an executor
+
+An executor created from a list of worker groups lays out the workers of
+each group one after another and lets them steal tasks only from the
+workers of the same group.
+A task runs in the group given by rigel::Task::group, or else by
+rigel::Taskflow::group, or else in the group of the worker that submits it.
+
+@code{.cpp}
+rigel::Executor executor({
+  {"rt",    8,  {0, 1, 2, 3, 4, 5, 6, 7}},
+  {"batch", 56, {}, true}
+});
+@endcode
+*/
+struct WorkerGroup {
+
+  /**
+  @brief name of the group (see rigel::Executor::group_id)
+  */
+  std::string name;
+
+  /**
+  @brief number of workers in the group
+  */
+  size_t num_workers;
+
+  /**
+  @brief CPUs the workers of the group are pinned to, or empty to leave
+         the workers unpinned
+  */
+  std::vector<int> cpus {};
+
+  /**
+  @brief whether idle workers of the group may run tasks of other groups
+         that have no idle worker left
+  */
+  bool lend {false};
+};
+
 // ----------------------------------------------------------------------------
 // Class Definition: Worker
 // ----------------------------------------------------------------------------
@@ -50,11 +98,19 @@ class Worker {
     @brief queries the worker id associated with its parent executor
 
     A worker id is a unsigned integer in the range <tt>[0, N)</tt>,
-    where @c N is the number of workers spawned at the construction
-    time of the executor.
+    where @c N is the maximum number of workers of the executor
+    (see rigel::Executor::max_workers).
     */
     inline size_t id() const { return _id; }
 
+    /**
+    @brief queries the id of the worker group the worker belongs to
+
+    The id is the position of the group in the list given to the executor,
+    or zero if the executor has no groups (see rigel::WorkerGroup).
+    */
+    inline size_t group() const { return _group; }
+
     /**
     @brief acquires a pointer access to the underlying thread
     */
@@ -75,12 +131,30 @@ class Worker {
 
     size_t _id;
     size_t _vtm;
+    size_t _group {0};
     Executor* _executor;
     std::thread* _thread;
     Notifier::Waiter* _waiter;
     std::default_random_engine _rdgen { std::random_device{}() };
     TaskQueue<Node*> _wsq;
     Node* _cache;
+
+    // tasks pushed to this worker by others (e.g., rigel::AffinityPartitioner);
+    // producers are serialized by the mutex while any worker can steal
+    TaskQueue<Node*> _mailbox;
+    std::mutex _mailbox_mutex;
+
+    // observer snapshot protected by this worker while it runs observed tasks
+    // and the nesting depth of those tasks (e.g., corun inside a task)
+    std::atomic<ObserverSnapshot*> _observers {nullptr};
+    size_t _observer_depth {0};
+
+    // scheduler counters updated only while metrics are enabled
+    WorkerCounters _counters;
+
+    // a slot lent to a thread that runs tasks while it waits
+    // (see rigel::Executor::enable_guest_waits)
+    bool _guest {false};
 };
 
 // ----------------------------------------------------------------------------
@@ -90,26 +164,26 @@ class Worker {
 /**
 @private
 */
-//struct PerThreadWorker {
-//
-//  Worker* worker;
-//
-//  PerThreadWorker() : worker {nullptr} {}
-//
-//  PerThreadWorker(const PerThreadWorker&) = delete;
-//  PerThreadWorker(PerThreadWorker&&) = delete;
-//
-//  PerThreadWorker& operator = (const PerThreadWorker&) = delete;
-//  PerThreadWorker& operator = (PerThreadWorker&&) = delete;
-//};
+struct PerThreadWorker {
+
+  Worker* worker;
+
+  PerThreadWorker() : worker {nullptr} {}
+
+  PerThreadWorker(const PerThreadWorker&) = delete;
+  PerThreadWorker(PerThreadWorker&&) = delete;
+
+  PerThreadWorker& operator = (const PerThreadWorker&) = delete;
+  PerThreadWorker& operator = (PerThreadWorker&&) = delete;
+};
 
 /**
 @private
 */
-//inline PerThreadWorker& this_worker() {
-//  thread_local PerThreadWorker worker;
-//  return worker;
-//}
+inline PerThreadWorker& this_worker() {
+  thread_local PerThreadWorker worker;
+  return worker;
+}
 
 
 // ----------------------------------------------------------------------------
@@ -136,8 +210,8 @@ class WorkerView {
     @brief queries the worker id associated with its parent executor
 
     A worker id is a unsigned integer in the range <tt>[0, N)</tt>,
-    where @c N is the number of workers spawned at the construction
-    time of the executor.
+    where @c N is the maximum number of workers of the executor
+    (see rigel::Executor::max_workers).
     */
     size_t id() const;
 
@@ -32,6 +32,7 @@
 #include <vector>
 #include <cassert>
 #include <cstddef>
+#include <algorithm>
 
 namespace rigel {
 
@@ -141,6 +142,17 @@ namespace rigel {
         template<typename... ArgsT>
         T *animate(ArgsT &&... args);
 
+        /**
+        @brief acquires pointers to @c n objects each constructed from a copy
+               of the given argument list
+
+        The objects are taken from the local heap in batches under one lock
+        each, instead of one lock per object as with calling animate @c n
+        times.
+        */
+        template<typename... ArgsT>
+        void animate_n(T **objs, size_t n, const ArgsT &... args);
+
         /**
         @brief recycles a object pointed by @c ptr and destroys it
         */
@@ -176,6 +188,8 @@ namespace rigel {
 
         LocalHeap &_this_heap();
 
+        T *_take(LocalHeap &, Block *&);
+
         constexpr unsigned _next_pow2(unsigned n) const;
 
         template<class P, class Q>
@@ -621,6 +635,52 @@ namespace rigel {
         Block *s{nullptr};
 
         h.mutex.lock();
+        T *mem = _take(h, s);
+        h.mutex.unlock();
+
+        //printf("allocate %p (s=%p)\n", mem, s);
+
+        new(mem) T(std::forward<ArgsT>(args)...);
+
+        mem->_object_pool_block = s;
+
+        return mem;
+    }
+
+// Function: animate_n
+    template<typename T, size_t S>
+    template<typename... ArgsT>
+    void ObjectPool<T, S>::animate_n(T **objs, size_t n, const ArgsT &... args) {
+
+        LocalHeap &h = _this_heap();
+
+        // the block of each object is set after its construction
+        constexpr size_t B = 64;
+        Block *blocks[B];
+
+        for (size_t i = 0; i < n; i += B) {
+
+            size_t m = std::min(B, n - i);
+
+            h.mutex.lock();
+            for (size_t k = 0; k < m; ++k) {
+                objs[i + k] = _take(h, blocks[k]);
+            }
+            h.mutex.unlock();
+
+            for (size_t k = 0; k < m; ++k) {
+                new(objs[i + k]) T(args...);
+                objs[i + k]->_object_pool_block = blocks[k];
+            }
+        }
+    }
+
+// Function: _take
+// takes the memory of one object from the local heap, which must be locked
+    template<typename T, size_t S>
+    T *ObjectPool<T, S>::_take(LocalHeap &h, Block *&s) {
+
+        s = nullptr;
 
         // scan the list of superblocks from the most full to the least full
         int f = static_cast<int>(F - 1);
@@ -698,14 +758,6 @@ namespace rigel {
         //          << "h.u " << h.u  << '\n'
         //          << "h.a " << h.a  << '\n';
 
-        h.mutex.unlock();
-
-        //printf("allocate %p (s=%p)\n", mem, s);
-
-        new(mem) T(std::forward<ArgsT>(args)...);
-
-        mem->_object_pool_block = s;
-
         return mem;
     }
 
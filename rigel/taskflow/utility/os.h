@@ -16,7 +16,13 @@
 
 #include <cstdlib>
 #include <cstdio>
+#include <cstdint>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
 #include <string>
+#include <thread>
+#include <vector>
 
 #define TF_OS_LINUX 0
 #define TF_OS_DRAGONFLY 0
@@ -103,6 +109,11 @@
 #define TF_OS_UNIX 1
 #endif
 
+#if TF_OS_LINUX
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 
 //-----------------------------------------------------------------------------
 // Cache line alignment
@@ -134,6 +145,17 @@
 
 
 
+//-----------------------------------------------------------------------------
+// time stamp counter
+//-----------------------------------------------------------------------------
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+  #define TF_HAS_RDTSC 1
+  #include <intrin.h>
+#elif defined(__i386__) || defined(__x86_64__)
+  #define TF_HAS_RDTSC 1
+  #include <x86intrin.h>
+#endif
+
 //-----------------------------------------------------------------------------
 // pause
 //-----------------------------------------------------------------------------
@@ -189,6 +211,80 @@ inline bool has_env(const std::string& str) {
 #endif
 }
 
+// Function: read_tsc
+// reads the time stamp counter of the processor, or the nanoseconds of the
+// steady clock on processors without one
+inline uint64_t read_tsc() {
+#ifdef TF_HAS_RDTSC
+  return __rdtsc();
+#else
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()
+  ).count());
+#endif
+}
+
+// Function: cpu_quota
+// number of CPUs the process may use under its cgroup CPU bandwidth limit
+// (cpu.max of cgroup v2 or the CFS quota of cgroup v1), rounded up and
+// capped by the hardware concurrency, which is also returned when there is
+// no limit or it cannot be read
+inline size_t cpu_quota() {
+
+  size_t num_cpus = std::max(std::thread::hardware_concurrency(), 1u);
+
+#if TF_OS_LINUX
+  auto limit = [&](double quota, double period) -> size_t {
+    if(quota <= 0 || period <= 0) {
+      return num_cpus;
+    }
+    auto n = static_cast<size_t>(quota / period);
+    n += (n * period < quota);
+    return std::clamp<size_t>(n, 1, num_cpus);
+  };
+
+  // cgroup v2: "<quota> <period>" or "max <period>"
+  if(std::ifstream ifs("/sys/fs/cgroup/cpu.max"); ifs) {
+    std::string quota;
+    double period = 0;
+    if(ifs >> quota >> period && quota != "max") {
+      return limit(std::strtod(quota.c_str(), nullptr), period);
+    }
+    return num_cpus;
+  }
+
+  // cgroup v1: a quota of -1 means no limit
+  std::ifstream q("/sys/fs/cgroup/cpu/cpu.cfs_quota_us");
+  std::ifstream p("/sys/fs/cgroup/cpu/cpu.cfs_period_us");
+  double quota = 0, period = 0;
+  if(q >> quota && p >> period) {
+    return limit(quota, period);
+  }
+#endif
+
+  return num_cpus;
+}
+
+// Function: pin_this_thread
+// restricts the calling thread to the given CPUs; returns false if the
+// platform does not support it or the CPUs are not available
+inline bool pin_this_thread(const std::vector<int>& cpus) {
+#if TF_OS_LINUX
+  cpu_set_t cpuset;
+  CPU_ZERO(&cpuset);
+  for(auto cpu : cpus) {
+    if(cpu < 0 || cpu >= CPU_SETSIZE) {
+      return false;
+    }
+    CPU_SET(cpu, &cpuset);
+  }
+  return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset) == 0;
+#else
+  (void)cpus;
+  return false;
+#endif
+}
+
 // Procedure: relax_cpu
 //inline void relax_cpu() {
 //#ifdef TF_HAS_MM_PAUSE
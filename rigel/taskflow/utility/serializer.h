@@ -39,6 +39,18 @@
 #include <string>
 #include <variant>
 #include <optional>
+#include <cstring>
+#include <cstdint>
+#include <string_view>
+#include <limits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define TF_HAS_MMAP 1
+#endif
 
 namespace rigel {
 
@@ -250,6 +262,49 @@ namespace rigel {
     template<typename T>
     constexpr bool is_std_tuple_v = is_std_tuple<T>::value;
 
+// rigel::ArrayView
+    template<typename T>
+    class ArrayView;
+
+    template<typename T>
+    struct is_array_view : std::false_type {
+    };
+
+    template<typename T>
+    struct is_array_view<ArrayView<T>> : std::true_type {
+    };
+
+    template<typename T>
+    constexpr bool is_array_view_v = is_array_view<T>::value;
+
+// element types whose contiguous ranges are copied in one block
+    template<typename T>
+    constexpr bool is_bulk_serializable_v = std::is_arithmetic_v<T> || std::is_enum_v<T>;
+
+// streams that expose their memory (see rigel::ViewStream)
+    template<typename S, typename = void>
+    struct has_stream_view : std::false_type {
+    };
+
+    template<typename S>
+    struct has_stream_view<S, std::void_t<decltype(std::declval<S &>().view(size_t{}))>> : std::true_type {
+    };
+
+    template<typename S>
+    constexpr bool has_stream_view_v = has_stream_view<S>::value;
+
+// streams that know how many bytes are left (see rigel::ViewStream)
+    template<typename S, typename = void>
+    struct has_stream_remaining : std::false_type {
+    };
+
+    template<typename S>
+    struct has_stream_remaining<S, std::void_t<decltype(std::declval<const S &>().remaining())>> : std::true_type {
+    };
+
+    template<typename S>
+    constexpr bool has_stream_remaining_v = has_stream_remaining<S>::value;
+
 //-----------------------------------------------------------------------------
 // Type extraction.
 //-----------------------------------------------------------------------------
@@ -354,6 +409,323 @@ namespace rigel {
         return {std::forward<KeyT>(k), std::forward<ValueT>(v)};
     }
 
+// ----------------------------------------------------------------------------
+// Delta Varint Wrapper
+// ----------------------------------------------------------------------------
+
+// Class: DeltaVarintTag
+// Class that wraps a vector of integers, e.g., timestamps, which is serialized
+// as the differences between consecutive elements in zigzag LEB128 varints.
+// Sorted or clustered values take one or two bytes per element instead of
+// eight.
+    template<typename T>
+    class DeltaVarintTag {
+
+    public:
+
+        using type = std::conditional_t<std::is_lvalue_reference_v<T>, T, std::decay_t<T>>;
+
+        static_assert(
+                std::is_integral_v<typename std::decay_t<T>::value_type>,
+                "DeltaVarintTag requires a container of integers"
+        );
+
+        DeltaVarintTag(T &&item) : _item(std::forward<T>(item)) {}
+
+        DeltaVarintTag &operator=(const DeltaVarintTag &) = delete;
+
+        inline const T &get() const { return _item; }
+
+        template<typename ArchiverT>
+        auto save(ArchiverT &ar) const {
+
+            std::string bytes;
+            bytes.reserve(_item.size() * 2);
+
+            uint64_t prev = 0;
+            for (auto v: _item) {
+                auto d = static_cast<int64_t>(static_cast<uint64_t>(v) - prev);
+                auto z = (static_cast<uint64_t>(d) << 1) ^ static_cast<uint64_t>(d >> 63);
+                while (z >= 0x80) {
+                    bytes.push_back(static_cast<char>((z & 0x7f) | 0x80));
+                    z >>= 7;
+                }
+                bytes.push_back(static_cast<char>(z));
+                prev = static_cast<uint64_t>(v);
+            }
+
+            return ar(bytes);
+        }
+
+        template<typename ArchiverT>
+        auto load(ArchiverT &ar) {
+
+            using V = typename std::decay_t<T>::value_type;
+
+            std::string bytes;
+            auto sz = ar(bytes);
+
+            _item.clear();
+
+            uint64_t prev = 0;
+            for (size_t i = 0; i < bytes.size();) {
+                uint64_t z = 0;
+                for (int shift = 0; i < bytes.size() && shift < 64; shift += 7) {
+                    auto b = static_cast<uint8_t>(bytes[i++]);
+                    z |= static_cast<uint64_t>(b & 0x7f) << shift;
+                    if (!(b & 0x80)) {
+                        break;
+                    }
+                }
+                prev += (z >> 1) ^ (~(z & 1) + 1);
+                _item.push_back(static_cast<V>(prev));
+            }
+
+            return sz;
+        }
+
+    private:
+
+        type _item;
+    };
+
+// Function: make_delta_varint_tag
+    template<typename T>
+    DeltaVarintTag<T> make_delta_varint_tag(T &&t) {
+        return {std::forward<T>(t)};
+    }
+
+// ----------------------------------------------------------------------------
+// Array View
+// ----------------------------------------------------------------------------
+
+// Class: ArrayView
+// Read-only array of trivially copyable elements, serialized in the same
+// format as std::vector<T>. Deserialized from a stream that exposes its
+// memory (e.g., rigel::ViewStream over a rigel::MappedFile), the view points
+// into that memory without copying if the data is suitably aligned, and the
+// memory must then outlive the view. Otherwise the view owns a copy.
+    template<typename T>
+    class ArrayView {
+
+        static_assert(std::is_trivially_copyable_v<T>, "ArrayView requires trivially copyable elements");
+
+        template<typename, typename>
+        friend class Deserializer;
+
+    public:
+
+        using value_type = T;
+        using size_type = size_t;
+        using const_iterator = const T *;
+
+        ArrayView() = default;
+
+        ArrayView(const T *data, size_t size) : _data{data}, _size{size} {}
+
+        ArrayView(const std::vector<T> &vec) : _data{vec.data()}, _size{vec.size()} {}
+
+        ArrayView(const ArrayView &rhs) : _data{rhs._data}, _size{rhs._size}, _storage{rhs._storage} {
+            if (!_storage.empty()) {
+                _data = _storage.data();
+            }
+        }
+
+        ArrayView(ArrayView &&) = default;
+
+        ArrayView &operator=(const ArrayView &rhs) {
+            if (this != &rhs) {
+                _storage = rhs._storage;
+                _data = _storage.empty() ? rhs._data : _storage.data();
+                _size = rhs._size;
+            }
+            return *this;
+        }
+
+        ArrayView &operator=(ArrayView &&) = default;
+
+        const T *data() const { return _data; }
+
+        size_t size() const { return _size; }
+
+        bool empty() const { return _size == 0; }
+
+        const T *begin() const { return _data; }
+
+        const T *end() const { return _data + _size; }
+
+        const T &operator[](size_t i) const { return _data[i]; }
+
+        // queries if the view holds its own copy of the elements
+        bool owns_data() const { return !_storage.empty(); }
+
+        std::vector<T> to_vector() const { return std::vector<T>(begin(), end()); }
+
+    private:
+
+        const T *_data{nullptr};
+        size_t _size{0};
+        std::vector<T> _storage;
+    };
+
+// ----------------------------------------------------------------------------
+// Memory Streams
+// ----------------------------------------------------------------------------
+
+// Class: BufferStream
+// Output stream that appends to a growable byte buffer. A serializer over it
+// copies each field with a memcpy instead of a call into std::ostream, and
+// the buffer can be written to a file or socket in one call.
+    class BufferStream {
+
+    public:
+
+        BufferStream() = default;
+
+        BufferStream &write(const char *data, std::streamsize n) {
+            _buffer.insert(_buffer.end(), data, data + n);
+            return *this;
+        }
+
+        const char *data() const { return _buffer.data(); }
+
+        size_t size() const { return _buffer.size(); }
+
+        void reserve(size_t n) { _buffer.reserve(n); }
+
+        void clear() { _buffer.clear(); }
+
+        std::string_view str() const { return {_buffer.data(), _buffer.size()}; }
+
+    private:
+
+        std::vector<char> _buffer;
+    };
+
+// Class: ViewStream
+// Input stream over a block of memory the caller keeps alive, such as a
+// rigel::BufferStream or a rigel::MappedFile. Reading past the end puts the
+// stream in a failed state as std::istream does.
+    class ViewStream {
+
+    public:
+
+        ViewStream(const void *data, size_t size) :
+                _beg{static_cast<const char *>(data)}, _cur{_beg}, _end{_beg + size} {
+        }
+
+        ViewStream &read(char *data, std::streamsize n) {
+            if (auto p = view(static_cast<size_t>(n)); p) {
+                std::memcpy(data, p, static_cast<size_t>(n));
+            }
+            return *this;
+        }
+
+        // returns the next n bytes without copying and skips them,
+        // or nullptr if fewer than n bytes remain
+        const char *view(size_t n) {
+            if (_failed || static_cast<size_t>(_end - _cur) < n) {
+                _failed = true;
+                return nullptr;
+            }
+            auto p = _cur;
+            _cur += n;
+            return p;
+        }
+
+        int peek() const {
+            return _cur < _end ? std::char_traits<char>::to_int_type(*_cur) : std::char_traits<char>::eof();
+        }
+
+        size_t tellg() const { return static_cast<size_t>(_cur - _beg); }
+
+        size_t remaining() const { return static_cast<size_t>(_end - _cur); }
+
+        void setstate(std::ios_base::iostate) { _failed = true; }
+
+        explicit operator bool() const { return !_failed; }
+
+    private:
+
+        const char *_beg;
+        const char *_cur;
+        const char *_end;
+        bool _failed{false};
+    };
+
+// Class: MappedFile
+// Read-only memory mapping of a whole file. Pages are loaded on demand by
+// the kernel, so deserializing through rigel::ViewStream reads the file
+// without an intermediate copy. Without mmap the file is read into memory.
+    class MappedFile {
+
+    public:
+
+        explicit MappedFile(const std::string &path);
+
+        ~MappedFile();
+
+        MappedFile(const MappedFile &) = delete;
+
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        const char *data() const { return _data; }
+
+        size_t size() const { return _size; }
+
+        ViewStream stream() const { return ViewStream(_data, _size); }
+
+    private:
+
+        const char *_data{nullptr};
+        size_t _size{0};
+        bool _mapped{false};
+        std::vector<char> _buffer;
+    };
+
+// Constructor
+    inline MappedFile::MappedFile(const std::string &path) {
+#if defined(TF_HAS_MMAP)
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd == -1) {
+            throw std::runtime_error("failed to open " + path);
+        }
+        struct stat st;
+        if (::fstat(fd, &st) == -1) {
+            ::close(fd);
+            throw std::runtime_error("failed to stat " + path);
+        }
+        _size = static_cast<size_t>(st.st_size);
+        if (_size) {
+            void *p = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("failed to map " + path);
+            }
+            _data = static_cast<const char *>(p);
+            _mapped = true;
+        }
+        ::close(fd);
+#else
+        std::ifstream ifs(path, std::ios::binary);
+        if (!ifs) {
+            throw std::runtime_error("failed to open " + path);
+        }
+        _buffer.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+        _data = _buffer.data();
+        _size = _buffer.size();
+#endif
+    }
+
+// Destructor
+    inline MappedFile::~MappedFile() {
+#if defined(TF_HAS_MMAP)
+        if (_mapped) {
+            ::munmap(const_cast<char *>(_data), _size);
+        }
+#endif
+    }
+
 // ----------------------------------------------------------------------------
 // Serializer Definition
 // ----------------------------------------------------------------------------
@@ -376,7 +748,8 @@ namespace rigel {
             is_std_variant_v<T> ||
             is_std_optional_v<T> ||
             is_std_tuple_v<T> ||
-            is_std_array_v<T>
+            is_std_array_v<T> ||
+            is_array_view_v<T>
     );
 
 
@@ -485,6 +858,11 @@ namespace rigel {
         >
         SizeType _save(T &&);
 
+        template<typename T,
+                std::enable_if_t<is_array_view_v<std::decay_t<T>>, void> * = nullptr
+        >
+        SizeType _save(T &&);
+
 
     };
 
@@ -536,7 +914,7 @@ namespace rigel {
 
         auto sz = _save(make_size_tag(t.size()));
 
-        if constexpr (std::is_arithmetic_v<typename U::value_type>) {
+        if constexpr (is_bulk_serializable_v<typename U::value_type>) {
             _stream.write(
                     reinterpret_cast<const char *>(t.data()),
                     t.size() * sizeof(typename U::value_type)
@@ -686,7 +1064,7 @@ namespace rigel {
 
         SizeType sz;
 
-        if constexpr (std::is_arithmetic_v<typename U::value_type>) {
+        if constexpr (is_bulk_serializable_v<typename U::value_type>) {
             _stream.write(reinterpret_cast<const char *>(t.data()), sizeof(t));
             sz = sizeof(t);
         } else {
@@ -699,6 +1077,21 @@ namespace rigel {
         return sz;
     }
 
+// rigel::ArrayView
+    template<typename Stream, typename SizeType>
+    template<typename T,
+            std::enable_if_t<is_array_view_v<std::decay_t<T>>, void> *
+    >
+    SizeType Serializer<Stream, SizeType>::_save(T &&t) {
+        using U = std::decay_t<T>;
+        auto sz = _save(make_size_tag(t.size()));
+        _stream.write(
+                reinterpret_cast<const char *>(t.data()),
+                t.size() * sizeof(typename U::value_type)
+        );
+        return sz + t.size() * sizeof(typename U::value_type);
+    }
+
 // custom save method
     template<typename Stream, typename SizeType>
     template<typename T,
@@ -730,7 +1123,8 @@ namespace rigel {
             is_std_variant_v<T> ||
             is_std_optional_v<T> ||
             is_std_tuple_v<T> ||
-            is_std_array_v<T>;
+            is_std_array_v<T> ||
+            is_array_view_v<T>;
 
 // Class: Deserializer
     template<typename Stream, typename SizeType = std::streamsize>
@@ -747,6 +1141,8 @@ namespace rigel {
 
         Stream &_stream;
 
+        bool _fits(size_t, size_t);
+
         // Function: _variant_helper
         template<
                 size_t I = 0, typename... ArgsT,
@@ -841,6 +1237,11 @@ namespace rigel {
         >
         SizeType _load(T &&);
 
+        template<typename T,
+                std::enable_if_t<is_array_view_v<std::decay_t<T>>, void> * = nullptr
+        >
+        SizeType _load(T &&);
+
         template<typename T,
                 std::enable_if_t<!is_default_deserializable_v<std::decay_t<T>>, void> * = nullptr
         >
@@ -852,6 +1253,22 @@ namespace rigel {
     Deserializer<Stream, SizeType>::Deserializer(Stream &stream) : _stream(stream) {
     }
 
+// Function: _fits
+// Checks that a size read from the stream describes at most the bytes left
+// in the stream, and fails the stream otherwise, so a corrupted size neither
+// overflows nor allocates a huge buffer.
+    template<typename Stream, typename SizeType>
+    bool Deserializer<Stream, SizeType>::_fits(size_t num_data, size_t size) {
+        bool fits = num_data <= std::numeric_limits<size_t>::max() / size;
+        if constexpr (has_stream_remaining_v<Stream>) {
+            fits = fits && num_data <= _stream.remaining() / size;
+        }
+        if (!fits) {
+            _stream.setstate(std::ios_base::failbit);
+        }
+        return fits;
+    }
+
 // Operator ()
     template<typename Stream, typename SizeType>
     template<typename... T>
@@ -903,6 +1320,10 @@ namespace rigel {
         using U = std::decay_t<T>;
         typename U::size_type num_chars;
         auto sz = _load(make_size_tag(num_chars));
+        if (!_fits(num_chars, sizeof(typename U::value_type))) {
+            t.clear();
+            return sz;
+        }
         t.resize(num_chars);
         _stream.read(reinterpret_cast<char *>(t.data()), num_chars * sizeof(typename U::value_type));
         return sz + num_chars * sizeof(typename U::value_type);
@@ -921,7 +1342,11 @@ namespace rigel {
 
         auto sz = _load(make_size_tag(num_data));
 
-        if constexpr (std::is_arithmetic_v<typename U::value_type>) {
+        if constexpr (is_bulk_serializable_v<typename U::value_type>) {
+            if (!_fits(num_data, sizeof(typename U::value_type))) {
+                t.clear();
+                return sz;
+            }
             t.resize(num_data);
             _stream.read(reinterpret_cast<char *>(t.data()), num_data * sizeof(typename U::value_type));
             sz += num_data * sizeof(typename U::value_type);
@@ -1150,7 +1575,7 @@ namespace rigel {
 
         SizeType sz;
 
-        if constexpr (std::is_arithmetic_v<typename U::value_type>) {
+        if constexpr (is_bulk_serializable_v<typename U::value_type>) {
             _stream.read(reinterpret_cast<char *>(t.data()), sizeof(t));
             sz = sizeof(t);
         } else {
@@ -1163,6 +1588,51 @@ namespace rigel {
         return sz;
     }
 
+// rigel::ArrayView
+    template<typename Stream, typename SizeType>
+    template<typename T,
+            std::enable_if_t<is_array_view_v<std::decay_t<T>>, void> *
+    >
+    SizeType Deserializer<Stream, SizeType>::_load(T &&t) {
+
+        using V = typename std::decay_t<T>::value_type;
+
+        size_t num_data;
+        auto sz = _load(make_size_tag(num_data));
+
+        t._storage.clear();
+        t._data = nullptr;
+        t._size = 0;
+
+        if (!_fits(num_data, sizeof(V))) {
+            return sz;
+        }
+
+        auto num_bytes = num_data * sizeof(V);
+
+        if constexpr (has_stream_view_v<Stream>) {
+            auto p = _stream.view(num_bytes);
+            if (!p) {
+                return sz;
+            }
+            if (reinterpret_cast<uintptr_t>(p) % alignof(V) == 0) {
+                t._data = reinterpret_cast<const V *>(p);
+            } else {
+                t._storage.resize(num_data);
+                std::memcpy(t._storage.data(), p, num_bytes);
+                t._data = t._storage.data();
+            }
+        } else {
+            t._storage.resize(num_data);
+            _stream.read(reinterpret_cast<char *>(t._storage.data()), num_bytes);
+            t._data = t._storage.data();
+        }
+
+        t._size = num_data;
+
+        return sz + num_bytes;
+    }
+
 // custom save method
     template<typename Stream, typename SizeType>
     template<typename T,
@@ -402,3 +402,78 @@ TEST_CASE("RuntimeAsync.3threads") {
 TEST_CASE("RuntimeAsync.11threads") {
   runtime_async(11);
 }
+
+// --------------------------------------------------------
+// Testcase: SilentAsyncBulk
+// --------------------------------------------------------
+
+void silent_async_bulk(size_t W) {
+
+  rigel::Executor executor(W);
+
+  const int N = 10000;
+
+  // indices from outside the executor
+  std::vector<int> data(N, 0);
+  executor.silent_async_bulk(0, N, [&](int i){ data[i] += i; });
+  std::atomic<int> wrong{0};
+  executor.silent_async_bulk(5, 5, [&](int){ wrong++; });
+  executor.silent_async_bulk(5, 2, [&](int){ wrong++; });
+  executor.wait_for_all();
+
+  for(int i=0; i<N; i++) {
+    REQUIRE(data[i] == i);
+  }
+
+  // iterators from a worker, with a callable holding state
+  std::list<int> items(N, 1);
+  std::atomic<int> sum{0};
+  executor.silent_async([&](){
+    executor.silent_async_bulk(items.begin(), items.end(), [&, k=2](int& item){
+      item *= k;
+      sum.fetch_add(item, std::memory_order_relaxed);
+    });
+  });
+  executor.wait_for_all();
+
+  REQUIRE(sum == 2*N);
+  REQUIRE(std::count(items.begin(), items.end(), 2) == N);
+
+  // joined by a runtime
+  rigel::Taskflow taskflow;
+  std::atomic<int> counter{0};
+  taskflow.emplace([&](rigel::Runtime& rt){
+    std::atomic<int> joined{0};
+    rt.silent_async_bulk(0, N, [&](int){
+      joined.fetch_add(1, std::memory_order_relaxed);
+    });
+    rt.join();
+    if(joined != N) {
+      wrong++;
+    }
+    rt.silent_async_bulk(data.begin(), data.end(), [&](int){
+      counter.fetch_add(1, std::memory_order_relaxed);
+    });
+    rt.join();
+  });
+  executor.run_n(taskflow, 3).wait();
+
+  REQUIRE(counter == 3*N);
+  REQUIRE(wrong == 0);
+}
+
+TEST_CASE("SilentAsyncBulk.1thread" * doctest::timeout(300)) {
+  silent_async_bulk(1);
+}
+
+TEST_CASE("SilentAsyncBulk.2threads" * doctest::timeout(300)) {
+  silent_async_bulk(2);
+}
+
+TEST_CASE("SilentAsyncBulk.4threads" * doctest::timeout(300)) {
+  silent_async_bulk(4);
+}
+
+TEST_CASE("SilentAsyncBulk.8threads" * doctest::timeout(300)) {
+  silent_async_bulk(8);
+}
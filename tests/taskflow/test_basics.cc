@@ -18,6 +18,9 @@
 #include "rigel/taskflow/taskflow.h"
 #include "rigel/taskflow/algorithm/for_each.h"
 #include "rigel/taskflow/algorithm/reduce.h"
+#include "rigel/taskflow/core/analysis.h"
+#include "rigel/taskflow/core/perf_observer.h"
+#include "rigel/taskflow/core/snapshot.h"
 
 // --------------------------------------------------------
 // Testcase: Type
@@ -1410,4 +1413,1186 @@ TEST_CASE("Observer.4threads" * doctest::timeout(300)) {
   observer(4);
 }
 
+// --------------------------------------------------------
+// Testcase: Observer.Registration
+// --------------------------------------------------------
+
+struct CountingObserver : public rigel::ObserverInterface {
+
+  std::atomic<size_t> entries {0};
+  std::atomic<size_t> exits {0};
+
+  void set_up(size_t) override final {}
+
+  void on_entry(rigel::WorkerView, rigel::TaskView) override final {
+    entries.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void on_exit(rigel::WorkerView, rigel::TaskView) override final {
+    exits.fetch_add(1, std::memory_order_relaxed);
+  }
+};
+
+void observer_registration(unsigned w) {
+
+  rigel::Executor executor(w);
+  rigel::Taskflow taskflow;
+
+  REQUIRE(executor.num_observers() == 0);
+
+  std::atomic<size_t> counter {0};
+
+  for(auto i=0; i < 64; i++) {
+    taskflow.emplace([&](rigel::Subflow& sf){
+      for(auto j=0; j<4; j++) {
+        sf.emplace([&](){ counter.fetch_add(1, std::memory_order_relaxed); });
+      }
+    });
+  }
+
+  // add and remove observers while the taskflow is running
+  auto future = executor.run_n(taskflow, 200);
+
+  std::vector<std::shared_ptr<CountingObserver>> observers;
+
+  for(size_t i=0; i<100; i++) {
+    observers.push_back(executor.make_observer<CountingObserver>());
+    if(i % 3 == 0) {
+      executor.remove_observer(observers[i / 2]);
+    }
+    std::this_thread::yield();
+  }
+
+  future.get();
+
+  REQUIRE(counter == 64*4*200);
+
+  // every observed entry has its exit
+  for(auto& observer : observers) {
+    REQUIRE(observer->entries == observer->exits);
+  }
+
+  for(auto& observer : observers) {
+    executor.remove_observer(observer);
+  }
+
+  REQUIRE(executor.num_observers() == 0);
+
+  // a new observer sees every task of a new run
+  auto observer = executor.make_observer<CountingObserver>();
+
+  REQUIRE(executor.num_observers() == 1);
+
+  executor.run(taskflow).wait();
+
+  REQUIRE(observer->entries == 64*5);
+  REQUIRE(observer->exits == 64*5);
+}
+
+TEST_CASE("Observer.Registration.1thread" * doctest::timeout(300)) {
+  observer_registration(1);
+}
+
+TEST_CASE("Observer.Registration.2threads" * doctest::timeout(300)) {
+  observer_registration(2);
+}
+
+TEST_CASE("Observer.Registration.3threads" * doctest::timeout(300)) {
+  observer_registration(3);
+}
+
+TEST_CASE("Observer.Registration.4threads" * doctest::timeout(300)) {
+  observer_registration(4);
+}
+
+// --------------------------------------------------------
+// Testcase: TraceObserver
+// --------------------------------------------------------
+
+void trace_observer(unsigned w) {
+
+  rigel::Executor executor(w);
+
+  auto observer = executor.make_observer<rigel::TraceObserver>(1000);
+
+  REQUIRE(observer->capacity() == 1024);
+
+  rigel::Taskflow taskflow;
+
+  for(auto i=0; i < 64; i ++) {
+    taskflow.emplace([](){}).name("task-" + std::to_string(i));
+  }
+
+  executor.run_n(taskflow, 16).get();
+
+  REQUIRE(observer->num_tasks() == 64*16);
+
+  auto data = observer->data();
+
+  REQUIRE(data.num_tasks() == 64*16);
+  REQUIRE(data.num_overwritten() == 0);
+
+  auto timeline = data.timeline();
+  size_t num_segments = 0;
+  for(const auto& worker : timeline.segments) {
+    for(const auto& level : worker) {
+      for(const auto& s : level) {
+        REQUIRE(s.name.rfind("task-", 0) == 0);
+        REQUIRE(s.type == rigel::TaskType::STATIC);
+        REQUIRE(s.beg <= s.end);
+        num_segments++;
+      }
+    }
+  }
+  REQUIRE(num_segments == 64*16);
+
+  // binary round trip
+  std::stringstream ss;
+  observer->save(ss);
+
+  rigel::TraceData loaded;
+  rigel::Deserializer<std::stringstream> deserializer(ss);
+  deserializer(loaded);
+
+  REQUIRE(loaded.num_tasks() == data.num_tasks());
+
+  REQUIRE(loaded.num_overwritten() == 0);
+
+  std::ostringstream chrome, tfprof;
+  loaded.dump_chrome(chrome);
+  loaded.dump_tfprof(tfprof);
+
+  REQUIRE(chrome.str().find("task-63") != std::string::npos);
+  REQUIRE(tfprof.str().find("task-63") != std::string::npos);
+
+  // the oldest events are overwritten once a buffer is full
+  observer->clear();
+  REQUIRE(observer->num_tasks() == 0);
+
+  executor.run_n(taskflow, 64).get();
+
+  data = observer->data();
+  REQUIRE(data.num_tasks() <= 1024 * w);
+  REQUIRE(data.num_tasks() + data.num_overwritten() == 64*64);
+
+  // snapshots taken while the executor is running hold only complete events
+  observer->clear();
+
+  std::atomic<size_t> num_errors(0);
+  auto future = executor.run_n(taskflow, 256);
+
+  while(future.wait_for(std::chrono::milliseconds(0)) != std::future_status::ready) {
+    auto snapshot = observer->data();
+    for(const auto& worker : snapshot.timeline().segments) {
+      for(const auto& level : worker) {
+        for(const auto& s : level) {
+          if(s.name.rfind("task-", 0) != 0 || s.beg > s.end) {
+            num_errors++;
+          }
+        }
+      }
+    }
+  }
+  future.get();
+
+  REQUIRE(num_errors == 0);
+  data = observer->data();
+  REQUIRE(data.num_tasks() + data.num_overwritten() == 64*256);
+
+  // indexed names are interned by their prefix and index and formatted
+  // only when a snapshot is taken
+  observer->clear();
+
+  rigel::Taskflow indexed;
+  indexed.emplace([](rigel::Runtime& rt){
+    for(size_t i=0; i<8; i++) {
+      rt.silent_async_unchecked(rigel::IndexedName{"chunk-", i}, [](){});
+    }
+    rt.join();
+  }).name("parent");
+
+  executor.run_n(indexed, 4).get();
+
+  std::multiset<std::string> names;
+  for(const auto& worker : observer->data().timeline().segments) {
+    for(const auto& level : worker) {
+      for(const auto& s : level) {
+        names.insert(s.name);
+      }
+    }
+  }
+  REQUIRE(names.size() == 4*9);
+  REQUIRE(names.count("parent") == 4);
+  for(size_t i=0; i<8; i++) {
+    REQUIRE(names.count("chunk-" + std::to_string(i)) == 4);
+  }
+}
+
+TEST_CASE("TraceObserver.1thread" * doctest::timeout(300)) {
+  trace_observer(1);
+}
+
+TEST_CASE("TraceObserver.2threads" * doctest::timeout(300)) {
+  trace_observer(2);
+}
+
+TEST_CASE("TraceObserver.3threads" * doctest::timeout(300)) {
+  trace_observer(3);
+}
+
+TEST_CASE("TraceObserver.4threads" * doctest::timeout(300)) {
+  trace_observer(4);
+}
+
+// --------------------------------------------------------
+// Testcase: TFProfManager.Streaming
+// --------------------------------------------------------
+
+TEST_CASE("TFProfManager.Streaming" * doctest::timeout(300)) {
+
+  const std::string path = "TFProfManager.Streaming.tfp";
+
+  // only this executor registers a profiler with the manager
+  setenv(TF_ENABLE_PROFILER, path.c_str(), 1);
+  rigel::Executor executor(4);
+  unsetenv(TF_ENABLE_PROFILER);
+
+  auto& manager = rigel::TFProfManager::get();
+
+  rigel::Taskflow taskflow;
+
+  for(auto i=0; i < 100; i ++) {
+    taskflow.emplace([](){}).name("task-" + std::to_string(i));
+  }
+
+  auto num_tasks = [&](){
+    std::ifstream ifs(path, std::ios::binary);
+    auto data = rigel::load_tfprof(ifs);
+    REQUIRE(data.timelines.size() <= 1);
+    size_t n = 0;
+    for(const auto& timeline : data.timelines) {
+      for(const auto& worker : timeline.segments) {
+        for(const auto& level : worker) {
+          for(const auto& s : level) {
+            REQUIRE(s.name.rfind("task-", 0) == 0);
+            n++;
+          }
+        }
+      }
+    }
+    return n;
+  };
+
+  // each flush appends the tasks finished since the previous one
+  for(size_t r=1; r<=3; r++) {
+    executor.run(taskflow).wait();
+    manager.flush();
+    REQUIRE(num_tasks() == 100*r);
+  }
+
+  manager.flush();
+  REQUIRE(num_tasks() == 300);
+
+  // flush by size
+  manager.stream(std::chrono::milliseconds(0), 100);
+  executor.run_n(taskflow, 5).wait();
+  while(num_tasks() != 800) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  // flush by time
+  manager.stream(std::chrono::milliseconds(10));
+  executor.run(taskflow).wait();
+  while(num_tasks() != 900) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  manager.stream(std::chrono::milliseconds(0), 0);
+
+  std::remove(path.c_str());
+}
+
+// --------------------------------------------------------
+// Testcase: ProfileAnalysis
+// --------------------------------------------------------
+
+void profile_analysis(unsigned w) {
+
+  using namespace std::chrono_literals;
+
+  rigel::Executor executor(w);
+
+  auto observer = executor.make_observer<rigel::TFProfObserver>();
+
+  // A -> B -> C is the critical path and D -> C is the short branch;
+  // B is long enough that scheduling delays of the short tasks do not
+  // change the critical path
+  rigel::Taskflow taskflow;
+
+  auto A = taskflow.emplace([](){ std::this_thread::sleep_for(1ms); }).name("A");
+  auto B = taskflow.emplace([](){ std::this_thread::sleep_for(30ms); }).name("B");
+  auto C = taskflow.emplace([](){ std::this_thread::sleep_for(1ms); }).name("C");
+  auto D = taskflow.emplace([](){ std::this_thread::sleep_for(2ms); }).name("D");
+
+  A.precede(B);
+  B.precede(C);
+  D.precede(C);
+
+  executor.run_n(taskflow, 3).wait();
+
+  auto check = [&](const rigel::ProfileAnalysis& analysis){
+
+    REQUIRE(analysis.num_workers() == w);
+    REQUIRE(analysis.runs().size() == 3);
+
+    for(const auto& run : analysis.runs()) {
+      REQUIRE(run.num_tasks == 4);
+      REQUIRE(run.critical_path.size() == 3);
+      REQUIRE(run.critical_path[0].name == "A");
+      REQUIRE(run.critical_path[1].name == "B");
+      REQUIRE(run.critical_path[2].name == "C");
+      REQUIRE(run.critical_path_span >= 32ms);
+      REQUIRE(run.critical_path_span <= run.makespan);
+      REQUIRE(run.work >= run.critical_path_span);
+      REQUIRE(run.parallelism() > 0.0f);
+      REQUIRE(run.max_latency >= run.avg_latency);
+    }
+
+    auto tasks = analysis.top_critical_tasks(2);
+    REQUIRE(tasks.size() == 2);
+    REQUIRE(tasks[0].name == "B");
+    REQUIRE(tasks[0].span >= 90ms);
+
+    auto report = analysis.dump(2);
+    REQUIRE(report.find("3 runs") != std::string::npos);
+    REQUIRE(report.find("Top 2 tasks") != std::string::npos);
+  };
+
+  // dependencies from the taskflow
+  check(rigel::ProfileAnalysis(*observer, rigel::ProfileGraph(taskflow)));
+
+  // dependencies from the dump of the taskflow
+  std::istringstream dot(taskflow.dump());
+  rigel::ProfileGraph graph;
+  graph.load_dot(dot);
+  REQUIRE(graph.num_tasks() == 4);
+  REQUIRE(graph.num_dependencies() == 3);
+  check(rigel::ProfileAnalysis(*observer, graph));
+
+  // without dependencies the timeline is one run led by its longest task
+  rigel::ProfileAnalysis analysis(*observer);
+  REQUIRE(analysis.runs().size() == 1);
+  REQUIRE(analysis.runs()[0].num_tasks == 12);
+  REQUIRE(analysis.runs()[0].critical_path.size() == 1);
+  REQUIRE(analysis.runs()[0].critical_path[0].name == "B");
+}
+
+TEST_CASE("ProfileAnalysis.1thread" * doctest::timeout(300)) {
+  profile_analysis(1);
+}
+
+TEST_CASE("ProfileAnalysis.2threads" * doctest::timeout(300)) {
+  profile_analysis(2);
+}
+
+TEST_CASE("ProfileAnalysis.3threads" * doctest::timeout(300)) {
+  profile_analysis(3);
+}
+
+TEST_CASE("ProfileAnalysis.4threads" * doctest::timeout(300)) {
+  profile_analysis(4);
+}
+
+TEST_CASE("ProfileAnalysis.Subflow" * doctest::timeout(300)) {
+
+  rigel::Executor executor(2);
+
+  auto observer = executor.make_observer<rigel::TFProfObserver>();
+
+  rigel::Taskflow taskflow;
+
+  auto S = taskflow.emplace([](rigel::Subflow& sf){
+    auto x = sf.emplace([](){}).name("x");
+    auto y = sf.emplace([](){}).name("y");
+    x.precede(y);
+  }).name("S");
+  auto T = taskflow.emplace([](){}).name("T");
+  S.precede(T);
+
+  executor.run_n(taskflow, 2).wait();
+
+  // the dump after the run includes the subflow but the edge joining
+  // y back to S is not a dependency
+  std::istringstream dot(taskflow.dump());
+  rigel::ProfileGraph graph;
+  graph.load_dot(dot);
+  REQUIRE(graph.num_dependencies() == 2);
+
+  rigel::ProfileAnalysis analysis(*observer, graph);
+  REQUIRE(analysis.runs().size() == 4);
+  size_t num_tasks = 0;
+  for(const auto& run : analysis.runs()) {
+    num_tasks += run.num_tasks;
+  }
+  REQUIRE(num_tasks == 8);
+}
+
+
+
+// --------------------------------------------------------
+// Testcase: PerfCounterObserver
+// --------------------------------------------------------
+
+void perf_counter_observer(size_t W) {
+
+  rigel::Executor executor(W);
+
+  auto observer = executor.make_observer<rigel::PerfCounterObserver>();
+
+  rigel::Taskflow taskflow("tf");
+  rigel::Taskflow other("other");
+
+  std::vector<int> data(1 << 16);
+
+  auto A = taskflow.emplace([&](){
+    for(size_t i=0; i<data.size(); i++) data[i] = static_cast<int>(i);
+  }).name("A");
+  auto B = taskflow.emplace([&](){
+    volatile int sum = 0;
+    for(size_t i=0; i<data.size(); i++) sum = sum + data[i];
+  }).name("B");
+  A.precede(B);
+
+  other.emplace([](){}).name("A");
+
+  executor.run_n(taskflow, 10).wait();
+  executor.run_n(other, 5).wait();
+
+  executor.silent_async("async", [](){});
+  executor.wait_for_all();
+
+  REQUIRE(observer->num_tasks() == 26);
+
+  auto records = observer->records();
+  REQUIRE(records.size() == 4);
+
+  std::map<std::pair<std::string, std::string>, rigel::PerfCounterRecord> map;
+  for(const auto& r : records) {
+    map[{r.taskflow, r.name}] = r;
+  }
+  REQUIRE(map.at({"tf", "A"}).counters.count == 10);
+  REQUIRE(map.at({"tf", "B"}).counters.count == 10);
+  REQUIRE(map.at({"other", "A"}).counters.count == 5);
+  REQUIRE(map.at({"", "async"}).counters.count == 1);
+  REQUIRE(map.at({"tf", "A"}).type == rigel::TaskType::STATIC);
+  REQUIRE(map.at({"", "async"}).type == rigel::TaskType::ASYNC);
+
+  auto taskflows = observer->taskflows();
+  REQUIRE(taskflows.size() == 3);
+
+  if(observer->available(rigel::PerfEvent::CYCLES)) {
+    REQUIRE(map.at({"tf", "B"}).counters[rigel::PerfEvent::CYCLES] > 0);
+  }
+  if(observer->available(rigel::PerfEvent::INSTRUCTIONS)) {
+    REQUIRE(map.at({"tf", "B"}).counters.ipc() > 0);
+  }
+
+  REQUIRE(observer->dump().find("tf") != std::string::npos);
+
+  observer->clear();
+  REQUIRE(observer->num_tasks() == 0);
+  REQUIRE(observer->records().empty());
+}
+
+TEST_CASE("PerfCounterObserver.1thread" * doctest::timeout(300)) {
+  perf_counter_observer(1);
+}
+
+TEST_CASE("PerfCounterObserver.2threads" * doctest::timeout(300)) {
+  perf_counter_observer(2);
+}
+
+TEST_CASE("PerfCounterObserver.3threads" * doctest::timeout(300)) {
+  perf_counter_observer(3);
+}
+
+TEST_CASE("PerfCounterObserver.4threads" * doctest::timeout(300)) {
+  perf_counter_observer(4);
+}
+
+// --------------------------------------------------------
+// Testcase: TaskflowSnapshot
+// --------------------------------------------------------
+
+void taskflow_snapshot(size_t W) {
+
+  rigel::Executor executor(W);
+
+  // module: M1 -> M2
+  rigel::Taskflow module;
+  auto M1 = module.placeholder().name("M1");
+  auto M2 = module.placeholder().name("M2");
+  M1.precede(M2);
+
+  // init -> loop -> cond -> {loop, done}, done -> mod
+  rigel::Semaphore semaphore(1);
+  rigel::Taskflow taskflow("snapshot");
+  auto init = taskflow.placeholder().name("init");
+  auto cond = taskflow.placeholder().name("cond");
+  auto loop = taskflow.placeholder().name("loop").priority(rigel::TaskPriority::LOW);
+  auto done = taskflow.placeholder().name("done");
+  auto mod  = taskflow.composed_of(module).name("mod");
+  init.precede(loop);
+  loop.precede(cond);
+  cond.precede(loop, done);
+  done.precede(mod);
+  loop.acquire(semaphore).release(semaphore);
+
+  std::stringstream ss;
+  rigel::TaskflowSnapshot(taskflow).save(ss);
+
+  rigel::TaskflowSnapshot snapshot;
+  snapshot.load(ss);
+
+  REQUIRE(snapshot.name() == "snapshot");
+  REQUIRE(snapshot.num_graphs() == 2);
+  REQUIRE(snapshot.num_tasks() == 7);
+  REQUIRE(snapshot.num_semaphores() == 1);
+  REQUIRE(snapshot.graph().size() == 5);
+  REQUIRE(snapshot.graph().num_dependencies() == 5);
+  REQUIRE(snapshot.graph().name(1) == "cond");
+  REQUIRE(snapshot.graph().num_successors(1) == 2);
+  REQUIRE(snapshot.graph().priority(2) == rigel::TaskPriority::LOW);
+  REQUIRE(snapshot.graph().type(4) == rigel::TaskType::MODULE);
+  REQUIRE(snapshot.module_of(4) == 1);
+  REQUIRE(snapshot.module_of(3) == static_cast<size_t>(-1));
+  REQUIRE(snapshot.graph(1).size() == 2);
+  REQUIRE(snapshot.graph(1).num_dependencies() == 1);
+
+  // restore and rebind the callables
+  auto restored = snapshot.restore();
+
+  // a restored taskflow snapshots to the same structure
+  std::stringstream ss2;
+  rigel::TaskflowSnapshot(restored.taskflow()).save(ss2);
+  REQUIRE(ss.str() == ss2.str());
+
+  std::atomic<int> counter {0};
+  int iterations = 0;
+  std::vector<std::string> order;
+  std::mutex mutex;
+
+  auto log = [&](const char* name){
+    std::lock_guard<std::mutex> lock(mutex);
+    order.push_back(name);
+  };
+
+  REQUIRE(restored.bind("init", [&](){ log("init"); iterations = 0; }) == 1);
+  REQUIRE(restored.bind("cond", [&](){ log("cond"); return iterations++ < 3 ? 0 : 1; }) == 1);
+  REQUIRE(restored.bind("loop", [&](){ log("loop"); counter++; }) == 1);
+  REQUIRE(restored.bind("none", [](){}) == 0);
+  restored.bind(3, [&](){ log("done"); });
+  REQUIRE(restored.bind("M1", [&](){ log("M1"); }) == 1);
+  REQUIRE(restored.bind("M2", [&](){ log("M2"); }) == 1);
+
+  REQUIRE(restored.task(2).priority() == rigel::TaskPriority::LOW);
+  REQUIRE(restored.task(0, 1).name() == "M1");
+  REQUIRE(restored.taskflow().name() == "snapshot");
+  REQUIRE(restored.taskflow().num_tasks() == 5);
+
+  executor.run_n(restored.taskflow(), 2).wait();
+
+  REQUIRE(counter == 8);
+
+  std::vector<std::string> once {
+    "init", "loop", "cond", "loop", "cond", "loop", "cond", "loop", "cond", "done", "M1", "M2"
+  };
+  REQUIRE(order.size() == 2 * once.size());
+  REQUIRE(std::equal(once.begin(), once.end(), order.begin()));
+  REQUIRE(std::equal(once.begin(), once.end(), order.begin() + once.size()));
+}
+
+TEST_CASE("TaskflowSnapshot.1thread" * doctest::timeout(300)) {
+  taskflow_snapshot(1);
+}
+
+TEST_CASE("TaskflowSnapshot.2threads" * doctest::timeout(300)) {
+  taskflow_snapshot(2);
+}
+
+TEST_CASE("TaskflowSnapshot.3threads" * doctest::timeout(300)) {
+  taskflow_snapshot(3);
+}
+
+TEST_CASE("TaskflowSnapshot.4threads" * doctest::timeout(300)) {
+  taskflow_snapshot(4);
+}
+
+TEST_CASE("TaskflowSnapshot.InvalidStream" * doctest::timeout(300)) {
+  std::stringstream ss("not a snapshot");
+  rigel::TaskflowSnapshot snapshot;
+  REQUIRE_THROWS_AS(snapshot.load(ss), std::runtime_error);
+}
+
+// ----------------------------------------------------------------------------
+// Guest Waits
+// ----------------------------------------------------------------------------
 
+void guest_waits(unsigned W) {
+
+  rigel::Executor executor(W);
+
+  REQUIRE(executor.guest_waits_enabled() == false);
+  executor.enable_guest_waits();
+  REQUIRE(executor.guest_waits_enabled() == true);
+
+  const size_t C = 4;
+  const size_t R = 50;
+
+  std::atomic<size_t> counter {0};
+  std::vector<std::thread> clients;
+
+  for(size_t c=0; c<C; c++) {
+    clients.emplace_back([&, c](){
+      rigel::Taskflow taskflow;
+      auto A = taskflow.emplace([&](){ counter++; });
+      auto B = taskflow.emplace([&](rigel::Subflow& sf){
+        for(int i=0; i<4; i++) {
+          sf.emplace([&](){ counter++; });
+        }
+      });
+      auto C = taskflow.emplace([&](rigel::Runtime& rt){
+        for(int i=0; i<4; i++) {
+          rt.silent_async([&](){ counter++; });
+        }
+        rt.join();
+      });
+      auto D = taskflow.emplace([&](){ counter++; });
+      A.precede(B, C);
+      D.succeed(B, C);
+      for(size_t r=0; r<R; r++) {
+        if((r + c) % 2) {
+          executor.run(taskflow).wait();
+        }
+        else {
+          executor.run(taskflow).get();
+        }
+      }
+    });
+  }
+
+  for(auto& client : clients) {
+    client.join();
+  }
+
+  REQUIRE(counter == C * R * 10);
+  REQUIRE(executor.num_topologies() == 0);
+}
+
+TEST_CASE("GuestWaits.1thread" * doctest::timeout(300)) {
+  guest_waits(1);
+}
+
+TEST_CASE("GuestWaits.2threads" * doctest::timeout(300)) {
+  guest_waits(2);
+}
+
+TEST_CASE("GuestWaits.4threads" * doctest::timeout(300)) {
+  guest_waits(4);
+}
+
+// the only worker is held until a task that needs the waiting thread to run
+// releases it
+TEST_CASE("GuestWaits.BusyWorker" * doctest::timeout(300)) {
+
+  rigel::Executor executor(1);
+  executor.enable_guest_waits();
+
+  std::atomic<bool> held {false};
+  std::atomic<bool> hold {true};
+  std::atomic<size_t> guests {0};
+
+  executor.silent_async([&](){
+    held = true;
+    while(hold) {
+      std::this_thread::yield();
+    }
+  });
+
+  while(!held) {
+    std::this_thread::yield();
+  }
+
+  rigel::Taskflow taskflow;
+  auto A = taskflow.emplace([&](){
+    guests += (executor.this_worker_id() == -1);
+  });
+  auto B = taskflow.emplace([&](){
+    guests += (executor.this_worker_id() == -1);
+    hold = false;
+  });
+  A.precede(B);
+
+  executor.run(taskflow).wait();
+
+  REQUIRE(guests == 2);
+
+  executor.wait_for_all();
+  REQUIRE(executor.num_topologies() == 0);
+}
+
+TEST_CASE("GuestWaits.WaitForAll" * doctest::timeout(300)) {
+
+  rigel::Executor executor(1);
+  executor.enable_guest_waits();
+
+  std::atomic<bool> hold {true};
+  std::atomic<size_t> counter {0};
+
+  executor.silent_async([&](){
+    while(hold) {
+      std::this_thread::yield();
+    }
+  });
+
+  for(int i=0; i<100; i++) {
+    executor.silent_async([&](){
+      if(++counter == 100) {
+        hold = false;
+      }
+    });
+  }
+
+  executor.wait_for_all();
+
+  REQUIRE(counter == 100);
+  REQUIRE(executor.num_topologies() == 0);
+}
+
+// a guest runs a task that joins its children while the only worker is held
+TEST_CASE("GuestWaits.Corun" * doctest::timeout(300)) {
+
+  rigel::Executor executor(1);
+  executor.enable_guest_waits();
+
+  std::atomic<bool> held {false};
+  std::atomic<bool> hold {true};
+  std::atomic<size_t> guests {0};
+  std::atomic<size_t> counter {0};
+
+  executor.silent_async([&](){
+    held = true;
+    while(hold) {
+      std::this_thread::yield();
+    }
+  });
+
+  while(!held) {
+    std::this_thread::yield();
+  }
+
+  rigel::Taskflow inner;
+  inner.emplace([&](){ counter++; });
+
+  rigel::Taskflow taskflow;
+  taskflow.emplace([&](rigel::Runtime& rt){
+    guests += (executor.this_worker_id() == -1);
+    for(int i=0; i<4; i++) {
+      rt.silent_async([&](){ counter++; });
+    }
+    rt.join();
+    rt.corun(inner);
+    hold = false;
+  });
+
+  executor.run(taskflow).wait();
+
+  REQUIRE(guests == 1);
+  REQUIRE(counter == 5);
+}
+
+// the executor is destroyed while a thread still waits on a future as a guest
+TEST_CASE("GuestWaits.Destructor" * doctest::timeout(300)) {
+
+  for(int r=0; r<10; r++) {
+
+    rigel::Taskflow taskflow;
+    std::atomic<bool> hold {true};
+    std::atomic<bool> guest {false};
+    std::atomic<size_t> counter {0};
+
+    // only the client can run the first task since the worker is held
+    auto A = taskflow.emplace([&](){ guest = true; });
+    for(int i=0; i<16; i++) {
+      A.precede(taskflow.emplace([&](){ counter++; }));
+    }
+
+    std::thread client;
+
+    {
+      rigel::Executor executor(1);
+      executor.enable_guest_waits();
+
+      executor.silent_async([&](){
+        while(hold) {
+          std::this_thread::yield();
+        }
+      });
+
+      client = std::thread([&](){
+        executor.run(taskflow).wait();
+      });
+
+      while(!guest) {
+        std::this_thread::yield();
+      }
+      hold = false;
+    }
+
+    client.join();
+
+    REQUIRE(counter == 16);
+  }
+}
+
+// ----------------------------------------------------------------------------
+// Instancing
+// ----------------------------------------------------------------------------
+
+void instancing(unsigned W) {
+
+  rigel::Executor executor(W);
+  rigel::Taskflow taskflow;
+
+  REQUIRE(taskflow.instancing_enabled() == false);
+
+  // A -> {B, C} -> D -> E -> G, where D checks that B and C, including the
+  // tasks C spawns, ran at least as often
+  std::atomic<size_t> a {0}, b {0}, c {0}, d {0}, wrong {0};
+
+  auto A = taskflow.emplace([&](){ a++; });
+  auto B = taskflow.emplace([&](){ b++; });
+  auto C = taskflow.emplace([&](rigel::Runtime& rt){
+    // left unjoined on purpose
+    for(int i=0; i<4; i++) {
+      rt.silent_async([&](){ c++; });
+    }
+  });
+  auto D = taskflow.emplace([&](){
+    auto n = d++;
+    if(b <= n || c < 4*(n+1)) {
+      wrong++;
+    }
+  });
+  auto E = taskflow.emplace([](){ return 1; });
+  auto F = taskflow.emplace([&](){ wrong++; });
+  auto G = taskflow.emplace([&](){ a++; });
+
+  A.precede(B, C);
+  D.succeed(B, C);
+  D.precede(E);
+  E.precede(F, G);
+
+  taskflow.enable_instancing();
+  REQUIRE(taskflow.instancing_enabled() == true);
+
+  const size_t R = 100;
+
+  std::vector<rigel::Future<void>> futures;
+  for(size_t r=0; r<R; r++) {
+    futures.push_back(executor.run(taskflow));
+  }
+  for(auto& fu : futures) {
+    fu.get();
+  }
+
+  REQUIRE(a == 2*R);
+  REQUIRE(b == R);
+  REQUIRE(c == 4*R);
+  REQUIRE(d == R);
+  REQUIRE(wrong == 0);
+
+  // each instance runs its own iterations
+  futures.clear();
+  for(size_t r=0; r<R; r++) {
+    futures.push_back(executor.run_n(taskflow, 3));
+  }
+  executor.wait_for_all();
+
+  REQUIRE(a == 8*R);
+  REQUIRE(d == 4*R);
+  REQUIRE(wrong == 0);
+  REQUIRE(executor.num_topologies() == 0);
+
+  // the runs queue up again once instancing is disabled
+  taskflow.enable_instancing(false);
+  REQUIRE(taskflow.instancing_enabled() == false);
+
+  executor.run_n(taskflow, 2).wait();
+  REQUIRE(a == 8*R + 4);
+  REQUIRE(wrong == 0);
+}
+
+TEST_CASE("Instancing.1thread" * doctest::timeout(300)) {
+  instancing(1);
+}
+
+TEST_CASE("Instancing.2threads" * doctest::timeout(300)) {
+  instancing(2);
+}
+
+TEST_CASE("Instancing.4threads" * doctest::timeout(300)) {
+  instancing(4);
+}
+
+TEST_CASE("Instancing.8threads" * doctest::timeout(300)) {
+  instancing(8);
+}
+
+// the only task of each instance waits until both instances are running,
+// which never happens if the runs queue up
+TEST_CASE("Instancing.Concurrent" * doctest::timeout(300)) {
+
+  rigel::Executor executor(2);
+  rigel::Taskflow taskflow;
+
+  std::atomic<size_t> arrived {0};
+
+  taskflow.emplace([&](){
+    arrived++;
+    while(arrived < 2) {
+      std::this_thread::yield();
+    }
+  });
+
+  taskflow.enable_instancing();
+
+  auto fu1 = executor.run(taskflow);
+  auto fu2 = executor.run(taskflow);
+
+  fu1.wait();
+  fu2.wait();
+
+  REQUIRE(arrived == 2);
+}
+
+TEST_CASE("Instancing.Cancel" * doctest::timeout(300)) {
+
+  rigel::Executor executor(4);
+  rigel::Taskflow taskflow;
+
+  std::atomic<size_t> counter {0};
+
+  for(int i=0; i<100; i++) {
+    taskflow.emplace([&](){
+      counter++;
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+    });
+  }
+
+  taskflow.enable_instancing();
+
+  std::vector<rigel::Future<void>> futures;
+  for(int r=0; r<10; r++) {
+    futures.push_back(executor.run_n(taskflow, 100));
+  }
+  for(auto& fu : futures) {
+    fu.cancel();
+  }
+  executor.wait_for_all();
+
+  REQUIRE(counter < 100 * 100 * 10);
+  REQUIRE(executor.num_topologies() == 0);
+}
+
+TEST_CASE("Instancing.Satellite" * doctest::timeout(300)) {
+
+  rigel::Executor executor(2);
+
+  std::atomic<size_t> counter {0};
+
+  for(int r=0; r<10; r++) {
+    rigel::Taskflow taskflow;
+    auto A = taskflow.emplace([&](){ counter++; });
+    auto B = taskflow.emplace([&](){ counter++; });
+    A.precede(B);
+    taskflow.enable_instancing();
+    executor.run_n(std::move(taskflow), 2);
+  }
+  executor.wait_for_all();
+
+  REQUIRE(counter == 40);
+}
+
+// changing the tasks of the graph drops the plan of its instances
+TEST_CASE("Instancing.GraphChanges" * doctest::timeout(300)) {
+
+  rigel::Executor executor(4);
+  rigel::Taskflow taskflow;
+
+  std::atomic<size_t> counter {0};
+
+  auto A = taskflow.emplace([&](){ counter++; });
+  auto B = taskflow.emplace([&](){ counter++; });
+  A.precede(B);
+
+  // erase
+  taskflow.enable_instancing();
+  executor.run_n(taskflow, 10).wait();
+  REQUIRE(counter == 20);
+
+  taskflow.erase(B);
+  REQUIRE(taskflow.instancing_enabled() == false);
+
+  executor.run_n(taskflow, 10).wait();
+  REQUIRE(counter == 30);
+
+  taskflow.enable_instancing();
+  REQUIRE(taskflow.instancing_enabled() == true);
+  executor.run_n(taskflow, 10).wait();
+  REQUIRE(counter == 40);
+
+  // emplace
+  taskflow.emplace([&](){ counter++; });
+  REQUIRE(taskflow.instancing_enabled() == false);
+
+  executor.run_n(taskflow, 10).wait();
+  REQUIRE(counter == 60);
+
+  // clear
+  taskflow.enable_instancing();
+  taskflow.clear();
+  REQUIRE(taskflow.instancing_enabled() == false);
+
+  executor.run(taskflow).wait();
+  REQUIRE(counter == 60);
+
+  for(int i=0; i<8; i++) {
+    taskflow.emplace([&](){ counter++; });
+  }
+  executor.run_n(taskflow, 10).wait();
+  REQUIRE(counter == 140);
+
+  taskflow.enable_instancing();
+  std::vector<rigel::Future<void>> futures;
+  for(int r=0; r<10; r++) {
+    futures.push_back(executor.run(taskflow));
+  }
+  for(auto& fu : futures) {
+    fu.get();
+  }
+  REQUIRE(counter == 220);
+
+  // a moved taskflow keeps the plan of its graph
+  rigel::Taskflow moved(std::move(taskflow));
+  REQUIRE(moved.instancing_enabled() == true);
+  REQUIRE(taskflow.instancing_enabled() == false);
+  executor.run(moved).wait();
+  REQUIRE(counter == 228);
+}
+
+// concurrent instances of a loop task keep their own partitioner runs
+template <typename P>
+void instancing_partitioner(unsigned W) {
+
+  rigel::Executor executor(W);
+  rigel::Taskflow taskflow;
+
+  const size_t N = 10000;
+  const size_t R = 16;
+
+  std::vector<std::atomic<size_t>> data(N);
+  for(auto& d : data) {
+    d = 0;
+  }
+
+  P part;
+  taskflow.for_each_index(size_t{0}, N, size_t{1}, [&](size_t i){ data[i]++; }, part);
+  taskflow.enable_instancing();
+
+  std::vector<rigel::Future<void>> futures;
+  for(size_t r=0; r<R; r++) {
+    futures.push_back(executor.run_n(taskflow, 4));
+  }
+  for(auto& fu : futures) {
+    fu.get();
+  }
+
+  for(auto& d : data) {
+    REQUIRE(d == 4*R);
+  }
+}
+
+TEST_CASE("Instancing.AffinityPartitioner.2threads" * doctest::timeout(300)) {
+  instancing_partitioner<rigel::AffinityPartitioner>(2);
+}
+
+TEST_CASE("Instancing.AffinityPartitioner.4threads" * doctest::timeout(300)) {
+  instancing_partitioner<rigel::AffinityPartitioner>(4);
+}
+
+TEST_CASE("Instancing.AffinityPartitioner.8threads" * doctest::timeout(300)) {
+  instancing_partitioner<rigel::AffinityPartitioner>(8);
+}
+
+TEST_CASE("Instancing.AdaptivePartitioner.2threads" * doctest::timeout(300)) {
+  instancing_partitioner<rigel::AdaptivePartitioner>(2);
+}
+
+TEST_CASE("Instancing.AdaptivePartitioner.4threads" * doctest::timeout(300)) {
+  instancing_partitioner<rigel::AdaptivePartitioner>(4);
+}
+
+TEST_CASE("Instancing.AdaptivePartitioner.8threads" * doctest::timeout(300)) {
+  instancing_partitioner<rigel::AdaptivePartitioner>(8);
+}
+
+TEST_CASE("Instancing.Unsupported" * doctest::timeout(300)) {
+
+  rigel::Taskflow taskflow;
+  taskflow.emplace([](){});
+  auto S = taskflow.emplace([](rigel::Subflow& sf){ sf.emplace([](){}); });
+
+  REQUIRE_THROWS_AS(taskflow.enable_instancing(), std::runtime_error);
+  REQUIRE(taskflow.instancing_enabled() == false);
+
+  taskflow.erase(S);
+  rigel::Semaphore semaphore(1);
+  taskflow.emplace([](){}).acquire(semaphore);
+
+  REQUIRE_THROWS_AS(taskflow.enable_instancing(), std::runtime_error);
+  REQUIRE(taskflow.instancing_enabled() == false);
+}
+
+// a runtime task cannot schedule a task of an instanced run
+TEST_CASE("Instancing.RuntimeSchedule" * doctest::timeout(300)) {
+
+  rigel::Executor executor(2);
+  rigel::Taskflow taskflow;
+
+  std::atomic<size_t> thrown {0};
+  std::atomic<size_t> counter {0};
+
+  auto A = taskflow.emplace([](){ return 0; });
+  rigel::Task C;
+  auto B = taskflow.emplace([&](rigel::Runtime& rt){
+    try {
+      rt.schedule(C);
+    }
+    catch(const std::runtime_error&) {
+      thrown++;
+    }
+  });
+  C = taskflow.emplace([&](){ counter++; });
+  A.precede(B, C);
+
+  // a plain run schedules the task
+  executor.run(taskflow).wait();
+  REQUIRE(thrown == 0);
+  REQUIRE(counter == 1);
+
+  taskflow.enable_instancing();
+  executor.run_n(taskflow, 4).wait();
+  REQUIRE(thrown == 4);
+  REQUIRE(counter == 1);
+}
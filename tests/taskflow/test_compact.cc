@@ -0,0 +1,790 @@
+// Copyright 2023 The titan-search Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include "tests/doctest.h"
+#include "rigel/taskflow/taskflow.h"
+#include "rigel/taskflow/algorithm/compact.h"
+
+// ----------------------------------------------------------------------------
+// copy_if
+// ----------------------------------------------------------------------------
+
+template <typename P>
+void test_copy_if(unsigned W) {
+
+  rigel::Executor executor(W);
+  rigel::Taskflow taskflow;
+  std::vector<int> input, output, golden;
+
+  for(size_t n = 0; n <= 150000; n <= 16 ? n++ : n=2*n+1) {
+    for(size_t c : {0, 1, 3}) {
+      for(int s : {0, 10, 50, 100}) {
+
+        taskflow.clear();
+
+        input.resize(n);
+        output.assign(n, -1);
+        golden.assign(n, -1);
+
+        for(auto& i : input) {
+          i = ::rand() % 100;
+        }
+
+        auto pred = [s] (int i) { return i < s; };
+
+        auto gend = std::copy_if(input.begin(), input.end(), golden.begin(), pred);
+
+        std::vector<int>::iterator result, beg, end, d_beg;
+
+        auto init = taskflow.emplace([&](){
+          beg = input.begin();
+          end = input.end();
+          d_beg = output.begin();
+        });
+
+        auto task = taskflow.copy_if(
+          std::ref(beg), std::ref(end), std::ref(d_beg), result, pred, P(c)
+        );
+
+        init.precede(task);
+
+        executor.run(taskflow).wait();
+
+        REQUIRE(result - output.begin() == gend - golden.begin());
+        REQUIRE(output == golden);
+      }
+    }
+  }
+}
+
+// static partitioner
+TEST_CASE("CopyIf.StaticPartitioner.1thread" * doctest::timeout(300)) {
+  test_copy_if<rigel::StaticPartitioner>(1);
+}
+
+TEST_CASE("CopyIf.StaticPartitioner.2threads" * doctest::timeout(300)) {
+  test_copy_if<rigel::StaticPartitioner>(2);
+}
+
+TEST_CASE("CopyIf.StaticPartitioner.3threads" * doctest::timeout(300)) {
+  test_copy_if<rigel::StaticPartitioner>(3);
+}
+
+TEST_CASE("CopyIf.StaticPartitioner.4threads" * doctest::timeout(300)) {
+  test_copy_if<rigel::StaticPartitioner>(4);
+}
+
+TEST_CASE("CopyIf.StaticPartitioner.8threads" * doctest::timeout(300)) {
+  test_copy_if<rigel::StaticPartitioner>(8);
+}
+
+// guided partitioner
+TEST_CASE("CopyIf.GuidedPartitioner.1thread" * doctest::timeout(300)) {
+  test_copy_if<rigel::GuidedPartitioner>(1);
+}
+
+TEST_CASE("CopyIf.GuidedPartitioner.2threads" * doctest::timeout(300)) {
+  test_copy_if<rigel::GuidedPartitioner>(2);
+}
+
+TEST_CASE("CopyIf.GuidedPartitioner.3threads" * doctest::timeout(300)) {
+  test_copy_if<rigel::GuidedPartitioner>(3);
+}
+
+TEST_CASE("CopyIf.GuidedPartitioner.4threads" * doctest::timeout(300)) {
+  test_copy_if<rigel::GuidedPartitioner>(4);
+}
+
+TEST_CASE("CopyIf.GuidedPartitioner.8threads" * doctest::timeout(300)) {
+  test_copy_if<rigel::GuidedPartitioner>(8);
+}
+
+// dynamic partitioner
+TEST_CASE("CopyIf.DynamicPartitioner.1thread" * doctest::timeout(300)) {
+  test_copy_if<rigel::DynamicPartitioner>(1);
+}
+
+TEST_CASE("CopyIf.DynamicPartitioner.2threads" * doctest::timeout(300)) {
+  test_copy_if<rigel::DynamicPartitioner>(2);
+}
+
+TEST_CASE("CopyIf.DynamicPartitioner.3threads" * doctest::timeout(300)) {
+  test_copy_if<rigel::DynamicPartitioner>(3);
+}
+
+TEST_CASE("CopyIf.DynamicPartitioner.4threads" * doctest::timeout(300)) {
+  test_copy_if<rigel::DynamicPartitioner>(4);
+}
+
+TEST_CASE("CopyIf.DynamicPartitioner.8threads" * doctest::timeout(300)) {
+  test_copy_if<rigel::DynamicPartitioner>(8);
+}
+
+// random partitioner
+TEST_CASE("CopyIf.RandomPartitioner.1thread" * doctest::timeout(300)) {
+  test_copy_if<rigel::RandomPartitioner>(1);
+}
+
+TEST_CASE("CopyIf.RandomPartitioner.2threads" * doctest::timeout(300)) {
+  test_copy_if<rigel::RandomPartitioner>(2);
+}
+
+TEST_CASE("CopyIf.RandomPartitioner.3threads" * doctest::timeout(300)) {
+  test_copy_if<rigel::RandomPartitioner>(3);
+}
+
+TEST_CASE("CopyIf.RandomPartitioner.4threads" * doctest::timeout(300)) {
+  test_copy_if<rigel::RandomPartitioner>(4);
+}
+
+TEST_CASE("CopyIf.RandomPartitioner.8threads" * doctest::timeout(300)) {
+  test_copy_if<rigel::RandomPartitioner>(8);
+}
+
+// affinity
+TEST_CASE("CopyIf.AffinityPartitioner.1thread" * doctest::timeout(300)) {
+  test_copy_if<rigel::AffinityPartitioner>(1);
+}
+
+TEST_CASE("CopyIf.AffinityPartitioner.2threads" * doctest::timeout(300)) {
+  test_copy_if<rigel::AffinityPartitioner>(2);
+}
+
+TEST_CASE("CopyIf.AffinityPartitioner.3threads" * doctest::timeout(300)) {
+  test_copy_if<rigel::AffinityPartitioner>(3);
+}
+
+TEST_CASE("CopyIf.AffinityPartitioner.4threads" * doctest::timeout(300)) {
+  test_copy_if<rigel::AffinityPartitioner>(4);
+}
+
+TEST_CASE("CopyIf.AffinityPartitioner.8threads" * doctest::timeout(300)) {
+  test_copy_if<rigel::AffinityPartitioner>(8);
+}
+
+TEST_CASE("CopyIf.AdaptivePartitioner.1thread" * doctest::timeout(300)) {
+  test_copy_if<rigel::AdaptivePartitioner>(1);
+}
+
+TEST_CASE("CopyIf.AdaptivePartitioner.2threads" * doctest::timeout(300)) {
+  test_copy_if<rigel::AdaptivePartitioner>(2);
+}
+
+TEST_CASE("CopyIf.AdaptivePartitioner.3threads" * doctest::timeout(300)) {
+  test_copy_if<rigel::AdaptivePartitioner>(3);
+}
+
+TEST_CASE("CopyIf.AdaptivePartitioner.4threads" * doctest::timeout(300)) {
+  test_copy_if<rigel::AdaptivePartitioner>(4);
+}
+
+TEST_CASE("CopyIf.AdaptivePartitioner.8threads" * doctest::timeout(300)) {
+  test_copy_if<rigel::AdaptivePartitioner>(8);
+}
+
+// ----------------------------------------------------------------------------
+// remove_if
+// ----------------------------------------------------------------------------
+
+template <typename P>
+void test_remove_if(unsigned W) {
+
+  rigel::Executor executor(W);
+  rigel::Taskflow taskflow;
+  std::vector<std::string> input, golden;
+
+  for(size_t n = 0; n <= 150000; n <= 16 ? n++ : n=2*n+1) {
+    for(size_t c : {0, 1, 3}) {
+      for(int s : {0, 10, 50, 100}) {
+
+        taskflow.clear();
+
+        input.resize(n);
+
+        for(auto& i : input) {
+          i = std::to_string(::rand() % 100);
+        }
+
+        golden = input;
+
+        auto pred = [s] (const std::string& i) { return std::stoi(i) < s; };
+
+        golden.erase(std::remove_if(golden.begin(), golden.end(), pred), golden.end());
+
+        std::vector<std::string>::iterator result;
+
+        taskflow.remove_if(input.begin(), input.end(), result, pred, P(c));
+
+        executor.run(taskflow).wait();
+
+        input.erase(result, input.end());
+
+        REQUIRE(input == golden);
+      }
+    }
+  }
+}
+
+// static partitioner
+TEST_CASE("RemoveIf.StaticPartitioner.1thread" * doctest::timeout(300)) {
+  test_remove_if<rigel::StaticPartitioner>(1);
+}
+
+TEST_CASE("RemoveIf.StaticPartitioner.2threads" * doctest::timeout(300)) {
+  test_remove_if<rigel::StaticPartitioner>(2);
+}
+
+TEST_CASE("RemoveIf.StaticPartitioner.3threads" * doctest::timeout(300)) {
+  test_remove_if<rigel::StaticPartitioner>(3);
+}
+
+TEST_CASE("RemoveIf.StaticPartitioner.4threads" * doctest::timeout(300)) {
+  test_remove_if<rigel::StaticPartitioner>(4);
+}
+
+TEST_CASE("RemoveIf.StaticPartitioner.8threads" * doctest::timeout(300)) {
+  test_remove_if<rigel::StaticPartitioner>(8);
+}
+
+// guided partitioner
+TEST_CASE("RemoveIf.GuidedPartitioner.1thread" * doctest::timeout(300)) {
+  test_remove_if<rigel::GuidedPartitioner>(1);
+}
+
+TEST_CASE("RemoveIf.GuidedPartitioner.2threads" * doctest::timeout(300)) {
+  test_remove_if<rigel::GuidedPartitioner>(2);
+}
+
+TEST_CASE("RemoveIf.GuidedPartitioner.3threads" * doctest::timeout(300)) {
+  test_remove_if<rigel::GuidedPartitioner>(3);
+}
+
+TEST_CASE("RemoveIf.GuidedPartitioner.4threads" * doctest::timeout(300)) {
+  test_remove_if<rigel::GuidedPartitioner>(4);
+}
+
+TEST_CASE("RemoveIf.GuidedPartitioner.8threads" * doctest::timeout(300)) {
+  test_remove_if<rigel::GuidedPartitioner>(8);
+}
+
+// dynamic partitioner
+TEST_CASE("RemoveIf.DynamicPartitioner.1thread" * doctest::timeout(300)) {
+  test_remove_if<rigel::DynamicPartitioner>(1);
+}
+
+TEST_CASE("RemoveIf.DynamicPartitioner.2threads" * doctest::timeout(300)) {
+  test_remove_if<rigel::DynamicPartitioner>(2);
+}
+
+TEST_CASE("RemoveIf.DynamicPartitioner.3threads" * doctest::timeout(300)) {
+  test_remove_if<rigel::DynamicPartitioner>(3);
+}
+
+TEST_CASE("RemoveIf.DynamicPartitioner.4threads" * doctest::timeout(300)) {
+  test_remove_if<rigel::DynamicPartitioner>(4);
+}
+
+TEST_CASE("RemoveIf.DynamicPartitioner.8threads" * doctest::timeout(300)) {
+  test_remove_if<rigel::DynamicPartitioner>(8);
+}
+
+// random partitioner
+TEST_CASE("RemoveIf.RandomPartitioner.1thread" * doctest::timeout(300)) {
+  test_remove_if<rigel::RandomPartitioner>(1);
+}
+
+TEST_CASE("RemoveIf.RandomPartitioner.2threads" * doctest::timeout(300)) {
+  test_remove_if<rigel::RandomPartitioner>(2);
+}
+
+TEST_CASE("RemoveIf.RandomPartitioner.3threads" * doctest::timeout(300)) {
+  test_remove_if<rigel::RandomPartitioner>(3);
+}
+
+TEST_CASE("RemoveIf.RandomPartitioner.4threads" * doctest::timeout(300)) {
+  test_remove_if<rigel::RandomPartitioner>(4);
+}
+
+TEST_CASE("RemoveIf.RandomPartitioner.8threads" * doctest::timeout(300)) {
+  test_remove_if<rigel::RandomPartitioner>(8);
+}
+
+// affinity
+TEST_CASE("RemoveIf.AffinityPartitioner.1thread" * doctest::timeout(300)) {
+  test_remove_if<rigel::AffinityPartitioner>(1);
+}
+
+TEST_CASE("RemoveIf.AffinityPartitioner.2threads" * doctest::timeout(300)) {
+  test_remove_if<rigel::AffinityPartitioner>(2);
+}
+
+TEST_CASE("RemoveIf.AffinityPartitioner.3threads" * doctest::timeout(300)) {
+  test_remove_if<rigel::AffinityPartitioner>(3);
+}
+
+TEST_CASE("RemoveIf.AffinityPartitioner.4threads" * doctest::timeout(300)) {
+  test_remove_if<rigel::AffinityPartitioner>(4);
+}
+
+TEST_CASE("RemoveIf.AffinityPartitioner.8threads" * doctest::timeout(300)) {
+  test_remove_if<rigel::AffinityPartitioner>(8);
+}
+
+TEST_CASE("RemoveIf.AdaptivePartitioner.1thread" * doctest::timeout(300)) {
+  test_remove_if<rigel::AdaptivePartitioner>(1);
+}
+
+TEST_CASE("RemoveIf.AdaptivePartitioner.2threads" * doctest::timeout(300)) {
+  test_remove_if<rigel::AdaptivePartitioner>(2);
+}
+
+TEST_CASE("RemoveIf.AdaptivePartitioner.3threads" * doctest::timeout(300)) {
+  test_remove_if<rigel::AdaptivePartitioner>(3);
+}
+
+TEST_CASE("RemoveIf.AdaptivePartitioner.4threads" * doctest::timeout(300)) {
+  test_remove_if<rigel::AdaptivePartitioner>(4);
+}
+
+TEST_CASE("RemoveIf.AdaptivePartitioner.8threads" * doctest::timeout(300)) {
+  test_remove_if<rigel::AdaptivePartitioner>(8);
+}
+
+// ----------------------------------------------------------------------------
+// stable_partition
+// ----------------------------------------------------------------------------
+
+template <typename P>
+void test_stable_partition(unsigned W) {
+
+  rigel::Executor executor(W);
+  rigel::Taskflow taskflow;
+  std::vector<int> input, golden;
+
+  for(size_t n = 0; n <= 150000; n <= 16 ? n++ : n=2*n+1) {
+    for(size_t c : {0, 1, 3}) {
+      for(int s : {0, 10, 50, 100}) {
+
+        taskflow.clear();
+
+        input.resize(n);
+
+        for(auto& i : input) {
+          i = ::rand() % 100;
+        }
+
+        golden = input;
+
+        auto pred = [s] (int i) { return i < s; };
+
+        auto gmid = std::stable_partition(golden.begin(), golden.end(), pred);
+
+        std::vector<int>::iterator result1, result2;
+        std::vector<int> input2 = input;
+
+        taskflow.stable_partition(input.begin(), input.end(), result1, pred, P(c));
+        taskflow.partition(input2.begin(), input2.end(), result2, pred, P(c));
+
+        executor.run(taskflow).wait();
+
+        REQUIRE(result1 - input.begin() == gmid - golden.begin());
+        REQUIRE(result2 - input2.begin() == gmid - golden.begin());
+        REQUIRE(input == golden);
+        REQUIRE(input2 == golden);
+      }
+    }
+  }
+}
+
+// static partitioner
+TEST_CASE("StablePartition.StaticPartitioner.1thread" * doctest::timeout(300)) {
+  test_stable_partition<rigel::StaticPartitioner>(1);
+}
+
+TEST_CASE("StablePartition.StaticPartitioner.2threads" * doctest::timeout(300)) {
+  test_stable_partition<rigel::StaticPartitioner>(2);
+}
+
+TEST_CASE("StablePartition.StaticPartitioner.3threads" * doctest::timeout(300)) {
+  test_stable_partition<rigel::StaticPartitioner>(3);
+}
+
+TEST_CASE("StablePartition.StaticPartitioner.4threads" * doctest::timeout(300)) {
+  test_stable_partition<rigel::StaticPartitioner>(4);
+}
+
+TEST_CASE("StablePartition.StaticPartitioner.8threads" * doctest::timeout(300)) {
+  test_stable_partition<rigel::StaticPartitioner>(8);
+}
+
+// guided partitioner
+TEST_CASE("StablePartition.GuidedPartitioner.1thread" * doctest::timeout(300)) {
+  test_stable_partition<rigel::GuidedPartitioner>(1);
+}
+
+TEST_CASE("StablePartition.GuidedPartitioner.2threads" * doctest::timeout(300)) {
+  test_stable_partition<rigel::GuidedPartitioner>(2);
+}
+
+TEST_CASE("StablePartition.GuidedPartitioner.3threads" * doctest::timeout(300)) {
+  test_stable_partition<rigel::GuidedPartitioner>(3);
+}
+
+TEST_CASE("StablePartition.GuidedPartitioner.4threads" * doctest::timeout(300)) {
+  test_stable_partition<rigel::GuidedPartitioner>(4);
+}
+
+TEST_CASE("StablePartition.GuidedPartitioner.8threads" * doctest::timeout(300)) {
+  test_stable_partition<rigel::GuidedPartitioner>(8);
+}
+
+// dynamic partitioner
+TEST_CASE("StablePartition.DynamicPartitioner.1thread" * doctest::timeout(300)) {
+  test_stable_partition<rigel::DynamicPartitioner>(1);
+}
+
+TEST_CASE("StablePartition.DynamicPartitioner.2threads" * doctest::timeout(300)) {
+  test_stable_partition<rigel::DynamicPartitioner>(2);
+}
+
+TEST_CASE("StablePartition.DynamicPartitioner.3threads" * doctest::timeout(300)) {
+  test_stable_partition<rigel::DynamicPartitioner>(3);
+}
+
+TEST_CASE("StablePartition.DynamicPartitioner.4threads" * doctest::timeout(300)) {
+  test_stable_partition<rigel::DynamicPartitioner>(4);
+}
+
+TEST_CASE("StablePartition.DynamicPartitioner.8threads" * doctest::timeout(300)) {
+  test_stable_partition<rigel::DynamicPartitioner>(8);
+}
+
+// random partitioner
+TEST_CASE("StablePartition.RandomPartitioner.1thread" * doctest::timeout(300)) {
+  test_stable_partition<rigel::RandomPartitioner>(1);
+}
+
+TEST_CASE("StablePartition.RandomPartitioner.2threads" * doctest::timeout(300)) {
+  test_stable_partition<rigel::RandomPartitioner>(2);
+}
+
+TEST_CASE("StablePartition.RandomPartitioner.3threads" * doctest::timeout(300)) {
+  test_stable_partition<rigel::RandomPartitioner>(3);
+}
+
+TEST_CASE("StablePartition.RandomPartitioner.4threads" * doctest::timeout(300)) {
+  test_stable_partition<rigel::RandomPartitioner>(4);
+}
+
+TEST_CASE("StablePartition.RandomPartitioner.8threads" * doctest::timeout(300)) {
+  test_stable_partition<rigel::RandomPartitioner>(8);
+}
+
+// affinity
+TEST_CASE("StablePartition.AffinityPartitioner.1thread" * doctest::timeout(300)) {
+  test_stable_partition<rigel::AffinityPartitioner>(1);
+}
+
+TEST_CASE("StablePartition.AffinityPartitioner.2threads" * doctest::timeout(300)) {
+  test_stable_partition<rigel::AffinityPartitioner>(2);
+}
+
+TEST_CASE("StablePartition.AffinityPartitioner.3threads" * doctest::timeout(300)) {
+  test_stable_partition<rigel::AffinityPartitioner>(3);
+}
+
+TEST_CASE("StablePartition.AffinityPartitioner.4threads" * doctest::timeout(300)) {
+  test_stable_partition<rigel::AffinityPartitioner>(4);
+}
+
+TEST_CASE("StablePartition.AffinityPartitioner.8threads" * doctest::timeout(300)) {
+  test_stable_partition<rigel::AffinityPartitioner>(8);
+}
+
+TEST_CASE("StablePartition.AdaptivePartitioner.1thread" * doctest::timeout(300)) {
+  test_stable_partition<rigel::AdaptivePartitioner>(1);
+}
+
+TEST_CASE("StablePartition.AdaptivePartitioner.2threads" * doctest::timeout(300)) {
+  test_stable_partition<rigel::AdaptivePartitioner>(2);
+}
+
+TEST_CASE("StablePartition.AdaptivePartitioner.3threads" * doctest::timeout(300)) {
+  test_stable_partition<rigel::AdaptivePartitioner>(3);
+}
+
+TEST_CASE("StablePartition.AdaptivePartitioner.4threads" * doctest::timeout(300)) {
+  test_stable_partition<rigel::AdaptivePartitioner>(4);
+}
+
+TEST_CASE("StablePartition.AdaptivePartitioner.8threads" * doctest::timeout(300)) {
+  test_stable_partition<rigel::AdaptivePartitioner>(8);
+}
+
+// ----------------------------------------------------------------------------
+// unique
+// ----------------------------------------------------------------------------
+
+template <typename P>
+void test_unique(unsigned W) {
+
+  rigel::Executor executor(W);
+  rigel::Taskflow taskflow;
+  std::vector<int> input, golden;
+
+  for(size_t n = 0; n <= 150000; n <= 16 ? n++ : n=2*n+1) {
+    for(size_t c : {0, 1, 3}) {
+      for(int r : {1, 2, 1000}) {
+
+        taskflow.clear();
+
+        input.resize(n);
+
+        for(auto& i : input) {
+          i = ::rand() % r;
+        }
+
+        golden = input;
+        golden.erase(std::unique(golden.begin(), golden.end()), golden.end());
+
+        std::vector<int>::iterator result;
+
+        taskflow.unique(input.begin(), input.end(), result, std::equal_to<int>(), P(c));
+
+        executor.run(taskflow).wait();
+
+        input.erase(result, input.end());
+
+        REQUIRE(input == golden);
+      }
+    }
+  }
+}
+
+// static partitioner
+TEST_CASE("Unique.StaticPartitioner.1thread" * doctest::timeout(300)) {
+  test_unique<rigel::StaticPartitioner>(1);
+}
+
+TEST_CASE("Unique.StaticPartitioner.2threads" * doctest::timeout(300)) {
+  test_unique<rigel::StaticPartitioner>(2);
+}
+
+TEST_CASE("Unique.StaticPartitioner.3threads" * doctest::timeout(300)) {
+  test_unique<rigel::StaticPartitioner>(3);
+}
+
+TEST_CASE("Unique.StaticPartitioner.4threads" * doctest::timeout(300)) {
+  test_unique<rigel::StaticPartitioner>(4);
+}
+
+TEST_CASE("Unique.StaticPartitioner.8threads" * doctest::timeout(300)) {
+  test_unique<rigel::StaticPartitioner>(8);
+}
+
+// guided partitioner
+TEST_CASE("Unique.GuidedPartitioner.1thread" * doctest::timeout(300)) {
+  test_unique<rigel::GuidedPartitioner>(1);
+}
+
+TEST_CASE("Unique.GuidedPartitioner.2threads" * doctest::timeout(300)) {
+  test_unique<rigel::GuidedPartitioner>(2);
+}
+
+TEST_CASE("Unique.GuidedPartitioner.3threads" * doctest::timeout(300)) {
+  test_unique<rigel::GuidedPartitioner>(3);
+}
+
+TEST_CASE("Unique.GuidedPartitioner.4threads" * doctest::timeout(300)) {
+  test_unique<rigel::GuidedPartitioner>(4);
+}
+
+TEST_CASE("Unique.GuidedPartitioner.8threads" * doctest::timeout(300)) {
+  test_unique<rigel::GuidedPartitioner>(8);
+}
+
+// dynamic partitioner
+TEST_CASE("Unique.DynamicPartitioner.1thread" * doctest::timeout(300)) {
+  test_unique<rigel::DynamicPartitioner>(1);
+}
+
+TEST_CASE("Unique.DynamicPartitioner.2threads" * doctest::timeout(300)) {
+  test_unique<rigel::DynamicPartitioner>(2);
+}
+
+TEST_CASE("Unique.DynamicPartitioner.3threads" * doctest::timeout(300)) {
+  test_unique<rigel::DynamicPartitioner>(3);
+}
+
+TEST_CASE("Unique.DynamicPartitioner.4threads" * doctest::timeout(300)) {
+  test_unique<rigel::DynamicPartitioner>(4);
+}
+
+TEST_CASE("Unique.DynamicPartitioner.8threads" * doctest::timeout(300)) {
+  test_unique<rigel::DynamicPartitioner>(8);
+}
+
+// random partitioner
+TEST_CASE("Unique.RandomPartitioner.1thread" * doctest::timeout(300)) {
+  test_unique<rigel::RandomPartitioner>(1);
+}
+
+TEST_CASE("Unique.RandomPartitioner.2threads" * doctest::timeout(300)) {
+  test_unique<rigel::RandomPartitioner>(2);
+}
+
+TEST_CASE("Unique.RandomPartitioner.3threads" * doctest::timeout(300)) {
+  test_unique<rigel::RandomPartitioner>(3);
+}
+
+TEST_CASE("Unique.RandomPartitioner.4threads" * doctest::timeout(300)) {
+  test_unique<rigel::RandomPartitioner>(4);
+}
+
+TEST_CASE("Unique.RandomPartitioner.8threads" * doctest::timeout(300)) {
+  test_unique<rigel::RandomPartitioner>(8);
+}
+
+// affinity
+TEST_CASE("Unique.AffinityPartitioner.1thread" * doctest::timeout(300)) {
+  test_unique<rigel::AffinityPartitioner>(1);
+}
+
+TEST_CASE("Unique.AffinityPartitioner.2threads" * doctest::timeout(300)) {
+  test_unique<rigel::AffinityPartitioner>(2);
+}
+
+TEST_CASE("Unique.AffinityPartitioner.3threads" * doctest::timeout(300)) {
+  test_unique<rigel::AffinityPartitioner>(3);
+}
+
+TEST_CASE("Unique.AffinityPartitioner.4threads" * doctest::timeout(300)) {
+  test_unique<rigel::AffinityPartitioner>(4);
+}
+
+TEST_CASE("Unique.AffinityPartitioner.8threads" * doctest::timeout(300)) {
+  test_unique<rigel::AffinityPartitioner>(8);
+}
+
+TEST_CASE("Unique.AdaptivePartitioner.1thread" * doctest::timeout(300)) {
+  test_unique<rigel::AdaptivePartitioner>(1);
+}
+
+TEST_CASE("Unique.AdaptivePartitioner.2threads" * doctest::timeout(300)) {
+  test_unique<rigel::AdaptivePartitioner>(2);
+}
+
+TEST_CASE("Unique.AdaptivePartitioner.3threads" * doctest::timeout(300)) {
+  test_unique<rigel::AdaptivePartitioner>(3);
+}
+
+TEST_CASE("Unique.AdaptivePartitioner.4threads" * doctest::timeout(300)) {
+  test_unique<rigel::AdaptivePartitioner>(4);
+}
+
+TEST_CASE("Unique.AdaptivePartitioner.8threads" * doctest::timeout(300)) {
+  test_unique<rigel::AdaptivePartitioner>(8);
+}
+
+// ----------------------------------------------------------------------------
+// value types without a default constructor
+// ----------------------------------------------------------------------------
+
+struct NoDefault {
+
+  static std::atomic<int> alive;
+
+  explicit NoDefault(int v) : value {v} { alive++; }
+  NoDefault(const NoDefault& rhs) : value {rhs.value} { alive++; }
+  NoDefault(NoDefault&& rhs) : value {rhs.value} { alive++; }
+  NoDefault& operator = (const NoDefault&) = default;
+  NoDefault& operator = (NoDefault&&) = default;
+  ~NoDefault() { alive--; }
+
+  int value;
+};
+
+std::atomic<int> NoDefault::alive {0};
+
+void test_no_default(unsigned W) {
+
+  rigel::Executor executor(W);
+
+  const size_t N = 100000;
+
+  std::vector<NoDefault> input, golden;
+  for(size_t i=0; i<N; i++) {
+    input.emplace_back(::rand() % 10);
+  }
+
+  auto odd = [](const NoDefault& x) { return x.value % 2; };
+  auto equal = [](const NoDefault& a, const NoDefault& b) { return a.value == b.value; };
+  auto values = [](auto beg, auto end) {
+    std::vector<int> v;
+    for(; beg != end; ++beg) {
+      v.push_back(beg->value);
+    }
+    return v;
+  };
+
+  std::vector<NoDefault>::iterator result;
+  std::vector<NoDefault> data;
+
+  // remove_if
+  data = input;
+  golden = input;
+  auto gend = std::remove_if(golden.begin(), golden.end(), odd);
+  rigel::Taskflow remove_if;
+  remove_if.remove_if(data.begin(), data.end(), result, odd);
+  executor.run(remove_if).wait();
+  REQUIRE(values(data.begin(), result) == values(golden.begin(), gend));
+
+  // stable_partition
+  data = input;
+  golden = input;
+  gend = std::stable_partition(golden.begin(), golden.end(), odd);
+  rigel::Taskflow stable_partition;
+  stable_partition.stable_partition(data.begin(), data.end(), result, odd);
+  executor.run(stable_partition).wait();
+  REQUIRE(result - data.begin() == gend - golden.begin());
+  REQUIRE(values(data.begin(), data.end()) == values(golden.begin(), golden.end()));
+
+  // unique
+  data = input;
+  golden = input;
+  gend = std::unique(golden.begin(), golden.end(), equal);
+  rigel::Taskflow unique;
+  unique.unique(data.begin(), data.end(), result, equal);
+  executor.run(unique).wait();
+  REQUIRE(values(data.begin(), result) == values(golden.begin(), gend));
+
+  // the buffers destroyed every element they held
+  data.clear();
+  golden.clear();
+  REQUIRE(NoDefault::alive == static_cast<int>(input.size()));
+}
+
+TEST_CASE("Compact.NoDefaultConstructor.1thread" * doctest::timeout(300)) {
+  test_no_default(1);
+}
+
+TEST_CASE("Compact.NoDefaultConstructor.2threads" * doctest::timeout(300)) {
+  test_no_default(2);
+}
+
+TEST_CASE("Compact.NoDefaultConstructor.4threads" * doctest::timeout(300)) {
+  test_no_default(4);
+}
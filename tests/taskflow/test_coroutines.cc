@@ -0,0 +1,397 @@
+// Copyright 2023 The titan-search Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include "tests/doctest.h"
+#include "rigel/taskflow/taskflow.h"
+
+// --------------------------------------------------------
+// Testcase: Coroutine.AsyncAwait
+// --------------------------------------------------------
+
+void coroutine_async_await(unsigned W) {
+
+  rigel::Executor executor(W);
+  rigel::Taskflow taskflow;
+
+  const int N = 64;
+  const int M = 16;
+
+  std::atomic<int> sum {0};
+  std::atomic<int> finished {0};
+  std::atomic<int> runs {0};
+
+  auto check = taskflow.emplace([&](){
+    REQUIRE(finished == N);
+    REQUIRE(sum == N*M*(M-1)/2);
+    finished = 0;
+    sum = 0;
+    runs++;
+  });
+
+  for(int i=0; i<N; i++) {
+    auto task = taskflow.emplace([&]() -> rigel::Coro {
+      for(int j=0; j<M; j++) {
+        sum.fetch_add(co_await executor.async([j](){ return j; }));
+      }
+      co_await executor.async([](){});
+      finished.fetch_add(1);
+    });
+    REQUIRE(task.type() == rigel::TaskType::COROUTINE);
+    task.precede(check);
+  }
+
+  for(int r=1; r<=3; r++) {
+    executor.run(taskflow).wait();
+    REQUIRE(runs == r);
+  }
+
+  executor.run_n(taskflow, 4).wait();
+  REQUIRE(runs == 7);
+}
+
+TEST_CASE("Coroutine.AsyncAwait.1thread" * doctest::timeout(300)) {
+  coroutine_async_await(1);
+}
+
+TEST_CASE("Coroutine.AsyncAwait.2threads" * doctest::timeout(300)) {
+  coroutine_async_await(2);
+}
+
+TEST_CASE("Coroutine.AsyncAwait.4threads" * doctest::timeout(300)) {
+  coroutine_async_await(4);
+}
+
+TEST_CASE("Coroutine.AsyncAwait.8threads" * doctest::timeout(300)) {
+  coroutine_async_await(8);
+}
+
+// --------------------------------------------------------
+// Testcase: Coroutine.OtherExecutor
+// --------------------------------------------------------
+
+void coroutine_other_executor(unsigned W) {
+
+  rigel::Executor executor(W);
+  rigel::Executor other(2);
+  rigel::Taskflow taskflow;
+
+  std::atomic<int> counter {0};
+
+  for(int i=0; i<16; i++) {
+    taskflow.emplace([&]() -> rigel::Coro {
+      for(int j=0; j<8; j++) {
+        // the coroutine resumes on its own executor
+        auto id = co_await other.async([&](){ return other.this_worker_id(); });
+        REQUIRE(id != -1);
+        REQUIRE(executor.this_worker_id() != -1);
+        counter.fetch_add(1);
+      }
+    });
+  }
+
+  executor.run(taskflow).wait();
+  REQUIRE(counter == 16*8);
+}
+
+TEST_CASE("Coroutine.OtherExecutor.1thread" * doctest::timeout(300)) {
+  coroutine_other_executor(1);
+}
+
+TEST_CASE("Coroutine.OtherExecutor.4threads" * doctest::timeout(300)) {
+  coroutine_other_executor(4);
+}
+
+// --------------------------------------------------------
+// Testcase: Coroutine.Yield
+// --------------------------------------------------------
+
+void coroutine_yield(unsigned W) {
+
+  rigel::Executor executor(W);
+  rigel::Taskflow taskflow;
+
+  std::atomic<int> counter {0};
+
+  auto [A, B, C] = taskflow.emplace(
+    [&]() -> rigel::Coro {
+      for(int i=0; i<100; i++) {
+        counter.fetch_add(1);
+        co_await std::suspend_always{};
+      }
+    },
+    [&](){ REQUIRE(counter == 100); counter.fetch_add(1); },
+    [&]() -> rigel::Coro {
+      REQUIRE(counter == 101);
+      co_return;
+    }
+  );
+
+  A.precede(B);
+  B.precede(C);
+
+  executor.run(taskflow).wait();
+  REQUIRE(counter == 101);
+}
+
+TEST_CASE("Coroutine.Yield.1thread" * doctest::timeout(300)) {
+  coroutine_yield(1);
+}
+
+TEST_CASE("Coroutine.Yield.2threads" * doctest::timeout(300)) {
+  coroutine_yield(2);
+}
+
+TEST_CASE("Coroutine.Yield.4threads" * doctest::timeout(300)) {
+  coroutine_yield(4);
+}
+
+// --------------------------------------------------------
+// Testcase: Coroutine.Subflow
+// --------------------------------------------------------
+
+void coroutine_subflow(unsigned W) {
+
+  rigel::Executor executor(W);
+  rigel::Taskflow taskflow;
+
+  std::atomic<int> counter {0};
+
+  taskflow.emplace([&](rigel::Subflow& sf){
+    for(int i=0; i<32; i++) {
+      sf.emplace([&]() -> rigel::Coro {
+        auto value = co_await executor.async([](){ return 2; });
+        counter.fetch_add(value);
+      });
+    }
+    sf.join();
+    REQUIRE(counter == 64);
+  });
+
+  executor.run(taskflow).wait();
+  REQUIRE(counter == 64);
+}
+
+TEST_CASE("Coroutine.Subflow.1thread" * doctest::timeout(300)) {
+  coroutine_subflow(1);
+}
+
+TEST_CASE("Coroutine.Subflow.2threads" * doctest::timeout(300)) {
+  coroutine_subflow(2);
+}
+
+TEST_CASE("Coroutine.Subflow.4threads" * doctest::timeout(300)) {
+  coroutine_subflow(4);
+}
+
+// --------------------------------------------------------
+// Testcase: Coroutine.Cancel
+// --------------------------------------------------------
+
+void coroutine_cancel(unsigned W) {
+
+  rigel::Executor executor(W);
+  rigel::Taskflow taskflow;
+
+  std::atomic<bool> started {false};
+  std::atomic<bool> release {false};
+  std::atomic<int> resumed {0};
+
+  auto A = taskflow.emplace([&]() -> rigel::Coro {
+    co_await executor.async([&](){
+      started = true;
+      while(!release) {
+        std::this_thread::yield();
+      }
+    });
+    resumed.fetch_add(1);
+  });
+
+  auto B = taskflow.emplace([&](){ resumed.fetch_add(1); });
+
+  A.precede(B);
+
+  for(int r=0; r<10; r++) {
+
+    started = false;
+    release = false;
+
+    auto fu = executor.run(taskflow);
+
+    // the coroutine is suspended or about to suspend on the async task
+    while(!started) {
+      std::this_thread::yield();
+    }
+
+    fu.cancel();
+    release = true;
+    fu.get();
+
+    REQUIRE(resumed == 0);
+  }
+
+  executor.wait_for_all();
+}
+
+TEST_CASE("Coroutine.Cancel.1thread" * doctest::timeout(300)) {
+  coroutine_cancel(1);
+}
+
+TEST_CASE("Coroutine.Cancel.2threads" * doctest::timeout(300)) {
+  coroutine_cancel(2);
+}
+
+TEST_CASE("Coroutine.Cancel.4threads" * doctest::timeout(300)) {
+  coroutine_cancel(4);
+}
+
+// --------------------------------------------------------
+// Testcase: Coroutine.Exception
+// --------------------------------------------------------
+
+void coroutine_exception(unsigned W) {
+
+  rigel::Executor executor(W);
+  rigel::Taskflow taskflow;
+
+  std::atomic<int> after {0};
+
+  auto A = taskflow.emplace([&]() -> rigel::Coro {
+    co_await executor.async([](){ return 1; });
+    throw std::runtime_error("coroutine");
+  });
+
+  auto B = taskflow.emplace([&](){ after.fetch_add(1); });
+
+  A.precede(B);
+
+  // the exception reaches the future of the run and cancels the successors
+  for(int r=0; r<10; r++) {
+    auto fu = executor.run(taskflow);
+    REQUIRE_THROWS_WITH_AS(fu.get(), "coroutine", std::runtime_error);
+  }
+
+  REQUIRE(after == 0);
+
+  // a throwing run stops repeated runs at once
+  REQUIRE_THROWS_AS(executor.run_n(taskflow, 100).get(), std::runtime_error);
+  REQUIRE(after == 0);
+
+  // the workers survive and keep running other work
+  rigel::Taskflow other;
+  std::atomic<int> counter {0};
+  for(int i=0; i<100; i++) {
+    other.emplace([&](){ counter.fetch_add(1); });
+  }
+  executor.run(other).wait();
+  executor.wait_for_all();
+
+  REQUIRE(counter == 100);
+}
+
+TEST_CASE("Coroutine.Exception.1thread" * doctest::timeout(300)) {
+  coroutine_exception(1);
+}
+
+TEST_CASE("Coroutine.Exception.2threads" * doctest::timeout(300)) {
+  coroutine_exception(2);
+}
+
+TEST_CASE("Coroutine.Exception.4threads" * doctest::timeout(300)) {
+  coroutine_exception(4);
+}
+
+// --------------------------------------------------------
+// Testcase: Coroutine.AsyncFuture
+// --------------------------------------------------------
+
+TEST_CASE("Coroutine.AsyncFuture" * doctest::timeout(300)) {
+
+  rigel::Executor executor(2);
+
+  // usable as a std::future
+  std::future<int> fu1 = executor.async([](){ return 1; });
+  REQUIRE(fu1.get() == 1);
+
+  auto fu2 = executor.async([](){ return 2; });
+  auto fu3 = std::move(fu2);
+  REQUIRE(fu3.get() == 2);
+
+  // dropped before the task finishes
+  for(int i=0; i<1000; i++) {
+    executor.async([i](){ return i; });
+  }
+  executor.wait_for_all();
+
+  // awaited after the task has finished
+  rigel::Taskflow taskflow;
+  taskflow.emplace([&]() -> rigel::Coro {
+    auto fu = executor.async([](){ return 3; });
+    while(fu.wait_for(std::chrono::seconds(0)) != std::future_status::ready);
+    REQUIRE(co_await std::move(fu) == 3);
+  });
+  executor.run(taskflow).wait();
+}
+
+#ifdef TF_HAS_ASYNC_IO
+// --------------------------------------------------------
+// Testcase: Coroutine.AsyncIO
+// --------------------------------------------------------
+
+void coroutine_async_io(unsigned W) {
+
+  rigel::Executor executor(W);
+  rigel::Taskflow taskflow;
+
+  int fds[2];
+  REQUIRE(::pipe(fds) == 0);
+
+  const int N = 64;
+
+  int value = -1;
+  std::atomic<int> received {0};
+
+  // the reader suspends on each read until the writer gets to it
+  taskflow.emplace([&]() -> rigel::Coro {
+    for(int i=0; i<N; i++) {
+      if(co_await executor.async_read(fds[0], &value, sizeof(value)) == sizeof(value) &&
+         value == i) {
+        received.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+  });
+
+  taskflow.emplace([&]() -> rigel::Coro {
+    for(int i=0; i<N; i++) {
+      co_await executor.async_write(fds[1], &i, sizeof(i));
+    }
+  });
+
+  executor.run(taskflow).wait();
+
+  REQUIRE(received == N);
+
+  ::close(fds[0]);
+  ::close(fds[1]);
+}
+
+TEST_CASE("Coroutine.AsyncIO.1thread" * doctest::timeout(300)) {
+  coroutine_async_io(1);
+}
+
+TEST_CASE("Coroutine.AsyncIO.4threads" * doctest::timeout(300)) {
+  coroutine_async_io(4);
+}
+#endif
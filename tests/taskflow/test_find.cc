@@ -166,6 +166,27 @@ TEST_CASE("find_if.DynamicPartitioner.8threads" * doctest::timeout(300)) {
   test_find_if<rigel::DynamicPartitioner>(8);
 }
 
+// affinity
+TEST_CASE("find_if.AffinityPartitioner.1thread" * doctest::timeout(300)) {
+  test_find_if<rigel::AffinityPartitioner>(1);
+}
+
+TEST_CASE("find_if.AffinityPartitioner.2threads" * doctest::timeout(300)) {
+  test_find_if<rigel::AffinityPartitioner>(2);
+}
+
+TEST_CASE("find_if.AffinityPartitioner.3threads" * doctest::timeout(300)) {
+  test_find_if<rigel::AffinityPartitioner>(3);
+}
+
+TEST_CASE("find_if.AffinityPartitioner.4threads" * doctest::timeout(300)) {
+  test_find_if<rigel::AffinityPartitioner>(4);
+}
+
+TEST_CASE("find_if.AffinityPartitioner.8threads" * doctest::timeout(300)) {
+  test_find_if<rigel::AffinityPartitioner>(8);
+}
+
 // ----------------------------------------------------------------------------
 // find_if_not
 // ----------------------------------------------------------------------------
@@ -321,6 +342,27 @@ TEST_CASE("find_if_not.DynamicPartitioner.8threads" * doctest::timeout(300)) {
   test_find_if_not<rigel::DynamicPartitioner>(8);
 }
 
+// affinity
+TEST_CASE("find_if_not.AffinityPartitioner.1thread" * doctest::timeout(300)) {
+  test_find_if_not<rigel::AffinityPartitioner>(1);
+}
+
+TEST_CASE("find_if_not.AffinityPartitioner.2threads" * doctest::timeout(300)) {
+  test_find_if_not<rigel::AffinityPartitioner>(2);
+}
+
+TEST_CASE("find_if_not.AffinityPartitioner.3threads" * doctest::timeout(300)) {
+  test_find_if_not<rigel::AffinityPartitioner>(3);
+}
+
+TEST_CASE("find_if_not.AffinityPartitioner.4threads" * doctest::timeout(300)) {
+  test_find_if_not<rigel::AffinityPartitioner>(4);
+}
+
+TEST_CASE("find_if_not.AffinityPartitioner.8threads" * doctest::timeout(300)) {
+  test_find_if_not<rigel::AffinityPartitioner>(8);
+}
+
 // ----------------------------------------------------------------------------
 // min_element
 // ----------------------------------------------------------------------------
@@ -480,6 +522,27 @@ TEST_CASE("min_element.DynamicPartitioner.8threads" * doctest::timeout(300)) {
   test_min_element<rigel::DynamicPartitioner>(8);
 }
 
+// affinity
+TEST_CASE("min_element.AffinityPartitioner.1thread" * doctest::timeout(300)) {
+  test_min_element<rigel::AffinityPartitioner>(1);
+}
+
+TEST_CASE("min_element.AffinityPartitioner.2threads" * doctest::timeout(300)) {
+  test_min_element<rigel::AffinityPartitioner>(2);
+}
+
+TEST_CASE("min_element.AffinityPartitioner.3threads" * doctest::timeout(300)) {
+  test_min_element<rigel::AffinityPartitioner>(3);
+}
+
+TEST_CASE("min_element.AffinityPartitioner.4threads" * doctest::timeout(300)) {
+  test_min_element<rigel::AffinityPartitioner>(4);
+}
+
+TEST_CASE("min_element.AffinityPartitioner.8threads" * doctest::timeout(300)) {
+  test_min_element<rigel::AffinityPartitioner>(8);
+}
+
 // ----------------------------------------------------------------------------
 // max_element
 // ----------------------------------------------------------------------------
@@ -639,6 +702,27 @@ TEST_CASE("max_element.DynamicPartitioner.8threads" * doctest::timeout(300)) {
   test_max_element<rigel::DynamicPartitioner>(8);
 }
 
+// affinity
+TEST_CASE("max_element.AffinityPartitioner.1thread" * doctest::timeout(300)) {
+  test_max_element<rigel::AffinityPartitioner>(1);
+}
+
+TEST_CASE("max_element.AffinityPartitioner.2threads" * doctest::timeout(300)) {
+  test_max_element<rigel::AffinityPartitioner>(2);
+}
+
+TEST_CASE("max_element.AffinityPartitioner.3threads" * doctest::timeout(300)) {
+  test_max_element<rigel::AffinityPartitioner>(3);
+}
+
+TEST_CASE("max_element.AffinityPartitioner.4threads" * doctest::timeout(300)) {
+  test_max_element<rigel::AffinityPartitioner>(4);
+}
+
+TEST_CASE("max_element.AffinityPartitioner.8threads" * doctest::timeout(300)) {
+  test_max_element<rigel::AffinityPartitioner>(8);
+}
+
 
 
 
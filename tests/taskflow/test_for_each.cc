@@ -284,6 +284,47 @@ TEST_CASE("ParallelFor.Random.12threads" * doctest::timeout(300)) {
   for_each<rigel::RandomPartitioner>(12);
 }
 
+// affinity
+TEST_CASE("ParallelFor.Affinity.1thread" * doctest::timeout(300)) {
+  for_each<rigel::AffinityPartitioner>(1);
+}
+
+TEST_CASE("ParallelFor.Affinity.2threads" * doctest::timeout(300)) {
+  for_each<rigel::AffinityPartitioner>(2);
+}
+
+TEST_CASE("ParallelFor.Affinity.3threads" * doctest::timeout(300)) {
+  for_each<rigel::AffinityPartitioner>(3);
+}
+
+TEST_CASE("ParallelFor.Affinity.4threads" * doctest::timeout(300)) {
+  for_each<rigel::AffinityPartitioner>(4);
+}
+
+TEST_CASE("ParallelFor.Affinity.8threads" * doctest::timeout(300)) {
+  for_each<rigel::AffinityPartitioner>(8);
+}
+
+TEST_CASE("ParallelFor.Adaptive.1thread" * doctest::timeout(300)) {
+  for_each<rigel::AdaptivePartitioner>(1);
+}
+
+TEST_CASE("ParallelFor.Adaptive.2threads" * doctest::timeout(300)) {
+  for_each<rigel::AdaptivePartitioner>(2);
+}
+
+TEST_CASE("ParallelFor.Adaptive.3threads" * doctest::timeout(300)) {
+  for_each<rigel::AdaptivePartitioner>(3);
+}
+
+TEST_CASE("ParallelFor.Adaptive.4threads" * doctest::timeout(300)) {
+  for_each<rigel::AdaptivePartitioner>(4);
+}
+
+TEST_CASE("ParallelFor.Adaptive.8threads" * doctest::timeout(300)) {
+  for_each<rigel::AdaptivePartitioner>(8);
+}
+
 // ----------------------------------------------------------------------------
 // stateful_for_each
 // ----------------------------------------------------------------------------
@@ -545,3 +586,495 @@ TEST_CASE("StatefulParallelFor.Random.11threads" * doctest::timeout(300)) {
 TEST_CASE("StatefulParallelFor.Random.12threads" * doctest::timeout(300)) {
   stateful_for_each<rigel::RandomPartitioner>(12);
 }
+
+// affinity
+TEST_CASE("StatefulParallelFor.Affinity.1thread" * doctest::timeout(300)) {
+  stateful_for_each<rigel::AffinityPartitioner>(1);
+}
+
+TEST_CASE("StatefulParallelFor.Affinity.2threads" * doctest::timeout(300)) {
+  stateful_for_each<rigel::AffinityPartitioner>(2);
+}
+
+TEST_CASE("StatefulParallelFor.Affinity.3threads" * doctest::timeout(300)) {
+  stateful_for_each<rigel::AffinityPartitioner>(3);
+}
+
+TEST_CASE("StatefulParallelFor.Affinity.4threads" * doctest::timeout(300)) {
+  stateful_for_each<rigel::AffinityPartitioner>(4);
+}
+
+TEST_CASE("StatefulParallelFor.Affinity.8threads" * doctest::timeout(300)) {
+  stateful_for_each<rigel::AffinityPartitioner>(8);
+}
+
+TEST_CASE("StatefulParallelFor.Adaptive.1thread" * doctest::timeout(300)) {
+  stateful_for_each<rigel::AdaptivePartitioner>(1);
+}
+
+TEST_CASE("StatefulParallelFor.Adaptive.2threads" * doctest::timeout(300)) {
+  stateful_for_each<rigel::AdaptivePartitioner>(2);
+}
+
+TEST_CASE("StatefulParallelFor.Adaptive.3threads" * doctest::timeout(300)) {
+  stateful_for_each<rigel::AdaptivePartitioner>(3);
+}
+
+TEST_CASE("StatefulParallelFor.Adaptive.4threads" * doctest::timeout(300)) {
+  stateful_for_each<rigel::AdaptivePartitioner>(4);
+}
+
+TEST_CASE("StatefulParallelFor.Adaptive.8threads" * doctest::timeout(300)) {
+  stateful_for_each<rigel::AdaptivePartitioner>(8);
+}
+
+// --------------------------------------------------------
+// Testcase: affinity partitioner replay
+// --------------------------------------------------------
+
+void affinity_replay(unsigned W) {
+
+  rigel::Executor executor(W);
+  rigel::Taskflow taskflow;
+
+  const size_t N = 10000;
+
+  std::vector<int> data(N, 0);
+
+  rigel::AffinityPartitioner part(100);
+
+  REQUIRE(part.affinity().empty());
+
+  taskflow.emplace([&](rigel::Runtime& rt){
+    for(int r=1; r<=10; r++) {
+      std::atomic<size_t> next(0);
+      rigel::launch_loop(N, W, rt, next, part, [&](){
+        part.loop(N, W, next, [&](size_t curr_b, size_t curr_e){
+          for(size_t i=curr_b; i<curr_e; i++) {
+            data[i]++;
+          }
+        });
+      });
+      REQUIRE(part.affinity().size() == N / 100);
+      for(auto w : part.affinity()) {
+        REQUIRE(w < W);
+      }
+    }
+  });
+
+  executor.run(taskflow).wait();
+
+  for(auto d : data) {
+    REQUIRE(d == 10);
+  }
+
+  // a different number of iterations discards the recorded mapping
+  taskflow.clear();
+  taskflow.emplace([&](rigel::Runtime& rt){
+    std::atomic<size_t> next(0);
+    rigel::launch_loop(N/2, W, rt, next, part, [&](){
+      part.loop(N/2, W, next, [&](size_t curr_b, size_t curr_e){
+        for(size_t i=curr_b; i<curr_e; i++) {
+          data[i]++;
+        }
+      });
+    });
+  });
+
+  executor.run(taskflow).wait();
+
+  REQUIRE(part.affinity().size() == N / 200);
+
+  for(size_t i=0; i<N; i++) {
+    REQUIRE(data[i] == (i < N/2 ? 11 : 10));
+  }
+
+  part.clear();
+
+  REQUIRE(part.affinity().empty());
+
+  // the partitioner is copied into the task and keeps its mapping across runs
+  std::fill(data.begin(), data.end(), 0);
+  taskflow.clear();
+  taskflow.for_each_index(size_t{0}, N, size_t{1}, [&](size_t i){ data[i]++; }, part);
+  executor.run_n(taskflow, 10).wait();
+
+  for(auto d : data) {
+    REQUIRE(d == 10);
+  }
+}
+
+TEST_CASE("AffinityPartitioner.Replay.1thread" * doctest::timeout(300)) {
+  affinity_replay(1);
+}
+
+TEST_CASE("AffinityPartitioner.Replay.2threads" * doctest::timeout(300)) {
+  affinity_replay(2);
+}
+
+TEST_CASE("AffinityPartitioner.Replay.4threads" * doctest::timeout(300)) {
+  affinity_replay(4);
+}
+
+TEST_CASE("AffinityPartitioner.Replay.8threads" * doctest::timeout(300)) {
+  affinity_replay(8);
+}
+
+// --------------------------------------------------------
+// Testcase: AdaptivePartitioner.Tuning
+// --------------------------------------------------------
+
+void adaptive_tuning(unsigned W) {
+
+  rigel::Executor executor(W);
+  rigel::Taskflow taskflow;
+
+  const size_t N = 100000;
+
+  std::vector<int> data(N, 0);
+
+  rigel::AdaptivePartitioner part;
+
+  REQUIRE(part.parameters().mode == rigel::AdaptiveMode::GUIDED);
+  REQUIRE(part.parameters().num_runs == 0);
+
+  // the partitioner passed to the algorithm shares its parameters with the
+  // copy owned by the task
+  taskflow.for_each_index(size_t{0}, N, size_t{1}, [&](size_t i){ data[i]++; }, part);
+  executor.run_n(taskflow, 10).wait();
+
+  for(auto d : data) {
+    REQUIRE(d == 10);
+  }
+
+  auto params = part.parameters();
+
+  if(W > 1) {
+    REQUIRE(params.num_runs == 10);
+    REQUIRE(params.num_chunks > 0);
+    REQUIRE(params.mode != rigel::AdaptiveMode::GUIDED);
+    REQUIRE(params.chunk_size >= 1);
+    REQUIRE(params.chunk_size <= (N + W - 1) / W);
+    REQUIRE(params.idle_ratio >= 0.0);
+    REQUIRE(params.idle_ratio <= 1.0);
+    REQUIRE(params.steal_ratio >= 0.0);
+    REQUIRE(params.steal_ratio <= 1.0);
+  }
+  // a single worker runs the loop sequentially without measurement
+  else {
+    REQUIRE(params.num_runs == 0);
+  }
+
+  part.clear();
+
+  REQUIRE(part.parameters().mode == rigel::AdaptiveMode::GUIDED);
+  REQUIRE(part.parameters().num_runs == 0);
+
+  // irregular iterations keep the partitioner dynamic and the results intact
+  std::atomic<size_t> sum(0);
+  taskflow.clear();
+  taskflow.for_each_index(size_t{0}, N / 10, size_t{1}, [&](size_t i){
+    size_t s = 0;
+    for(size_t k=0; k<(i % 97 == 0 ? 10000 : 1); k++) {
+      s += k;
+    }
+    sum.fetch_add(s + 1, std::memory_order_relaxed);
+  }, part);
+  executor.run_n(taskflow, 5).wait();
+
+  size_t expected = 0;
+  for(size_t i=0; i<N/10; i++) {
+    size_t n = (i % 97 == 0 ? 10000 : 1);
+    expected += n * (n - 1) / 2 + 1;
+  }
+  REQUIRE(sum == 5 * expected);
+}
+
+TEST_CASE("AdaptivePartitioner.Tuning.1thread" * doctest::timeout(300)) {
+  adaptive_tuning(1);
+}
+
+TEST_CASE("AdaptivePartitioner.Tuning.2threads" * doctest::timeout(300)) {
+  adaptive_tuning(2);
+}
+
+TEST_CASE("AdaptivePartitioner.Tuning.4threads" * doctest::timeout(300)) {
+  adaptive_tuning(4);
+}
+
+TEST_CASE("AdaptivePartitioner.Tuning.8threads" * doctest::timeout(300)) {
+  adaptive_tuning(8);
+}
+
+// --------------------------------------------------------
+// Testcase: tiled for_each_index
+// --------------------------------------------------------
+
+template <typename P>
+void tiled_for_each_2d(unsigned W) {
+
+  rigel::Executor executor(W);
+  rigel::Taskflow taskflow;
+
+  for(size_t rows : {0, 1, 7, 64, 129}) {
+    for(size_t cols : {0, 1, 13, 100}) {
+      for(size_t tile : {1, 4, 32}) {
+        for(auto order : {rigel::TileOrder::ROW_MAJOR, rigel::TileOrder::MORTON}) {
+
+          taskflow.clear();
+
+          std::vector<std::atomic<int>> counts((rows+2) * (cols+3));
+          std::atomic<size_t> tiles {0};
+
+          rigel::IndexSpace<2> space({2, 3}, {rows+2, cols+3}, {tile, 2*tile}, order);
+
+          taskflow.for_each_index(space, [&](const rigel::IndexTile<2>& t){
+            REQUIRE(t.beg[0] < t.end[0]);
+            REQUIRE(t.beg[1] < t.end[1]);
+            REQUIRE(t.end[0] - t.beg[0] <= tile);
+            REQUIRE(t.end[1] - t.beg[1] <= 2*tile);
+            for(size_t i=t.beg[0]; i<t.end[0]; i++) {
+              for(size_t j=t.beg[1]; j<t.end[1]; j++) {
+                counts[i*(cols+3) + j].fetch_add(1, std::memory_order_relaxed);
+              }
+            }
+            tiles.fetch_add(1, std::memory_order_relaxed);
+          }, P(1));
+
+          executor.run(taskflow).wait();
+
+          REQUIRE(tiles == space.num_tiles());
+
+          for(size_t i=0; i<rows+2; i++) {
+            for(size_t j=0; j<cols+3; j++) {
+              bool inside = (i >= 2 && j >= 3);
+              REQUIRE(counts[i*(cols+3) + j] == (inside ? 1 : 0));
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+template <typename P>
+void tiled_for_each_3d(unsigned W) {
+
+  rigel::Executor executor(W);
+  rigel::Taskflow taskflow;
+
+  for(size_t n : {0, 1, 9, 33}) {
+    for(size_t tile : {1, 4, 8}) {
+      for(auto order : {rigel::TileOrder::ROW_MAJOR, rigel::TileOrder::MORTON}) {
+
+        taskflow.clear();
+
+        std::vector<std::atomic<int>> counts(n * (n+1) * (n+2));
+
+        rigel::IndexSpace<3> space({0, 0, 0}, {n, n+1, n+2}, {tile, tile, 2*tile}, order);
+        rigel::IndexSpace<3> stateful({0, 0, 0}, {0, 0, 0}, {1, 1, 1});
+
+        auto init = taskflow.emplace([&](){ stateful = space; });
+
+        auto loop = taskflow.for_each_index(std::ref(stateful), [&](const rigel::IndexTile<3>& t){
+          for(size_t i=t.beg[0]; i<t.end[0]; i++) {
+            for(size_t j=t.beg[1]; j<t.end[1]; j++) {
+              for(size_t k=t.beg[2]; k<t.end[2]; k++) {
+                counts[(i*(n+1) + j)*(n+2) + k].fetch_add(1, std::memory_order_relaxed);
+              }
+            }
+          }
+        }, P(1));
+
+        init.precede(loop);
+
+        executor.run(taskflow).wait();
+
+        for(auto& c : counts) {
+          REQUIRE(c == 1);
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("TileOrder.Morton") {
+
+  rigel::IndexSpace<2> space({0, 0}, {4, 4}, {1, 1}, rigel::TileOrder::MORTON);
+
+  auto order = rigel::detail::make_tile_order(space);
+
+  REQUIRE(order == std::vector<size_t>{0, 1, 4, 5, 2, 3, 6, 7, 8, 9, 12, 13, 10, 11, 14, 15});
+
+  rigel::IndexSpace<2> row({0, 0}, {4, 4}, {1, 1}, rigel::TileOrder::ROW_MAJOR);
+
+  REQUIRE(rigel::detail::make_tile_order(row).empty());
+}
+
+// guided
+TEST_CASE("TiledParallelFor2D.Guided.1thread" * doctest::timeout(300)) {
+  tiled_for_each_2d<rigel::GuidedPartitioner>(1);
+}
+
+TEST_CASE("TiledParallelFor2D.Guided.2threads" * doctest::timeout(300)) {
+  tiled_for_each_2d<rigel::GuidedPartitioner>(2);
+}
+
+TEST_CASE("TiledParallelFor2D.Guided.3threads" * doctest::timeout(300)) {
+  tiled_for_each_2d<rigel::GuidedPartitioner>(3);
+}
+
+TEST_CASE("TiledParallelFor2D.Guided.4threads" * doctest::timeout(300)) {
+  tiled_for_each_2d<rigel::GuidedPartitioner>(4);
+}
+
+TEST_CASE("TiledParallelFor2D.Guided.8threads" * doctest::timeout(300)) {
+  tiled_for_each_2d<rigel::GuidedPartitioner>(8);
+}
+
+// dynamic
+TEST_CASE("TiledParallelFor2D.Dynamic.1thread" * doctest::timeout(300)) {
+  tiled_for_each_2d<rigel::DynamicPartitioner>(1);
+}
+
+TEST_CASE("TiledParallelFor2D.Dynamic.2threads" * doctest::timeout(300)) {
+  tiled_for_each_2d<rigel::DynamicPartitioner>(2);
+}
+
+TEST_CASE("TiledParallelFor2D.Dynamic.3threads" * doctest::timeout(300)) {
+  tiled_for_each_2d<rigel::DynamicPartitioner>(3);
+}
+
+TEST_CASE("TiledParallelFor2D.Dynamic.4threads" * doctest::timeout(300)) {
+  tiled_for_each_2d<rigel::DynamicPartitioner>(4);
+}
+
+TEST_CASE("TiledParallelFor2D.Dynamic.8threads" * doctest::timeout(300)) {
+  tiled_for_each_2d<rigel::DynamicPartitioner>(8);
+}
+
+// static
+TEST_CASE("TiledParallelFor2D.Static.1thread" * doctest::timeout(300)) {
+  tiled_for_each_2d<rigel::StaticPartitioner>(1);
+}
+
+TEST_CASE("TiledParallelFor2D.Static.2threads" * doctest::timeout(300)) {
+  tiled_for_each_2d<rigel::StaticPartitioner>(2);
+}
+
+TEST_CASE("TiledParallelFor2D.Static.3threads" * doctest::timeout(300)) {
+  tiled_for_each_2d<rigel::StaticPartitioner>(3);
+}
+
+TEST_CASE("TiledParallelFor2D.Static.4threads" * doctest::timeout(300)) {
+  tiled_for_each_2d<rigel::StaticPartitioner>(4);
+}
+
+TEST_CASE("TiledParallelFor2D.Static.8threads" * doctest::timeout(300)) {
+  tiled_for_each_2d<rigel::StaticPartitioner>(8);
+}
+
+// random
+TEST_CASE("TiledParallelFor2D.Random.1thread" * doctest::timeout(300)) {
+  tiled_for_each_2d<rigel::RandomPartitioner>(1);
+}
+
+TEST_CASE("TiledParallelFor2D.Random.2threads" * doctest::timeout(300)) {
+  tiled_for_each_2d<rigel::RandomPartitioner>(2);
+}
+
+TEST_CASE("TiledParallelFor2D.Random.3threads" * doctest::timeout(300)) {
+  tiled_for_each_2d<rigel::RandomPartitioner>(3);
+}
+
+TEST_CASE("TiledParallelFor2D.Random.4threads" * doctest::timeout(300)) {
+  tiled_for_each_2d<rigel::RandomPartitioner>(4);
+}
+
+TEST_CASE("TiledParallelFor2D.Random.8threads" * doctest::timeout(300)) {
+  tiled_for_each_2d<rigel::RandomPartitioner>(8);
+}
+
+// guided
+TEST_CASE("TiledParallelFor3D.Guided.1thread" * doctest::timeout(300)) {
+  tiled_for_each_3d<rigel::GuidedPartitioner>(1);
+}
+
+TEST_CASE("TiledParallelFor3D.Guided.2threads" * doctest::timeout(300)) {
+  tiled_for_each_3d<rigel::GuidedPartitioner>(2);
+}
+
+TEST_CASE("TiledParallelFor3D.Guided.3threads" * doctest::timeout(300)) {
+  tiled_for_each_3d<rigel::GuidedPartitioner>(3);
+}
+
+TEST_CASE("TiledParallelFor3D.Guided.4threads" * doctest::timeout(300)) {
+  tiled_for_each_3d<rigel::GuidedPartitioner>(4);
+}
+
+TEST_CASE("TiledParallelFor3D.Guided.8threads" * doctest::timeout(300)) {
+  tiled_for_each_3d<rigel::GuidedPartitioner>(8);
+}
+
+// dynamic
+TEST_CASE("TiledParallelFor3D.Dynamic.1thread" * doctest::timeout(300)) {
+  tiled_for_each_3d<rigel::DynamicPartitioner>(1);
+}
+
+TEST_CASE("TiledParallelFor3D.Dynamic.2threads" * doctest::timeout(300)) {
+  tiled_for_each_3d<rigel::DynamicPartitioner>(2);
+}
+
+TEST_CASE("TiledParallelFor3D.Dynamic.3threads" * doctest::timeout(300)) {
+  tiled_for_each_3d<rigel::DynamicPartitioner>(3);
+}
+
+TEST_CASE("TiledParallelFor3D.Dynamic.4threads" * doctest::timeout(300)) {
+  tiled_for_each_3d<rigel::DynamicPartitioner>(4);
+}
+
+TEST_CASE("TiledParallelFor3D.Dynamic.8threads" * doctest::timeout(300)) {
+  tiled_for_each_3d<rigel::DynamicPartitioner>(8);
+}
+
+// static
+TEST_CASE("TiledParallelFor3D.Static.1thread" * doctest::timeout(300)) {
+  tiled_for_each_3d<rigel::StaticPartitioner>(1);
+}
+
+TEST_CASE("TiledParallelFor3D.Static.2threads" * doctest::timeout(300)) {
+  tiled_for_each_3d<rigel::StaticPartitioner>(2);
+}
+
+TEST_CASE("TiledParallelFor3D.Static.3threads" * doctest::timeout(300)) {
+  tiled_for_each_3d<rigel::StaticPartitioner>(3);
+}
+
+TEST_CASE("TiledParallelFor3D.Static.4threads" * doctest::timeout(300)) {
+  tiled_for_each_3d<rigel::StaticPartitioner>(4);
+}
+
+TEST_CASE("TiledParallelFor3D.Static.8threads" * doctest::timeout(300)) {
+  tiled_for_each_3d<rigel::StaticPartitioner>(8);
+}
+
+// random
+TEST_CASE("TiledParallelFor3D.Random.1thread" * doctest::timeout(300)) {
+  tiled_for_each_3d<rigel::RandomPartitioner>(1);
+}
+
+TEST_CASE("TiledParallelFor3D.Random.2threads" * doctest::timeout(300)) {
+  tiled_for_each_3d<rigel::RandomPartitioner>(2);
+}
+
+TEST_CASE("TiledParallelFor3D.Random.3threads" * doctest::timeout(300)) {
+  tiled_for_each_3d<rigel::RandomPartitioner>(3);
+}
+
+TEST_CASE("TiledParallelFor3D.Random.4threads" * doctest::timeout(300)) {
+  tiled_for_each_3d<rigel::RandomPartitioner>(4);
+}
+
+TEST_CASE("TiledParallelFor3D.Random.8threads" * doctest::timeout(300)) {
+  tiled_for_each_3d<rigel::RandomPartitioner>(8);
+}
@@ -0,0 +1,373 @@
+// Copyright 2023 The titan-search Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include "tests/doctest.h"
+#include "rigel/taskflow/taskflow.h"
+#include "rigel/taskflow/algorithm/histogram.h"
+
+// ----------------------------------------------------------------------------
+// histogram
+// ----------------------------------------------------------------------------
+
+template <typename P>
+void test_histogram(unsigned W) {
+
+  rigel::Executor executor(W);
+  rigel::Taskflow taskflow;
+  std::vector<int> input;
+  std::vector<size_t> bins, golden;
+
+  for(size_t n = 0; n <= 150000; n <= 16 ? n++ : n=2*n+1) {
+    for(size_t c : {0, 1, 3}) {
+      for(size_t num_bins : {1, 7, 256, 10000}) {
+
+        taskflow.clear();
+
+        input.resize(n);
+        bins.assign(num_bins, 1);
+        golden.assign(num_bins, 1);
+
+        for(auto& i : input) {
+          i = ::rand() % 20000;
+        }
+
+        // keys not less than num_bins are ignored
+        auto key = [num_bins] (int i) { return static_cast<size_t>(i) % (num_bins + 1); };
+
+        for(auto i : input) {
+          if(size_t k = key(i); k < num_bins) {
+            golden[k]++;
+          }
+        }
+
+        std::vector<int>::iterator beg, end;
+
+        auto init = taskflow.emplace([&](){
+          beg = input.begin();
+          end = input.end();
+        });
+
+        auto task = taskflow.histogram(
+          std::ref(beg), std::ref(end), bins.begin(), num_bins, key, P(c)
+        );
+
+        init.precede(task);
+
+        executor.run(taskflow).wait();
+
+        REQUIRE(bins == golden);
+      }
+    }
+  }
+}
+
+TEST_CASE("Histogram.StaticPartitioner.1thread" * doctest::timeout(300)) {
+  test_histogram<rigel::StaticPartitioner>(1);
+}
+
+TEST_CASE("Histogram.StaticPartitioner.2threads" * doctest::timeout(300)) {
+  test_histogram<rigel::StaticPartitioner>(2);
+}
+
+TEST_CASE("Histogram.StaticPartitioner.3threads" * doctest::timeout(300)) {
+  test_histogram<rigel::StaticPartitioner>(3);
+}
+
+TEST_CASE("Histogram.StaticPartitioner.4threads" * doctest::timeout(300)) {
+  test_histogram<rigel::StaticPartitioner>(4);
+}
+
+TEST_CASE("Histogram.StaticPartitioner.8threads" * doctest::timeout(300)) {
+  test_histogram<rigel::StaticPartitioner>(8);
+}
+
+TEST_CASE("Histogram.GuidedPartitioner.1thread" * doctest::timeout(300)) {
+  test_histogram<rigel::GuidedPartitioner>(1);
+}
+
+TEST_CASE("Histogram.GuidedPartitioner.2threads" * doctest::timeout(300)) {
+  test_histogram<rigel::GuidedPartitioner>(2);
+}
+
+TEST_CASE("Histogram.GuidedPartitioner.3threads" * doctest::timeout(300)) {
+  test_histogram<rigel::GuidedPartitioner>(3);
+}
+
+TEST_CASE("Histogram.GuidedPartitioner.4threads" * doctest::timeout(300)) {
+  test_histogram<rigel::GuidedPartitioner>(4);
+}
+
+TEST_CASE("Histogram.GuidedPartitioner.8threads" * doctest::timeout(300)) {
+  test_histogram<rigel::GuidedPartitioner>(8);
+}
+
+TEST_CASE("Histogram.DynamicPartitioner.1thread" * doctest::timeout(300)) {
+  test_histogram<rigel::DynamicPartitioner>(1);
+}
+
+TEST_CASE("Histogram.DynamicPartitioner.2threads" * doctest::timeout(300)) {
+  test_histogram<rigel::DynamicPartitioner>(2);
+}
+
+TEST_CASE("Histogram.DynamicPartitioner.3threads" * doctest::timeout(300)) {
+  test_histogram<rigel::DynamicPartitioner>(3);
+}
+
+TEST_CASE("Histogram.DynamicPartitioner.4threads" * doctest::timeout(300)) {
+  test_histogram<rigel::DynamicPartitioner>(4);
+}
+
+TEST_CASE("Histogram.DynamicPartitioner.8threads" * doctest::timeout(300)) {
+  test_histogram<rigel::DynamicPartitioner>(8);
+}
+
+TEST_CASE("Histogram.RandomPartitioner.1thread" * doctest::timeout(300)) {
+  test_histogram<rigel::RandomPartitioner>(1);
+}
+
+TEST_CASE("Histogram.RandomPartitioner.2threads" * doctest::timeout(300)) {
+  test_histogram<rigel::RandomPartitioner>(2);
+}
+
+TEST_CASE("Histogram.RandomPartitioner.3threads" * doctest::timeout(300)) {
+  test_histogram<rigel::RandomPartitioner>(3);
+}
+
+TEST_CASE("Histogram.RandomPartitioner.4threads" * doctest::timeout(300)) {
+  test_histogram<rigel::RandomPartitioner>(4);
+}
+
+TEST_CASE("Histogram.RandomPartitioner.8threads" * doctest::timeout(300)) {
+  test_histogram<rigel::RandomPartitioner>(8);
+}
+
+TEST_CASE("Histogram.AffinityPartitioner.1thread" * doctest::timeout(300)) {
+  test_histogram<rigel::AffinityPartitioner>(1);
+}
+
+TEST_CASE("Histogram.AffinityPartitioner.2threads" * doctest::timeout(300)) {
+  test_histogram<rigel::AffinityPartitioner>(2);
+}
+
+TEST_CASE("Histogram.AffinityPartitioner.3threads" * doctest::timeout(300)) {
+  test_histogram<rigel::AffinityPartitioner>(3);
+}
+
+TEST_CASE("Histogram.AffinityPartitioner.4threads" * doctest::timeout(300)) {
+  test_histogram<rigel::AffinityPartitioner>(4);
+}
+
+TEST_CASE("Histogram.AffinityPartitioner.8threads" * doctest::timeout(300)) {
+  test_histogram<rigel::AffinityPartitioner>(8);
+}
+
+TEST_CASE("Histogram.AdaptivePartitioner.1thread" * doctest::timeout(300)) {
+  test_histogram<rigel::AdaptivePartitioner>(1);
+}
+
+TEST_CASE("Histogram.AdaptivePartitioner.2threads" * doctest::timeout(300)) {
+  test_histogram<rigel::AdaptivePartitioner>(2);
+}
+
+TEST_CASE("Histogram.AdaptivePartitioner.3threads" * doctest::timeout(300)) {
+  test_histogram<rigel::AdaptivePartitioner>(3);
+}
+
+TEST_CASE("Histogram.AdaptivePartitioner.4threads" * doctest::timeout(300)) {
+  test_histogram<rigel::AdaptivePartitioner>(4);
+}
+
+TEST_CASE("Histogram.AdaptivePartitioner.8threads" * doctest::timeout(300)) {
+  test_histogram<rigel::AdaptivePartitioner>(8);
+}
+
+// ----------------------------------------------------------------------------
+// histogram_reduce
+// ----------------------------------------------------------------------------
+
+template <typename P>
+void test_histogram_reduce(unsigned W) {
+
+  rigel::Executor executor(W);
+  rigel::Taskflow taskflow;
+  std::vector<std::pair<size_t, int>> input;
+  std::vector<int> maxs, golden_maxs;
+  std::vector<long> sums, golden_sums;
+
+  for(size_t n = 0; n <= 150000; n <= 16 ? n++ : n=2*n+1) {
+    for(size_t c : {0, 1, 3}) {
+      for(size_t num_bins : {1, 7, 256, 10000}) {
+
+        taskflow.clear();
+
+        input.resize(n);
+        maxs.assign(num_bins, -1);
+        golden_maxs.assign(num_bins, -1);
+        sums.assign(num_bins, 0);
+        golden_sums.assign(num_bins, 0);
+
+        for(auto& i : input) {
+          i = {::rand() % (num_bins + 1), ::rand() % 1000};
+        }
+
+        for(auto& [k, v] : input) {
+          if(k < num_bins) {
+            golden_maxs[k] = std::max(golden_maxs[k], v);
+            golden_sums[k] += v;
+          }
+        }
+
+        auto key = [] (const std::pair<size_t, int>& p) { return p.first; };
+        auto value = [] (const std::pair<size_t, int>& p) { return p.second; };
+
+        taskflow.histogram_reduce(
+          input.begin(), input.end(), maxs.begin(), num_bins, key, value,
+          [] (int a, int b) { return std::max(a, b); }, P(c)
+        );
+
+        taskflow.histogram_reduce(
+          input.begin(), input.end(), sums.begin(), num_bins, key, value,
+          std::plus<long>{}, P(c)
+        );
+
+        executor.run(taskflow).wait();
+
+        REQUIRE(maxs == golden_maxs);
+        REQUIRE(sums == golden_sums);
+      }
+    }
+  }
+}
+
+TEST_CASE("HistogramReduce.StaticPartitioner.1thread" * doctest::timeout(300)) {
+  test_histogram_reduce<rigel::StaticPartitioner>(1);
+}
+
+TEST_CASE("HistogramReduce.StaticPartitioner.2threads" * doctest::timeout(300)) {
+  test_histogram_reduce<rigel::StaticPartitioner>(2);
+}
+
+TEST_CASE("HistogramReduce.StaticPartitioner.3threads" * doctest::timeout(300)) {
+  test_histogram_reduce<rigel::StaticPartitioner>(3);
+}
+
+TEST_CASE("HistogramReduce.StaticPartitioner.4threads" * doctest::timeout(300)) {
+  test_histogram_reduce<rigel::StaticPartitioner>(4);
+}
+
+TEST_CASE("HistogramReduce.StaticPartitioner.8threads" * doctest::timeout(300)) {
+  test_histogram_reduce<rigel::StaticPartitioner>(8);
+}
+
+TEST_CASE("HistogramReduce.GuidedPartitioner.1thread" * doctest::timeout(300)) {
+  test_histogram_reduce<rigel::GuidedPartitioner>(1);
+}
+
+TEST_CASE("HistogramReduce.GuidedPartitioner.2threads" * doctest::timeout(300)) {
+  test_histogram_reduce<rigel::GuidedPartitioner>(2);
+}
+
+TEST_CASE("HistogramReduce.GuidedPartitioner.3threads" * doctest::timeout(300)) {
+  test_histogram_reduce<rigel::GuidedPartitioner>(3);
+}
+
+TEST_CASE("HistogramReduce.GuidedPartitioner.4threads" * doctest::timeout(300)) {
+  test_histogram_reduce<rigel::GuidedPartitioner>(4);
+}
+
+TEST_CASE("HistogramReduce.GuidedPartitioner.8threads" * doctest::timeout(300)) {
+  test_histogram_reduce<rigel::GuidedPartitioner>(8);
+}
+
+TEST_CASE("HistogramReduce.DynamicPartitioner.1thread" * doctest::timeout(300)) {
+  test_histogram_reduce<rigel::DynamicPartitioner>(1);
+}
+
+TEST_CASE("HistogramReduce.DynamicPartitioner.2threads" * doctest::timeout(300)) {
+  test_histogram_reduce<rigel::DynamicPartitioner>(2);
+}
+
+TEST_CASE("HistogramReduce.DynamicPartitioner.3threads" * doctest::timeout(300)) {
+  test_histogram_reduce<rigel::DynamicPartitioner>(3);
+}
+
+TEST_CASE("HistogramReduce.DynamicPartitioner.4threads" * doctest::timeout(300)) {
+  test_histogram_reduce<rigel::DynamicPartitioner>(4);
+}
+
+TEST_CASE("HistogramReduce.DynamicPartitioner.8threads" * doctest::timeout(300)) {
+  test_histogram_reduce<rigel::DynamicPartitioner>(8);
+}
+
+TEST_CASE("HistogramReduce.RandomPartitioner.1thread" * doctest::timeout(300)) {
+  test_histogram_reduce<rigel::RandomPartitioner>(1);
+}
+
+TEST_CASE("HistogramReduce.RandomPartitioner.2threads" * doctest::timeout(300)) {
+  test_histogram_reduce<rigel::RandomPartitioner>(2);
+}
+
+TEST_CASE("HistogramReduce.RandomPartitioner.3threads" * doctest::timeout(300)) {
+  test_histogram_reduce<rigel::RandomPartitioner>(3);
+}
+
+TEST_CASE("HistogramReduce.RandomPartitioner.4threads" * doctest::timeout(300)) {
+  test_histogram_reduce<rigel::RandomPartitioner>(4);
+}
+
+TEST_CASE("HistogramReduce.RandomPartitioner.8threads" * doctest::timeout(300)) {
+  test_histogram_reduce<rigel::RandomPartitioner>(8);
+}
+
+TEST_CASE("HistogramReduce.AffinityPartitioner.1thread" * doctest::timeout(300)) {
+  test_histogram_reduce<rigel::AffinityPartitioner>(1);
+}
+
+TEST_CASE("HistogramReduce.AffinityPartitioner.2threads" * doctest::timeout(300)) {
+  test_histogram_reduce<rigel::AffinityPartitioner>(2);
+}
+
+TEST_CASE("HistogramReduce.AffinityPartitioner.3threads" * doctest::timeout(300)) {
+  test_histogram_reduce<rigel::AffinityPartitioner>(3);
+}
+
+TEST_CASE("HistogramReduce.AffinityPartitioner.4threads" * doctest::timeout(300)) {
+  test_histogram_reduce<rigel::AffinityPartitioner>(4);
+}
+
+TEST_CASE("HistogramReduce.AffinityPartitioner.8threads" * doctest::timeout(300)) {
+  test_histogram_reduce<rigel::AffinityPartitioner>(8);
+}
+
+TEST_CASE("HistogramReduce.AdaptivePartitioner.1thread" * doctest::timeout(300)) {
+  test_histogram_reduce<rigel::AdaptivePartitioner>(1);
+}
+
+TEST_CASE("HistogramReduce.AdaptivePartitioner.2threads" * doctest::timeout(300)) {
+  test_histogram_reduce<rigel::AdaptivePartitioner>(2);
+}
+
+TEST_CASE("HistogramReduce.AdaptivePartitioner.3threads" * doctest::timeout(300)) {
+  test_histogram_reduce<rigel::AdaptivePartitioner>(3);
+}
+
+TEST_CASE("HistogramReduce.AdaptivePartitioner.4threads" * doctest::timeout(300)) {
+  test_histogram_reduce<rigel::AdaptivePartitioner>(4);
+}
+
+TEST_CASE("HistogramReduce.AdaptivePartitioner.8threads" * doctest::timeout(300)) {
+  test_histogram_reduce<rigel::AdaptivePartitioner>(8);
+}
@@ -0,0 +1,300 @@
+// Copyright 2023 The titan-search Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include "tests/doctest.h"
+#include "rigel/taskflow/taskflow.h"
+
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+
+// makes the executors created afterwards use the given backend
+void use_backend(rigel::IOBackend backend) {
+  if(backend == rigel::IOBackend::EPOLL) {
+    ::setenv(TF_IO_BACKEND, "epoll", 1);
+  }
+  else {
+    ::unsetenv(TF_IO_BACKEND);
+  }
+}
+
+// opens an anonymous temporary file
+int temp_file() {
+  char path[] = "/tmp/tf_test_io_XXXXXX";
+  int fd = ::mkstemp(path);
+  REQUIRE(fd != -1);
+  ::unlink(path);
+  return fd;
+}
+
+// --------------------------------------------------------
+// Testcase: AsyncIO.ReadWrite
+// --------------------------------------------------------
+
+void read_write(unsigned W, rigel::IOBackend backend) {
+
+  use_backend(backend);
+
+  rigel::Executor executor(W);
+
+  // io_uring falls back to epoll on kernels without it
+  if(backend == rigel::IOBackend::EPOLL) {
+    REQUIRE(executor.io_backend() == rigel::IOBackend::EPOLL);
+  }
+
+  int fd = temp_file();
+
+  const size_t B = 4096;
+  const size_t N = 64;
+
+  std::vector<char> in(B*N), out(B*N, 0);
+  for(size_t i=0; i<in.size(); ++i) {
+    in[i] = static_cast<char>(i * 31 + 7);
+  }
+
+  std::vector<std::future<ssize_t>> fus;
+
+  for(size_t i=0; i<N; ++i) {
+    fus.push_back(executor.async_write(fd, in.data() + i*B, B, i*B));
+  }
+  for(auto& fu : fus) {
+    REQUIRE(fu.get() == B);
+  }
+  fus.clear();
+
+  // issue the reads from the workers as well
+  for(size_t i=0; i<N; ++i) {
+    executor.silent_async([&, i](){
+      executor.async_read(fd, out.data() + i*B, B, i*B);
+    });
+  }
+  executor.wait_for_all();
+
+  REQUIRE(in == out);
+
+  // reading at the end of the file returns zero
+  REQUIRE(executor.async_read(fd, out.data(), B, B*N).get() == 0);
+
+  // reading at the current file position
+  REQUIRE(::lseek(fd, B, SEEK_SET) == static_cast<off_t>(B));
+  REQUIRE(executor.async_read(fd, out.data(), B).get() == B);
+  REQUIRE(std::equal(out.begin(), out.begin() + B, in.begin() + B));
+
+  ::close(fd);
+}
+
+TEST_CASE("AsyncIO.ReadWrite.IOUring.1thread" * doctest::timeout(300)) {
+  read_write(1, rigel::IOBackend::IO_URING);
+}
+
+TEST_CASE("AsyncIO.ReadWrite.IOUring.4threads" * doctest::timeout(300)) {
+  read_write(4, rigel::IOBackend::IO_URING);
+}
+
+TEST_CASE("AsyncIO.ReadWrite.Epoll.1thread" * doctest::timeout(300)) {
+  read_write(1, rigel::IOBackend::EPOLL);
+}
+
+TEST_CASE("AsyncIO.ReadWrite.Epoll.4threads" * doctest::timeout(300)) {
+  read_write(4, rigel::IOBackend::EPOLL);
+}
+
+// --------------------------------------------------------
+// Testcase: AsyncIO.Pipe
+// --------------------------------------------------------
+
+void pipe_read_write(unsigned W, rigel::IOBackend backend) {
+
+  use_backend(backend);
+
+  rigel::Executor executor(W);
+
+  int fds[2];
+  REQUIRE(::pipe(fds) == 0);
+
+  const int N = 100;
+
+  std::vector<int> in(N), out(N, -1);
+
+  // the reads are pending until the writes arrive
+  std::vector<std::future<ssize_t>> reads;
+  for(int i=0; i<N; ++i) {
+    reads.push_back(executor.async_read(fds[0], &out[i], sizeof(int)));
+  }
+
+  for(int i=0; i<N; ++i) {
+    in[i] = i;
+    REQUIRE(executor.async_write(fds[1], &in[i], sizeof(int)).get() == sizeof(int));
+  }
+
+  // io_uring may complete the pending reads in any order
+  std::vector<int> sorted;
+  for(int i=0; i<N; ++i) {
+    REQUIRE(reads[i].get() == sizeof(int));
+    sorted.push_back(out[i]);
+  }
+  std::sort(sorted.begin(), sorted.end());
+  REQUIRE(sorted == in);
+
+  ::close(fds[0]);
+  ::close(fds[1]);
+}
+
+TEST_CASE("AsyncIO.Pipe.IOUring.1thread" * doctest::timeout(300)) {
+  pipe_read_write(1, rigel::IOBackend::IO_URING);
+}
+
+TEST_CASE("AsyncIO.Pipe.IOUring.4threads" * doctest::timeout(300)) {
+  pipe_read_write(4, rigel::IOBackend::IO_URING);
+}
+
+TEST_CASE("AsyncIO.Pipe.Epoll.1thread" * doctest::timeout(300)) {
+  pipe_read_write(1, rigel::IOBackend::EPOLL);
+}
+
+TEST_CASE("AsyncIO.Pipe.Epoll.4threads" * doctest::timeout(300)) {
+  pipe_read_write(4, rigel::IOBackend::EPOLL);
+}
+
+// --------------------------------------------------------
+// Testcase: AsyncIO.Dependent
+// --------------------------------------------------------
+
+void dependent_read_write(unsigned W, rigel::IOBackend backend) {
+
+  use_backend(backend);
+
+  rigel::Executor executor(W);
+
+  int fd = temp_file();
+
+  const size_t B = 1024;
+  const size_t N = 32;
+
+  std::vector<std::vector<char>> in(N, std::vector<char>(B)), out(N, std::vector<char>(B));
+  std::atomic<size_t> checked {0};
+
+  // produce -> write -> read -> check, with the I/O off the workers
+  for(size_t i=0; i<N; ++i) {
+    auto P = executor.silent_dependent_async([&, i](){
+      std::fill(in[i].begin(), in[i].end(), static_cast<char>(i + 1));
+    });
+    auto [Wr, fuW] = executor.dependent_async_write(fd, in[i].data(), B, i*B, P);
+    auto [Rd, fuR] = executor.dependent_async_read(fd, out[i].data(), B, i*B, Wr);
+    executor.silent_dependent_async([&, i, fuW=fuW.share(), fuR=fuR.share()](){
+      if(fuW.get() == B && fuR.get() == B && in[i] == out[i]) {
+        checked.fetch_add(1, std::memory_order_relaxed);
+      }
+    }, Rd);
+  }
+
+  executor.wait_for_all();
+
+  REQUIRE(checked == N);
+
+  ::close(fd);
+}
+
+TEST_CASE("AsyncIO.Dependent.IOUring.1thread" * doctest::timeout(300)) {
+  dependent_read_write(1, rigel::IOBackend::IO_URING);
+}
+
+TEST_CASE("AsyncIO.Dependent.IOUring.4threads" * doctest::timeout(300)) {
+  dependent_read_write(4, rigel::IOBackend::IO_URING);
+}
+
+TEST_CASE("AsyncIO.Dependent.Epoll.1thread" * doctest::timeout(300)) {
+  dependent_read_write(1, rigel::IOBackend::EPOLL);
+}
+
+TEST_CASE("AsyncIO.Dependent.Epoll.4threads" * doctest::timeout(300)) {
+  dependent_read_write(4, rigel::IOBackend::EPOLL);
+}
+
+// --------------------------------------------------------
+// Testcase: AsyncIO.Error
+// --------------------------------------------------------
+
+void io_error(rigel::IOBackend backend) {
+
+  use_backend(backend);
+
+  rigel::Executor executor(2);
+
+  char buf[16];
+
+  REQUIRE(executor.async_read(-1, buf, sizeof(buf), 0).get() == -EBADF);
+  REQUIRE(executor.async_write(-1, buf, sizeof(buf), 0).get() == -EBADF);
+
+  auto [A, fuA] = executor.dependent_async_read(-1, buf, sizeof(buf), 0);
+  auto [B, fuB] = executor.dependent_async_read(-1, buf, sizeof(buf), 0, A);
+  REQUIRE(fuA.get() == -EBADF);
+  REQUIRE(fuB.get() == -EBADF);
+}
+
+TEST_CASE("AsyncIO.Error.IOUring" * doctest::timeout(300)) {
+  io_error(rigel::IOBackend::IO_URING);
+}
+
+TEST_CASE("AsyncIO.Error.Epoll" * doctest::timeout(300)) {
+  io_error(rigel::IOBackend::EPOLL);
+}
+
+// --------------------------------------------------------
+// Testcase: AsyncIO.Shutdown
+// --------------------------------------------------------
+
+void io_shutdown(rigel::IOBackend backend) {
+
+  int fds[2];
+  REQUIRE(::pipe(fds) == 0);
+
+  std::atomic<size_t> completed {0};
+  size_t expected {0};
+  char buf[16];
+  rigel::IORequest request {rigel::IORequest::READ, fds[0], buf, sizeof(buf), -1};
+
+  {
+    rigel::IOReactor reactor([&](rigel::IORequest* r){
+      REQUIRE(r == &request);
+      completed.fetch_add(1);
+    }, backend);
+
+    // nobody writes the pipe, so the read is still pending at shutdown;
+    // a request handed to io_uring cannot be cancelled
+    if(reactor.backend() == rigel::IOBackend::EPOLL) {
+      reactor.submit(&request);
+      expected = 1;
+    }
+  }
+
+  // the reactor thread is joined and the pending read is cancelled
+  REQUIRE(completed == expected);
+  if(expected) {
+    REQUIRE(request.result == -ECANCELED);
+  }
+
+  ::close(fds[0]);
+  ::close(fds[1]);
+}
+
+TEST_CASE("AsyncIO.Shutdown.IOUring" * doctest::timeout(300)) {
+  io_shutdown(rigel::IOBackend::IO_URING);
+}
+
+TEST_CASE("AsyncIO.Shutdown.Epoll" * doctest::timeout(300)) {
+  io_shutdown(rigel::IOBackend::EPOLL);
+}
@@ -246,6 +246,47 @@ TEST_CASE("Reduce.Static.12threads" * doctest::timeout(300)) {
   reduce<rigel::StaticPartitioner>(12);
 }
 
+// affinity
+TEST_CASE("Reduce.Affinity.1thread" * doctest::timeout(300)) {
+  reduce<rigel::AffinityPartitioner>(1);
+}
+
+TEST_CASE("Reduce.Affinity.2threads" * doctest::timeout(300)) {
+  reduce<rigel::AffinityPartitioner>(2);
+}
+
+TEST_CASE("Reduce.Affinity.3threads" * doctest::timeout(300)) {
+  reduce<rigel::AffinityPartitioner>(3);
+}
+
+TEST_CASE("Reduce.Affinity.4threads" * doctest::timeout(300)) {
+  reduce<rigel::AffinityPartitioner>(4);
+}
+
+TEST_CASE("Reduce.Affinity.8threads" * doctest::timeout(300)) {
+  reduce<rigel::AffinityPartitioner>(8);
+}
+
+TEST_CASE("Reduce.Adaptive.1thread" * doctest::timeout(300)) {
+  reduce<rigel::AdaptivePartitioner>(1);
+}
+
+TEST_CASE("Reduce.Adaptive.2threads" * doctest::timeout(300)) {
+  reduce<rigel::AdaptivePartitioner>(2);
+}
+
+TEST_CASE("Reduce.Adaptive.3threads" * doctest::timeout(300)) {
+  reduce<rigel::AdaptivePartitioner>(3);
+}
+
+TEST_CASE("Reduce.Adaptive.4threads" * doctest::timeout(300)) {
+  reduce<rigel::AdaptivePartitioner>(4);
+}
+
+TEST_CASE("Reduce.Adaptive.8threads" * doctest::timeout(300)) {
+  reduce<rigel::AdaptivePartitioner>(8);
+}
+
 // random
 TEST_CASE("Reduce.Random.1thread" * doctest::timeout(300)) {
   reduce<rigel::RandomPartitioner>(1);
@@ -490,6 +531,47 @@ TEST_CASE("ReduceSum.Static.12threads" * doctest::timeout(300)) {
   reduce_sum<rigel::StaticPartitioner>(12);
 }
 
+// affinity
+TEST_CASE("ReduceSum.Affinity.1thread" * doctest::timeout(300)) {
+  reduce_sum<rigel::AffinityPartitioner>(1);
+}
+
+TEST_CASE("ReduceSum.Affinity.2threads" * doctest::timeout(300)) {
+  reduce_sum<rigel::AffinityPartitioner>(2);
+}
+
+TEST_CASE("ReduceSum.Affinity.3threads" * doctest::timeout(300)) {
+  reduce_sum<rigel::AffinityPartitioner>(3);
+}
+
+TEST_CASE("ReduceSum.Affinity.4threads" * doctest::timeout(300)) {
+  reduce_sum<rigel::AffinityPartitioner>(4);
+}
+
+TEST_CASE("ReduceSum.Affinity.8threads" * doctest::timeout(300)) {
+  reduce_sum<rigel::AffinityPartitioner>(8);
+}
+
+TEST_CASE("ReduceSum.Adaptive.1thread" * doctest::timeout(300)) {
+  reduce_sum<rigel::AdaptivePartitioner>(1);
+}
+
+TEST_CASE("ReduceSum.Adaptive.2threads" * doctest::timeout(300)) {
+  reduce_sum<rigel::AdaptivePartitioner>(2);
+}
+
+TEST_CASE("ReduceSum.Adaptive.3threads" * doctest::timeout(300)) {
+  reduce_sum<rigel::AdaptivePartitioner>(3);
+}
+
+TEST_CASE("ReduceSum.Adaptive.4threads" * doctest::timeout(300)) {
+  reduce_sum<rigel::AdaptivePartitioner>(4);
+}
+
+TEST_CASE("ReduceSum.Adaptive.8threads" * doctest::timeout(300)) {
+  reduce_sum<rigel::AdaptivePartitioner>(8);
+}
+
 // random
 TEST_CASE("ReduceSum.Random.1thread" * doctest::timeout(300)) {
   reduce_sum<rigel::RandomPartitioner>(1);
@@ -747,6 +829,47 @@ TEST_CASE("TransformReduce.Static.12threads" * doctest::timeout(300)) {
   transform_reduce<rigel::StaticPartitioner>(12);
 }
 
+// affinity
+TEST_CASE("TransformReduce.Affinity.1thread" * doctest::timeout(300)) {
+  transform_reduce<rigel::AffinityPartitioner>(1);
+}
+
+TEST_CASE("TransformReduce.Affinity.2threads" * doctest::timeout(300)) {
+  transform_reduce<rigel::AffinityPartitioner>(2);
+}
+
+TEST_CASE("TransformReduce.Affinity.3threads" * doctest::timeout(300)) {
+  transform_reduce<rigel::AffinityPartitioner>(3);
+}
+
+TEST_CASE("TransformReduce.Affinity.4threads" * doctest::timeout(300)) {
+  transform_reduce<rigel::AffinityPartitioner>(4);
+}
+
+TEST_CASE("TransformReduce.Affinity.8threads" * doctest::timeout(300)) {
+  transform_reduce<rigel::AffinityPartitioner>(8);
+}
+
+TEST_CASE("TransformReduce.Adaptive.1thread" * doctest::timeout(300)) {
+  transform_reduce<rigel::AdaptivePartitioner>(1);
+}
+
+TEST_CASE("TransformReduce.Adaptive.2threads" * doctest::timeout(300)) {
+  transform_reduce<rigel::AdaptivePartitioner>(2);
+}
+
+TEST_CASE("TransformReduce.Adaptive.3threads" * doctest::timeout(300)) {
+  transform_reduce<rigel::AdaptivePartitioner>(3);
+}
+
+TEST_CASE("TransformReduce.Adaptive.4threads" * doctest::timeout(300)) {
+  transform_reduce<rigel::AdaptivePartitioner>(4);
+}
+
+TEST_CASE("TransformReduce.Adaptive.8threads" * doctest::timeout(300)) {
+  transform_reduce<rigel::AdaptivePartitioner>(8);
+}
+
 // random
 TEST_CASE("TransformReduce.Random.1thread" * doctest::timeout(300)) {
   transform_reduce<rigel::RandomPartitioner>(1);
@@ -1160,6 +1283,47 @@ TEST_CASE("TransformReduceSum.Static.12threads" * doctest::timeout(300)) {
   transform_reduce_sum<rigel::StaticPartitioner>(12);
 }
 
+// affinity
+TEST_CASE("TransformReduceSum.Affinity.1thread" * doctest::timeout(300)) {
+  transform_reduce_sum<rigel::AffinityPartitioner>(1);
+}
+
+TEST_CASE("TransformReduceSum.Affinity.2threads" * doctest::timeout(300)) {
+  transform_reduce_sum<rigel::AffinityPartitioner>(2);
+}
+
+TEST_CASE("TransformReduceSum.Affinity.3threads" * doctest::timeout(300)) {
+  transform_reduce_sum<rigel::AffinityPartitioner>(3);
+}
+
+TEST_CASE("TransformReduceSum.Affinity.4threads" * doctest::timeout(300)) {
+  transform_reduce_sum<rigel::AffinityPartitioner>(4);
+}
+
+TEST_CASE("TransformReduceSum.Affinity.8threads" * doctest::timeout(300)) {
+  transform_reduce_sum<rigel::AffinityPartitioner>(8);
+}
+
+TEST_CASE("TransformReduceSum.Adaptive.1thread" * doctest::timeout(300)) {
+  transform_reduce_sum<rigel::AdaptivePartitioner>(1);
+}
+
+TEST_CASE("TransformReduceSum.Adaptive.2threads" * doctest::timeout(300)) {
+  transform_reduce_sum<rigel::AdaptivePartitioner>(2);
+}
+
+TEST_CASE("TransformReduceSum.Adaptive.3threads" * doctest::timeout(300)) {
+  transform_reduce_sum<rigel::AdaptivePartitioner>(3);
+}
+
+TEST_CASE("TransformReduceSum.Adaptive.4threads" * doctest::timeout(300)) {
+  transform_reduce_sum<rigel::AdaptivePartitioner>(4);
+}
+
+TEST_CASE("TransformReduceSum.Adaptive.8threads" * doctest::timeout(300)) {
+  transform_reduce_sum<rigel::AdaptivePartitioner>(8);
+}
+
 // random
 TEST_CASE("TransformReduceSum.Random.1thread" * doctest::timeout(300)) {
   transform_reduce_sum<rigel::RandomPartitioner>(1);
@@ -842,3 +842,61 @@ TEST_CASE("ScalablePipeline(SPSPSPSP).Runtime.Subflow.8threads" * doctest::timeo
   scalable_pipeline_spspspsp_runtime_subflow(8);
 }
 
+
+// --------------------------------------------------------
+// Testcase: Runtime.IndexedName
+// --------------------------------------------------------
+
+struct NameObserver : public rigel::ObserverInterface {
+
+  std::mutex mutex;
+  std::multiset<std::string> names;
+
+  void set_up(size_t) override final {}
+
+  void on_entry(rigel::WorkerView, rigel::TaskView) override final {}
+
+  void on_exit(rigel::WorkerView, rigel::TaskView tv) override final {
+    std::lock_guard<std::mutex> lock(mutex);
+    names.insert(tv.name());
+  }
+};
+
+void runtime_indexed_name(size_t W) {
+
+  rigel::Executor executor(W);
+  rigel::Taskflow taskflow;
+
+  auto observer = executor.make_observer<NameObserver>();
+
+  const size_t N = 10;
+
+  taskflow.emplace([&](rigel::Runtime& rt){
+    for(size_t i=0; i<N; i++) {
+      rt.silent_async_unchecked(rigel::IndexedName{"indexed-", i}, [](){});
+    }
+    rt.silent_async_on(0, rigel::IndexedName{"on-", 7}, [](){});
+    rt.join();
+  }).name("parent");
+
+  executor.run(taskflow).wait();
+
+  REQUIRE(observer->names.size() == N + 2);
+  REQUIRE(observer->names.count("parent") == 1);
+  REQUIRE(observer->names.count("on-7") == 1);
+  for(size_t i=0; i<N; i++) {
+    REQUIRE(observer->names.count("indexed-" + std::to_string(i)) == 1);
+  }
+}
+
+TEST_CASE("Runtime.IndexedName.1thread" * doctest::timeout(300)) {
+  runtime_indexed_name(1);
+}
+
+TEST_CASE("Runtime.IndexedName.2threads" * doctest::timeout(300)) {
+  runtime_indexed_name(2);
+}
+
+TEST_CASE("Runtime.IndexedName.4threads" * doctest::timeout(300)) {
+  runtime_indexed_name(4);
+}
@@ -634,3 +634,279 @@ TEST_CASE("optional" * doctest::timeout(300)) {
 TEST_CASE("tuple" * doctest::timeout(300)) {
   test_tuple();
 }
+
+// ----------------------------------------------------------------------------
+// Memory streams
+// ----------------------------------------------------------------------------
+
+enum class Color : uint8_t { RED, GREEN, BLUE };
+
+TEST_CASE("BufferStream" * doctest::timeout(300)) {
+
+  std::vector<int> vi(1000);
+  std::iota(vi.begin(), vi.end(), 0);
+  std::vector<std::string> vs {"a", "bc", "", "def"};
+  std::map<int, std::string> m {{1, "one"}, {2, "two"}};
+  std::vector<Color> colors {Color::RED, Color::BLUE, Color::GREEN};
+  std::optional<double> o {3.5};
+
+  // a buffer stream writes the same bytes as a std::ostream
+  std::ostringstream oss;
+  rigel::Serializer<std::ostringstream> oar(oss);
+  auto osz = oar(vi, vs, m, colors, o);
+
+  rigel::BufferStream buffer;
+  rigel::Serializer<rigel::BufferStream> bar(buffer);
+  auto bsz = bar(vi, vs, m, colors, o);
+
+  REQUIRE(osz == bsz);
+  REQUIRE(buffer.size() == static_cast<size_t>(bsz));
+  REQUIRE(buffer.str() == oss.str());
+
+  // read back through a view stream
+  decltype(vi) vi2;
+  decltype(vs) vs2;
+  decltype(m) m2;
+  decltype(colors) colors2;
+  decltype(o) o2;
+
+  rigel::ViewStream is(buffer.data(), buffer.size());
+  rigel::Deserializer<rigel::ViewStream> iar(is);
+  REQUIRE(iar(vi2, vs2, m2, colors2, o2) == bsz);
+  REQUIRE(is);
+  REQUIRE(is.remaining() == 0);
+  REQUIRE(is.peek() == std::char_traits<char>::eof());
+  REQUIRE(vi == vi2);
+  REQUIRE(vs == vs2);
+  REQUIRE(m == m2);
+  REQUIRE(colors == colors2);
+  REQUIRE(o == o2);
+
+  // reading past the end fails
+  int x;
+  iar(x);
+  REQUIRE(!is);
+}
+
+TEST_CASE("ViewStream.Truncated" * doctest::timeout(300)) {
+
+  std::vector<uint64_t> v(100, 7);
+
+  rigel::BufferStream buffer;
+  rigel::Serializer<rigel::BufferStream> oar(buffer);
+  oar(v);
+
+  rigel::ViewStream is(buffer.data(), buffer.size() - 1);
+  rigel::Deserializer<rigel::ViewStream> iar(is);
+  rigel::ArrayView<uint64_t> view;
+  iar(view);
+  REQUIRE(!is);
+  REQUIRE(view.empty());
+}
+
+TEST_CASE("ViewStream.CorruptedSize" * doctest::timeout(300)) {
+
+  // a size whose byte count overflows to 8
+  rigel::BufferStream buffer;
+  rigel::Serializer<rigel::BufferStream> oar(buffer);
+  oar(std::numeric_limits<size_t>::max() / 8 + 2, uint64_t{7});
+
+  {
+    rigel::ViewStream is(buffer.data(), buffer.size());
+    rigel::Deserializer<rigel::ViewStream> iar(is);
+    rigel::ArrayView<uint64_t> view;
+    iar(view);
+    REQUIRE(!is);
+    REQUIRE(view.empty());
+  }
+
+  {
+    rigel::ViewStream is(buffer.data(), buffer.size());
+    rigel::Deserializer<rigel::ViewStream> iar(is);
+    std::vector<uint64_t> v {1, 2, 3};
+    iar(v);
+    REQUIRE(!is);
+    REQUIRE(v.empty());
+  }
+
+  {
+    std::istringstream iss(std::string(buffer.str()));
+    rigel::Deserializer<std::istringstream> iar(iss);
+    std::vector<uint64_t> v;
+    iar(v);
+    REQUIRE(!iss);
+    REQUIRE(v.empty());
+  }
+
+  // a size larger than the bytes left
+  rigel::BufferStream small;
+  rigel::Serializer<rigel::BufferStream> sar(small);
+  sar(size_t{1000}, uint64_t{7});
+
+  rigel::ViewStream is(small.data(), small.size());
+  rigel::Deserializer<rigel::ViewStream> iar(is);
+  std::vector<uint64_t> v;
+  iar(v);
+  REQUIRE(!is);
+  REQUIRE(v.empty());
+}
+
+// ----------------------------------------------------------------------------
+// ArrayView
+// ----------------------------------------------------------------------------
+
+struct Point {
+  double x, y;
+  bool operator == (const Point& rhs) const { return x == rhs.x && y == rhs.y; }
+};
+
+TEST_CASE("ArrayView" * doctest::timeout(300)) {
+
+  std::vector<uint64_t> v(1000);
+  std::iota(v.begin(), v.end(), 100);
+  std::vector<Point> points {{1, 2}, {3, 4}, {5, 6}};
+
+  // an array view is saved in the vector format
+  rigel::BufferStream b1, b2;
+  rigel::Serializer<rigel::BufferStream> s1(b1), s2(b2);
+  s1(v);
+  s2(rigel::ArrayView<uint64_t>(v));
+  REQUIRE(b1.str() == b2.str());
+
+  // aligned data is viewed in place
+  std::vector<uint64_t> aligned((b1.size() + 7) / 8);
+  std::memcpy(aligned.data(), b1.data(), b1.size());
+  {
+    rigel::ViewStream is(aligned.data(), b1.size());
+    rigel::Deserializer<rigel::ViewStream> iar(is);
+    rigel::ArrayView<uint64_t> view;
+    iar(view);
+    REQUIRE(is);
+    REQUIRE(!view.owns_data());
+    REQUIRE(reinterpret_cast<const char*>(view.data()) ==
+            reinterpret_cast<const char*>(aligned.data()) + sizeof(size_t));
+    REQUIRE(view.to_vector() == v);
+  }
+
+  // misaligned data is copied
+  std::vector<char> misaligned(b1.size() + 1);
+  std::memcpy(misaligned.data() + 1, b1.data(), b1.size());
+  {
+    rigel::ViewStream is(misaligned.data() + 1, b1.size());
+    rigel::Deserializer<rigel::ViewStream> iar(is);
+    rigel::ArrayView<uint64_t> view;
+    iar(view);
+    if(reinterpret_cast<uintptr_t>(misaligned.data() + 1 + sizeof(size_t)) % alignof(uint64_t)) {
+      REQUIRE(view.owns_data());
+    }
+    REQUIRE(view.to_vector() == v);
+
+    // copies of an owning view own their data
+    auto copy = view;
+    REQUIRE(copy.to_vector() == v);
+    if(view.owns_data()) {
+      REQUIRE(copy.data() != view.data());
+    }
+  }
+
+  // a std::istream fills an owning view
+  {
+    std::istringstream iss(std::string(b1.str()));
+    rigel::Deserializer<std::istringstream> iar(iss);
+    rigel::ArrayView<uint64_t> view;
+    iar(view);
+    REQUIRE(view.owns_data());
+    REQUIRE(view.to_vector() == v);
+  }
+
+  // trivially copyable structs
+  rigel::BufferStream b3;
+  rigel::Serializer<rigel::BufferStream> s3(b3);
+  s3(rigel::ArrayView<Point>(points.data(), points.size()));
+  rigel::ViewStream is(b3.data(), b3.size());
+  rigel::Deserializer<rigel::ViewStream> iar(is);
+  rigel::ArrayView<Point> view;
+  iar(view);
+  REQUIRE(view.to_vector() == points);
+}
+
+// ----------------------------------------------------------------------------
+// DeltaVarintTag
+// ----------------------------------------------------------------------------
+
+template <typename T>
+void test_delta_varint(const std::vector<T>& v) {
+
+  rigel::BufferStream buffer;
+  rigel::Serializer<rigel::BufferStream> oar(buffer);
+  oar(rigel::make_delta_varint_tag(v));
+
+  std::vector<T> v2 {1, 2, 3};
+  rigel::ViewStream is(buffer.data(), buffer.size());
+  rigel::Deserializer<rigel::ViewStream> iar(is);
+  iar(rigel::make_delta_varint_tag(v2));
+
+  REQUIRE(is);
+  REQUIRE(v == v2);
+}
+
+TEST_CASE("DeltaVarintTag" * doctest::timeout(300)) {
+
+  // increasing timestamps take about one byte each
+  std::vector<uint64_t> stamps;
+  uint64_t t = 1700000000000000000ull;
+  for(int i=0; i<10000; i++) {
+    stamps.push_back(t += random<uint64_t>() % 100);
+  }
+  test_delta_varint(stamps);
+
+  rigel::BufferStream buffer;
+  rigel::Serializer<rigel::BufferStream> oar(buffer);
+  oar(rigel::make_delta_varint_tag(stamps));
+  REQUIRE(buffer.size() < stamps.size() * 2 + 32);
+
+  // signed, unsigned and extreme values
+  test_delta_varint(std::vector<int>{0, -1, 1, std::numeric_limits<int>::min(), std::numeric_limits<int>::max(), 0});
+  test_delta_varint(std::vector<uint64_t>{std::numeric_limits<uint64_t>::max(), 0, 1ull << 63, 5});
+  test_delta_varint(std::vector<int64_t>{std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max()});
+  test_delta_varint(std::vector<uint8_t>{255, 0, 128});
+  test_delta_varint(std::vector<int>{});
+}
+
+// ----------------------------------------------------------------------------
+// MappedFile
+// ----------------------------------------------------------------------------
+
+TEST_CASE("MappedFile" * doctest::timeout(300)) {
+
+  const std::string path = "test_serializer_mapped_file.bin";
+
+  std::vector<double> v(4096);
+  std::iota(v.begin(), v.end(), 0.5);
+  // an 8-character string keeps the array 8-byte aligned in the file
+  std::string s = "mapped!!";
+
+  {
+    std::ofstream ofs(path, std::ios::binary);
+    rigel::Serializer<std::ofstream> oar(ofs);
+    oar(s, v);
+  }
+
+  {
+    rigel::MappedFile file(path);
+    auto is = file.stream();
+    rigel::Deserializer<rigel::ViewStream> iar(is);
+    std::string s2;
+    rigel::ArrayView<double> view;
+    iar(s2, view);
+    REQUIRE(is);
+    REQUIRE(s2 == s);
+    REQUIRE(view.to_vector() == v);
+    REQUIRE(!view.owns_data());
+    REQUIRE(reinterpret_cast<const char*>(view.data()) == file.data() + 24);
+  }
+
+  std::remove(path.c_str());
+
+  REQUIRE_THROWS_AS(rigel::MappedFile("no/such/file"), std::runtime_error);
+}
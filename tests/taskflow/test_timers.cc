@@ -0,0 +1,248 @@
+// Copyright 2023 The titan-search Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include "tests/doctest.h"
+#include "rigel/taskflow/taskflow.h"
+#include "rigel/taskflow/algorithm/for_each.h"
+
+using namespace std::chrono_literals;
+
+// --------------------------------------------------------
+// Testcase: Timer.AsyncAfter
+// --------------------------------------------------------
+
+void async_after(unsigned W) {
+
+  rigel::Executor executor(W);
+
+  using clock = std::chrono::steady_clock;
+
+  const int N = 100;
+
+  std::vector<clock::time_point> due(N), ran(N);
+
+  auto beg = clock::now();
+
+  for(int i=0; i<N; i++) {
+    auto delay = std::chrono::milliseconds((i * 7) % 50);
+    due[i] = beg + delay;
+    executor.silent_async_after(delay, [&, i](){ ran[i] = clock::now(); });
+  }
+
+  // pending timers count as running tasks
+  executor.wait_for_all();
+
+  for(int i=0; i<N; i++) {
+    REQUIRE(ran[i] >= due[i]);
+  }
+
+  // delays that cascade down from the upper levels of the wheel
+  for(auto delay : {65ms, 300ms, 4100ms}) {
+    auto due = clock::now() + delay;
+    auto ran = executor.async_after(delay, [](){ return clock::now(); }).second.get();
+    REQUIRE(ran >= due);
+    REQUIRE(ran < due + 1s);
+  }
+
+  auto [timer, fu] = executor.async_after(1ms, [](){ return 7; });
+  REQUIRE(fu.get() == 7);
+  REQUIRE(timer.cancel() == false);
+  REQUIRE(timer.is_periodic() == false);
+}
+
+TEST_CASE("Timer.AsyncAfter.1thread" * doctest::timeout(300)) {
+  async_after(1);
+}
+
+TEST_CASE("Timer.AsyncAfter.2threads" * doctest::timeout(300)) {
+  async_after(2);
+}
+
+TEST_CASE("Timer.AsyncAfter.4threads" * doctest::timeout(300)) {
+  async_after(4);
+}
+
+// --------------------------------------------------------
+// Testcase: Timer.AsyncAt
+// --------------------------------------------------------
+
+void async_at(unsigned W) {
+
+  rigel::Executor executor(W);
+
+  // time points of another clock and in the past
+  auto when = std::chrono::system_clock::now() + 10ms;
+  auto [t1, fu1] = executor.async_at(when, [](){ return std::chrono::system_clock::now(); });
+  auto [t2, fu2] = executor.async_at(std::chrono::steady_clock::now() - 1s, [](){ return 2; });
+
+  REQUIRE(fu1.get() >= when);
+  REQUIRE(fu2.get() == 2);
+
+  std::atomic<int> counter {0};
+  for(int i=0; i<100; i++) {
+    executor.silent_async_at(std::chrono::steady_clock::now() + 1ms * i, [&](){
+      counter.fetch_add(1, std::memory_order_relaxed);
+    });
+  }
+  executor.wait_for_all();
+  REQUIRE(counter == 100);
+}
+
+TEST_CASE("Timer.AsyncAt.1thread" * doctest::timeout(300)) {
+  async_at(1);
+}
+
+TEST_CASE("Timer.AsyncAt.4threads" * doctest::timeout(300)) {
+  async_at(4);
+}
+
+// --------------------------------------------------------
+// Testcase: Timer.Cancel
+// --------------------------------------------------------
+
+void cancel(unsigned W) {
+
+  rigel::Executor executor(W);
+
+  const int N = 100000;
+
+  std::atomic<int> counter {0};
+  std::vector<rigel::TimerTask> timers;
+
+  // delays spread over all levels of the wheel, up to hours
+  for(int i=0; i<N; i++) {
+    auto delay = i % 2 ? std::chrono::milliseconds(i % 20) : std::chrono::milliseconds(i + 1) * 1000;
+    timers.push_back(executor.silent_async_after(delay, [&](){
+      counter.fetch_add(1, std::memory_order_relaxed);
+    }));
+  }
+
+  // cancels the far timers, so waiting only takes the near ones
+  int cancelled = 0;
+  for(int i=0; i<N; i+=2) {
+    cancelled += timers[i].cancel();
+  }
+  REQUIRE(cancelled == N/2);
+
+  executor.wait_for_all();
+  REQUIRE(counter == N/2);
+
+  // neither expired nor cancelled timers can be cancelled again
+  for(auto& timer : timers) {
+    REQUIRE(timer.cancel() == false);
+  }
+
+  // a cancelled timer breaks the promise of its future
+  auto [timer, fu] = executor.async_after(1h, [](){ return 1; });
+  REQUIRE(timer.cancel() == true);
+  REQUIRE_THROWS_AS(fu.get(), std::future_error);
+
+  REQUIRE(rigel::TimerTask().cancel() == false);
+}
+
+TEST_CASE("Timer.Cancel.1thread" * doctest::timeout(300)) {
+  cancel(1);
+}
+
+TEST_CASE("Timer.Cancel.4threads" * doctest::timeout(300)) {
+  cancel(4);
+}
+
+// --------------------------------------------------------
+// Testcase: Timer.Periodic
+// --------------------------------------------------------
+
+void periodic(unsigned W) {
+
+  rigel::Executor executor(W);
+
+  std::atomic<int> counter {0};
+
+  auto timer = executor.silent_async_every(2ms, [&](){
+    counter.fetch_add(1, std::memory_order_relaxed);
+  });
+
+  REQUIRE(timer.is_periodic());
+
+  // periodic timers do not keep wait_for_all waiting
+  executor.wait_for_all();
+
+  while(counter < 10);
+
+  REQUIRE(timer.cancel() == true);
+  REQUIRE(timer.cancel() == false);
+
+  // a run already handed to the executor may still be on its way
+  std::this_thread::sleep_for(10ms);
+  executor.wait_for_all();
+  auto stopped = counter.load();
+  std::this_thread::sleep_for(20ms);
+  REQUIRE(counter == stopped);
+
+  // the executor stops the remaining periodic timers
+  for(int i=0; i<10; i++) {
+    executor.silent_async_every(1ms, [&](){
+      counter.fetch_add(1, std::memory_order_relaxed);
+    });
+  }
+  std::this_thread::sleep_for(5ms);
+}
+
+TEST_CASE("Timer.Periodic.1thread" * doctest::timeout(300)) {
+  periodic(1);
+}
+
+TEST_CASE("Timer.Periodic.2threads" * doctest::timeout(300)) {
+  periodic(2);
+}
+
+TEST_CASE("Timer.Periodic.4threads" * doctest::timeout(300)) {
+  periodic(4);
+}
+
+// --------------------------------------------------------
+// Testcase: Timer.FromWorkers
+// --------------------------------------------------------
+
+void from_workers(unsigned W) {
+
+  rigel::Executor executor(W);
+  rigel::Taskflow taskflow;
+
+  std::atomic<int> counter {0};
+
+  // timers created by tasks chain further timers
+  taskflow.for_each_index(0, 100, 1, [&](int){
+    executor.silent_async_after(1ms, [&](){
+      executor.silent_async_after(1ms, [&](){
+        counter.fetch_add(1, std::memory_order_relaxed);
+      });
+    });
+  });
+
+  executor.run(taskflow).wait();
+  executor.wait_for_all();
+
+  REQUIRE(counter == 100);
+}
+
+TEST_CASE("Timer.FromWorkers.1thread" * doctest::timeout(300)) {
+  from_workers(1);
+}
+
+TEST_CASE("Timer.FromWorkers.4threads" * doctest::timeout(300)) {
+  from_workers(4);
+}
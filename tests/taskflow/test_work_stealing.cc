@@ -1257,3 +1257,385 @@ TEST_CASE("WorkStealing.Continuation.8threads" * doctest::timeout(300)) {
 
 
 
+
+// ----------------------------------------------------------------------------
+// Testcase: Metrics
+// ----------------------------------------------------------------------------
+
+void metrics_test(size_t W) {
+
+  rigel::Executor executor(W);
+
+  REQUIRE(executor.metrics_enabled() == false);
+
+  rigel::Taskflow taskflow;
+
+  for(int i=0; i<100; i++) {
+    taskflow.emplace([](){});
+  }
+
+  auto cond = taskflow.emplace([](){ return 0; });
+  auto subflow = taskflow.emplace([](rigel::Subflow& sf){
+    for(int i=0; i<10; i++) {
+      sf.emplace([](){});
+    }
+  });
+  auto async = taskflow.emplace([&](){
+    for(int i=0; i<2000; i++) {
+      executor.silent_async([](){});
+    }
+  });
+  cond.precede(subflow);
+
+  // nothing is collected before metrics are enabled
+  executor.run(taskflow).wait();
+  executor.wait_for_all();
+
+  auto metrics = executor.metrics();
+  REQUIRE(metrics.workers().size() == W);
+  REQUIRE(metrics.total().num_tasks() == 0);
+
+  executor.enable_metrics();
+  REQUIRE(executor.metrics_enabled() == true);
+
+  executor.run(taskflow).wait();
+  executor.wait_for_all();
+
+  metrics = executor.metrics();
+
+  auto total = metrics.total();
+  auto count = [&](rigel::TaskType type){
+    return total.tasks[static_cast<size_t>(type)];
+  };
+
+  REQUIRE(count(rigel::TaskType::STATIC) == 100 + 1 + 10);
+  REQUIRE(count(rigel::TaskType::CONDITION) == 1);
+  REQUIRE(count(rigel::TaskType::DYNAMIC) == 1);
+  REQUIRE(count(rigel::TaskType::ASYNC) == 2000);
+  REQUIRE(total.num_tasks() == 100 + 1 + 10 + 1 + 1 + 2000);
+  REQUIRE(total.steals <= total.steal_attempts);
+  REQUIRE(total.unparks <= total.parks);
+  REQUIRE(total.queue_high_water > 0);
+  REQUIRE(total.queue_size == 0);
+  REQUIRE(metrics.shared_queue_size() == 0);
+
+  // a single worker has no thief to drain its queue while it spawns
+  if(W == 1) {
+    REQUIRE(total.queue_high_water >= 2000);
+    REQUIRE(total.queue_resizes >= 1);
+  }
+
+  size_t num_tasks = 0;
+  for(const auto& w : metrics.workers()) {
+    num_tasks += w.num_tasks();
+  }
+  REQUIRE(num_tasks == total.num_tasks());
+
+  auto text = metrics.dump_prometheus();
+  REQUIRE(text.find("# TYPE rigel_executor_tasks_total counter") != std::string::npos);
+  REQUIRE(text.find("rigel_executor_tasks_total{worker=\"0\",type=\"static\"}") != std::string::npos);
+  REQUIRE(text.find("# TYPE rigel_executor_queue_high_water gauge") != std::string::npos);
+  REQUIRE(text.find("rigel_executor_queue_depth{worker=\"shared\"} 0") != std::string::npos);
+  REQUIRE(metrics.dump_prometheus("app").find("app_steals_total") != std::string::npos);
+
+  // disabling metrics keeps the collected counters
+  executor.enable_metrics(false);
+  executor.run(taskflow).wait();
+  executor.wait_for_all();
+
+  REQUIRE(executor.metrics().total().num_tasks() == total.num_tasks());
+}
+
+TEST_CASE("WorkStealing.Metrics.1thread" * doctest::timeout(300)) {
+  metrics_test(1);
+}
+
+TEST_CASE("WorkStealing.Metrics.2threads" * doctest::timeout(300)) {
+  metrics_test(2);
+}
+
+TEST_CASE("WorkStealing.Metrics.3threads" * doctest::timeout(300)) {
+  metrics_test(3);
+}
+
+TEST_CASE("WorkStealing.Metrics.4threads" * doctest::timeout(300)) {
+  metrics_test(4);
+}
+
+TEST_CASE("WorkStealing.Metrics.8threads" * doctest::timeout(300)) {
+  metrics_test(8);
+}
+
+// ----------------------------------------------------------------------------
+// Testcase: ReadyLatency
+// ----------------------------------------------------------------------------
+
+void ready_latency_test(size_t W) {
+
+  rigel::Executor executor(W);
+
+  REQUIRE(executor.latency_sampling_period() == 0);
+
+  rigel::Taskflow taskflow;
+
+  // a chain of 100 high-priority tasks and 200 independent low-priority ones
+  rigel::Task prev;
+  for(int i=0; i<100; i++) {
+    auto task = taskflow.emplace([](){}).priority(rigel::TaskPriority::HIGH);
+    if(i) {
+      prev.precede(task);
+    }
+    prev = task;
+  }
+  for(int i=0; i<200; i++) {
+    taskflow.emplace([](){}).priority(rigel::TaskPriority::LOW);
+  }
+
+  // no sampling by default
+  executor.run(taskflow).wait();
+  REQUIRE(executor.metrics().latency(rigel::TaskPriority::HIGH).count() == 0);
+
+  // every task
+  executor.enable_latency_sampling();
+  REQUIRE(executor.latency_sampling_period() == 1);
+  executor.run(taskflow).wait();
+
+  auto metrics = executor.metrics();
+  auto high = metrics.latency(rigel::TaskPriority::HIGH);
+  auto normal = metrics.latency(rigel::TaskPriority::NORMAL);
+  auto low = metrics.latency(rigel::TaskPriority::LOW);
+
+  REQUIRE(high.count() == 100);
+  REQUIRE(normal.count() == 0);
+  REQUIRE(low.count() == 200);
+  REQUIRE(high.min() <= high.percentile(50));
+  REQUIRE(high.percentile(50) <= high.percentile(99));
+  REQUIRE(high.percentile(99) <= high.max());
+  REQUIRE(high.percentile(100) == high.max());
+
+  size_t count = 0;
+  for(const auto& w : metrics.workers()) {
+    count += w.latency[static_cast<size_t>(rigel::TaskPriority::LOW)].count();
+  }
+  REQUIRE(count == 200);
+  REQUIRE(metrics.total().latency[static_cast<size_t>(rigel::TaskPriority::LOW)].count() == 200);
+
+  auto text = metrics.dump_prometheus();
+  REQUIRE(text.find("# TYPE rigel_executor_ready_latency_seconds summary") != std::string::npos);
+  REQUIRE(text.find("rigel_executor_ready_latency_seconds_count{priority=\"high\"} 100") != std::string::npos);
+
+  // every 10th task made ready by each scheduling thread
+  executor.enable_latency_sampling(10);
+  executor.run_n(taskflow, 10).wait();
+
+  metrics = executor.metrics();
+  auto sampled = metrics.latency(rigel::TaskPriority::HIGH).count() +
+                 metrics.latency(rigel::TaskPriority::LOW).count() - 300;
+  REQUIRE(sampled > 0);
+  REQUIRE(sampled <= 3000 / 10 + W + 1);
+
+  executor.enable_latency_sampling(0);
+  executor.run(taskflow).wait();
+  REQUIRE(executor.metrics().latency(rigel::TaskPriority::LOW).count() ==
+          metrics.latency(rigel::TaskPriority::LOW).count());
+}
+
+TEST_CASE("WorkStealing.ReadyLatency.1thread" * doctest::timeout(300)) {
+  ready_latency_test(1);
+}
+
+TEST_CASE("WorkStealing.ReadyLatency.2threads" * doctest::timeout(300)) {
+  ready_latency_test(2);
+}
+
+TEST_CASE("WorkStealing.ReadyLatency.3threads" * doctest::timeout(300)) {
+  ready_latency_test(3);
+}
+
+TEST_CASE("WorkStealing.ReadyLatency.4threads" * doctest::timeout(300)) {
+  ready_latency_test(4);
+}
+
+TEST_CASE("WorkStealing.ReadyLatency.8threads" * doctest::timeout(300)) {
+  ready_latency_test(8);
+}
+
+// ----------------------------------------------------------------------------
+// Testcase: LatencyHistogram
+// ----------------------------------------------------------------------------
+
+TEST_CASE("WorkStealing.LatencyHistogram" * doctest::timeout(300)) {
+
+  using H = rigel::LatencyHistogram;
+
+  // buckets are contiguous and each value falls in its own bucket
+  for(size_t b=0; b+1<H::NUM_BUCKETS; b++) {
+    REQUIRE(H::lowest_value(b) <= H::highest_value(b));
+    REQUIRE(H::highest_value(b) + 1 == H::lowest_value(b+1));
+    REQUIRE(H::bucket(H::lowest_value(b)) == b);
+    REQUIRE(H::bucket(H::highest_value(b)) == b);
+  }
+  REQUIRE(H::bucket(~uint64_t{0}) == H::NUM_BUCKETS - 1);
+
+  // relative error within 1/16
+  for(uint64_t v=1; v<1000000; v=v*3+1) {
+    auto b = H::bucket(v);
+    REQUIRE(H::highest_value(b) - H::lowest_value(b) <= v / H::SUB_BUCKETS);
+  }
+
+  H h1, h2;
+  for(uint64_t v=1; v<=1000; v++) {
+    (v % 2 ? h1 : h2).record(v);
+  }
+  h1.merge(h2);
+
+  REQUIRE(h1.count() == 1000);
+  REQUIRE(h1.sum() == 500500);
+  REQUIRE(h1.min() == 1);
+  REQUIRE(h1.max() == 1000);
+  REQUIRE(h1.mean() == doctest::Approx(500.5));
+
+  auto p50 = h1.percentile(50);
+  auto p99 = h1.percentile(99);
+  REQUIRE(p50 >= 500);
+  REQUIRE(p50 <= 500 + 500/16);
+  REQUIRE(p99 >= 990);
+  REQUIRE(p99 <= 1000);
+
+  h1.clear();
+  REQUIRE(h1.count() == 0);
+  REQUIRE(h1.percentile(99) == 0);
+}
+
+// ----------------------------------------------------------------------------
+// Fan-out wakeups: wide batches submitted while all workers are parked
+// ----------------------------------------------------------------------------
+
+void fan_out_wakeup_test(size_t W) {
+
+  rigel::Executor executor(W);
+
+  std::atomic<size_t> counter {0};
+
+  // roots scheduled together from the caller thread
+  rigel::Taskflow roots;
+  for(size_t i=0; i<2*W+1; i++) {
+    roots.emplace([&](){ counter.fetch_add(1, std::memory_order_relaxed); });
+  }
+
+  // successors scheduled together by a worker
+  rigel::Taskflow fanout;
+  auto src = fanout.emplace([](){});
+  for(size_t i=0; i<W-1+W/2; i++) {
+    src.precede(fanout.emplace([&](){ counter.fetch_add(1, std::memory_order_relaxed); }));
+  }
+
+  size_t expected = 0;
+
+  for(size_t r=0; r<50; r++) {
+
+    // let the workers park
+    std::this_thread::sleep_for(std::chrono::microseconds(200));
+
+    executor.run(roots).wait();
+    expected += roots.num_tasks();
+    REQUIRE(counter == expected);
+
+    std::this_thread::sleep_for(std::chrono::microseconds(200));
+
+    executor.run(fanout).wait();
+    expected += fanout.num_tasks() - 1;
+    REQUIRE(counter == expected);
+  }
+}
+
+TEST_CASE("WorkStealing.FanOutWakeup.1thread" * doctest::timeout(300)) {
+  fan_out_wakeup_test(1);
+}
+
+TEST_CASE("WorkStealing.FanOutWakeup.2threads" * doctest::timeout(300)) {
+  fan_out_wakeup_test(2);
+}
+
+TEST_CASE("WorkStealing.FanOutWakeup.3threads" * doctest::timeout(300)) {
+  fan_out_wakeup_test(3);
+}
+
+TEST_CASE("WorkStealing.FanOutWakeup.4threads" * doctest::timeout(300)) {
+  fan_out_wakeup_test(4);
+}
+
+TEST_CASE("WorkStealing.FanOutWakeup.8threads" * doctest::timeout(300)) {
+  fan_out_wakeup_test(8);
+}
+
+TEST_CASE("WorkStealing.FanOutWakeup.16threads" * doctest::timeout(300)) {
+  fan_out_wakeup_test(16);
+}
+
+// ----------------------------------------------------------------------------
+// Batched Schedule
+// ----------------------------------------------------------------------------
+
+void batched_schedule_test(size_t W) {
+
+  rigel::Executor executor(W);
+
+  std::atomic<size_t> counter {0};
+
+  // successors of mixed priorities, where only the highest one is kept by
+  // the worker and the rest is scheduled as one batch
+  rigel::Taskflow fanout;
+  auto src = fanout.emplace([](){});
+  for(size_t i=0; i<64; i++) {
+    auto t = fanout.emplace([&](){ counter.fetch_add(1, std::memory_order_relaxed); });
+    t.priority(static_cast<rigel::TaskPriority>(i % 3));
+    src.precede(t);
+  }
+
+  // subflow sources scheduled as one batch while the parent joins them
+  rigel::Taskflow subflows;
+  for(size_t i=0; i<4; i++) {
+    subflows.emplace([&](rigel::Subflow& sf){
+      for(size_t j=0; j<16; j++) {
+        sf.emplace([&](rigel::Subflow& sf2){
+          for(size_t k=0; k<4; k++) {
+            sf2.emplace([&](){ counter.fetch_add(1, std::memory_order_relaxed); });
+          }
+        });
+      }
+    });
+  }
+
+  size_t expected = 0;
+
+  for(size_t r=0; r<20; r++) {
+    executor.run(fanout).wait();
+    expected += 64;
+    REQUIRE(counter == expected);
+
+    executor.run_n(subflows, 2).wait();
+    expected += 2*4*16*4;
+    REQUIRE(counter == expected);
+  }
+}
+
+TEST_CASE("WorkStealing.BatchedSchedule.1thread" * doctest::timeout(300)) {
+  batched_schedule_test(1);
+}
+
+TEST_CASE("WorkStealing.BatchedSchedule.2threads" * doctest::timeout(300)) {
+  batched_schedule_test(2);
+}
+
+TEST_CASE("WorkStealing.BatchedSchedule.3threads" * doctest::timeout(300)) {
+  batched_schedule_test(3);
+}
+
+TEST_CASE("WorkStealing.BatchedSchedule.4threads" * doctest::timeout(300)) {
+  batched_schedule_test(4);
+}
+
+TEST_CASE("WorkStealing.BatchedSchedule.8threads" * doctest::timeout(300)) {
+  batched_schedule_test(8);
+}
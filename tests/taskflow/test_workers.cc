@@ -81,3 +81,325 @@ TEST_CASE("WorkerInterface" * doctest::timeout(300)) {
 
 
 
+
+// --------------------------------------------------------
+// Testcase: Resize
+// --------------------------------------------------------
+
+TEST_CASE("Resize" * doctest::timeout(300)) {
+
+  std::atomic<size_t> counter{0};
+  std::vector<size_t> ids;
+
+  {
+    rigel::Executor executor(2, std::make_shared<CustomWorkerBehavior>(counter, ids), 8);
+
+    REQUIRE(executor.num_workers() == 2);
+    REQUIRE(executor.max_workers() == 8);
+    REQUIRE(counter == 2);
+
+    REQUIRE_THROWS(executor.resize(0));
+    REQUIRE_THROWS(executor.resize(9));
+
+    // growing spawns the new workers only once
+    executor.resize(6);
+    REQUIRE(executor.num_workers() == 6);
+    REQUIRE(counter == 6);
+
+    executor.resize(1);
+    REQUIRE(executor.num_workers() == 1);
+    executor.resize(6);
+    REQUIRE(counter == 6);
+
+    // retired workers leave the tasks to the active ones
+    executor.resize(1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    rigel::Taskflow taskflow;
+    std::atomic<int> others{0};
+    for(int i=0; i<1000; i++) {
+      taskflow.emplace([&](){
+        if(executor.this_worker_id() != 0) {
+          others.fetch_add(1, std::memory_order_relaxed);
+        }
+      });
+    }
+    executor.run(taskflow).wait();
+    REQUIRE(others == 0);
+
+    executor.resize(8);
+    REQUIRE(executor.num_workers() == 8);
+  }
+
+  REQUIRE(counter == 16);
+  REQUIRE(ids.size() == 8);
+}
+
+// --------------------------------------------------------
+// Testcase: Resize.UnderLoad
+// --------------------------------------------------------
+
+void resize_under_load(size_t N, size_t M) {
+
+  rigel::Executor executor(N, nullptr, M);
+  rigel::Taskflow taskflow;
+
+  std::atomic<size_t> counter{0};
+  std::atomic<size_t> bad_ids{0};
+
+  // a wide graph whose tasks spawn asynchronous tasks
+  auto src = taskflow.emplace([](){});
+  auto dst = taskflow.emplace([](){});
+  for(int i=0; i<256; i++) {
+    auto t = taskflow.emplace([&](rigel::Subflow& sf){
+      counter.fetch_add(1, std::memory_order_relaxed);
+      if(auto id = executor.this_worker_id(); id < 0 || static_cast<size_t>(id) >= M) {
+        bad_ids.fetch_add(1, std::memory_order_relaxed);
+      }
+      for(int j=0; j<4; j++) {
+        sf.emplace([&](){ counter.fetch_add(1, std::memory_order_relaxed); });
+      }
+      executor.silent_async([&](){ counter.fetch_add(1, std::memory_order_relaxed); });
+    });
+    src.precede(t);
+    t.precede(dst);
+  }
+
+  const size_t R = 50;
+
+  auto fu = executor.run_n(taskflow, R);
+
+  // resizes from outside and from tasks while the taskflow runs
+  std::thread resizer([&](){
+    for(size_t i=0; fu.wait_for(std::chrono::microseconds(100)) != std::future_status::ready; i++) {
+      executor.resize(1 + (i * 7) % M);
+      if(i % 8 == 0) {
+        executor.silent_async([&, i](){ executor.resize(1 + (i * 3) % M); });
+      }
+    }
+  });
+
+  fu.wait();
+  resizer.join();
+  executor.wait_for_all();
+
+  REQUIRE(counter == R * 256 * 6);
+  REQUIRE(bad_ids == 0);
+
+  // the executor still runs at every size
+  for(size_t n=1; n<=M; n++) {
+    executor.resize(n);
+    counter = 0;
+    executor.run(taskflow).wait();
+    executor.wait_for_all();
+    REQUIRE(counter == 256 * 6);
+  }
+}
+
+TEST_CASE("Resize.UnderLoad.1to2threads" * doctest::timeout(300)) {
+  resize_under_load(1, 2);
+}
+
+TEST_CASE("Resize.UnderLoad.2to4threads" * doctest::timeout(300)) {
+  resize_under_load(2, 4);
+}
+
+TEST_CASE("Resize.UnderLoad.4to8threads" * doctest::timeout(300)) {
+  resize_under_load(4, 8);
+}
+
+TEST_CASE("Resize.UnderLoad.8to16threads" * doctest::timeout(300)) {
+  resize_under_load(8, 16);
+}
+
+// --------------------------------------------------------
+// Testcase: WorkerGroups
+// --------------------------------------------------------
+
+void worker_groups(size_t A, size_t B) {
+
+  REQUIRE_THROWS(rigel::Executor(std::vector<rigel::WorkerGroup>{}));
+  REQUIRE_THROWS(rigel::Executor({{"a", A}, {"b", 0}}));
+
+  rigel::Executor executor({{"a", A}, {"b", B}});
+
+  REQUIRE(executor.num_workers() == A + B);
+  REQUIRE(executor.num_groups() == 2);
+  REQUIRE(executor.group_id("a") == 0);
+  REQUIRE(executor.group_id("b") == 1);
+  REQUIRE_THROWS(executor.group_id("c"));
+  REQUIRE_THROWS(executor.resize(1));
+
+  auto in = [&](size_t g) {
+    auto id = static_cast<size_t>(executor.this_worker_id());
+    return g == 0 ? id < A : (id >= A && id < A + B);
+  };
+
+  std::atomic<int> wrong{0};
+  std::atomic<int> count{0};
+
+  auto check = [&](size_t g) {
+    if(!in(g)) {
+      wrong.fetch_add(1, std::memory_order_relaxed);
+    }
+    count.fetch_add(1, std::memory_order_relaxed);
+  };
+
+  // tasks follow the group of the taskflow unless they have their own
+  rigel::Taskflow taskflow;
+  taskflow.group(executor.group_id("b"));
+  REQUIRE(taskflow.group() == 1);
+
+  for(int i=0; i<100; i++) {
+    auto x = taskflow.emplace([&](){ check(1); });
+    auto y = taskflow.emplace([&](){ check(0); }).group(0);
+    auto z = taskflow.emplace([&](rigel::Subflow& sf){
+      check(1);
+      sf.emplace([&](){ check(1); });
+      sf.emplace([&](){ check(0); }).group(0);
+    });
+    REQUIRE(y.group() == 0);
+    x.precede(y);
+    y.precede(z);
+  }
+
+  executor.run_n(taskflow, 10).wait();
+
+  REQUIRE(count == 10*100*5);
+  REQUIRE(wrong == 0);
+
+  // asynchronous tasks run in the group of the submitting worker
+  count = 0;
+  for(int i=0; i<100; i++) {
+    executor.silent_async([&](){ check(0); });
+  }
+  executor.silent_async([&](){
+    for(int i=0; i<100; i++) {
+      executor.silent_async([&](){ check(0); });
+    }
+  });
+  rigel::Taskflow nested;
+  nested.emplace([&](){
+    for(int i=0; i<100; i++) {
+      executor.silent_async([&](){ check(1); });
+    }
+  }).group(1);
+  executor.run(nested);
+  executor.wait_for_all();
+
+  REQUIRE(count == 300);
+  REQUIRE(wrong == 0);
+
+  // a taskflow without a group follows the submitting worker too
+  rigel::Taskflow inner;
+  for(int i=0; i<100; i++) {
+    inner.emplace([&](){ check(1); });
+  }
+  count = 0;
+  rigel::Taskflow outer;
+  outer.emplace([&](){ executor.run(inner); }).group(1);
+  executor.run(outer).wait();
+  executor.wait_for_all();
+
+  REQUIRE(count == 100);
+  REQUIRE(wrong == 0);
+}
+
+TEST_CASE("WorkerGroups.1+1threads" * doctest::timeout(300)) {
+  worker_groups(1, 1);
+}
+
+TEST_CASE("WorkerGroups.1+3threads" * doctest::timeout(300)) {
+  worker_groups(1, 3);
+}
+
+TEST_CASE("WorkerGroups.4+4threads" * doctest::timeout(300)) {
+  worker_groups(4, 4);
+}
+
+// --------------------------------------------------------
+// Testcase: WorkerGroups.Lend
+// --------------------------------------------------------
+
+TEST_CASE("WorkerGroups.Lend" * doctest::timeout(300)) {
+
+  // the rt workers lend themselves to the batch group but not the reverse
+  rigel::Executor executor({{"rt", 2, {}, true}, {"batch", 1}});
+
+  std::atomic<int> lent{0};
+  std::atomic<int> wrong{0};
+
+  rigel::Taskflow batch;
+  batch.group(executor.group_id("batch"));
+  for(int i=0; i<200; i++) {
+    batch.emplace([&](){
+      if(executor.this_worker_id() < 2) {
+        lent.fetch_add(1, std::memory_order_relaxed);
+      }
+      std::this_thread::sleep_for(std::chrono::microseconds(200));
+    });
+  }
+
+  rigel::Taskflow rt;
+  for(int i=0; i<200; i++) {
+    rt.emplace([&](){
+      if(executor.this_worker_id() == 2) {
+        wrong.fetch_add(1, std::memory_order_relaxed);
+      }
+    });
+  }
+
+  executor.run(batch);
+  executor.run_n(rt, 10);
+  executor.wait_for_all();
+
+  REQUIRE(lent > 0);
+  REQUIRE(wrong == 0);
+}
+
+// --------------------------------------------------------
+// Testcase: WorkerGroups.Pin
+// --------------------------------------------------------
+
+class GroupRecorder : public rigel::WorkerInterface {
+
+  public:
+
+  void scheduler_prologue(rigel::Worker& w) override {
+    std::scoped_lock lock(mutex);
+    groups[w.id()] = w.group();
+#if defined(__linux__)
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+    cpus[w.id()] = CPU_COUNT(&cpuset);
+#endif
+  }
+
+  void scheduler_epilogue(rigel::Worker&, std::exception_ptr) override {
+  }
+
+  std::mutex mutex;
+  std::map<size_t, size_t> groups;
+  std::map<size_t, int> cpus;
+};
+
+TEST_CASE("WorkerGroups.Pin" * doctest::timeout(300)) {
+
+  auto recorder = std::make_shared<GroupRecorder>();
+
+  {
+    rigel::Executor executor({{"pinned", 2, {0}}, {"free", 3}}, recorder);
+  }
+
+  REQUIRE(recorder->groups.size() == 5);
+  for(size_t id=0; id<5; id++) {
+    REQUIRE(recorder->groups[id] == (id < 2 ? 0 : 1));
+  }
+
+#if defined(__linux__)
+  // workers are pinned before the prologue
+  REQUIRE(recorder->cpus[0] == 1);
+  REQUIRE(recorder->cpus[1] == 1);
+#endif
+}